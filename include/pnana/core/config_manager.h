@@ -17,6 +17,9 @@ struct EditorConfig {
     bool insert_spaces = true;
     bool word_wrap = false;
     bool auto_indent = true;
+    int undo_memory_limit_mb = 64; // 每个文档撤销/重做历史的内存上限（MB）
+    bool crash_recovery = true;    // 是否记录编辑日志，崩溃后可恢复未保存的修改
+    bool fsync_on_save = false;    // 保存时是否 fsync 文件和所在目录
 };
 
 // 显示配置结构
@@ -1,9 +1,18 @@
 #ifndef PNANA_CORE_DOCUMENT_H
 #define PNANA_CORE_DOCUMENT_H
 
+#include "core/document_snapshot.h"
+#include "core/edit_journal.h"
+#include "core/fold_index.h"
+#include "core/lazy_line_loader.h"
+#include "core/line_column_index.h"
+#include "core/line_buffer.h"
+#include "core/save_job.h"
+#include "core/undo_history.h"
 #include "features/lsp/lsp_types.h"
-#include <chrono>
-#include <deque>
+#include "utils/text_scanner.h"
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <set>
 #include <string>
@@ -12,46 +21,12 @@
 namespace pnana {
 namespace core {
 
-// 文档修改记录（用于撤销/重做）
-struct DocumentChange {
-    enum class Type { INSERT, DELETE, REPLACE, NEWLINE, COMPLETION };
-
-    Type type;
-    size_t row;
-    size_t col;
-    std::string old_content;
-    std::string new_content;
-    std::string after_cursor;                        // 用于 NEWLINE 类型：光标后的内容
-    std::chrono::steady_clock::time_point timestamp; // 时间戳，用于智能合并
-
-    DocumentChange(Type t, size_t r, size_t c, const std::string& old_c, const std::string& new_c)
-        : type(t), row(r), col(c), old_content(old_c), new_content(new_c), after_cursor(""),
-          timestamp(std::chrono::steady_clock::now()) {}
-
-    // NEWLINE 类型的构造函数
-    DocumentChange(Type t, size_t r, size_t c, const std::string& old_c, const std::string& new_c,
-                   const std::string& after)
-        : type(t), row(r), col(c), old_content(old_c), new_content(new_c), after_cursor(after),
-          timestamp(std::chrono::steady_clock::now()) {}
-
-    // COMPLETION 类型的构造函数（添加布尔参数以避免重载冲突）
-    DocumentChange(Type t, size_t r, size_t c, const std::string& replaced_text,
-                   const std::string& completion_text, bool /*is_completion*/)
-        : type(t), row(r), col(c), old_content(replaced_text), new_content(completion_text),
-          after_cursor(""), timestamp(std::chrono::steady_clock::now()) {}
-
-    // 带时间戳的构造函数（用于合并操作）
-    DocumentChange(Type t, size_t r, size_t c, const std::string& old_c, const std::string& new_c,
-                   const std::chrono::steady_clock::time_point& ts)
-        : type(t), row(r), col(c), old_content(old_c), new_content(new_c), after_cursor(""),
-          timestamp(ts) {}
-};
-
 // 文档类 - 管理单个文件的内容
 class Document {
   public:
     Document();
     explicit Document(const std::string& filepath);
+    ~Document();
 
     // 文件操作
     bool load(const std::string& filepath);
@@ -59,21 +34,88 @@ class Document {
     bool saveAs(const std::string& filepath);
     bool reload();
 
+    // 大文件后台加载
+    // 超过 LAZY_LOAD_THRESHOLD 的文件以内存映射方式打开：首块同步索引后立即可显示，
+    // 其余行由后台线程索引，主线程调用 pollLoading() 追加；行在首次访问所在块时才转为字符串
+    static constexpr size_t LAZY_LOAD_THRESHOLD = 32 * 1024 * 1024;
+    bool isLoading() const {
+        return loader_ != nullptr;
+    }
+    // 追加后台已索引的行；返回是否有变化（新行或加载完成）
+    bool pollLoading();
+    // 阻塞直到全部行索引完成
+    void finishLoading();
+    // 加载进度（0-100）
+    int loadProgress() const;
+    // 后台加载或保存有新进展时调用（在工作线程中调用，回调需线程安全）
+    void setLoadNotifier(std::function<void()> notifier);
+
+    // 后台保存
+    // 工作线程写出当前内容的快照（LineBuffer 的写时复制拷贝），主线程可以继续编辑；
+    // 结束后由 pollSaving() 更新文件路径和已保存版本（保存期间的修改仍算未保存）
+    static constexpr size_t BACKGROUND_SAVE_LINES = 100000; // Editor 对超过该行数的文档使用
+    bool startSave(const std::string& filepath);
+    bool isSaving() const {
+        return saver_ != nullptr;
+    }
+    // 后台保存结束时返回 true；失败原因见 getLastError()
+    bool pollSaving();
+    // 阻塞直到后台保存结束
+    void finishSaving();
+    // 保存进度（0-100）
+    int saveProgress() const;
+    // 最近一次保存（同步或后台）的结果
+    const SaveJob::Result& getLastSaveResult() const {
+        return last_save_;
+    }
+    // 保存时是否 fsync 文件和所在目录（默认关闭：依赖重命名的原子性，掉电时可能丢失最近一次保存）
+    void setFsyncOnSave(bool enabled) {
+        fsync_on_save_ = enabled;
+    }
+
     // 内容访问
     size_t lineCount() const {
         return lines_.size();
     }
     const std::string& getLine(size_t row) const;
-    const std::vector<std::string>& getLines() const {
+    const LineBuffer& getLines() const {
         return lines_;
     }
-    std::vector<std::string>& getLines() {
+    LineBuffer& getLines() {
         return lines_;
     }
 
-    // 获取完整的文档内容（所有行合并）
+    // 第 row 行中 byte 所在字形簇的起始显示列、覆盖第 column 列的字形簇的起始字节
+    // （语义同 utils::UnicodeWidth::columnAt/byteAt）。长行按行缓存稀疏检查点，
+    // 只从最近的检查点起扫描，编辑只使改动过的行失效
+    size_t columnAt(size_t row, size_t byte);
+    size_t byteAt(size_t row, size_t column);
+
+    // 获取完整的文档内容（所有行合并；后台加载期间只包含已索引的部分）
     std::string getContent() const;
 
+    // 当前内容的只读快照（O(块数)，与文档共享行存储），可交给后台线程读取，见 DocumentSnapshot
+    DocumentSnapshot snapshot() const;
+
+    // 取出并清空 tracker 自上次调用以来的行修改窗口：原来从 first 开始的 replaced 行
+    // 变成了现在的 [first, end)；没有修改时返回 false
+    bool takeLineChanges(LineBuffer::ChangeTracker tracker, size_t& first, size_t& end,
+                         size_t& replaced);
+
+    // 高亮器按文档保存的数据（如 Tree-sitter 语法树，类型由高亮器决定），
+    // 随文档一起销毁，内容整体替换时丢弃
+    std::shared_ptr<void>& syntaxState() {
+        return syntax_state_;
+    }
+    // 后台高亮按文档保存的数据（逐行词法状态、已发布的结果），语义同 syntaxState()
+    std::shared_ptr<void>& highlightState() {
+        return highlight_state_;
+    }
+    // 界面按文档保存的数据（按行缓存的样式区间），语义同 syntaxState()
+    std::shared_ptr<void>& renderState() {
+        return render_state_;
+    }
+
     // 编辑操作
     void insertChar(size_t row, size_t col, char ch);
     void insertText(size_t row, size_t col, const std::string& text);
@@ -90,6 +132,28 @@ class Document {
     bool redo(size_t* out_row = nullptr, size_t* out_col = nullptr);
     void pushChange(const DocumentChange& change);
     void clearHistory();
+    // 撤销/重做历史占用的字节数
+    size_t getUndoMemoryUsage() const {
+        return undo_stack_.memoryUsage() + redo_stack_.memoryUsage();
+    }
+    // 撤销/重做栈各自的字节预算，超出时淘汰最旧的记录
+    void setUndoByteBudget(size_t bytes);
+
+    // 崩溃恢复日志
+    // 启用后，有路径的文档把每次修改的行窗口追加到编辑日志，由后台线程组提交落盘；
+    // 正常关闭（无未保存修改）或保存时日志被清空，崩溃后留下的日志可在下次打开时回放
+    void setJournalEnabled(bool enabled);
+    bool isJournalEnabled() const {
+        return journal_enabled_;
+    }
+    // 打开文件时发现了上次崩溃留下的日志（原文件未被改动过）
+    bool hasRecoveryJournal() const {
+        return recovery_pending_;
+    }
+    // 在原文件内容上回放日志，成功后文档处于已修改状态
+    bool recoverFromJournal();
+    // 丢弃崩溃留下的日志并开始新的日志
+    void discardRecoveryJournal();
 
     // 选择和剪贴板
     std::string getSelection(size_t start_row, size_t start_col, size_t end_row,
@@ -107,14 +171,19 @@ class Document {
     }
     std::string getFileName() const;
     std::string getFileExtension() const;
+    // 修改状态：当前内容版本号与保存时的版本号比较，O(1)
     bool isModified() const {
-        return modified_;
+        return version_ != saved_version_;
     }
     bool isReadOnly() const {
         return read_only_;
     }
-    void setModified(bool modified) {
-        modified_ = modified;
+    // 绕过撤销历史直接修改 getLines() 后需调用 setModified(true)；
+    // setModified(false) 将当前内容标记为已保存
+    void setModified(bool modified);
+    // 内容版本号：每次修改都会变化，撤销/重做恢复为对应修改前/后的版本号
+    uint64_t getVersion() const {
+        return version_;
     }
 
     // 编码信息
@@ -161,26 +230,30 @@ class Document {
 
     // 获取可见行（排除折叠的行）
     std::vector<size_t> getVisibleLines(size_t start_line = 0, size_t end_line = SIZE_MAX) const;
+    // 从第 first_display_line 个显示行开始，最多 count 个可见行的实际行号（用于渲染窗口）
+    std::vector<size_t> getVisibleLineWindow(size_t first_display_line, size_t count) const;
     size_t getVisibleLineCount() const;
 
-    // 将显示行号转换为实际行号
+    // 将显示行号转换为实际行号（O(log 折叠数)）
     size_t displayLineToActualLine(size_t display_line) const;
-    // 将实际行号转换为显示行号
+    // 将实际行号转换为显示行号（O(log 折叠数)）
     size_t actualLineToDisplayLine(size_t actual_line) const;
 
   private:
-    std::vector<std::string> lines_;
-    std::vector<std::string> original_lines_; // 保存原始内容（用于判断是否修改）
+    LineBuffer lines_;
     std::string filepath_;
     std::string encoding_;
     LineEnding line_ending_;
-    bool modified_;
     bool read_only_;
 
-    // 撤销/重做栈
-    std::deque<DocumentChange> undo_stack_;
-    std::deque<DocumentChange> redo_stack_;
-    static constexpr size_t MAX_UNDO_STACK = 1000;
+    // 内容版本号：next_version_ 单调递增，保证撤销后的新分支不会与已保存版本重号
+    uint64_t version_ = 0;
+    uint64_t saved_version_ = 0;
+    uint64_t next_version_ = 0;
+
+    // 撤销/重做栈（按字节预算淘汰）
+    UndoHistory undo_stack_;
+    UndoHistory redo_stack_;
 
     // 剪贴板
     std::string clipboard_;
@@ -191,17 +264,50 @@ class Document {
     // 二进制文件标志
     bool is_binary_;
 
+    // 崩溃恢复日志
+    std::unique_ptr<EditJournal> journal_;
+    bool journal_enabled_ = false;
+    bool recovery_pending_ = false;
+
+    // 大文件后台加载
+    std::unique_ptr<LazyLineLoader> loader_;
+    std::function<void()> load_notifier_;
+
+    // 后台保存
+    std::unique_ptr<SaveJob> saver_;
+    uint64_t saving_version_ = 0; // 正在写出的版本
+    SaveJob::Result last_save_;
+    bool fsync_on_save_ = false;
+
     // 折叠范围
     std::vector<pnana::features::FoldingRange> folding_ranges_;
 
     // 已折叠的行范围（存储起始行号）
     std::set<int> folded_lines_;
 
+    // 折叠隐藏行索引（折叠状态变化时重建）
+    FoldIndex fold_index_;
+
+    // 高亮器按文档保存的数据
+    std::shared_ptr<void> syntax_state_;
+    std::shared_ptr<void> highlight_state_;
+    std::shared_ptr<void> render_state_;
+
+    // 长行的显示列检查点
+    LineColumnIndex column_index_;
+
     // 辅助方法
-    void detectLineEnding(const std::string& content);
+    bool loadMapped(const std::string& filepath);
+    void detectLineEnding(const utils::TextScanResult& scan);
     std::string applyLineEnding(const std::string& line) const;
-    void saveOriginalContent();           // 保存当前内容作为原始内容
-    bool isContentSameAsOriginal() const; // 检查当前内容是否与原始内容相同
+    void markSaved();     // 将当前版本标记为已保存
+    void completeSave(const std::string& filepath, uint64_t version); // 保存成功后更新状态
+    void resetVersion();  // 内容被整体替换（加载）后分配新版本并标记为已保存
+    void attachJournal(); // 加载后：发现崩溃日志时等待用户选择，否则开始新日志
+    void startJournal();  // 以磁盘文件为基准开始新日志
+    void stopJournal();   // 停止并删除当前日志
+    void journalEdits();  // 将自上次记录以来改动的行窗口追加到日志
+    void syncColumnIndex(); // 按自上次查询以来的行修改更新显示列检查点
 };
 
 } // namespace core
@@ -55,10 +55,20 @@ class DocumentManager {
     };
     std::vector<TabInfo> getAllTabs() const;
 
+    // 每个文档撤销/重做历史的字节预算（同时应用到已打开的文档）
+    void setUndoByteBudget(size_t bytes);
+    // 是否为文档记录崩溃恢复日志（同时应用到已打开的文档）
+    void setJournalEnabled(bool enabled);
+    // 保存时是否 fsync（同时应用到已打开的文档）
+    void setFsyncOnSave(bool enabled);
+
   private:
     std::vector<std::unique_ptr<Document>> documents_;
     size_t current_index_;
     size_t next_untitled_number_; // 用于未命名文档编号
+    size_t undo_byte_budget_;
+    bool journal_enabled_;
+    bool fsync_on_save_;
 
     void ensureAtLeastOneDocument();
 };
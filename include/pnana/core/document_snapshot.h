@@ -0,0 +1,88 @@
+#ifndef PNANA_CORE_DOCUMENT_SNAPSHOT_H
+#define PNANA_CORE_DOCUMENT_SNAPSHOT_H
+
+#include "core/line_buffer.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace pnana {
+namespace core {
+
+// 文档某一版本的只读快照
+// 由 Document::snapshot() 在主线程创建：LineBuffer 的块在快照与文档之间共享（写时复制），
+// 创建只需 O(块数)，之后文档的修改不会影响快照。快照本身可以随意拷贝并交给任意线程，
+// 多个线程同时读取也无需加锁；后台任务用 version() 标记结果，
+// 回到主线程时与 Document::getVersion() 比较即可丢弃过期的结果。
+class DocumentSnapshot {
+  public:
+    DocumentSnapshot() : lines_(std::make_shared<const LineBuffer>()) {}
+    DocumentSnapshot(std::shared_ptr<const LineBuffer> lines, uint64_t version,
+                     std::string filepath)
+        : lines_(std::move(lines)), version_(version), filepath_(std::move(filepath)) {}
+
+    // 创建快照时文档的内容版本
+    uint64_t version() const {
+        return version_;
+    }
+    const std::string& filepath() const {
+        return filepath_;
+    }
+
+    size_t lineCount() const {
+        return lines_->size();
+    }
+    // 第 row 行（越界时返回空行）
+    std::string_view line(size_t row) const {
+        return row < lines_->size() ? lines_->view(row) : std::string_view();
+    }
+
+    // 底层的行存储（只读，可直接交给按 LineBuffer 工作的代码，如 LineStateIndex）
+    const LineBuffer& lines() const {
+        return *lines_;
+    }
+
+    // 顺序遍历所有行 / [first, last) 行
+    template <typename Fn>
+    void forEachLine(Fn&& fn) const {
+        lines_->forEachLine(std::forward<Fn>(fn));
+    }
+    template <typename Fn>
+    void forEachLine(size_t first, size_t last, Fn&& fn) const {
+        lines_->forEachLine(first, last, std::forward<Fn>(fn));
+    }
+
+    // 按顺序输出前 max_lines 行以 \n 连接后的内容片段（行内容和换行符），不拼接成整个字符串；
+    // 片段直接指向快照的行存储，只在回调内有效
+    template <typename Fn>
+    void forEachChunk(Fn&& fn, size_t max_lines = static_cast<size_t>(-1)) const {
+        const size_t count = std::min(max_lines, lines_->size());
+        size_t i = 0;
+        lines_->forEachLine(0, count, [&](std::string_view line) {
+            if (!line.empty()) {
+                fn(line);
+            }
+            if (++i < count) {
+                fn(std::string_view("\n", 1)); // 添加换行符，除了最后一行
+            }
+        });
+    }
+    // forEachChunk() 输出的总字节数
+    size_t contentSize(size_t max_lines = static_cast<size_t>(-1)) const;
+
+    // 前 max_lines 行以 \n 连接（与 Document::getContent() 的格式一致）
+    std::string getContent(size_t max_lines = static_cast<size_t>(-1)) const;
+
+  private:
+    std::shared_ptr<const LineBuffer> lines_;
+    uint64_t version_ = 0;
+    std::string filepath_;
+};
+
+} // namespace core
+} // namespace pnana
+
+#endif // PNANA_CORE_DOCUMENT_SNAPSHOT_H
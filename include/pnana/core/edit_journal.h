@@ -0,0 +1,120 @@
+#ifndef PNANA_CORE_EDIT_JOURNAL_H
+#define PNANA_CORE_EDIT_JOURNAL_H
+
+#include "core/line_buffer.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pnana {
+namespace core {
+
+// 追加写入的编辑日志（崩溃恢复）
+// 日志以磁盘上的原文件为基准，依次记录"把从 first 开始的 replaced 行替换为这些行"的行级修改，
+// 回放时在原文件内容上按顺序应用即可还原未保存的编辑。
+// - 记录在主线程编码进内存缓冲，写入和 fsync 由后台线程完成；
+// - 后台线程按 COMMIT_INTERVAL 做组提交，一批记录只需一次 write + fsync；
+// - 每条记录带长度和校验和，崩溃时写了一半的尾部记录在读取时被忽略；
+// - 写入期间对日志文件持有排他 flock，其他实例据此区分"正在使用"和"崩溃遗留"。
+class EditJournal {
+  public:
+    static constexpr auto COMMIT_INTERVAL = std::chrono::milliseconds(200);
+    // 日志超过该大小、且超过基准文件大小的两倍后才以一条全文记录重写（见 compact()）
+    static constexpr size_t COMPACT_BYTES = 16 << 20;
+    // 全文记录的 replaced：替换原文件的全部行
+    static constexpr size_t REPLACE_ALL = static_cast<size_t>(-1);
+
+    // 一条行级修改：从第 first 行开始的 replaced 行替换为 lines
+    // （只用从头计的行号：大文件惰性加载时，记录写入时文件末尾可能还未索引）
+    struct Record {
+        size_t first = 0;
+        size_t replaced = 0;
+        std::vector<std::string> lines;
+    };
+
+    // 读取到的日志内容
+    struct Contents {
+        std::string target;     // 日志对应的文件
+        int64_t base_size = -1; // 写日志时原文件的大小（-1 表示文件不存在）
+        int64_t base_mtime = 0; // 写日志时原文件的修改时间
+        std::vector<Record> records;
+        size_t valid_bytes = 0; // 最后一条完整记录的结束位置
+    };
+
+    ~EditJournal();
+
+    EditJournal(const EditJournal&) = delete;
+    EditJournal& operator=(const EditJournal&) = delete;
+
+    // 以 target 当前的磁盘内容为基准新建日志（覆盖同名旧日志）；日志被其他实例锁住时失败
+    static std::unique_ptr<EditJournal> create(const std::string& target, std::string* error);
+    // 在已有日志的 valid_bytes 处截断后继续追加（恢复之后使用）
+    static std::unique_ptr<EditJournal> resume(const std::string& target, size_t valid_bytes,
+                                               std::string* error);
+
+    // 读取 target 的日志；日志不存在或头部无效时返回 false
+    static bool read(const std::string& target, Contents& contents, std::string* error);
+    // 日志是否正被另一个实例（或本进程中的另一个文档）持有，此时它不是崩溃遗留
+    static bool inUse(const std::string& target);
+    // 原文件自写日志以来是否未被改动（否则回放没有意义）
+    static bool baseMatches(const Contents& contents);
+    // 日志文件路径：~/.config/pnana/journal/<文件名>.<路径哈希>.journal
+    static std::string journalPath(const std::string& target);
+
+    // 记录旧内容从 first 开始的 replaced 行被替换为 lines 中的 [first, end)
+    // 只在调用线程编码，不做任何系统调用
+    void append(const LineBuffer& lines, size_t first, size_t end, size_t replaced);
+    // 日志是否已经大到值得重写：相对文档足够大时，全文记录才比已有记录小
+    bool needsCompaction() const {
+        return logical_size_ > compact_threshold_;
+    }
+    // 丢弃已有记录，以 lines 的全文作为唯一一条记录；
+    // 下一次重写的阈值随之提高到全文记录的两倍，避免大文件每次修改都重写
+    void compact(const LineBuffer& lines);
+    // 阻塞直到已追加的记录全部落盘
+    void flush();
+    // 停止写入并删除日志文件
+    void discard();
+
+    // 日志当前的逻辑大小（包括尚未落盘的部分）
+    size_t size() const {
+        return logical_size_;
+    }
+
+  private:
+    EditJournal(int fd, std::string path, size_t header_size, size_t size, int64_t base_size);
+
+    // 丢弃所有记录，回到只有头部的状态
+    void reset();
+    void run();
+    void startWorker();
+    void stopWorker();
+
+    int fd_;
+    std::string path_;
+    size_t header_size_;
+    size_t logical_size_;
+    size_t compact_threshold_;
+
+    std::thread worker_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable durable_;
+    std::string pending_;           // 尚未写入的记录
+    bool truncate_pending_ = false; // 写入 pending_ 前先截断到头部
+    bool flush_requested_ = false;
+    bool stop_ = false;
+    bool failed_ = false;
+    uint64_t queued_seq_ = 0;  // 已追加的批次序号
+    uint64_t durable_seq_ = 0; // 已落盘的批次序号
+};
+
+} // namespace core
+} // namespace pnana
+
+#endif // PNANA_CORE_EDIT_JOURNAL_H
@@ -19,6 +19,7 @@
 #include "ui/format_dialog.h"
 #include "ui/help.h"
 #include "ui/helpbar.h"
+#include "ui/line_render_cache.h"
 #include "ui/new_file_prompt.h"
 #include "ui/save_as_dialog.h"
 #include "ui/search_dialog.h"
@@ -39,6 +40,7 @@
 #ifdef BUILD_IMAGE_PREVIEW_SUPPORT
 #include "features/image_preview.h"
 #endif
+#include "features/SyntaxHighlighter/background_highlighter.h"
 #include "features/SyntaxHighlighter/syntax_highlighter.h"
 #include "features/command_palette.h"
 #include "features/split_view.h"
@@ -123,13 +125,16 @@ class Editor {
 
     // 文件操作
     bool openFile(const std::string& filepath);
-    bool saveFile();
+    // 大文件默认在后台保存，返回 true 只表示已开始；wait 为 true 时等到写完，返回值即保存结果
+    bool saveFile(bool wait = false);
     bool saveFileAs(const std::string& filepath);
     void startSaveAs(); // 启动另存为对话框
     bool closeFile();
     void newFile();
     void createFolder();   // 创建新文件夹
     void openFilePicker(); // 打开文件选择器
+    // 若有文档留有上次崩溃的编辑日志，询问是否恢复
+    void offerJournalRecovery();
 
     // 光标移动
     void moveCursorUp();
@@ -370,6 +375,9 @@ class Editor {
     // 当前搜索状态
     bool search_highlight_active_;
     features::SearchOptions current_search_options_;
+    bool search_jump_pending_ = false; // 后台搜索到达第一个匹配时把光标移过去
+    // 有对话框打开时推迟的崩溃恢复询问，对话框关闭后的下一个事件中再询问
+    bool journal_recovery_queued_ = false;
 #ifdef BUILD_IMAGE_PREVIEW_SUPPORT
     features::ImagePreview image_preview_;
 #endif
@@ -384,7 +392,7 @@ class Editor {
         size_t cursor_row = 0;
         size_t cursor_col = 0;
         size_t view_offset_row = 0;
-        size_t view_offset_col = 0;
+        size_t view_offset_col = 0; // 显示列
     };
     std::vector<RegionState> region_states_;
 
@@ -460,7 +468,7 @@ class Editor {
     size_t cursor_row_;
     size_t cursor_col_;
     size_t view_offset_row_;
-    size_t view_offset_col_;
+    size_t view_offset_col_; // 水平滚动的起始显示列（不是字节偏移）
 
     // SSH连接状态
     pnana::ui::SSHConfig current_ssh_config_;
@@ -527,6 +535,17 @@ class Editor {
     std::chrono::steady_clock::time_point last_markdown_preview_update_time_;
     std::chrono::milliseconds markdown_preview_update_delay_{300}; // 300ms延迟更新
     bool markdown_preview_needs_update_ = false;
+    // Markdown预览缓存：文档、内容版本、尺寸和主题都未变化时复用上次的渲染结果
+    ftxui::Element markdown_preview_cache_;
+    const Document* markdown_preview_doc_ = nullptr;
+    std::string markdown_preview_path_;
+    uint64_t markdown_preview_version_ = 0;
+    int markdown_preview_width_ = 0;
+    int markdown_preview_height_ = 0;
+    std::string markdown_preview_theme_;
+
+    // 行渲染缓存：没有光标、选中和搜索匹配的行按行文本复用语法高亮结果
+    pnana::ui::LineRenderCache line_render_cache_;
 
     // 强制触发待处理的光标更新
     void triggerPendingCursorUpdate();
@@ -535,6 +554,9 @@ class Editor {
     ftxui::ScreenInteractive screen_;
     ftxui::Component main_component_;
 
+    // 后台语法高亮（原生分词器）；结果到达时通过 screen_ 请求重绘，因此在 screen_ 之后声明、先析构
+    features::BackgroundHighlighter background_highlighter_;
+
     // 事件处理
     void handleInput(ftxui::Event event);
     void handleNormalMode(ftxui::Event event);
@@ -550,7 +572,16 @@ class Editor {
     ftxui::Element renderSplitEditor(); // 分屏编辑器渲染
     ftxui::Element renderEditorRegion(const features::ViewRegion& region, Document* doc,
                                       size_t region_index); // 渲染单个区域
-    ftxui::Element renderLine(Document* doc, size_t line_num, bool is_current);
+    // 把即将渲染的行提交给后台高亮
+    void updateBackgroundHighlight(Document* doc, const std::vector<size_t>& visible_lines);
+    // 文档按行缓存的样式区间（必要时新建），先按文档的行修改丢弃改动过的行
+    pnana::ui::RowSpanCache& rowSpanCache(Document& doc);
+    // 渲染一行：只取从显示列 first_col 开始、text_width 列（加少量余量）内的文本，
+    // 超长行的代价只与视口宽度有关
+    ftxui::Element renderLine(Document* doc, size_t line_num, bool is_current, size_t first_col,
+                              size_t text_width);
+    // 代码区宽度为 area_width 列时行文本可用的列数（去掉折叠指示器和行号）
+    size_t lineTextWidth(int area_width) const;
     ftxui::Element renderLineNumber(Document* doc, size_t line_num, bool is_current);
     ftxui::Element renderStatusbar();
     ftxui::Element renderHelpbar();
@@ -565,11 +596,21 @@ class Editor {
     // 辅助方法
     void adjustCursor();
     void adjustViewOffset();
+    // 光标所在的显示列
+    size_t cursorDisplayColumn();
+    // 把光标移到 row 行并保持显示列不变（落在宽字符中间时取该字符的开头）
+    void moveCursorToRow(size_t row);
     void adjustViewOffsetForUndo(size_t target_row, size_t target_col);
     void adjustViewOffsetForUndoConservative(size_t target_row, size_t target_col);
     void setStatusMessage(const std::string& message);
+    void pollDocumentLoading(); // 追加大文件后台加载的结果，取回后台保存的结果
+    void showSaveResult(Document* doc); // 在状态栏显示最近一次保存的结果
     std::string getFileType() const;
     void executeSearch(bool move_cursor = true);
+    // 大文档在后台并行搜索，结果由 pollSearchResults() 陆续并入
+    void startBackgroundSearch(const std::string& pattern, const features::SearchOptions& options,
+                               bool move_cursor);
+    void pollSearchResults();
     void executeReplace();
 
     // 快捷键检查
@@ -0,0 +1,61 @@
+#ifndef PNANA_CORE_FOLD_INDEX_H
+#define PNANA_CORE_FOLD_INDEX_H
+
+#include "features/lsp/lsp_types.h"
+#include <cstddef>
+#include <set>
+#include <vector>
+
+namespace pnana {
+namespace core {
+
+// 折叠隐藏行索引
+// 将所有已折叠范围的隐藏部分（startLine 之后到 endLine）合并为按起点排序、互不相交的区间，
+// 并记录每个区间之前的隐藏行数前缀和。显示行与实际行的互相转换只需在区间上二分，
+// 复杂度为 O(log 折叠数)，与文件行数无关。折叠状态变化时调用 rebuild() 重建。
+class FoldIndex {
+  public:
+    void rebuild(const std::vector<pnana::features::FoldingRange>& ranges,
+                 const std::set<int>& folded_lines);
+    void clear() {
+        intervals_.clear();
+    }
+    bool empty() const {
+        return intervals_.empty();
+    }
+
+    // 行是否被折叠隐藏
+    bool isHidden(size_t line) const;
+    // [0, line) 中被隐藏的行数
+    size_t hiddenBefore(size_t line) const;
+    // 共 line_count 行时的可见行数
+    size_t visibleCount(size_t line_count) const {
+        return line_count - hiddenBefore(line_count);
+    }
+
+    // 实际行 -> 显示行（隐藏行映射到它之前最近的可见行）
+    size_t actualToDisplay(size_t line) const {
+        return line - hiddenBefore(line + 1);
+    }
+    // 显示行 -> 实际行（不检查是否超出文档末尾）
+    size_t displayToActual(size_t display_line) const;
+
+    // 从 line 开始（含）的第一个可见行
+    size_t nextVisible(size_t line) const;
+
+  private:
+    struct Interval {
+        size_t start;         // 第一个隐藏行
+        size_t end;           // 最后一个隐藏行之后
+        size_t hidden_before; // 该区间之前的隐藏行总数
+    };
+    std::vector<Interval> intervals_;
+
+    // 返回第一个 start > line 的区间下标
+    size_t upperBound(size_t line) const;
+};
+
+} // namespace core
+} // namespace pnana
+
+#endif // PNANA_CORE_FOLD_INDEX_H
@@ -0,0 +1,83 @@
+#ifndef PNANA_CORE_LAZY_LINE_LOADER_H
+#define PNANA_CORE_LAZY_LINE_LOADER_H
+
+#include "core/mapped_file.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pnana {
+namespace core {
+
+// 映射文件中一段连续的行（对应 LineBuffer 的一个映射块）
+struct MappedLineChunk {
+    size_t base = 0;
+    std::shared_ptr<const std::vector<uint32_t>> bounds; // 行起始偏移 + 块结束偏移
+};
+
+// 大文件后台行索引器
+// 在工作线程中扫描映射文件的换行符，按块产出行偏移；主线程通过 takeChunks() 取走结果
+// 并追加到 LineBuffer，因此 LineBuffer 本身始终只在主线程访问。
+class LazyLineLoader {
+  public:
+    static constexpr size_t CHUNK_LINES = 512;           // 每块行数（与 LineBuffer 一致）
+    static constexpr size_t MAX_CHUNK_BYTES = 1u << 30;  // 单块字节上限（偏移用 uint32_t）
+    static constexpr size_t PUBLISH_CHUNKS = 256;        // 每积累多少块通知一次主线程
+
+    using NotifyCallback = std::function<void()>;
+
+    // 从 offset 开始在后台扫描；notify 在有新结果或扫描结束时于工作线程调用
+    LazyLineLoader(std::shared_ptr<const MappedFile> file, size_t offset,
+                   NotifyCallback notify = nullptr);
+    ~LazyLineLoader();
+
+    LazyLineLoader(const LazyLineLoader&) = delete;
+    LazyLineLoader& operator=(const LazyLineLoader&) = delete;
+
+    // 从行首 offset 开始扫描一块，next_offset 返回下一块的起点
+    // 返回 true 表示本块已包含文件的最后一行（可能为空行），扫描结束
+    // 注意：单行超过 4 GiB 时偏移会溢出，这类文件不适合惰性加载
+    static bool scanChunk(const MappedFile& file, size_t offset, MappedLineChunk& chunk,
+                          size_t& next_offset);
+
+    // 取走目前已完成的块
+    std::vector<MappedLineChunk> takeChunks();
+
+    // 等待扫描完成
+    void wait();
+
+    // 更换通知回调（可在扫描过程中调用）
+    void setNotify(NotifyCallback notify);
+
+    bool isFinished() const {
+        return finished_.load();
+    }
+    // 已扫描的字节数（用于显示进度）
+    size_t scannedBytes() const {
+        return scanned_.load();
+    }
+    const std::shared_ptr<const MappedFile>& file() const {
+        return file_;
+    }
+
+  private:
+    void run(size_t offset);
+
+    std::shared_ptr<const MappedFile> file_;
+    NotifyCallback notify_;
+    std::thread worker_;
+    std::mutex mutex_;
+    std::vector<MappedLineChunk> pending_;
+    std::atomic<bool> cancelled_{false};
+    std::atomic<bool> finished_{false};
+    std::atomic<size_t> scanned_{0};
+};
+
+} // namespace core
+} // namespace pnana
+
+#endif // PNANA_CORE_LAZY_LINE_LOADER_H
@@ -0,0 +1,404 @@
+#ifndef PNANA_CORE_LINE_BUFFER_H
+#define PNANA_CORE_LINE_BUFFER_H
+
+#include "core/mapped_file.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace pnana {
+namespace core {
+
+// 分块行存储（行级 rope）
+// 文本按行分成若干块，每块最多 MAX_CHUNK_LINES 行，块大小由 Fenwick 树索引：
+// - 行定位 O(log 块数)
+// - 插入/删除行只移动所在块内的字符串头，而不是整个文件
+// 行数不超过一个块时退化为单个 vector，小文件没有额外开销。
+// 大文件惰性加载时，块可以只记录行在映射文件中的偏移，首次访问该块时才转换为 std::string。
+// 块的行存储在拷贝之间共享（写时复制），拷贝整个 LineBuffer 只需 O(块数)，可作为保存等后台任务的快照。
+// 接口刻意与 std::vector<std::string> 保持一致，便于 Document 内外现有代码直接使用。
+class LineBuffer {
+  public:
+    static constexpr size_t TARGET_CHUNK_LINES = 512;  // 批量构建时每块的行数
+    static constexpr size_t MAX_CHUNK_LINES = 1024;    // 超过后分裂
+    static constexpr size_t MERGE_CHUNK_LINES = 128;   // 低于后尝试与相邻块合并
+
+    template <bool IsConst>
+    class Iterator {
+      public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = std::string;
+        using difference_type = std::ptrdiff_t;
+        using pointer = typename std::conditional<IsConst, const std::string*, std::string*>::type;
+        using reference =
+            typename std::conditional<IsConst, const std::string&, std::string&>::type;
+        using buffer_type = typename std::conditional<IsConst, const LineBuffer, LineBuffer>::type;
+
+        Iterator() : buffer_(nullptr), index_(0), chunk_(0), offset_(0) {}
+        Iterator(buffer_type* buffer, size_t index) : buffer_(buffer), index_(index) {
+            buffer_->locate(index_, chunk_, offset_);
+        }
+        // 允许 iterator -> const_iterator
+        template <bool OtherConst, typename = typename std::enable_if<IsConst && !OtherConst>::type>
+        Iterator(const Iterator<OtherConst>& other)
+            : buffer_(other.buffer_), index_(other.index_), chunk_(other.chunk_),
+              offset_(other.offset_) {}
+
+        // 非 const 迭代器解引用视为可能修改该行
+        reference operator*() const {
+            if constexpr (!IsConst) {
+                buffer_->touch(index_, index_ + 1);
+            }
+            return buffer_->ownedLines(chunk_)[offset_];
+        }
+        pointer operator->() const {
+            if constexpr (!IsConst) {
+                buffer_->touch(index_, index_ + 1);
+            }
+            return &buffer_->ownedLines(chunk_)[offset_];
+        }
+
+        Iterator& operator++() {
+            ++index_;
+            if (++offset_ >= buffer_->chunks_[chunk_].size() &&
+                chunk_ + 1 < buffer_->chunks_.size()) {
+                ++chunk_;
+                offset_ = 0;
+            }
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        Iterator& operator--() {
+            --index_;
+            if (offset_ == 0) {
+                --chunk_;
+                offset_ = buffer_->chunks_[chunk_].size() - 1;
+            } else {
+                --offset_;
+            }
+            return *this;
+        }
+        Iterator operator--(int) {
+            Iterator tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        // 随机偏移需要重新定位（O(log 块数)）
+        Iterator operator+(difference_type n) const {
+            return Iterator(buffer_, static_cast<size_t>(static_cast<difference_type>(index_) + n));
+        }
+        Iterator operator-(difference_type n) const {
+            return Iterator(buffer_, static_cast<size_t>(static_cast<difference_type>(index_) - n));
+        }
+        difference_type operator-(const Iterator& other) const {
+            return static_cast<difference_type>(index_) -
+                   static_cast<difference_type>(other.index_);
+        }
+
+        bool operator==(const Iterator& other) const {
+            return index_ == other.index_;
+        }
+        bool operator!=(const Iterator& other) const {
+            return index_ != other.index_;
+        }
+
+        size_t index() const {
+            return index_;
+        }
+
+      private:
+        template <bool>
+        friend class Iterator;
+
+        buffer_type* buffer_;
+        size_t index_;
+        size_t chunk_;
+        size_t offset_;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    LineBuffer() = default;
+    LineBuffer(const std::vector<std::string>& lines);
+    LineBuffer(std::vector<std::string>&& lines);
+
+    LineBuffer& operator=(const std::vector<std::string>& lines);
+    LineBuffer& operator=(std::vector<std::string>&& lines);
+
+    // 容量
+    size_t size() const {
+        return size_;
+    }
+    bool empty() const {
+        return size_ == 0;
+    }
+    size_t chunkCount() const {
+        return chunks_.size();
+    }
+
+    // 元素访问（不做越界检查，与 std::vector 一致）
+    std::string& operator[](size_t row);
+    const std::string& operator[](size_t row) const;
+    // 第 row 行的只读视图：不转换映射块，因此多个线程可以同时读取同一个（不再被修改的）LineBuffer
+    std::string_view view(size_t row) const;
+    std::string& front() {
+        touch(0, 1);
+        return ownedLines(0).front();
+    }
+    const std::string& front() const {
+        return ownedLines(0).front();
+    }
+    std::string& back() {
+        touch(size_ - 1, size_);
+        return ownedLines(chunks_.size() - 1).back();
+    }
+    const std::string& back() const {
+        return ownedLines(chunks_.size() - 1).back();
+    }
+
+    // 迭代
+    iterator begin() {
+        return iterator(this, 0);
+    }
+    iterator end() {
+        return iterator(this, size_);
+    }
+    const_iterator begin() const {
+        return const_iterator(this, 0);
+    }
+    const_iterator end() const {
+        return const_iterator(this, size_);
+    }
+    const_iterator cbegin() const {
+        return begin();
+    }
+    const_iterator cend() const {
+        return end();
+    }
+
+    // 按块遍历（顺序扫描时比逐行定位更快）
+    const std::vector<std::string>& chunkLines(size_t chunk) const {
+        return ownedLines(chunk);
+    }
+
+    // 只读顺序遍历所有行；映射块不会被转换为 std::string，适合保存、搜索等整文件扫描
+    template <typename Fn>
+    void forEachLine(Fn&& fn) const {
+        for (const auto& chunk : chunks_) {
+            for (size_t i = 0, n = chunk.size(); i < n; ++i) {
+                fn(chunk.view(i));
+            }
+        }
+    }
+    // 只读顺序遍历 [first, last) 行
+    template <typename Fn>
+    void forEachLine(size_t first, size_t last, Fn&& fn) const {
+        last = std::min(last, size_);
+        if (first >= last) {
+            return;
+        }
+        size_t chunk, offset;
+        locate(first, chunk, offset);
+        for (size_t remaining = last - first; remaining > 0; ++chunk, offset = 0) {
+            const Chunk& current = chunks_[chunk];
+            size_t n = std::min(current.size(), offset + remaining);
+            for (size_t i = offset; i < n; ++i) {
+                fn(current.view(i));
+            }
+            remaining -= n - offset;
+        }
+    }
+
+    // 惰性加载：在末尾追加一个仍位于映射文件中的块
+    // bounds[i] 为第 i 行相对 base 的起始偏移，末元素为块的结束偏移（共 行数 + 1 个）
+    void appendMapped(std::shared_ptr<const MappedFile> source, size_t base,
+                      std::shared_ptr<const std::vector<uint32_t>> bounds);
+    bool isChunkMapped(size_t chunk) const {
+        return chunks_[chunk].source != nullptr;
+    }
+
+    // 修改
+    void clear();
+    void push_back(const std::string& line);
+    void push_back(std::string&& line);
+    void pop_back();
+    void insert(size_t row, std::string line);
+    void insert(size_t row, std::vector<std::string> lines);
+    void erase(size_t first, size_t last);
+    void erase(size_t row) {
+        erase(row, row + 1);
+    }
+    iterator insert(const_iterator pos, std::string line);
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+
+    // 修改窗口（供编辑日志增量记录）
+    // 自上次 clearDirty() 以来，开头 dirtyBegin() 行和末尾若干行都没有被改动过，
+    // 当时从 dirtyBegin() 开始的 dirtyReplacedLines() 行被替换成了现在的 [dirtyBegin(), dirtyEnd())。
+    // 非 const 的行访问都视为改动，因此窗口可能偏大，但不会漏记
+    bool hasDirtyLines() const {
+        return dirty_.first != NO_DIRTY;
+    }
+    size_t dirtyBegin() const {
+        return dirty_.begin(size_);
+    }
+    size_t dirtyEnd() const {
+        return dirty_.end(size_);
+    }
+    size_t dirtyReplacedLines() const {
+        return dirty_.replaced(size_);
+    }
+    void clearDirty() {
+        dirty_.clear(size_);
+    }
+
+    // 按行缓存使用的独立修改窗口，每个使用方一个、各自清空，语义与 dirty* 相同
+    enum ChangeTracker : size_t {
+        LINE_STATES = 0, // 逐行词法状态检查点（后台高亮）
+        SYNTAX_TREE,     // Tree-sitter 语法树
+        SEARCH_MATCHES,  // 搜索匹配（SearchEngine::applyEdits）
+        COLUMN_INDEX,    // 长行的显示列检查点（Document::columnAt/byteAt）
+        RENDER_ROWS,     // 按行缓存的样式区间（渲染）
+        CHANGE_TRACKER_COUNT
+    };
+    bool hasChangedLines(ChangeTracker tracker) const {
+        return changed_[tracker].first != NO_DIRTY;
+    }
+    size_t changedBegin(ChangeTracker tracker) const {
+        return changed_[tracker].begin(size_);
+    }
+    size_t changedEnd(ChangeTracker tracker) const {
+        return changed_[tracker].end(size_);
+    }
+    size_t changedReplacedLines(ChangeTracker tracker) const {
+        return changed_[tracker].replaced(size_);
+    }
+    void clearChanged(ChangeTracker tracker) {
+        changed_[tracker].clear(size_);
+    }
+
+    // 转换为普通 vector（拷贝，仅用于需要连续存储的旧接口）
+    std::vector<std::string> toVector() const;
+
+    bool operator==(const LineBuffer& other) const;
+    bool operator!=(const LineBuffer& other) const {
+        return !(*this == other);
+    }
+
+  private:
+    struct Chunk {
+        // 行存储；拷贝 LineBuffer 时与副本共享，修改前通过 mutableLines() 取得独占的一份
+        std::shared_ptr<std::vector<std::string>> lines;
+        // 映射块：source 非空时行内容仍在文件映射中，lines 为空
+        std::shared_ptr<const MappedFile> source;
+        size_t base = 0;
+        std::shared_ptr<const std::vector<uint32_t>> bounds;
+
+        size_t size() const {
+            if (source) {
+                return bounds->size() - 1;
+            }
+            return lines ? lines->size() : 0;
+        }
+        // 第 i 行的只读视图（映射块去掉行尾的 \n 和 \r）
+        std::string_view view(size_t i) const {
+            if (!source) {
+                return (*lines)[i];
+            }
+            const char* data = source->data() + base;
+            size_t begin = (*bounds)[i];
+            size_t end = (*bounds)[i + 1];
+            if (end > begin && data[end - 1] == '\n') {
+                --end;
+            }
+            if (end > begin && data[end - 1] == '\r') {
+                --end;
+            }
+            return std::string_view(data + begin, end - begin);
+        }
+        // 将映射块转换为普通块
+        void materialize();
+        // 可修改的行存储：必要时先转换映射块；与其他副本共享时先复制
+        std::vector<std::string>& mutableLines();
+    };
+
+    static constexpr size_t NO_DIRTY = static_cast<size_t>(-1);
+
+    // 修改窗口（行号均为修改后的位置）
+    struct ChangeWindow {
+        size_t first = NO_DIRTY; // 最靠前的改动行
+        size_t tail = 0;         // 末尾未改动的行数
+        size_t base_size = 0;    // clear() 时的行数（加上之后惰性追加的行）
+
+        size_t begin(size_t size) const {
+            return std::min(first, end(size));
+        }
+        size_t end(size_t size) const {
+            return size - std::min(tail, size);
+        }
+        size_t replaced(size_t size) const {
+            size_t old_end = base_size - std::min(tail, base_size);
+            return old_end - std::min(begin(size), old_end);
+        }
+        void clear(size_t size) {
+            first = NO_DIRTY;
+            tail = size;
+            base_size = size;
+        }
+        // 修改后 [first, last) 行被改动
+        void touch(size_t touched_first, size_t touched_last, size_t size) {
+            first = std::min(first, touched_first);
+            tail = std::min(tail, size - std::min(touched_last, size));
+        }
+        // 末尾追加了原文件内容（不算改动）
+        void append(size_t count) {
+            tail += count;
+            base_size += count;
+        }
+    };
+
+    // 映射块在 const 访问时也会被转换（逻辑内容不变），因此声明为 mutable
+    mutable std::vector<Chunk> chunks_;
+    std::vector<size_t> fenwick_; // 块行数的 Fenwick 树（1-based）
+    size_t size_ = 0;
+    ChangeWindow dirty_;   // 编辑日志的修改窗口
+    std::array<ChangeWindow, CHANGE_TRACKER_COUNT> changed_; // 按行缓存的修改窗口
+
+    // 记录修改后 [first, last) 行被改动（行号为修改后的位置）
+    void touch(size_t first, size_t last) {
+        dirty_.touch(first, last, size_);
+        for (auto& window : changed_) {
+            window.touch(first, last, size_);
+        }
+    }
+    // 将行号映射为 (块, 块内偏移)；row == size() 时返回末尾位置
+    void locate(size_t row, size_t& chunk, size_t& offset) const;
+    // 返回块的行存储，必要时先转换映射块；非 const 版本还会解除与副本的共享
+    const std::vector<std::string>& ownedLines(size_t chunk) const;
+    std::vector<std::string>& ownedLines(size_t chunk);
+    void fenwickAdd(size_t chunk, long long delta);
+    void rebuildIndex();
+    void assign(std::vector<std::string>&& lines);
+    // 插入后检查块是否需要分裂；返回是否改变了块结构
+    bool splitIfNeeded(size_t chunk);
+    // 删除后清理空块并合并过小的相邻块
+    void compact();
+};
+
+} // namespace core
+} // namespace pnana
+
+#endif // PNANA_CORE_LINE_BUFFER_H
@@ -0,0 +1,42 @@
+#ifndef PNANA_CORE_LINE_COLUMN_INDEX_H
+#define PNANA_CORE_LINE_COLUMN_INDEX_H
+
+#include "utils/unicode_width.h"
+#include <cstddef>
+#include <map>
+#include <string_view>
+
+namespace pnana {
+namespace core {
+
+// 按行缓存的显示列索引
+// 长于 utils::ColumnIndex::CHECKPOINT_BYTES 的行在首次查询时建立稀疏检查点，
+// 之后光标换算和水平滚动的窗口定位只从最近的检查点起扫描；短行直接扫描。
+// 文档修改后由 Document 调用 applyChange()：改动过的行丢弃索引，之后的行随行号平移。
+// 最多缓存 MAX_ROWS 行（略多于一屏），超出时整体清空。
+class LineColumnIndex {
+  public:
+    static constexpr size_t MAX_ROWS = 256;
+
+    // 第 row 行（文本为 line）中 byte 所在字形簇的起始显示列
+    size_t columnAt(size_t row, std::string_view line, size_t byte);
+    // 第 row 行中覆盖第 column 列的字形簇的起始字节
+    size_t byteAt(size_t row, std::string_view line, size_t column);
+
+    // 文档修改：原来从 first 开始的 replaced 行被替换成了现在的 [first, end)
+    void applyChange(size_t first, size_t end, size_t replaced);
+    void clear() {
+        rows_.clear();
+    }
+
+  private:
+    // 长行的索引（必要时新建），短行返回 nullptr
+    utils::ColumnIndex* rowIndex(size_t row, std::string_view line);
+
+    std::map<size_t, utils::ColumnIndex> rows_;
+};
+
+} // namespace core
+} // namespace pnana
+
+#endif // PNANA_CORE_LINE_COLUMN_INDEX_H
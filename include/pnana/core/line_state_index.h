@@ -0,0 +1,63 @@
+#ifndef PNANA_CORE_LINE_STATE_INDEX_H
+#define PNANA_CORE_LINE_STATE_INDEX_H
+
+#include "core/line_buffer.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pnana {
+namespace core {
+
+// 逐行词法状态检查点
+// 记录每行开头的词法状态（如是否处于多行注释/字符串中，每行 1 字节），
+// 任意一行的高亮都从最近的有效检查点继续分词，而不必从文件开头重新开始。
+// 文档修改后由 Document 调用 applyChange()：改动之前的检查点保持有效，
+// 改动之后的检查点随行号平移并保留为"待验证"；重新分词越过改动后，
+// 一旦某行开头的状态与旧值相同即收敛，后面的检查点无需重算，
+// 因此一次按键的重新分词量与受影响的行数成正比，而不是与文件大小成正比。
+class LineStateIndex {
+  public:
+    // 分词一行：由该行开头的状态得到下一行开头的状态
+    using LexFn = std::function<uint8_t(std::string_view line, uint8_t state)>;
+
+    static constexpr uint8_t UNKNOWN = 0xFF;
+
+    // 第 row 行开头的状态；必要时从最近的有效检查点起调用 lex 逐行推进
+    uint8_t entryState(size_t row, const LineBuffer& lines, const LexFn& lex);
+
+    // 调用方已从 entryState(row) 分词完第 row 行（例如渲染时），
+    // 直接记下第 row + 1 行开头的状态，避免重复分词
+    void recordExitState(size_t row, uint8_t state);
+
+    // 文档修改：原来从 first 开始的 replaced 行被替换成了现在的 [first, end)
+    void applyChange(size_t first, size_t end, size_t replaced);
+
+    // 设置分词上下文（文件类型、高亮后端等），与当前不同时清空
+    void setContext(const std::string& context);
+    void clear();
+
+    // 已验证的检查点数（[0, validRows()) 行开头的状态可直接使用）
+    size_t validRows() const {
+        return valid_;
+    }
+
+  private:
+    // 记下第 row 行（row == valid_）开头的状态，与待验证的旧值相同时收敛
+    void store(size_t row, uint8_t state);
+
+    std::string context_;
+    std::vector<uint8_t> states_; // states_[i]：第 i 行开头的状态
+    size_t valid_ = 0;            // [0, valid_) 已验证
+    // 各次修改后第一个待验证检查点的位置（有序）：收敛时最多延伸到下一个边界，
+    // 边界之后的旧值对应的是更早的内容，需要在边界处重新比较
+    std::vector<size_t> barriers_;
+};
+
+} // namespace core
+} // namespace pnana
+
+#endif // PNANA_CORE_LINE_STATE_INDEX_H
@@ -0,0 +1,41 @@
+#ifndef PNANA_CORE_MAPPED_FILE_H
+#define PNANA_CORE_MAPPED_FILE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace pnana {
+namespace core {
+
+// 只读内存映射文件（RAII）
+// 大文件加载时直接在映射上建立行索引，避免整文件读入和逐行拷贝。
+// 映射使用 MAP_PRIVATE，文件在磁盘上被替换（例如保存时 rename）不影响已映射的内容。
+class MappedFile {
+  public:
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 打开并映射文件；失败返回 nullptr，错误信息写入 error
+    static std::shared_ptr<MappedFile> open(const std::string& filepath, std::string* error);
+
+    const char* data() const {
+        return data_;
+    }
+    size_t size() const {
+        return size_;
+    }
+
+  private:
+    MappedFile(const char* data, size_t size) : data_(data), size_(size) {}
+
+    const char* data_;
+    size_t size_;
+};
+
+} // namespace core
+} // namespace pnana
+
+#endif // PNANA_CORE_MAPPED_FILE_H
@@ -0,0 +1,91 @@
+#ifndef PNANA_CORE_SAVE_JOB_H
+#define PNANA_CORE_SAVE_JOB_H
+
+#include "core/line_buffer.h"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace pnana {
+namespace core {
+
+// 保存任务
+// 把 LineBuffer 写入临时文件后原子地重命名为目标文件（nano 风格的安全保存）。
+// 行内容以视图的形式直接交给 writev，映射块和已转换的块都不会再复制一遍；
+// 每批最多 BATCH_BYTES 字节 / IOV_MAX 段，一次系统调用写出数百行。
+// 后台保存时构造函数启动工作线程，调用方传入的是 LineBuffer 的拷贝（写时复制，拷贝只需 O(块数)），
+// 因此主线程在保存期间可以继续编辑。
+class SaveJob {
+  public:
+    static constexpr size_t BATCH_BYTES = 1 << 20;   // 每次 writev 的字节上限
+    static constexpr size_t NOTIFY_BYTES = 32 << 20; // 每写出多少字节通知一次主线程
+
+    using NotifyCallback = std::function<void()>;
+    using ProgressCallback = std::function<void(size_t written)>;
+
+    struct Result {
+        bool success = false;
+        size_t lines = 0; // 写入的行数
+        size_t bytes = 0; // 写入的字节数
+        std::string error;
+    };
+
+    // 在后台保存 lines；notify 在有进度和保存结束时于工作线程调用
+    SaveJob(LineBuffer lines, std::string filepath, std::string line_ending, bool sync,
+            NotifyCallback notify = nullptr);
+    // 等待保存结束（不会中途放弃，以免留下半写的临时文件）
+    ~SaveJob();
+
+    SaveJob(const SaveJob&) = delete;
+    SaveJob& operator=(const SaveJob&) = delete;
+
+    // 同步保存；progress（可选）在每批写出后以累计字节数调用
+    // sync 为 true 时在重命名前 fsync 临时文件，重命名后 fsync 所在目录
+    static Result write(const LineBuffer& lines, const std::string& filepath,
+                        const std::string& line_ending, bool sync,
+                        const ProgressCallback& progress = nullptr);
+    // 写出的总字节数（与 write() 写入的内容一致）
+    static size_t byteSize(const LineBuffer& lines, const std::string& line_ending);
+
+    void wait();
+
+    // 更换通知回调（可在保存过程中调用）
+    void setNotify(NotifyCallback notify);
+
+    bool isFinished() const {
+        return finished_.load();
+    }
+    // 保存进度（0-100）
+    int progress() const;
+    const std::string& filepath() const {
+        return filepath_;
+    }
+    // 保存结果，isFinished() 之后有效
+    const Result& result() const {
+        return result_;
+    }
+
+  private:
+    void run();
+    void notify();
+
+    LineBuffer lines_;
+    std::string filepath_;
+    std::string line_ending_;
+    bool sync_;
+    NotifyCallback notify_;
+    Result result_;
+    std::thread worker_;
+    std::mutex mutex_;
+    std::atomic<size_t> total_{0};
+    std::atomic<size_t> written_{0};
+    std::atomic<bool> finished_{false};
+};
+
+} // namespace core
+} // namespace pnana
+
+#endif // PNANA_CORE_SAVE_JOB_H
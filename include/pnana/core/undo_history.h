@@ -0,0 +1,126 @@
+#ifndef PNANA_CORE_UNDO_HISTORY_H
+#define PNANA_CORE_UNDO_HISTORY_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+namespace pnana {
+namespace core {
+
+// 文档修改记录（用于撤销/重做）
+struct DocumentChange {
+    enum class Type { INSERT, DELETE, REPLACE, NEWLINE, COMPLETION };
+
+    Type type;
+    size_t row;
+    size_t col;
+    std::string old_content;
+    std::string new_content;
+    std::string after_cursor;                        // 用于 NEWLINE 类型：光标后的内容
+    std::chrono::steady_clock::time_point timestamp; // 时间戳，用于智能合并
+    uint64_t version_before = 0;                     // 修改前的内容版本号（撤销时恢复）
+    uint64_t version_after = 0;                      // 修改后的内容版本号（重做时恢复）
+
+    DocumentChange(Type t, size_t r, size_t c, const std::string& old_c, const std::string& new_c)
+        : type(t), row(r), col(c), old_content(old_c), new_content(new_c), after_cursor(""),
+          timestamp(std::chrono::steady_clock::now()) {}
+
+    // NEWLINE 类型的构造函数
+    DocumentChange(Type t, size_t r, size_t c, const std::string& old_c, const std::string& new_c,
+                   const std::string& after)
+        : type(t), row(r), col(c), old_content(old_c), new_content(new_c), after_cursor(after),
+          timestamp(std::chrono::steady_clock::now()) {}
+
+    // COMPLETION 类型的构造函数（添加布尔参数以避免重载冲突）
+    DocumentChange(Type t, size_t r, size_t c, const std::string& replaced_text,
+                   const std::string& completion_text, bool /*is_completion*/)
+        : type(t), row(r), col(c), old_content(replaced_text), new_content(completion_text),
+          after_cursor(""), timestamp(std::chrono::steady_clock::now()) {}
+
+    // 带时间戳的构造函数（用于合并操作）
+    DocumentChange(Type t, size_t r, size_t c, const std::string& old_c, const std::string& new_c,
+                   const std::chrono::steady_clock::time_point& ts)
+        : type(t), row(r), col(c), old_content(old_c), new_content(new_c), after_cursor(""),
+          timestamp(ts) {}
+};
+
+// 按字节预算管理的紧凑修改历史（撤销栈/重做栈各一个实例）
+// - 所有记录的文本负载顺序存放在同一块 arena 中，每条记录只保留定长的元数据
+// - old_content 以 new_content + after_cursor 为基准做差分编码，只存公共前后缀之外的部分
+//   （整行替换、换行等记录因此只占一份文本）
+// - 超出字节预算时从最旧的记录开始淘汰，而不是按条数截断；最新一条总会保留
+class UndoHistory {
+  public:
+    static constexpr size_t DEFAULT_BYTE_BUDGET = 64 << 20;
+
+    explicit UndoHistory(size_t byte_budget = DEFAULT_BYTE_BUDGET);
+
+    bool empty() const {
+        return records_.empty();
+    }
+    size_t size() const {
+        return records_.size();
+    }
+    // 当前占用的字节数（元数据 + 文本负载）
+    size_t memoryUsage() const {
+        return live_bytes_;
+    }
+    size_t byteBudget() const {
+        return byte_budget_;
+    }
+    // 修改预算后立即按新预算淘汰
+    void setByteBudget(size_t bytes);
+
+    void push(const DocumentChange& change);
+    // 解码最新一条记录
+    DocumentChange back() const;
+    // 替换最新一条记录（用于合并连续输入）
+    void replaceBack(const DocumentChange& change);
+    void popBack();
+    void clear();
+    // 最新一条记录的修改后版本号（无需解码负载）
+    uint64_t backVersionAfter() const {
+        return records_.back().version_after;
+    }
+    void setBackVersionAfter(uint64_t version) {
+        records_.back().version_after = version;
+    }
+
+  private:
+    struct Record {
+        DocumentChange::Type type;
+        size_t row;
+        size_t col;
+        std::chrono::steady_clock::time_point timestamp;
+        uint64_t version_before;
+        uint64_t version_after;
+        size_t offset;     // 负载在 arena 中的逻辑偏移：after_cursor | new_content | old 差分部分
+        size_t after_len;
+        size_t new_len;
+        size_t old_mid_len;
+        size_t old_prefix; // old_content 与基准文本的公共前缀长度
+        size_t old_suffix; // old_content 与基准文本的公共后缀长度
+
+        size_t payloadSize() const {
+            return after_len + new_len + old_mid_len;
+        }
+    };
+
+    std::deque<Record> records_;
+    std::string arena_;
+    size_t arena_base_ = 0; // arena_[0] 对应的逻辑偏移（淘汰的前缀被截掉后增加）
+    size_t live_bytes_ = 0;
+    size_t byte_budget_;
+
+    void append(const DocumentChange& change);
+    void evictToBudget();
+    void compactArena();
+};
+
+} // namespace core
+} // namespace pnana
+
+#endif // PNANA_CORE_UNDO_HISTORY_H
@@ -0,0 +1,107 @@
+#ifndef PNANA_FEATURES_SYNTAX_HIGHLIGHTER_BACKGROUND_HIGHLIGHTER_H
+#define PNANA_FEATURES_SYNTAX_HIGHLIGHTER_BACKGROUND_HIGHLIGHTER_H
+
+#include "core/line_state_index.h"
+#include "features/SyntaxHighlighter/syntax_highlighter.h"
+#include "ui/theme.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace pnana {
+namespace core {
+class Document;
+} // namespace core
+
+namespace features {
+
+// 后台线程为一行生成的语法高亮结果
+struct LineStyles {
+    SyntaxHighlighter::TokenRuns runs; // 覆盖整行的语法区间
+    uint8_t entry_state = 0;           // 行开头的多行状态
+    uint8_t exit_state = 0;            // 下一行开头的多行状态
+};
+
+// 后台语法高亮
+// 原生分词器的逐行分词放在独立的工作线程中：界面线程每帧用 update() 提交文档快照和可见范围，
+// 工作线程先分词可见行，再向下预读 LOOK_AHEAD_ROWS 行、向上 LOOK_BEHIND_ROWS 行，
+// 结果逐行发布到该版本的分页槽位数组（原子指针）中，界面线程读取无需加锁。
+// 渲染时 lineStyles() 返回 nullptr 的行先按普通文本显示，可见行的结果到达后由 notify 请求重绘，
+// 因此翻页或跳转到大文件末尾都不会在界面线程上等待分词。
+// 修改文档后，新版本的结果到达之前，未改动的行沿用上一版本的结果（按修改窗口换算行号）；
+// 工作线程按文档保留逐行词法状态检查点，并复用上一版本中开头状态相同的行，
+// 一次按键只重新分词受影响的行。
+class BackgroundHighlighter {
+  public:
+    static constexpr size_t LOOK_AHEAD_ROWS = 2000;
+    static constexpr size_t LOOK_BEHIND_ROWS = 500;
+
+    // notify 在工作线程中调用，用于请求重绘（如 ScreenInteractive::PostEvent）
+    explicit BackgroundHighlighter(std::function<void()> notify);
+    ~BackgroundHighlighter();
+
+    BackgroundHighlighter(const BackgroundHighlighter&) = delete;
+    BackgroundHighlighter& operator=(const BackgroundHighlighter&) = delete;
+
+    // 界面线程每帧渲染前调用：doc 的 [first_row, last_row) 行即将以 file_type 高亮显示
+    void update(core::Document& doc, const std::string& file_type, size_t first_row,
+                size_t last_row);
+
+    // 第 row 行的结果（界面线程调用，不加锁）；尚未生成时返回 nullptr。
+    // 返回值在下一次 update() 之前有效
+    const LineStyles* lineStyles(core::Document& doc, size_t row) const;
+
+    // 结果纪元：任何一行的 lineStyles() 可能变化时（发布新结果、提交新版本）递增，
+    // 界面线程据此判断按行缓存的样式区间是否仍然有效
+    uint64_t epoch() const {
+        return epoch_.load(std::memory_order_acquire);
+    }
+
+  private:
+    struct Generation;
+    struct DocumentState;
+
+    struct Job {
+        std::shared_ptr<DocumentState> state;
+        std::shared_ptr<Generation> generation;
+        size_t first_row = 0;
+        size_t last_row = 0;
+    };
+
+    // newer 处理完后 older 不再需要：同一文档，且 older 是旧版本或其可见行在 newer 的处理范围内
+    // （同一文档在分屏中显示的多个不相邻位置各自保留任务）
+    static bool covers(const Job& newer, const Job& older);
+    void submit(Job job);
+    void run();
+    void process(const Job& job);
+    // 分词第 row 行并发布（已有结果时跳过），返回是否新发布
+    bool styleRow(DocumentState& state, Generation& generation, size_t row);
+    // 有新的任务时让出并返回 true：新任务覆盖 job 时丢弃 job，否则 job 排到队尾稍后继续
+    bool yield(const Job& job);
+
+    std::function<void()> notify_;
+    std::atomic<uint64_t> epoch_{0};
+
+    // 以下只在工作线程中使用：分词结果只含语法类型，主题不影响
+    ui::Theme theme_;
+    SyntaxHighlighter highlighter_;
+    core::LineStateIndex::LexFn lex_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Job> jobs_;
+    bool stop_ = false;
+    std::thread worker_;
+};
+
+} // namespace features
+} // namespace pnana
+
+#endif // PNANA_FEATURES_SYNTAX_HIGHLIGHTER_BACKGROUND_HIGHLIGHTER_H
@@ -0,0 +1,91 @@
+#ifndef PNANA_FEATURES_SYNTAX_HIGHLIGHTER_HIGHLIGHT_QUERY_H
+#define PNANA_FEATURES_SYNTAX_HIGHLIGHTER_HIGHLIGHT_QUERY_H
+
+#include "core/line_buffer.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <tree_sitter/api.h>
+
+namespace pnana {
+namespace features {
+
+// 高亮样式编号：加载查询时由 capture 名称解析得到，渲染时再按当前主题取颜色
+enum class HighlightStyle : uint8_t {
+    NONE = 0, // 不着色（前景色）
+    KEYWORD,
+    STRING,
+    COMMENT,
+    NUMBER,
+    FUNCTION,
+    TYPE,
+    OPERATOR,
+    PREPROCESSOR
+};
+
+// Tree-sitter 高亮查询（语法仓库自带的 queries/highlights.scm）
+// 加载时编译查询，并把每个 capture 名称（@keyword、@string.escape 等）解析为 HighlightStyle；
+// 执行时用 ts_query_cursor_set_byte_range 限定字节范围，只访问与可见区域相交的节点。
+// 谓词支持 #eq? / #not-eq? / #match? / #not-match? / #any-of?，其余谓词忽略。
+class HighlightQuery {
+  public:
+    ~HighlightQuery();
+
+    HighlightQuery(const HighlightQuery&) = delete;
+    HighlightQuery& operator=(const HighlightQuery&) = delete;
+
+    // 在 searchPaths() 中查找 <language_name>/highlights.scm 并编译；
+    // 找不到或编译失败时返回 nullptr（调用方退回按节点类型着色）
+    static std::unique_ptr<HighlightQuery> load(const TSLanguage* language,
+                                                const std::string& language_name);
+
+    // 编译查询源码，origin 仅用于日志
+    static std::unique_ptr<HighlightQuery> compile(const TSLanguage* language,
+                                                   const std::string& source,
+                                                   const std::string& origin);
+
+    // 查询文件的搜索目录（按优先级）：~/.config/pnana/queries、
+    // /usr/local/share/pnana/queries、/usr/share/pnana/queries
+    static std::vector<std::string> searchPaths();
+
+    // capture 名称对应的样式（按点分隔的前缀匹配，如 keyword.return -> KEYWORD）
+    static HighlightStyle styleForCapture(const std::string& name);
+
+    // 对 root 之下与 [start_byte, end_byte) 相交的节点执行查询，按文档顺序给出带样式的 capture；
+    // 同一节点被多个模式捕获时只给出第一个（文件中靠前的模式优先），内层节点在外层之后给出。
+    // lines 用于取出谓词需要比较的节点文本
+    using CaptureFn = std::function<void(TSNode node, HighlightStyle style)>;
+    void run(TSNode root, uint32_t start_byte, uint32_t end_byte, const core::LineBuffer& lines,
+             const CaptureFn& fn);
+
+  private:
+    HighlightQuery() = default;
+
+    struct Predicate {
+        enum Kind { EQ, MATCH, ANY_OF };
+        Kind kind = EQ;
+        bool negate = false;
+        uint32_t capture = 0;
+        int64_t other_capture = -1;      // #eq? 比较两个 capture 时的第二个
+        std::vector<std::string> values; // 字面量参数
+        std::regex regex;                // #match? 的正则（加载时编译）
+    };
+
+    // 解析 pattern 的谓词，不支持或无法编译时返回 false
+    bool parsePredicates(uint32_t pattern);
+    bool matchPredicates(const TSQueryMatch& match, const core::LineBuffer& lines) const;
+
+    TSQuery* query_ = nullptr;
+    TSQueryCursor* cursor_ = nullptr;
+    std::vector<HighlightStyle> capture_styles_;      // capture 编号 -> 样式
+    std::vector<std::vector<Predicate>> predicates_; // pattern 编号 -> 谓词
+};
+
+} // namespace features
+} // namespace pnana
+
+#endif // PNANA_FEATURES_SYNTAX_HIGHLIGHTER_HIGHLIGHT_QUERY_H
@@ -0,0 +1,582 @@
+#ifndef PNANA_FEATURES_SYNTAX_HIGHLIGHTER_LANGUAGE_SPECS_H
+#define PNANA_FEATURES_SYNTAX_HIGHLIGHTER_LANGUAGE_SPECS_H
+
+#include <cstdint>
+
+namespace pnana {
+namespace features {
+
+// 声明式的语言定义：只描述注释、字符串、标识符、变量前缀等词法规则，
+// TableLexer 在编译期据此生成每种语言的字符分类表。新增语言只需在 LANGUAGE_SPECS 中加一项，
+// 关键字和类型仍放在 SyntaxHighlighter::initializeLanguages() 中，按 word_set 查找。
+// 各字段以链式调用设置，如 LanguageSpec("lua", "lua").lineComment("--").strings("\"'")
+struct LanguageSpec {
+    enum Flags : uint8_t {
+        FUNCTION_CALLS = 1 << 0,    // 紧跟 '(' 的标识符按函数着色
+        CAPITALIZED_TYPES = 1 << 1, // 大写字母开头的标识符按类型着色（构造器、模块、变量等）
+        UPPER_CASE_WORDS = 1 << 2,  // 关键字表为大写，比较前先转为大写（SQL）
+        LOWER_CASE_WORDS = 1 << 3,  // 关键字表为小写，比较前先转为小写（Fortran）
+        DOUBLED_QUOTES = 1 << 4,    // 字符串中连续两个引号表示引号本身
+        SYMBOLS_AS_OPERATORS = 1 << 5 // 其余字符（含非 ASCII 字符）也按运算符着色
+    };
+
+    static constexpr int MAX_LINE_COMMENTS = 3;
+    static constexpr int MAX_SIGILS = 8;
+
+    const char* names;                                 // 文件类型，以空格分隔
+    const char* word_set;                              // 关键字/类型表的语言名，空表示没有
+    const char* line_comments[MAX_LINE_COMMENTS] = {}; // 到行尾的注释
+    const char* line_start_comments = "";              // 行首为其中任一字符时整行为注释
+    const char* block_comment_open = nullptr;          // 可跨行的块注释
+    const char* block_comment_close = nullptr;
+    const char* quotes = "";          // 单行字符串的引号
+    char escape = '\\';               // 字符串中的转义字符，0 表示没有
+    char char_quote = 0;              // 只含一个字符的字符字面量（如 Haskell 的 'a'）
+    const char* string_prefixes = ""; // 紧接引号时算作字符串的前缀（如 SML 的 #"c"）
+    const char* block_string_open = nullptr; // 可跨行的块字符串
+    const char* block_string_close = nullptr;
+    const char* sigils[MAX_SIGILS] = {}; // 变量前缀，后跟标识符时按类型着色；以 '{' 结尾时取到 '}'
+    const char* ident_start = "";        // 字母、'_' 之外可以开始标识符的字符
+    const char* ident_part = "";         // 字母、数字、'_' 之外可以出现在标识符中的字符
+    const char* operator_chars = "+-*/%=<>!&|^~?:()[]{},;.";
+    const char* exponent_chars = "eE"; // 数字的指数标记
+    uint8_t flags = 0;
+
+    constexpr explicit LanguageSpec(const char* file_types, const char* words = "")
+        : names(file_types), word_set(words) {}
+
+    constexpr LanguageSpec lineComment(const char* prefix) const {
+        LanguageSpec spec = *this;
+        for (auto& slot : spec.line_comments) {
+            if (!slot) {
+                slot = prefix;
+                return spec;
+            }
+        }
+        throw "too many line comments";
+    }
+    constexpr LanguageSpec lineStartComment(const char* chars) const {
+        LanguageSpec spec = *this;
+        spec.line_start_comments = chars;
+        return spec;
+    }
+    constexpr LanguageSpec blockComment(const char* open, const char* close) const {
+        LanguageSpec spec = *this;
+        spec.block_comment_open = open;
+        spec.block_comment_close = close;
+        return spec;
+    }
+    constexpr LanguageSpec strings(const char* quote_chars, char escape_char = '\\') const {
+        LanguageSpec spec = *this;
+        spec.quotes = quote_chars;
+        spec.escape = escape_char;
+        return spec;
+    }
+    constexpr LanguageSpec charLiteral(char quote) const {
+        LanguageSpec spec = *this;
+        spec.char_quote = quote;
+        return spec;
+    }
+    constexpr LanguageSpec stringPrefixes(const char* chars) const {
+        LanguageSpec spec = *this;
+        spec.string_prefixes = chars;
+        return spec;
+    }
+    constexpr LanguageSpec blockString(const char* open, const char* close) const {
+        LanguageSpec spec = *this;
+        spec.block_string_open = open;
+        spec.block_string_close = close;
+        return spec;
+    }
+    constexpr LanguageSpec sigil(const char* prefix) const {
+        LanguageSpec spec = *this;
+        for (auto& slot : spec.sigils) {
+            if (!slot) {
+                slot = prefix;
+                return spec;
+            }
+        }
+        throw "too many sigils";
+    }
+    constexpr LanguageSpec identifier(const char* start_chars, const char* part_chars) const {
+        LanguageSpec spec = *this;
+        spec.ident_start = start_chars;
+        spec.ident_part = part_chars;
+        return spec;
+    }
+    constexpr LanguageSpec operators(const char* chars) const {
+        LanguageSpec spec = *this;
+        spec.operator_chars = chars;
+        return spec;
+    }
+    constexpr LanguageSpec exponents(const char* chars) const {
+        LanguageSpec spec = *this;
+        spec.exponent_chars = chars;
+        return spec;
+    }
+    constexpr LanguageSpec with(uint8_t flag) const {
+        LanguageSpec spec = *this;
+        spec.flags = static_cast<uint8_t>(spec.flags | flag);
+        return spec;
+    }
+};
+
+// clang-format off
+inline constexpr LanguageSpec LANGUAGE_SPECS[] = {
+    // Shell / 脚本
+    LanguageSpec("shell", "shell")
+        .lineComment("#")
+        .strings("\"'")
+        .sigil("${").sigil("$")
+        .identifier("", "-")
+        .with(LanguageSpec::SYMBOLS_AS_OPERATORS),
+    LanguageSpec("powershell ps1", "powershell")
+        .blockComment("<#", "#>")
+        .lineComment("#")
+        .strings("\"'", '`')
+        .sigil("$")
+        .identifier("", "-")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("perl pl pm", "perl")
+        .lineComment("#")
+        .strings("\"'")
+        .sigil("$").sigil("@").sigil("%")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("ruby rb", "ruby")
+        .blockComment("=begin", "=end")
+        .lineComment("#")
+        .strings("\"'")
+        .sigil("@@").sigil("@").sigil("$").sigil(":")
+        .identifier("", "?")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("crystal")
+        .lineComment("#")
+        .strings("\"'")
+        .sigil("@@").sigil("@").sigil(":")
+        .identifier("", "?!")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("tcl", "tcl")
+        .lineComment("#")
+        .strings("\"")
+        .sigil("${").sigil("$")
+        .identifier(":", ":")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("vim vimrc", "vim")
+        .lineComment("\"")
+        .strings("'")
+        .sigil("g:").sigil("b:").sigil("w:").sigil("t:")
+        .sigil("s:").sigil("l:").sigil("a:").sigil("v:")
+        .with(LanguageSpec::SYMBOLS_AS_OPERATORS),
+    LanguageSpec("lua", "lua")
+        .blockComment("--[[", "]]")
+        .lineComment("--")
+        .strings("\"'")
+        .blockString("[[", "]]")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("nelua")
+        .blockComment("--[[", "]]")
+        .lineComment("--")
+        .strings("\"'")
+        .blockString("[[", "]]")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("moonscript")
+        .lineComment("--")
+        .strings("\"'")
+        .blockString("[[", "]]")
+        .sigil("@")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("r R", "r")
+        .lineComment("#")
+        .strings("\"'")
+        .identifier(".", ".")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("julia")
+        .blockComment("#=", "=#")
+        .lineComment("#")
+        .strings("\"")
+        .charLiteral('\'')
+        .blockString("\"\"\"", "\"\"\"")
+        .identifier("", "!")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("elixir")
+        .lineComment("#")
+        .strings("\"'")
+        .blockString("\"\"\"", "\"\"\"")
+        .sigil(":").sigil("@")
+        .identifier("", "?!")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("erlang")
+        .lineComment("%")
+        .strings("\"'")
+        .with(LanguageSpec::FUNCTION_CALLS | LanguageSpec::CAPITALIZED_TYPES),
+    LanguageSpec("nim", "nim")
+        .blockComment("#[", "]#")
+        .lineComment("#")
+        .strings("\"'")
+        .blockString("\"\"\"", "\"\"\"")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("coffeescript")
+        .blockComment("###", "###")
+        .lineComment("#")
+        .strings("\"'`")
+        .blockString("\"\"\"", "\"\"\"")
+        .sigil("@")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("vyper")
+        .lineComment("#")
+        .strings("\"'")
+        .blockString("\"\"\"", "\"\"\"")
+        .sigil("@")
+        .with(LanguageSpec::FUNCTION_CALLS),
+
+    // 构建与配置
+    LanguageSpec("cmake", "cmake")
+        .blockComment("#[[", "]]")
+        .lineComment("#")
+        .strings("\"'")
+        .blockString("[[", "]]")
+        .sigil("${").sigil("$ENV{")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("meson", "meson")
+        .lineComment("#")
+        .blockString("'''", "'''")
+        .strings("\"'")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("toml", "toml")
+        .lineComment("#")
+        .blockString("\"\"\"", "\"\"\"")
+        .strings("\"'")
+        .identifier("", "-"),
+    LanguageSpec("sql", "sql")
+        .lineComment("--")
+        .blockComment("/*", "*/")
+        .strings("\"'")
+        .identifier("@", "$")
+        .with(LanguageSpec::DOUBLED_QUOTES | LanguageSpec::UPPER_CASE_WORDS |
+              LanguageSpec::SYMBOLS_AS_OPERATORS),
+
+    // C 风格注释的语言
+    LanguageSpec("swift", "swift")
+        .lineComment("//")
+        .blockComment("/*", "*/")
+        .blockString("\"\"\"", "\"\"\"")
+        .strings("\"'")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("kotlin kt", "kotlin")
+        .lineComment("//")
+        .blockComment("/*", "*/")
+        .blockString("\"\"\"", "\"\"\"")
+        .strings("\"'")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("scala", "scala")
+        .lineComment("//")
+        .blockComment("/*", "*/")
+        .blockString("\"\"\"", "\"\"\"")
+        .strings("\"'")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("groovy")
+        .lineComment("//")
+        .blockComment("/*", "*/")
+        .blockString("\"\"\"", "\"\"\"")
+        .strings("\"'")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("dart")
+        .lineComment("//")
+        .blockComment("/*", "*/")
+        .blockString("\"\"\"", "\"\"\"")
+        .strings("\"'")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("csharp")
+        .lineComment("//")
+        .blockComment("/*", "*/")
+        .strings("\"'")
+        .stringPrefixes("@$")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("zig")
+        .lineComment("//")
+        .strings("\"'")
+        .identifier("@", "")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("dlang")
+        .lineComment("//")
+        .blockComment("/*", "*/")
+        .strings("\"'`")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("vlang")
+        .lineComment("//")
+        .blockComment("/*", "*/")
+        .strings("\"'`")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("odin")
+        .lineComment("//")
+        .blockComment("/*", "*/")
+        .strings("\"'`")
+        .sigil("#").sigil("@")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("jai")
+        .lineComment("//")
+        .blockComment("/*", "*/")
+        .strings("\"")
+        .sigil("#")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("carbon")
+        .lineComment("//")
+        .blockString("'''", "'''")
+        .strings("\"'")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("vala")
+        .lineComment("//")
+        .blockComment("/*", "*/")
+        .blockString("\"\"\"", "\"\"\"")
+        .strings("\"'")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("genie")
+        .lineComment("//")
+        .blockComment("/*", "*/")
+        .strings("\"'")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("pony")
+        .lineComment("//")
+        .blockComment("/*", "*/")
+        .blockString("\"\"\"", "\"\"\"")
+        .strings("\"'")
+        .with(LanguageSpec::FUNCTION_CALLS | LanguageSpec::CAPITALIZED_TYPES),
+    LanguageSpec("solidity")
+        .lineComment("//")
+        .blockComment("/*", "*/")
+        .strings("\"'")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("cadence")
+        .lineComment("//")
+        .blockComment("/*", "*/")
+        .strings("\"")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("ballerina")
+        .lineComment("//")
+        .strings("\"`")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("dafny")
+        .lineComment("//")
+        .blockComment("/*", "*/")
+        .strings("\"'")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("alloy")
+        .lineComment("//").lineComment("--")
+        .blockComment("/*", "*/")
+        .strings("\""),
+    LanguageSpec("wren")
+        .lineComment("//")
+        .blockComment("/*", "*/")
+        .strings("\"")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("fantom")
+        .lineComment("//").lineComment("**")
+        .blockComment("/*", "*/")
+        .strings("\"'`")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("verilog")
+        .lineComment("//")
+        .blockComment("/*", "*/")
+        .strings("\"")
+        .sigil("$").sigil("`"),
+    LanguageSpec("graphql")
+        .lineComment("#")
+        .blockString("\"\"\"", "\"\"\"")
+        .strings("\"")
+        .sigil("$").sigil("@"),
+
+    // 样式表与模板
+    LanguageSpec("less")
+        .lineComment("//")
+        .blockComment("/*", "*/")
+        .strings("\"'")
+        .sigil("@")
+        .identifier("", "-"),
+    LanguageSpec("stylus")
+        .lineComment("//")
+        .blockComment("/*", "*/")
+        .strings("\"'")
+        .identifier("", "-"),
+    LanguageSpec("postcss")
+        .blockComment("/*", "*/")
+        .strings("\"'")
+        .sigil("$").sigil("@")
+        .identifier("", "-"),
+    LanguageSpec("pug")
+        .lineComment("//")
+        .strings("\"'`")
+        .identifier("", "-"),
+    LanguageSpec("vue")
+        .lineComment("//")
+        .blockComment("<!--", "-->")
+        .strings("\"'`")
+        .identifier("", "-")
+        .with(LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("svelte")
+        .lineComment("//")
+        .blockComment("<!--", "-->")
+        .strings("\"'`")
+        .identifier("", "-")
+        .with(LanguageSpec::FUNCTION_CALLS),
+
+    // 函数式语言
+    LanguageSpec("haskell", "haskell")
+        .lineComment("--")
+        .blockComment("{-", "-}")
+        .strings("\"")
+        .charLiteral('\'')
+        .identifier("", "'")
+        .with(LanguageSpec::FUNCTION_CALLS | LanguageSpec::CAPITALIZED_TYPES),
+    LanguageSpec("purescript")
+        .lineComment("--")
+        .blockComment("{-", "-}")
+        .strings("\"")
+        .charLiteral('\'')
+        .identifier("", "'")
+        .with(LanguageSpec::CAPITALIZED_TYPES),
+    LanguageSpec("idris")
+        .lineComment("--")
+        .blockComment("{-", "-}")
+        .strings("\"")
+        .charLiteral('\'')
+        .identifier("", "'")
+        .with(LanguageSpec::CAPITALIZED_TYPES),
+    LanguageSpec("agda")
+        .lineComment("--")
+        .blockComment("{-", "-}")
+        .strings("\"")
+        .charLiteral('\'')
+        .identifier("", "'"),
+    LanguageSpec("lean")
+        .lineComment("--")
+        .blockComment("/-", "-/")
+        .strings("\"")
+        .charLiteral('\'')
+        .identifier("", "'!?"),
+    LanguageSpec("sml", "sml")
+        .blockComment("(*", "*)")
+        .strings("\"")
+        .stringPrefixes("#")
+        .identifier("'", "'")
+        .with(LanguageSpec::CAPITALIZED_TYPES | LanguageSpec::SYMBOLS_AS_OPERATORS),
+    LanguageSpec("ocaml")
+        .blockComment("(*", "*)")
+        .strings("\"")
+        .charLiteral('\'')
+        .identifier("'", "'")
+        .with(LanguageSpec::CAPITALIZED_TYPES),
+    LanguageSpec("coq")
+        .blockComment("(*", "*)")
+        .strings("\"")
+        .identifier("", "'"),
+    LanguageSpec("fsharp")
+        .lineComment("//")
+        .blockComment("(*", "*)")
+        .blockString("\"\"\"", "\"\"\"")
+        .strings("\"")
+        .charLiteral('\'')
+        .identifier("'", "'")
+        .with(LanguageSpec::CAPITALIZED_TYPES),
+    LanguageSpec("reason")
+        .lineComment("//")
+        .blockComment("/*", "*/")
+        .strings("\"")
+        .charLiteral('\'')
+        .identifier("'", "'")
+        .with(LanguageSpec::FUNCTION_CALLS | LanguageSpec::CAPITALIZED_TYPES),
+
+    // Lisp 家族（Common Lisp / Scheme 使用专门的分词器）
+    LanguageSpec("clojure")
+        .lineComment(";")
+        .strings("\"")
+        .sigil(":")
+        .identifier("", "-?!*"),
+    LanguageSpec("racket")
+        .blockComment("#|", "|#")
+        .lineComment(";")
+        .strings("\"")
+        .identifier("", "-?!*"),
+    LanguageSpec("emacslisp")
+        .lineComment(";")
+        .strings("\"")
+        .identifier("", "-?!*"),
+    LanguageSpec("clarity")
+        .lineComment(";;")
+        .strings("\"")
+        .identifier("", "-?!"),
+
+    // 逻辑编程
+    LanguageSpec("prolog")
+        .lineComment("%")
+        .blockComment("/*", "*/")
+        .strings("\"'")
+        .with(LanguageSpec::CAPITALIZED_TYPES),
+    LanguageSpec("mercury")
+        .lineComment("%")
+        .blockComment("/*", "*/")
+        .strings("\"'")
+        .with(LanguageSpec::CAPITALIZED_TYPES),
+
+    // 科学计算与数组语言
+    LanguageSpec("fortran", "fortran")
+        .lineStartComment("Cc*!")
+        .lineComment("!")
+        .strings("\"'", 0)
+        .exponents("eEdD")
+        .with(LanguageSpec::DOUBLED_QUOTES | LanguageSpec::LOWER_CASE_WORDS |
+              LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("matlab")
+        .blockComment("%{", "%}")
+        .lineComment("%")
+        .strings("\"'", 0)
+        .with(LanguageSpec::DOUBLED_QUOTES | LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("octave")
+        .blockComment("%{", "%}")
+        .lineComment("%").lineComment("#")
+        .strings("\"'")
+        .with(LanguageSpec::DOUBLED_QUOTES | LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("apl")
+        .lineComment("\xE2\x8D\x9D") // ⍝
+        .strings("'", 0)
+        .with(LanguageSpec::DOUBLED_QUOTES | LanguageSpec::SYMBOLS_AS_OPERATORS),
+    LanguageSpec("jlang")
+        .lineComment("NB.")
+        .strings("'", 0)
+        .with(LanguageSpec::DOUBLED_QUOTES | LanguageSpec::SYMBOLS_AS_OPERATORS),
+    LanguageSpec("klang")
+        .lineStartComment("/")
+        .strings("\"")
+        .with(LanguageSpec::SYMBOLS_AS_OPERATORS),
+    LanguageSpec("qlang")
+        .lineStartComment("/")
+        .strings("\"")
+        .with(LanguageSpec::SYMBOLS_AS_OPERATORS),
+
+    // 其他
+    LanguageSpec("smalltalk")
+        .blockComment("\"", "\"")
+        .strings("'", 0)
+        .sigil("#")
+        .with(LanguageSpec::DOUBLED_QUOTES | LanguageSpec::CAPITALIZED_TYPES),
+    LanguageSpec("vb")
+        .lineComment("'")
+        .strings("\"", 0)
+        .with(LanguageSpec::DOUBLED_QUOTES | LanguageSpec::FUNCTION_CALLS),
+    LanguageSpec("vhdl")
+        .lineComment("--")
+        .blockComment("/*", "*/")
+        .strings("\"")
+        .charLiteral('\''),
+    LanguageSpec("webassembly")
+        .lineComment(";;")
+        .blockComment("(;", ";)")
+        .strings("\"")
+        .sigil("$")
+        .identifier("", "."),
+};
+// clang-format on
+
+} // namespace features
+} // namespace pnana
+
+#endif // PNANA_FEATURES_SYNTAX_HIGHLIGHTER_LANGUAGE_SPECS_H
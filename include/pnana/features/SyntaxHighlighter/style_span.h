@@ -0,0 +1,29 @@
+#ifndef PNANA_FEATURES_SYNTAX_HIGHLIGHTER_STYLE_SPAN_H
+#define PNANA_FEATURES_SYNTAX_HIGHLIGHTER_STYLE_SPAN_H
+
+#include <cstddef>
+#include <ftxui/screen/color.hpp>
+#include <vector>
+
+namespace pnana {
+namespace features {
+
+// 样式区间：行内 [start, end) 字节使用同一前景色
+struct StyleSpan {
+    size_t start;
+    size_t end;
+    ftxui::Color color;
+};
+using StyleSpans = std::vector<StyleSpan>;
+
+inline bool operator==(const StyleSpan& a, const StyleSpan& b) {
+    return a.start == b.start && a.end == b.end && a.color == b.color;
+}
+inline bool operator!=(const StyleSpan& a, const StyleSpan& b) {
+    return !(a == b);
+}
+
+} // namespace features
+} // namespace pnana
+
+#endif // PNANA_FEATURES_SYNTAX_HIGHLIGHTER_STYLE_SPAN_H
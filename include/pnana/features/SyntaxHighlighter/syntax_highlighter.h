@@ -1,12 +1,16 @@
 #ifndef PNANA_FEATURES_SYNTAX_HIGHLIGHTER_SYNTAX_HIGHLIGHTER_H
 #define PNANA_FEATURES_SYNTAX_HIGHLIGHTER_SYNTAX_HIGHLIGHTER_H
 
+#include "features/SyntaxHighlighter/style_span.h"
+#include "features/SyntaxHighlighter/word_set.h"
 #include "ui/theme.h"
+#include <cstdint>
 #include <ftxui/dom/elements.hpp>
 #include <map>
 #include <memory>
 #include <regex>
 #include <string>
+#include <string_view>
 #include <vector>
 
 // 条件包含 Tree-sitter 头文件（如果启用）
@@ -22,8 +26,14 @@ class SyntaxHighlighterTreeSitter;
 #endif
 
 namespace pnana {
+namespace core {
+class Document;
+} // namespace core
+
 namespace features {
 
+class TableLexer;
+
 // 语法高亮后端类型
 enum class SyntaxHighlightBackend {
     NATIVE,     // 使用原有的分词器实现
@@ -66,9 +76,59 @@ class SyntaxHighlighter {
     // 重置多行状态（切换文件时调用）
     void resetMultiLineState();
 
+    // 当前文件类型
+    const std::string& getFileType() const {
+        return current_file_type_;
+    }
+
+    // 多行状态（跨行的注释/字符串）打包为一个字节，供行渲染缓存保存和恢复
+    uint8_t getMultiLineState() const {
+        return static_cast<uint8_t>((in_multiline_comment_ ? 1 : 0) |
+                                    (in_multiline_string_ ? 2 : 0));
+    }
+    void setMultiLineState(uint8_t state) {
+        in_multiline_comment_ = (state & 1) != 0;
+        in_multiline_string_ = (state & 2) != 0;
+    }
+
+    // 当前文件类型的高亮是否依赖多行状态（原生 C/C++ 分词器，以及声明了块注释或块字符串的语言）
+    bool hasMultiLineState() const;
+
+    // 从 state 开始分词一行（不生成元素），返回下一行开头的多行状态
+    uint8_t lexLine(const std::string& line, uint8_t state);
+
+    // 首尾相接、覆盖整行的语法区间（只含类型不含颜色，不依赖主题，可在后台线程生成）
+    struct TokenRun {
+        size_t start;
+        size_t end;
+        TokenType type;
+    };
+    using TokenRuns = std::vector<TokenRun>;
+
+    // 用原生分词器从 state 开始把一行分为 runs，返回下一行开头的多行状态
+    uint8_t tokenizeRuns(const std::string& line, uint8_t state, TokenRuns& runs);
+
+    // 按当前主题把语法区间转换为样式区间（相邻同色合并）；
+    // 只转换与 [begin, end) 字节相交的部分，超长行只需要可见的列（偏移仍相对于行首）
+    StyleSpans spansForRuns(const TokenRuns& runs, size_t begin = 0,
+                            size_t end = static_cast<size_t>(-1)) const;
+
     // 高亮一行代码
     ftxui::Element highlightLine(const std::string& line);
 
+    // 把整行高亮为首尾相接、覆盖整行的样式区间（整行只分词一次，
+    // 选中、搜索等装饰层再叠加在区间之上）
+    StyleSpans highlightSpans(const std::string& line);
+
+    // 当前文件类型是否由 Tree-sitter 按整个文档解析（此时一行的样式还取决于上下文）
+    bool usesDocumentTree() const;
+
+    // 高亮文档的第 row 行（line 为该行文本）：Tree-sitter 可用时使用文档的增量语法树，
+    // 否则按行解析。只生成与 [begin, end) 字节相交的区间（偏移仍相对于行首）；
+    // 按行解析时也只解析这部分，超长行每帧的开销与行长无关
+    StyleSpans highlightSpans(core::Document& doc, size_t row, const std::string& line,
+                              size_t begin = 0, size_t end = static_cast<size_t>(-1));
+
     // 获取颜色
     ftxui::Color getColorForToken(TokenType type) const;
 
@@ -93,127 +153,46 @@ class SyntaxHighlighter {
     std::unique_ptr<SyntaxHighlighterTreeSitter> tree_sitter_highlighter_;
 #endif
 
-    // 原有实现的数据成员
-    std::map<std::string, std::vector<std::string>> keywords_;
-    std::map<std::string, std::vector<std::string>> types_;
+    // 原有实现的数据成员：按语言名存放的关键字、类型集合（完美哈希，见 word_set.h）
+    std::map<std::string, WordSet> keywords_;
+    std::map<std::string, WordSet> types_;
+    // 当前文件类型的关键字、类型集合，setFileType() 时解析，没有时为 nullptr
+    const WordSet* current_keywords_;
+    const WordSet* current_types_;
     bool in_multiline_comment_;
     bool in_multiline_string_;
 
+    // 当前文件类型的表驱动分词器，没有声明式定义时为空
+    std::unique_ptr<TableLexer> table_lexer_;
+
     // 初始化语言定义（原有实现）
     void initializeLanguages();
 
-    // 分词（原有实现）
+    // 分词：有声明式定义（language_specs.h）的语言交给 table_lexer_，其余使用专门的分词器
     std::vector<Token> tokenize(const std::string& line);
 
-    // 特定语言的分词器（原有实现）
+    // 上下文相关、无法用声明式定义描述的语言的分词器（原有实现）
     std::vector<Token> tokenizeCpp(const std::string& line);
     std::vector<Token> tokenizePython(const std::string& line);
     std::vector<Token> tokenizeJavaScript(const std::string& line);
     std::vector<Token> tokenizeJSON(const std::string& line);
     std::vector<Token> tokenizeMarkdown(const std::string& line);
-    std::vector<Token> tokenizeShell(const std::string& line);
-    std::vector<Token> tokenizeLua(const std::string& line);
-    std::vector<Token> tokenizeCMake(const std::string& line);
-    std::vector<Token> tokenizeTCL(const std::string& line);
-    std::vector<Token> tokenizeFortran(const std::string& line);
-    std::vector<Token> tokenizeHaskell(const std::string& line);
 
     // 新增语言的分词器
     std::vector<Token> tokenizeYAML(const std::string& line);
     std::vector<Token> tokenizeXML(const std::string& line);
     std::vector<Token> tokenizeCSS(const std::string& line);
-    std::vector<Token> tokenizeSQL(const std::string& line);
-    std::vector<Token> tokenizeRuby(const std::string& line);
     std::vector<Token> tokenizePHP(const std::string& line);
-    std::vector<Token> tokenizeSwift(const std::string& line);
-    std::vector<Token> tokenizeKotlin(const std::string& line);
-    std::vector<Token> tokenizeScala(const std::string& line);
-    std::vector<Token> tokenizeR(const std::string& line);
-    std::vector<Token> tokenizePerl(const std::string& line);
     std::vector<Token> tokenizeDockerfile(const std::string& line);
     std::vector<Token> tokenizeMakefile(const std::string& line);
-    std::vector<Token> tokenizeVim(const std::string& line);
-    std::vector<Token> tokenizePowerShell(const std::string& line);
-
-    // 通用基础tokenize函数
-    std::vector<Token> tokenizeGeneric(const std::string& line);
-
-    // 新增语言的tokenize函数
-    std::vector<Token> tokenizeElixir(const std::string& line);
-    std::vector<Token> tokenizeClojure(const std::string& line);
-    std::vector<Token> tokenizeErlang(const std::string& line);
-    std::vector<Token> tokenizeJulia(const std::string& line);
-    std::vector<Token> tokenizeDart(const std::string& line);
-    std::vector<Token> tokenizeNim(const std::string& line);
-    std::vector<Token> tokenizeMeson(const std::string& line);
-    std::vector<Token> tokenizeTOML(const std::string& line);
     std::vector<Token> tokenizeHTML(const std::string& line);
-    std::vector<Token> tokenizeCrystal(const std::string& line);
-    std::vector<Token> tokenizeZig(const std::string& line);
-    std::vector<Token> tokenizeOCaml(const std::string& line);
-    std::vector<Token> tokenizeCoq(const std::string& line);
-    std::vector<Token> tokenizeAgda(const std::string& line);
-    std::vector<Token> tokenizeIdris(const std::string& line);
-    std::vector<Token> tokenizePureScript(const std::string& line);
-    std::vector<Token> tokenizeReason(const std::string& line);
-    std::vector<Token> tokenizeSML(const std::string& line);
-    std::vector<Token> tokenizeGroovy(const std::string& line);
-    std::vector<Token> tokenizeCoffeeScript(const std::string& line);
-    std::vector<Token> tokenizePug(const std::string& line);
-    std::vector<Token> tokenizeStylus(const std::string& line);
-    std::vector<Token> tokenizeSass(const std::string& line);
-    std::vector<Token> tokenizeLess(const std::string& line);
-    std::vector<Token> tokenizePostCSS(const std::string& line);
-    std::vector<Token> tokenizeGraphQL(const std::string& line);
-    std::vector<Token> tokenizeVue(const std::string& line);
-    std::vector<Token> tokenizeSvelte(const std::string& line);
-    std::vector<Token> tokenizeFSharp(const std::string& line);
-    std::vector<Token> tokenizeCSharp(const std::string& line);
-    std::vector<Token> tokenizeVB(const std::string& line);
     std::vector<Token> tokenizeAssembly(const std::string& line);
-    std::vector<Token> tokenizeWebAssembly(const std::string& line);
-    std::vector<Token> tokenizeVerilog(const std::string& line);
-    std::vector<Token> tokenizeVHDL(const std::string& line);
-    std::vector<Token> tokenizeMATLAB(const std::string& line);
-    std::vector<Token> tokenizeOctave(const std::string& line);
-    std::vector<Token> tokenizeRacket(const std::string& line);
-    std::vector<Token> tokenizeScheme(const std::string& line);
     std::vector<Token> tokenizeCommonLisp(const std::string& line);
-    std::vector<Token> tokenizeEmacsLisp(const std::string& line);
-    std::vector<Token> tokenizeProlog(const std::string& line);
-    std::vector<Token> tokenizeMercury(const std::string& line);
-    std::vector<Token> tokenizeAlloy(const std::string& line);
-    std::vector<Token> tokenizeDafny(const std::string& line);
-    std::vector<Token> tokenizeLean(const std::string& line);
-    std::vector<Token> tokenizeBallerina(const std::string& line);
-    std::vector<Token> tokenizeCadence(const std::string& line);
-    std::vector<Token> tokenizeClarity(const std::string& line);
-    std::vector<Token> tokenizeSolidity(const std::string& line);
-    std::vector<Token> tokenizeVyper(const std::string& line);
-    std::vector<Token> tokenizeCarbon(const std::string& line);
-    std::vector<Token> tokenizeVala(const std::string& line);
-    std::vector<Token> tokenizeGenie(const std::string& line);
-    std::vector<Token> tokenizeD(const std::string& line);
-    std::vector<Token> tokenizePony(const std::string& line);
-    std::vector<Token> tokenizeV(const std::string& line);
-    std::vector<Token> tokenizeOdin(const std::string& line);
-    std::vector<Token> tokenizeJai(const std::string& line);
-    std::vector<Token> tokenizeNelua(const std::string& line);
-    std::vector<Token> tokenizeWren(const std::string& line);
-    std::vector<Token> tokenizeMoonScript(const std::string& line);
-    std::vector<Token> tokenizeFantom(const std::string& line);
-    std::vector<Token> tokenizeSmalltalk(const std::string& line);
-    std::vector<Token> tokenizeAPL(const std::string& line);
-    std::vector<Token> tokenizeJ(const std::string& line);
-    std::vector<Token> tokenizeK(const std::string& line);
-    std::vector<Token> tokenizeQ(const std::string& line);
-
-    // 新增的函数式编程和编译器语言
     std::vector<Token> tokenizeLLVMIR(const std::string& line);
 
     // 辅助方法（原有实现）
-    bool isKeyword(const std::string& word) const;
-    bool isType(const std::string& word) const;
+    bool isKeyword(std::string_view word) const;
+    bool isType(std::string_view word) const;
     bool isOperator(char ch) const;
     bool isMultiCharOperator(const std::string& text, size_t pos) const;
     bool isNumber(const std::string& text) const;
@@ -226,8 +205,16 @@ class SyntaxHighlighter {
     // 注释处理（原有实现）
     size_t parseComment(const std::string& line, size_t start, bool& is_multiline);
 
+    // 分词并定位每个 token 在行内的位置（原有实现），得到覆盖整行的语法区间；
+    // 超长行按 LEX_CHUNK_LENGTH 分块分词，每块从上一块最后一个完整 token 之后继续
+    TokenRuns locateTokens(const std::string& line);
+    // 把 text（位于行内 offset 处）的 tokens 定位为区间追加到 runs，未覆盖的部分按普通文本处理
+    static void appendTokenRuns(const std::string& text, size_t offset,
+                                const std::vector<Token>& tokens, TokenRuns& runs);
+
     // 使用原有实现高亮
     ftxui::Element highlightLineNative(const std::string& line);
+    StyleSpans highlightSpansNative(const std::string& line);
 };
 
 } // namespace features
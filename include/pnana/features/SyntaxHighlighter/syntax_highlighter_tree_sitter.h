@@ -1,6 +1,8 @@
 #ifndef PNANA_FEATURES_SYNTAX_HIGHLIGHTER_SYNTAX_HIGHLIGHTER_TREE_SITTER_H
 #define PNANA_FEATURES_SYNTAX_HIGHLIGHTER_SYNTAX_HIGHLIGHTER_TREE_SITTER_H
 
+#include "features/SyntaxHighlighter/highlight_query.h"
+#include "features/SyntaxHighlighter/style_span.h"
 #include "ui/theme.h"
 #include <ftxui/dom/elements.hpp>
 #include <map>
@@ -12,6 +14,10 @@
 #include <tree_sitter/api.h>
 
 namespace pnana {
+namespace core {
+class Document;
+} // namespace core
+
 namespace features {
 
 // Tree-sitter 语法高亮器
@@ -30,6 +36,17 @@ class SyntaxHighlighterTreeSitter {
     // 高亮一行代码（使用增量解析）
     ftxui::Element highlightLine(const std::string& line);
 
+    // 把一行高亮为样式区间
+    StyleSpans highlightSpans(const std::string& line);
+
+    // 高亮文档的第 row 行：每个文档保存一棵持久的语法树，编辑经 ts_tree_edit 标记后
+    // 以旧树为基础增量重解析，跨行的注释、字符串也能正确着色。语言有 highlights.scm 时
+    // 从 row 起对约一屏的字节范围执行一次查询，后续行直接取结果；否则取出与该行相交的叶子节点。
+    // 文档正在后台加载或过大时返回 false，由调用方退回按行解析。
+    // 只生成与 [begin, end) 字节相交的区间（偏移仍相对于行首），超长行只需要可见的列
+    bool highlightDocumentLine(core::Document& doc, size_t row, StyleSpans& spans,
+                               size_t begin = 0, size_t end = static_cast<size_t>(-1));
+
     // 高亮多行代码（更高效）
     ftxui::Element highlightLines(const std::vector<std::string>& lines);
 
@@ -40,6 +57,14 @@ class SyntaxHighlighterTreeSitter {
     bool supportsFileType(const std::string& file_type) const;
 
   private:
+    // 文档的语法树及解析时的内容尺寸，保存在 Document::syntaxState() 中
+    struct DocumentTree;
+
+    // 超过此行数的文档不建整棵语法树
+    static constexpr size_t MAX_TREE_LINES = 200000;
+    // 一次高亮查询覆盖的行数（略大于一屏）
+    static constexpr size_t HIGHLIGHT_WINDOW_ROWS = 128;
+
     ui::Theme& theme_;
     TSParser* parser_;
     TSLanguage* current_language_;
@@ -48,6 +73,15 @@ class SyntaxHighlighterTreeSitter {
     // 语言映射：文件类型 -> Tree-sitter 语言
     std::map<std::string, TSLanguage*> language_map_;
 
+    // 语言 -> 语法名（tree-sitter-<name>，也是查询目录名）
+    std::map<const TSLanguage*, std::string> language_names_;
+
+    // 语言 -> 高亮查询（首次使用时加载，没有查询文件时为 nullptr）
+    std::map<const TSLanguage*, std::unique_ptr<HighlightQuery>> queries_;
+
+    // 查询结果的逐字节样式（复用缓冲区）
+    std::vector<HighlightStyle> byte_styles_;
+
     // 初始化语言映射
     void initializeLanguages();
 
@@ -57,15 +91,37 @@ class SyntaxHighlighterTreeSitter {
     // 将 Tree-sitter 节点类型映射到颜色
     ftxui::Color getColorForNodeType(const std::string& node_type) const;
 
+    // 高亮样式在当前主题下的颜色
+    ftxui::Color getColorForStyle(HighlightStyle style) const;
+
+    // 语言的高亮查询，没有时返回 nullptr
+    HighlightQuery* getQueryForLanguage(const TSLanguage* language);
+
+    // 对 [start_byte, end_byte) 执行查询，结果写入 byte_styles_（下标相对 start_byte）
+    void paintQuery(HighlightQuery& query, TSNode root, uint32_t start_byte, uint32_t end_byte,
+                    const core::LineBuffer& lines);
+
+    // 从 first_row 起对 HIGHLIGHT_WINDOW_ROWS 行执行查询，按行保存样式
+    void highlightWindow(DocumentTree& state, const core::LineBuffer& lines, size_t first_row,
+                         HighlightQuery& query);
+
     // 解析代码并生成高亮元素
     ftxui::Element parseAndHighlight(const std::string& code);
 
-    // 遍历语法树并生成高亮元素
-    void traverseTree(TSNode node, const std::string& source, std::vector<ftxui::Element>& elements,
+    // 解析代码并生成样式区间
+    StyleSpans parseSpans(const std::string& code);
+
+    // 遍历语法树并生成样式区间
+    void traverseTree(TSNode node, size_t source_length, StyleSpans& spans,
                       size_t& current_pos) const;
 
-    // 获取节点文本
-    std::string getNodeText(TSNode node, const std::string& source) const;
+    // 使文档的语法树与当前内容同步（增量），不使用语法树时返回 nullptr
+    DocumentTree* syncDocumentTree(core::Document& doc);
+
+    // 从游标所在节点起收集与第 row 行的 [current_pos, end_col) 列相交的叶子节点的样式区间
+    // （列号即行内字节偏移）
+    void collectRowSpans(TSTreeCursor* cursor, uint32_t row, size_t end_col, StyleSpans& spans,
+                         size_t& current_pos) const;
 };
 
 } // namespace features
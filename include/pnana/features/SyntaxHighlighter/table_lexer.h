@@ -0,0 +1,52 @@
+#ifndef PNANA_FEATURES_SYNTAX_HIGHLIGHTER_TABLE_LEXER_H
+#define PNANA_FEATURES_SYNTAX_HIGHLIGHTER_TABLE_LEXER_H
+
+#include "features/SyntaxHighlighter/language_specs.h"
+#include "features/SyntaxHighlighter/syntax_highlighter.h"
+#include "features/SyntaxHighlighter/word_set.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace pnana {
+namespace features {
+
+// 表驱动的分词器：按 LanguageSpec 分词一行。
+// 每种语言的 256 项字符分类表在编译期生成，扫描时每个字节查一次表决定路径：
+// 空白、标识符、运算符直接成段，只有表中标记为“可能开始注释/字符串/变量”的字节才比较前缀；
+// 数字由所有语言共用的状态转移表（DFA）识别。结果直接写入 TokenRuns，不生成中间字符串。
+// 多行状态与 SyntaxHighlighter::getMultiLineState() 的编码相同：1 为块注释，2 为块字符串
+class TableLexer {
+  public:
+    // file_type 对应的语言定义，没有时返回 nullptr
+    static const LanguageSpec* findSpec(const std::string& file_type);
+
+    // spec 必须来自 LANGUAGE_SPECS；keywords/types 为该语言的关键字、类型表（可为 nullptr），
+    // 须比 TableLexer 活得久
+    TableLexer(const LanguageSpec& spec, const WordSet* keywords, const WordSet* types);
+
+    // 该语言是否有跨行的块注释或块字符串
+    bool hasMultiLineState() const;
+
+    // 从 state 开始把 line 分为首尾相接、覆盖整行的 runs，返回下一行开头的多行状态
+    uint8_t scan(std::string_view line, uint8_t state, SyntaxHighlighter::TokenRuns& runs) const;
+
+  private:
+    // 在 pos 处尝试注释、字符串、字符字面量和变量前缀，匹配时写入 runs 并返回结束位置，否则返回 pos
+    size_t scanSpecial(std::string_view line, size_t pos, uint8_t& state,
+                       SyntaxHighlighter::TokenRuns& runs) const;
+    size_t scanQuoted(std::string_view line, size_t pos, char quote) const;
+    size_t scanNumber(std::string_view line, size_t pos) const;
+    TokenType classifyWord(std::string_view line, size_t start, size_t end) const;
+
+    const LanguageSpec& spec_;
+    const uint8_t* classes_; // 编译期生成的字符分类表（256 项）
+    const WordSet* keywords_;
+    const WordSet* types_;
+};
+
+} // namespace features
+} // namespace pnana
+
+#endif // PNANA_FEATURES_SYNTAX_HIGHLIGHTER_TABLE_LEXER_H
@@ -0,0 +1,51 @@
+#ifndef PNANA_FEATURES_SYNTAX_HIGHLIGHTER_WORD_SET_H
+#define PNANA_FEATURES_SYNTAX_HIGHLIGHTER_WORD_SET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pnana {
+namespace features {
+
+// 关键字/类型集合（用于语法高亮中标识符的分类）
+// 构造时为词表生成完美哈希（hash-and-displace）：第一次哈希选桶，桶内按预先找到的种子再哈希一次，
+// 得到的槽位中至多存放一个词。查找时只计算两次哈希、比较一次字符串，不分配内存，
+// 长度不在词表范围内的词直接排除
+class WordSet {
+  public:
+    WordSet() = default;
+    // 允许 keywords_["lua"] = {"and", "break", ...} 的写法
+    WordSet(std::initializer_list<std::string_view> words);
+    explicit WordSet(const std::vector<std::string>& words);
+
+    bool contains(std::string_view word) const;
+
+    size_t size() const {
+        return words_.size();
+    }
+
+  private:
+    static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+
+    void build(std::vector<std::string> words);
+    // 在 slot_count 个槽位内为所有词找到无冲突的位置，失败时返回 false
+    bool place(size_t slot_count);
+    static uint32_t hash(std::string_view word, uint32_t seed);
+
+    std::vector<std::string> words_;     // 去重后的词
+    std::vector<uint32_t> displacements_; // 每个桶的第二次哈希种子
+    std::vector<uint32_t> slots_;         // 槽位中词在 words_ 中的下标，EMPTY_SLOT 表示空
+    uint32_t bucket_mask_ = 0;
+    uint32_t slot_mask_ = 0;
+    size_t min_length_ = 1; // 空集合时 min > max，任何词都不匹配
+    size_t max_length_ = 0;
+};
+
+} // namespace features
+} // namespace pnana
+
+#endif // PNANA_FEATURES_SYNTAX_HIGHLIGHTER_WORD_SET_H
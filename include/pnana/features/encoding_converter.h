@@ -26,8 +26,9 @@ class EncodingConverter {
                                        const std::string& to_encoding,
                                        const std::vector<uint8_t>& content);
 
-    // 从文件读取内容（按字节读取）
-    static std::vector<uint8_t> readFileAsBytes(const std::string& filepath);
+    // 从文件读取内容（按字节读取，最多 max_bytes 字节）
+    static std::vector<uint8_t> readFileAsBytes(const std::string& filepath,
+                                                size_t max_bytes = SIZE_MAX);
 
     // 将内容写入文件（按指定编码）
     static bool writeFileWithEncoding(const std::string& filepath, const std::string& encoding,
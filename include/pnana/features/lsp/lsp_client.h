@@ -1,6 +1,7 @@
 #ifndef PNANA_FEATURES_LSP_CLIENT_H
 #define PNANA_FEATURES_LSP_CLIENT_H
 
+#include "core/document_snapshot.h"
 #include "features/lsp/document_change_tracker.h"
 #include "features/lsp/lsp_stdio_connector.h"
 #include "features/lsp/lsp_types.h"
@@ -75,6 +76,11 @@ class LspClient {
     void didOpen(const std::string& uri, const std::string& language_id, const std::string& content,
                  int version = 1);
     void didChange(const std::string& uri, const std::string& content, int version = 1);
+    // 以快照为内容的全量同步：各行逐段转义后直接写入消息缓冲区，不生成整个文档的中间字符串
+    void didOpen(const std::string& uri, const std::string& language_id,
+                 const core::DocumentSnapshot& snapshot, int version = 1);
+    void didChange(const std::string& uri, const core::DocumentSnapshot& snapshot,
+                   int version = 1);
     void didChangeIncremental(const std::string& uri,
                               const std::vector<TextDocumentContentChangeEvent>& changes,
                               int version = 1);
@@ -119,6 +125,18 @@ class LspClient {
     }
 
   private:
+    // 写入转义后的文档内容（不含引号）
+    using TextWriter = std::function<void(std::string& out)>;
+    // 手工拼接带整段文档内容的通知并直接发送：{"jsonrpc":"2.0","method":..,"params":
+    // params_prefix "<text>" params_suffix}；text_size 用于预留缓冲区
+    void sendTextNotification(const std::string& method, const std::string& params_prefix,
+                              size_t text_size, const TextWriter& write_text,
+                              const char* params_suffix);
+    void sendDidOpen(const std::string& uri, const std::string& language_id, int version,
+                     size_t text_size, const TextWriter& write_text);
+    void sendDidChange(const std::string& uri, int version, size_t text_size,
+                       const TextWriter& write_text);
+
     // 辅助函数
     std::string applyTextEdits(const std::string& original_content, const jsonrpccxx::json& edits);
     size_t positionToOffset(const std::string& content, const LspPosition& position);
@@ -49,6 +49,9 @@ class LspStdioConnector : public jsonrpccxx::IClientConnector {
     // 实现 IClientConnector 接口
     std::string Send(const std::string& request) override;
 
+    // 直接发送已序列化的通知（调用方保证没有 id 字段）：不解析消息，也不等待响应
+    void sendNotification(const std::string& notification);
+
     // 启动后台线程监听服务器通知
     void startNotificationListener();
 
@@ -1,11 +1,19 @@
 #ifndef PNANA_FEATURES_SEARCH_H
 #define PNANA_FEATURES_SEARCH_H
 
+#include "core/line_buffer.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <regex>
 #include <string>
 #include <vector>
 
 namespace pnana {
+namespace core {
+class Document;
+} // namespace core
+
 namespace features {
 
 // 搜索匹配结果
@@ -27,14 +35,82 @@ struct SearchOptions {
     SearchOptions() = default;
 };
 
+// 边输入边搜索的上下文
+struct SearchScope {
+    const void* source = nullptr; // 被搜索的文档，与 version 一起判断能否复用上一次的结果
+    uint64_t version = 0;         // 文档内容版本
+    size_t first_visible = 0;     // 可见行 [first_visible, last_visible)，先于其余部分同步搜索
+    size_t last_visible = 0;
+};
+
+// 增量搜索的候选位置：上一次较短模式的匹配（按行有序），只在它覆盖的行上是完整的。
+// 覆盖从 first_line 起的 line_count 行，越过末尾后从第 0 行继续；
+// 上一次的后台搜索尚未完成时只覆盖可见行和已取到的部分
+struct SearchCandidates {
+    std::vector<SearchMatch> matches;
+    size_t first_line = 0;
+    size_t line_count = 0;
+};
+
+class SearchJob;
+
 // 搜索引擎
 class SearchEngine {
   public:
+    // 行数达到此值时按块分给多个线程搜索
+    static constexpr size_t PARALLEL_MIN_LINES = 65536;
+
     SearchEngine();
+    ~SearchEngine();
 
-    // 执行搜索
-    void search(const std::string& pattern, const std::vector<std::string>& lines,
+    // 执行搜索（大文档在多个线程中并行搜索，返回时已得到全部匹配）
+    void search(const std::string& pattern, const core::LineBuffer& lines,
                 const SearchOptions& options = SearchOptions());
+    // 同上，并记住结果属于 doc：之后 applyEdits(doc) 据此更新匹配，增量搜索可在其上细化。
+    // 搜索前取出 doc 尚未应用的修改窗口（结果已包含这些修改，applyEdits 不应再应用一次）
+    void search(const std::string& pattern, core::Document& doc,
+                const SearchOptions& options = SearchOptions());
+
+    // 后台并行搜索：立即返回，匹配按行序分批到达，由 pollResults() 并入；
+    // notify 在工作线程中调用（如 ScreenInteractive::PostEvent）。
+    // 搜索的是 lines 的拷贝（写时复制），期间可以继续编辑
+    void searchAsync(const std::string& pattern, const core::LineBuffer& lines,
+                     const SearchOptions& options, std::function<void()> notify);
+    void searchAsync(const std::string& pattern, core::Document& doc,
+                     const SearchOptions& options, std::function<void()> notify);
+    // 边输入边搜索：新模式延长了上一次字面搜索的模式时，只在上一次的匹配位置上确认
+    // （上一次仍在后台搜索时，未搜到的行照常搜索）；
+    // 大文档先同步搜索可见行，其余部分在后台继续（从可见区域之后开始，最后回到开头），
+    // 下一次调用时取消。notify 同 searchAsync
+    void searchIncremental(const std::string& pattern, const core::LineBuffer& lines,
+                           const SearchOptions& options, const SearchScope& scope,
+                           std::function<void()> notify);
+    // 同上，搜索 doc 的当前内容（scope 的 source 和 version 取自 doc），修改窗口的处理同 search
+    void searchIncremental(const std::string& pattern, core::Document& doc,
+                           const SearchOptions& options, const SearchScope& scope,
+                           std::function<void()> notify);
+    // 并入后台搜索已按顺序完成的结果，返回是否有新的匹配
+    bool pollResults();
+    // 后台搜索是否仍在进行
+    bool isSearching() const;
+    // 等待后台搜索完成并并入全部结果（需要完整匹配列表的操作之前调用，如全部替换）
+    void finish();
+
+    // 在 [first_line, last_line) 行中搜索，匹配追加到 out。
+    // 不使用引擎的状态，可在多个线程中同时调用
+    static void searchLines(const std::string& pattern, const core::LineBuffer& lines,
+                            const SearchOptions& options, size_t first_line, size_t last_line,
+                            std::vector<SearchMatch>& out);
+    // 在 [first_line, last_line) 行中搜索 pattern，结果与 searchLines 相同（前提见 canRefine）：
+    // candidates 覆盖的行只在候选位置上确认，其余行照常搜索
+    static void refineLines(const std::string& pattern, const core::LineBuffer& lines,
+                            const SearchOptions& options, const SearchCandidates& candidates,
+                            size_t first_line, size_t last_line, std::vector<SearchMatch>& out);
+
+    // 文档修改后更新匹配（编辑器每帧调用）：取出文档的修改窗口（见 Document::takeLineChanges），
+    // 窗口之后的匹配只平移行号，只重新搜索改动过的行；后台搜索进行中时重新开始。
+    // 结果不属于 doc（或来源未知）时只丢弃修改窗口。返回匹配是否有变化
+    bool applyEdits(core::Document& doc);
 
     // 查找下一个/上一个
     bool findNext();
@@ -42,10 +118,12 @@ class SearchEngine {
 
     // 跳转到匹配
     bool jumpToMatch(size_t index);
+    // 当前匹配设为位于 (line, column) 及之后的第一个，之后没有匹配时回到第一个
+    bool jumpToMatchAt(size_t line, size_t column);
 
     // 替换
-    bool replaceCurrentMatch(const std::string& replacement, std::vector<std::string>& lines);
-    size_t replaceAll(const std::string& replacement, std::vector<std::string>& lines);
+    bool replaceCurrentMatch(const std::string& replacement, core::LineBuffer& lines);
+    size_t replaceAll(const std::string& replacement, core::LineBuffer& lines);
 
     // 获取匹配信息
     const SearchMatch* getCurrentMatch() const;
@@ -76,11 +154,41 @@ class SearchEngine {
     SearchOptions options_;
     std::vector<SearchMatch> matches_;
     size_t current_match_index_;
+    std::unique_ptr<SearchJob> job_; // 进行中的后台搜索
+    // 后台搜索中位于可见区域之前的匹配：绕回开头后才到达，搜索完成时一次插到 matches_ 前面
+    std::vector<SearchMatch> head_matches_;
+    size_t head_end_line_ = 0;
+    size_t visible_lines_ = 0; // 增量搜索已同步搜过的可见行数（从 head_end_line_ 起）
+    const void* source_ = nullptr; // 当前结果对应的文档及版本（未知时为空）
+    uint64_t source_version_ = 0;
+    std::function<void()> notify_; // 后台搜索的通知回调，修改后重新开始时沿用
+
+    void resetSearch(const std::string& pattern, const SearchOptions& options);
+    // 结果即将取自 doc 的当前内容：丢弃此前累积的修改窗口
+    static void dropPendingEdits(core::Document& doc);
+    // 上一次的结果（已搜到的部分）能否作为 pattern 的候选位置
+    bool canRefine(const std::string& pattern, const SearchOptions& options,
+                   const SearchScope& scope) const;
 
     // 内部搜索方法
-    void searchLiteral(const std::string& pattern, const std::vector<std::string>& lines);
-    void searchRegex(const std::string& pattern, const std::vector<std::string>& lines);
-    void searchWholeWord(const std::string& pattern, const std::vector<std::string>& lines);
+    static void searchLiteral(const std::string& pattern, const core::LineBuffer& lines,
+                              const SearchOptions& options, size_t first_line, size_t last_line,
+                              std::vector<SearchMatch>& out);
+    static void searchRegex(const std::string& pattern, const core::LineBuffer& lines,
+                            const SearchOptions& options, size_t first_line, size_t last_line,
+                            std::vector<SearchMatch>& out);
+    // 只在 candidates 中位于 [first_line, last_line) 的位置上确认 pattern 的匹配
+    static void confirmCandidates(const std::string& pattern, const core::LineBuffer& lines,
+                                  const SearchOptions& options,
+                                  const std::vector<SearchMatch>& candidates, size_t first_line,
+                                  size_t last_line, std::vector<SearchMatch>& out);
+    // 使用了反向引用、环视等特性的模式交给 std::regex
+    static void searchStdRegex(const std::string& pattern, const core::LineBuffer& lines,
+                               const SearchOptions& options, size_t first_line,
+                               size_t last_line, std::vector<SearchMatch>& out);
+    static void searchWholeWord(const std::string& pattern, const core::LineBuffer& lines,
+                                const SearchOptions& options, size_t first_line,
+                                size_t last_line, std::vector<SearchMatch>& out);
 };
 
 } // namespace features
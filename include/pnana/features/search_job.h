@@ -0,0 +1,100 @@
+#ifndef PNANA_FEATURES_SEARCH_JOB_H
+#define PNANA_FEATURES_SEARCH_JOB_H
+
+#include "core/line_buffer.h"
+#include "features/search.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pnana {
+namespace features {
+
+// 并行搜索任务
+// 行范围按 CHUNK_LINES 行切块，工作线程用原子计数按块号顺序领取，各块的匹配存放在各自的向量中；
+// 调用方用 takeReady() 按块顺序取走从开头起连续完成的部分，因此取到的结果始终按行有序，
+// 第一块完成时第一屏的匹配就能显示。搜索的是 LineBuffer 的拷贝（写时复制，拷贝只需 O(块数)），
+// 多个线程只通过 forEachLine 读取同一个拷贝，映射块不会被转换。
+// 行范围可以从任意一行开始并在文档末尾绕回第 0 行：可见区域已由调用方先搜过时，
+// 块顺序为可见区域之后的部分、再回到开头，取到的结果在绕回处分成两段各自有序。
+class SearchJob {
+  public:
+    static constexpr size_t CHUNK_LINES = 16384;
+    // 两次通知之间的最短间隔（第一块和全部完成时总会通知）
+    static constexpr std::chrono::milliseconds NOTIFY_INTERVAL{50};
+
+    using NotifyCallback = std::function<void()>;
+    using Candidates = std::shared_ptr<const SearchCandidates>;
+
+    // 构造时启动工作线程；threads 为 0 时取 CPU 核数。notify 在工作线程中调用
+    SearchJob(std::string pattern, core::LineBuffer lines, SearchOptions options,
+              NotifyCallback notify = nullptr, size_t threads = 0);
+    // 只搜索从 first_line 起的 line_count 行（越过末尾后从第 0 行继续）；
+    // candidates 非空时只在这些位置上确认匹配（见 SearchEngine::refineLines）
+    SearchJob(std::string pattern, core::LineBuffer lines, SearchOptions options,
+              size_t first_line, size_t line_count, Candidates candidates,
+              NotifyCallback notify = nullptr, size_t threads = 0);
+    // 取消并等待工作线程退出（正在搜索的块搜完为止）
+    ~SearchJob();
+
+    SearchJob(const SearchJob&) = delete;
+    SearchJob& operator=(const SearchJob&) = delete;
+
+    void cancel();
+    void wait();
+
+    // 把从开头起连续完成的块中尚未取走的匹配追加到 out，返回追加的个数
+    size_t takeReady(std::vector<SearchMatch>& out);
+    // 已被 takeReady() 取走的块覆盖的行数（从范围的第一行起）
+    size_t readyLines();
+
+    // 所有块都已搜索完毕（取消后不再变为 true）
+    bool isFinished() const {
+        return done_chunks_.load() == chunk_count_;
+    }
+    // 已完成的块中的匹配总数（包括尚未按顺序取走的部分）
+    size_t matchCount() const {
+        return match_count_.load();
+    }
+    // 搜索进度（0-100）
+    int progress() const;
+
+  private:
+    void run();
+    void searchChunk(size_t chunk, std::vector<SearchMatch>& found) const;
+    void searchRange(size_t first_line, size_t last_line, std::vector<SearchMatch>& found) const;
+    void notify(size_t done_chunks);
+
+    std::string pattern_;
+    core::LineBuffer lines_;
+    SearchOptions options_;
+    size_t first_line_;
+    size_t line_count_;
+    Candidates candidates_;
+    NotifyCallback notify_;
+    size_t chunk_count_;
+
+    std::mutex mutex_;
+    std::vector<std::vector<SearchMatch>> chunk_matches_; // 以下各项由 mutex_ 保护
+    std::vector<char> chunk_done_;
+    size_t next_ready_ = 0; // 下一个要取走的块
+    bool first_notified_ = false;
+    std::chrono::steady_clock::time_point last_notify_;
+
+    std::atomic<size_t> next_chunk_{0};
+    std::atomic<size_t> done_chunks_{0};
+    std::atomic<size_t> match_count_{0};
+    std::atomic<bool> cancelled_{false};
+    std::vector<std::thread> workers_;
+};
+
+} // namespace features
+} // namespace pnana
+
+#endif // PNANA_FEATURES_SEARCH_JOB_H
@@ -0,0 +1,68 @@
+#ifndef PNANA_UI_LINE_DECORATIONS_H
+#define PNANA_UI_LINE_DECORATIONS_H
+
+#include "features/SyntaxHighlighter/style_span.h"
+#include <cstddef>
+#include <ftxui/dom/elements.hpp>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace pnana {
+namespace ui {
+
+// 叠加在语法样式之上的区间装饰（[start, end) 为行内字节偏移）
+struct DecorationRange {
+    size_t start;
+    size_t end;
+};
+
+// 诊断装饰：以下划线标出诊断范围，错误和警告同时改用对应的颜色
+struct DiagnosticDecoration {
+    size_t start;
+    size_t end;
+    int severity; // 1=Error, 2=Warning, 3=Info, 4=Hint
+};
+
+// 一行的全部装饰层，自下而上：语法 -> 诊断 -> 搜索匹配 -> 选中 -> 光标
+struct LineDecorations {
+    features::StyleSpans spans;                    // 语法层，首尾相接
+    std::vector<DiagnosticDecoration> diagnostics; // 诊断层
+    std::vector<DecorationRange> matches;          // 搜索匹配层，按起点有序
+    bool has_selection = false;                    // 选中层
+    DecorationRange selection{0, 0};
+    bool has_cursor = false; // 光标层
+    size_t cursor = 0;
+
+    // 是否只有语法层（这样的行只取决于行文本）
+    bool plain() const {
+        return diagnostics.empty() && matches.empty() && !has_selection && !has_cursor;
+    }
+};
+
+// 行装饰的颜色
+struct LineDecorationColors {
+    ftxui::Color foreground;
+    ftxui::Color selection;
+    ftxui::Color search_match;
+    ftxui::Color error;
+    ftxui::Color warning;
+};
+
+// 超长行只渲染 [begin, end) 字节时，把各层裁剪到该范围并平移为相对 begin 的偏移；
+// 语法层二分定位，代价只与范围内的区间数有关
+LineDecorations clipDecorations(const LineDecorations& decorations, size_t begin, size_t end);
+
+// 渲染光标所在字符（cursor_char 为光标处的完整 UTF-8 字符，行尾时为空格）
+using CursorRenderer = std::function<ftxui::Element(const std::string& cursor_char)>;
+
+// 把各装饰层合并为一行元素：按所有层的区间端点切分，一次扫描完成，
+// 语法层只在整行上计算一次，切分点落在 token 中间时颜色也不会断开
+ftxui::Element renderDecoratedLine(const std::string& line, const LineDecorations& decorations,
+                                   const LineDecorationColors& colors,
+                                   const CursorRenderer& render_cursor);
+
+} // namespace ui
+} // namespace pnana
+
+#endif // PNANA_UI_LINE_DECORATIONS_H
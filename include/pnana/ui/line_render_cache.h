@@ -0,0 +1,102 @@
+#ifndef PNANA_UI_LINE_RENDER_CACHE_H
+#define PNANA_UI_LINE_RENDER_CACHE_H
+
+#include "features/SyntaxHighlighter/style_span.h"
+#include <cstddef>
+#include <cstdint>
+#include <ftxui/dom/elements.hpp>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+namespace pnana {
+namespace ui {
+
+// 行渲染缓存
+// 缓存语法高亮后的行内容元素，键为 (高亮上下文, 行文本)：样式区间由调用方先算出
+// （Tree-sitter 语法树或后台分词的结果），查找时一并比较，区间相同才复用元素。
+// 编辑只会让被修改的行失效，插入/删除行导致的行号平移不影响命中。
+// 上下文（主题、文件类型、后端等）变化时整体清空。
+// 采用两代淘汰：当前代写满 MAX_ENTRIES 后整体降为上一代，上一代命中的条目提升回当前代，
+// 因此屏幕上反复出现的行常驻，很久没显示过的行自然淘汰。
+class LineRenderCache {
+  public:
+    static constexpr size_t MAX_ENTRIES = 4096;
+
+    struct Entry {
+        ftxui::Element element;
+        uint64_t frame = 0;         // 最近一次被使用的帧
+        features::StyleSpans spans; // 生成元素时的样式区间，用于校验
+    };
+
+    // 开始新的一帧；同一帧内同一元素只会交出一次（分屏显示同一行时各自渲染，
+    // 避免同一个节点在元素树中出现两次）
+    void beginFrame() {
+        ++frame_;
+    }
+
+    // 设置高亮上下文，与当前不同时清空缓存
+    void setContext(const std::string& context);
+
+    // 查找；行文本和样式区间都相同时命中，返回条目并标记为本帧已使用
+    const Entry* find(const std::string& line, const features::StyleSpans& spans);
+    void insert(const std::string& line, ftxui::Element element, features::StyleSpans spans);
+
+    void clear();
+    size_t size() const {
+        return current_.size() + previous_.size();
+    }
+    // 缓存每次清空（上下文或主题变化）时递增，按行缓存的样式区间据此失效
+    uint64_t generation() const {
+        return generation_;
+    }
+
+  private:
+    using Map = std::unordered_map<std::string, Entry>;
+
+    std::string context_;
+    Map current_;
+    Map previous_;
+    uint64_t frame_ = 1;
+    uint64_t generation_ = 0;
+};
+
+// 按行缓存的语法层样式区间（每个文档一份，保存在 Document::renderState() 中）
+// 键为行号，命中还要求生成时的校验值相同：高亮上下文、高亮纪元（Tree-sitter 为文档版本，
+// 后台分词为结果纪元）和水平窗口。光标移动等只改变装饰层的帧不必重新取样式区间。
+// 编辑由 applyChange() 按修改窗口丢弃改动过的行并平移之后的行。
+class RowSpanCache {
+  public:
+    static constexpr size_t MAX_ROWS = 1024;
+
+    struct Key {
+        uint64_t context = 0; // LineRenderCache::generation()
+        uint64_t epoch = 0;
+        size_t begin = 0; // 水平窗口 [begin, end)
+        size_t end = 0;
+
+        bool operator==(const Key& other) const {
+            return context == other.context && epoch == other.epoch && begin == other.begin &&
+                   end == other.end;
+        }
+    };
+
+    const features::StyleSpans* find(size_t row, const Key& key) const;
+    void insert(size_t row, const Key& key, features::StyleSpans spans);
+
+    // 文档修改：原来从 first 开始的 replaced 行被替换成了现在的 [first, end)
+    void applyChange(size_t first, size_t end, size_t replaced);
+
+  private:
+    struct Row {
+        Key key;
+        features::StyleSpans spans;
+    };
+
+    std::map<size_t, Row> rows_;
+};
+
+} // namespace ui
+} // namespace pnana
+
+#endif // PNANA_UI_LINE_RENDER_CACHE_H
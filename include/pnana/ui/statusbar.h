@@ -72,7 +72,8 @@ class Statusbar {
                           const std::string& region_name = "", bool syntax_highlighting = true,
                           bool has_selection = false, size_t selection_length = 0,
                           const std::string& git_branch = "", int git_uncommitted_count = 0,
-                          const std::string& ssh_host = "", const std::string& ssh_user = "");
+                          const std::string& ssh_host = "", const std::string& ssh_user = "",
+                          size_t undo_memory = 0);
 
     // Git相关方法（公共接口）
     static std::tuple<std::string, int> getGitInfo();
@@ -91,6 +92,9 @@ class Statusbar {
     // 格式化进度
     std::string formatProgress(size_t current, size_t total);
 
+    // 格式化字节数（B/K/M）
+    std::string formatBytes(size_t bytes);
+
     // 获取区域图标
     std::string getRegionIcon(const std::string& region_name);
 
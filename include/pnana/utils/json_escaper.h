@@ -0,0 +1,33 @@
+#ifndef PNANA_UTILS_JSON_ESCAPER_H
+#define PNANA_UTILS_JSON_ESCAPER_H
+
+#include <string>
+#include <string_view>
+
+namespace pnana {
+namespace utils {
+
+/**
+ * 流式 JSON 字符串转义
+ * 把文本片段转义后直接追加到输出缓冲区，用于拼接大段文本的 JSON 消息（如 LSP 同步整个文档），
+ * 避免先构造 json 对象再序列化带来的多份完整拷贝。
+ * 不需要转义的连续字节整段复制（由 TextScanner::findJsonEscape 定位转义点）；
+ * 非 ASCII 字节原样输出，调用方需保证内容是合法的 UTF-8。
+ */
+class JsonEscaper {
+  public:
+    // 追加 text 转义后的内容（不含两侧引号），可以对同一个字符串分多次调用
+    static void append(std::string& out, std::string_view text);
+
+    // 追加带引号的 JSON 字符串
+    static void appendQuoted(std::string& out, std::string_view text) {
+        out += '"';
+        append(out, text);
+        out += '"';
+    }
+};
+
+} // namespace utils
+} // namespace pnana
+
+#endif // PNANA_UTILS_JSON_ESCAPER_H
@@ -0,0 +1,70 @@
+#ifndef PNANA_UTILS_LITERAL_FINDER_H
+#define PNANA_UTILS_LITERAL_FINDER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace pnana {
+namespace utils {
+
+/**
+ * 字面量查找器
+ * 构造时把模式预处理一次，之后在任意 string_view 中查找，不复制、不分配内存。
+ * 用 SSE2/AVX2 同时比较模式的首字节和末字节（运行时检测 CPU 支持，非 x86 平台使用标量实现），
+ * 两者都命中的位置再逐字节确认。不区分大小写时只折叠 ASCII 字母（与 tolower 在 C 区域设置下一致），
+ * UTF-8 多字节字符按原字节比较。
+ */
+class LiteralFinder {
+  public:
+    LiteralFinder() = default;
+    LiteralFinder(std::string_view pattern, bool case_sensitive);
+
+    /**
+     * 在 text 的 [from, text.size()) 中查找第一个匹配
+     * @return 匹配的起始偏移；没有时返回 std::string_view::npos（模式为空时也返回 npos）
+     */
+    size_t find(std::string_view text, size_t from = 0) const;
+
+    /**
+     * 模式的字节数
+     */
+    size_t length() const {
+        return pattern_.size();
+    }
+
+    /**
+     * 当前使用的实现（"avx2"、"sse2" 或 "scalar"），用于日志
+     */
+    static const char* implementation();
+
+  private:
+    std::string pattern_; // 不区分大小写时已转为小写
+    bool case_sensitive_ = true;
+    // 首/末字节的比较方式：(byte | mask) == value，字母在不区分大小写时 mask 为 0x20
+    unsigned char first_value_ = 0;
+    unsigned char first_mask_ = 0;
+    unsigned char last_value_ = 0;
+    unsigned char last_mask_ = 0;
+
+    // 确认 candidate 处的完整匹配（首末字节已由调用方确认）
+    bool matchesAt(const char* candidate) const;
+
+    // 各实现的查找循环，调用前已保证 from + length() <= text.size()；SIMD 版本只在 x86_64 上定义
+    size_t findScalar(std::string_view text, size_t from) const;
+    size_t findSse2(std::string_view text, size_t from) const;
+    size_t findAvx2(std::string_view text, size_t from) const;
+
+    using FindFn = size_t (LiteralFinder::*)(std::string_view, size_t) const;
+    struct Implementation {
+        const char* name;
+        FindFn find;
+    };
+    // 按 CPU 支持选择实现（只检测一次）
+    static const Implementation& selectImplementation();
+};
+
+} // namespace utils
+} // namespace pnana
+
+#endif // PNANA_UTILS_LITERAL_FINDER_H
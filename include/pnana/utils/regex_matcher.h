@@ -0,0 +1,111 @@
+#ifndef PNANA_UTILS_REGEX_MATCHER_H
+#define PNANA_UTILS_REGEX_MATCHER_H
+
+#include "utils/literal_finder.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace pnana {
+namespace utils {
+
+/**
+ * 线性时间的正则表达式匹配器
+ * 支持 ECMAScript 语法的常用子集：字符、.、字符类（含 \d \w \s 及其补集）、分组 (...) 与 (?:...)、
+ * 选择 |、量词 * + ? {n} {n,} {n,m}（及惰性形式）、断言 ^ $ \b \B。
+ * 模式编译为 Thompson NFA，用 Pike VM 按码点并行推进所有线程，时间为 O(文本长度 × 程序长度)，
+ * 不回溯、不递归，长行也不会爆栈；线程按优先级排列，结果与回溯实现的最左优先语义一致。
+ * 编译时从语法树提取每个匹配都必须包含的字面量和匹配的字面量前缀：
+ * 不含必需字面量的行直接跳过（SIMD 查找），没有活动线程时跳到下一个前缀出现的位置，
+ * 没有前缀时按匹配可能的首字节表跳过不可能的起点。
+ * 不区分大小写时只折叠 ASCII 字母。反向引用和环视不支持，status() 为 UNSUPPORTED。
+ */
+class RegexMatcher {
+  public:
+    enum class Status {
+        OK,
+        INVALID,     // 语法错误
+        UNSUPPORTED, // 使用了反向引用、环视等不支持的特性，或程序过大
+    };
+
+    RegexMatcher(std::string_view pattern, bool case_sensitive);
+
+    Status status() const {
+        return status_;
+    }
+    const std::string& error() const {
+        return error_;
+    }
+
+    /**
+     * 在 text 的 [from, text.size()) 中查找最左的匹配（断言可以看到 from 之前的字符）
+     * @return 是否找到；找到时 [start, end) 为匹配的字节范围（可能为空）
+     * 可在多个线程中同时调用（工作区按线程分配）
+     */
+    bool find(std::string_view text, size_t from, size_t& start, size_t& end) const;
+
+    /**
+     * 每个匹配都必须包含的字面量（没有时为空）
+     */
+    const std::string& requiredLiteral() const {
+        return required_;
+    }
+
+    /**
+     * 文本中不含必需字面量时不可能匹配，调用方可据此跳过整行
+     */
+    bool mayMatch(std::string_view text) const {
+        return required_.empty() || required_finder_.find(text) != std::string_view::npos;
+    }
+
+  private:
+    struct Node;
+    struct Parser;
+    struct LiteralInfo;
+
+    enum class Op : uint8_t { CHAR, ANY, CLASS, SPLIT, JMP, ASSERT, MATCH };
+    enum class Assertion : uint8_t { LINE_BEGIN, LINE_END, WORD_BOUNDARY, NOT_WORD_BOUNDARY };
+
+    struct Inst {
+        Op op;
+        Assertion assertion;
+        char32_t ch; // CHAR：不区分大小写时已折叠为小写
+        uint32_t x;  // SPLIT/JMP 的目标（SPLIT 优先走 x），CLASS 的字符类下标
+        uint32_t y;
+    };
+
+    // 字符类：排好序、互不相交的码点区间（不区分大小写时已加入另一种大小写）
+    struct CharClass {
+        std::vector<std::pair<char32_t, char32_t>> ranges;
+        bool contains(char32_t ch) const;
+    };
+
+    static constexpr size_t MAX_PROGRAM_SIZE = 20000;
+
+    bool compile(const Node& node);
+    uint32_t emit(Op op);
+    void computeFirstBytes();
+    static LiteralInfo literals(const Node& node);
+    bool checkAssertion(Assertion assertion, std::string_view text, size_t pos) const;
+
+    Status status_ = Status::OK;
+    std::string error_;
+    bool case_sensitive_;
+    std::vector<Inst> program_;
+    std::vector<CharClass> classes_;
+    std::string required_;
+    std::string prefix_;
+    std::array<bool, 256> first_bytes_{}; // 匹配可能的首字节
+    bool skip_by_first_byte_ = false;     // 模式不能匹配空串时才能按首字节跳过
+    LiteralFinder required_finder_;
+    LiteralFinder prefix_finder_;
+};
+
+} // namespace utils
+} // namespace pnana
+
+#endif // PNANA_UTILS_REGEX_MATCHER_H
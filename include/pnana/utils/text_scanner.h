@@ -0,0 +1,88 @@
+#ifndef PNANA_UTILS_TEXT_SCANNER_H
+#define PNANA_UTILS_TEXT_SCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pnana {
+namespace utils {
+
+/**
+ * 文本扫描结果
+ * 一次扫描同时得到行偏移表、行尾类型统计和二进制检测所需的计数
+ */
+struct TextScanResult {
+    std::vector<size_t> line_starts; // 每行的起始偏移（首元素恒为 0，共 换行数 + 1 个）
+    size_t lf_count = 0;             // 换行符总数（含 CRLF 中的 \n）
+    size_t crlf_count = 0;           // \r\n 个数
+    size_t cr_count = 0;             // 单独的 \r 个数
+    bool has_non_ascii = false;      // 是否包含 >= 0x80 的字节
+
+    // 二进制检测只统计开头 probe_size 个字节
+    size_t probe_size = 0;
+    size_t null_count = 0;    // 空字符个数
+    size_t control_count = 0; // 除 \t \n \r 以外的控制字符个数（含空字符）
+
+    /**
+     * 二进制文件启发式判断
+     * 开头超过 1% 的空字符，或超过 5% 的控制字符，认为是二进制文件
+     */
+    bool looksBinary() const {
+        if (probe_size == 0) {
+            return false;
+        }
+        return null_count > probe_size / 100 || control_count > probe_size / 20;
+    }
+};
+
+/**
+ * 文本扫描工具类
+ * 使用 SSE2/AVX2 按块比较字节（运行时检测 CPU 支持，非 x86 平台使用标量实现），
+ * 供文档加载、编码检测等需要切分行或检测文件类型的地方共用。
+ */
+class TextScanner {
+  public:
+    static constexpr size_t BINARY_PROBE_BYTES = 8192; // 二进制检测只检查前8KB
+
+    /**
+     * 单次扫描内容
+     * @param data 内容起始地址
+     * @param size 内容长度
+     * @param collect_lines 是否生成行偏移表（只需要统计信息时可关闭）
+     */
+    static TextScanResult scan(const char* data, size_t size, bool collect_lines = true);
+
+    /**
+     * 从 data 开始查找换行符，最多记录 max_count 个
+     * @param positions 输出每个 \n 相对 data 的偏移
+     * @return 找到的个数；小于 max_count 表示已扫描到 size 末尾
+     */
+    static size_t findNewlines(const char* data, size_t size, size_t* positions, size_t max_count);
+
+    /**
+     * 查找第一个需要在 JSON 字符串中转义的字节（\"、\\ 或 < 0x20 的控制字符）
+     * @return 相对 data 的偏移；没有时返回 size
+     */
+    static size_t findJsonEscape(const char* data, size_t size);
+
+    /**
+     * 按 \n 切分内容并去掉行尾的 \r
+     * 行数为换行符个数 + 1（以换行结尾时最后一行为空）
+     */
+    static std::vector<std::string> splitLines(const std::string& content);
+    // 使用已有的扫描结果切分（scan 须由 collect_lines = true 得到）
+    static std::vector<std::string> splitLines(const std::string& content,
+                                               const TextScanResult& scan);
+
+    /**
+     * 当前使用的实现（"avx2"、"sse2" 或 "scalar"），用于日志
+     */
+    static const char* implementation();
+};
+
+} // namespace utils
+} // namespace pnana
+
+#endif // PNANA_UTILS_TEXT_SCANNER_H
@@ -0,0 +1,112 @@
+#ifndef PNANA_UTILS_UNICODE_WIDTH_H
+#define PNANA_UTILS_UNICODE_WIDTH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace pnana {
+namespace utils {
+
+/**
+ * Unicode 显示宽度与字形簇工具类
+ * 宽度表由 Unicode 字符数据库预先生成（East Asian Width 为 W/F 的字符占 2 列，
+ * 组合字符、格式字符和谚文中声/终声占 0 列），按区间二分查找，U+0300 以下直接返回。
+ * 字形簇采用简化规则：基字符加上其后的 0 宽字符（组合符号、变体选择符、ZWJ 等）、
+ * ZWJ 连接的下一个字符和 emoji 肤色修饰符，成对的区域指示符（国旗）也合为一簇。
+ */
+class UnicodeWidth {
+  public:
+    /**
+     * 码点的显示宽度：0、1 或 2（控制字符按 1 列）
+     */
+    static int codePointWidth(char32_t code_point);
+
+    /**
+     * 解码 pos 处的 UTF-8 码点并把 pos 移到下一个码点
+     * 无效或截断的序列按 U+FFFD 处理，只前移 1 字节
+     */
+    static char32_t decode(std::string_view text, size_t& pos);
+
+    /**
+     * pos 所在字形簇之后的下一个簇边界（pos 已在末尾时返回 text.size()）
+     */
+    static size_t nextGrapheme(std::string_view text, size_t pos);
+
+    /**
+     * pos 之前最近的簇边界（pos 为 0 时返回 0）
+     */
+    static size_t prevGrapheme(std::string_view text, size_t pos);
+
+    /**
+     * [pos, nextGrapheme(pos)) 这个字形簇的显示宽度（取基字符的宽度）
+     */
+    static int graphemeWidth(std::string_view text, size_t pos);
+
+    /**
+     * 整段文本的显示宽度
+     */
+    static size_t displayWidth(std::string_view text);
+
+    /**
+     * byte 所在字形簇的起始显示列（byte 超出末尾时为整段宽度）
+     * 只扫描 byte 之前的部分且不分配内存，开头的纯 ASCII 部分按字节即列直接跳过
+     */
+    static size_t columnAt(std::string_view text, size_t byte);
+
+    /**
+     * 覆盖第 column 列的字形簇的起始字节（column 超出整段宽度时为末尾），扫描方式同 columnAt
+     */
+    static size_t byteAt(std::string_view text, size_t column);
+
+    /**
+     * 第 units 个 UTF-16 码元（LSP 的列位置）对应的字节偏移（超出末尾时为 text.size()）
+     * 落在代理对中间时取该码点之后；无效字节按 1 个码元计
+     */
+    static size_t utf16ToByte(std::string_view text, size_t units);
+};
+
+/**
+ * 一行文本的稀疏显示列索引
+ * 每隔约 CHECKPOINT_BYTES 字节记录一个字形簇边界的 (字节, 显示列)，检查点按需向后延伸。
+ * columnAt/byteAt 的结果与 UnicodeWidth 的同名函数相同，但只从最近的检查点起扫描，
+ * 建好之后每次查询的开销与行长和位置无关。索引只对应一份文本：文本修改后由调用方 clear()
+ * （长度变化时也会自动重建）。
+ */
+class ColumnIndex {
+  public:
+    static constexpr size_t CHECKPOINT_BYTES = 4096;
+
+    /**
+     * byte 所在字形簇的起始显示列，同 UnicodeWidth::columnAt
+     */
+    size_t columnAt(std::string_view text, size_t byte);
+
+    /**
+     * 覆盖第 column 列的字形簇的起始字节，同 UnicodeWidth::byteAt
+     */
+    size_t byteAt(std::string_view text, size_t column);
+
+    void clear();
+
+  private:
+    struct Checkpoint {
+        size_t byte;
+        size_t column;
+    };
+
+    std::vector<Checkpoint> checkpoints_; // 按字节有序，第一个总是 (0, 0)
+    size_t length_ = 0;                   // 建立索引时的文本长度
+    bool complete_ = false;               // 已延伸到文本末尾
+
+    // 文本长度与索引不符时重新开始
+    void prepare(std::string_view text);
+    // 在最后一个检查点之后约 CHECKPOINT_BYTES 处追加一个检查点，已到末尾时返回 false
+    bool extend(std::string_view text);
+};
+
+} // namespace utils
+} // namespace pnana
+
+#endif // PNANA_UTILS_UNICODE_WIDTH_H
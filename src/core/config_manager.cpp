@@ -192,6 +192,38 @@ bool ConfigManager::parseJSON(const std::string& json_content) {
             }
         }
 
+        // 提取 undo_memory_limit_mb
+        size_t editor_end = cleaned.find('}', editor_pos);
+        size_t undo_pos = cleaned.find("\"undo_memory_limit_mb\":", editor_pos);
+        if (undo_pos != std::string::npos && undo_pos < editor_end) {
+            undo_pos += 23; // 跳过 "undo_memory_limit_mb":
+            size_t undo_end = cleaned.find_first_of(",}", undo_pos);
+            if (undo_end != std::string::npos) {
+                try {
+                    int limit = std::stoi(cleaned.substr(undo_pos, undo_end - undo_pos));
+                    config_.editor.undo_memory_limit_mb = std::max(1, limit);
+                } catch (...) {
+                    config_.editor.undo_memory_limit_mb = 64;
+                }
+            }
+        }
+
+        // 提取 crash_recovery
+        size_t recovery_pos = cleaned.find("\"crash_recovery\":", editor_pos);
+        if (recovery_pos != std::string::npos && recovery_pos < editor_end) {
+            recovery_pos += 17;                                         // 跳过 "crash_recovery":
+            std::string recovery_str = cleaned.substr(recovery_pos, 4); // "true" 或 "fals"
+            config_.editor.crash_recovery = (recovery_str.find("true") != std::string::npos);
+        }
+
+        // 提取 fsync_on_save
+        size_t fsync_pos = cleaned.find("\"fsync_on_save\":", editor_pos);
+        if (fsync_pos != std::string::npos && fsync_pos < editor_end) {
+            fsync_pos += 16;                                      // 跳过 "fsync_on_save":
+            std::string fsync_str = cleaned.substr(fsync_pos, 4); // "true" 或 "fals"
+            config_.editor.fsync_on_save = (fsync_str.find("true") != std::string::npos);
+        }
+
         // 提取其他 editor 配置（简化处理）
         // font_size, tab_size 等
     }
@@ -303,7 +335,11 @@ std::string ConfigManager::generateJSON() const {
     oss << "    \"tab_size\": " << config_.editor.tab_size << ",\n";
     oss << "    \"insert_spaces\": " << (config_.editor.insert_spaces ? "true" : "false") << ",\n";
     oss << "    \"word_wrap\": " << (config_.editor.word_wrap ? "true" : "false") << ",\n";
-    oss << "    \"auto_indent\": " << (config_.editor.auto_indent ? "true" : "false") << "\n";
+    oss << "    \"auto_indent\": " << (config_.editor.auto_indent ? "true" : "false") << ",\n";
+    oss << "    \"undo_memory_limit_mb\": " << config_.editor.undo_memory_limit_mb << ",\n";
+    oss << "    \"crash_recovery\": " << (config_.editor.crash_recovery ? "true" : "false")
+        << ",\n";
+    oss << "    \"fsync_on_save\": " << (config_.editor.fsync_on_save ? "true" : "false") << "\n";
     oss << "  },\n";
     oss << "  \"display\": {\n";
     oss << "    \"show_line_numbers\": " << (config_.display.show_line_numbers ? "true" : "false")
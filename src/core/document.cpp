@@ -1,30 +1,47 @@
 #include "core/document.h"
 #include "utils/logger.h"
+#include "utils/text_scanner.h"
 #include <algorithm>
-#include <cerrno>
-#include <cstdio>
-#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
-#include <sys/stat.h>
-#include <unistd.h>
 
 namespace pnana {
 namespace core {
 
+namespace {
+
+constexpr size_t LINE_ENDING_PROBE_BYTES = 1 << 20; // 映射加载时行尾检测的采样长度
+
+} // namespace
+
 Document::Document()
-    : filepath_(""), encoding_("UTF-8"), line_ending_(LineEnding::LF), modified_(false),
-      read_only_(false), is_binary_(false) {
+    : filepath_(""), encoding_("UTF-8"), line_ending_(LineEnding::LF), read_only_(false),
+      is_binary_(false) {
     lines_.push_back("");
-    original_lines_.push_back("");
 }
 
 Document::Document(const std::string& filepath) : Document() {
     load(filepath);
 }
 
+Document::~Document() {
+    // 后台保存不中途放弃
+    finishSaving();
+    // 没有未保存的修改时日志已无用；否则保留（例如退出时其他标签页仍有修改），下次打开时可恢复
+    if (journal_) {
+        journalEdits();
+        if (!isModified()) {
+            stopJournal();
+        }
+    }
+}
+
 bool Document::load(const std::string& filepath) {
+    // 停止上一次尚未完成的后台加载；正在进行的保存先完成
+    loader_.reset();
+    finishSaving();
+
     // 检查路径是否是目录
     try {
         if (std::filesystem::exists(filepath) && std::filesystem::is_directory(filepath)) {
@@ -35,193 +52,221 @@ bool Document::load(const std::string& filepath) {
         // 如果检查失败，继续尝试打开（可能是新文件）
     }
 
+    // 大文件使用内存映射 + 后台行索引，映射失败时退回普通读取
+    std::error_code size_error;
+    auto file_size = std::filesystem::file_size(filepath, size_error);
+    if (!size_error && file_size >= LAZY_LOAD_THRESHOLD && loadMapped(filepath)) {
+        return true;
+    }
+
     std::ifstream file(filepath, std::ios::binary);
     if (!file.is_open()) {
         // 如果文件不存在，创建新文件
         filepath_ = filepath;
         lines_.clear();
         lines_.push_back("");
-        modified_ = false;
+        resetVersion();
         return true;
     }
 
     lines_.clear();
-    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    // 按文件大小一次读入，避免 istreambuf_iterator 逐字符追加
+    std::string content;
+    if (!size_error) {
+        content.resize(static_cast<size_t>(file_size));
+        file.read(&content[0], static_cast<std::streamsize>(content.size()));
+        content.resize(static_cast<size_t>(file.gcount()));
+    } else {
+        content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
     file.close();
 
-    // 检测二进制文件
-    is_binary_ = false;
-    if (!content.empty()) {
-        // 检查是否包含大量空字符（二进制文件的典型特征）
-        size_t null_count = 0;
-        size_t check_size = std::min(content.size(), size_t(8192)); // 只检查前8KB
-        for (size_t i = 0; i < check_size; ++i) {
-            if (content[i] == '\0') {
-                null_count++;
-            }
-        }
-
-        // 如果前8KB中有超过1%的空字符，认为是二进制文件
-        if (null_count > check_size / 100) {
-            is_binary_ = true;
-        } else {
-            // 检查是否包含大量非可打印字符（排除常见的空白字符）
-            size_t non_printable = 0;
-            for (size_t i = 0; i < check_size; ++i) {
-                unsigned char ch = static_cast<unsigned char>(content[i]);
-                // 允许的字符：可打印字符、换行符、制表符、回车符
-                if (ch < 32 && ch != '\n' && ch != '\r' && ch != '\t') {
-                    non_printable++;
-                }
-            }
-
-            // 如果非可打印字符超过5%，认为是二进制文件
-            if (non_printable > check_size / 20) {
-                is_binary_ = true;
-            }
-        }
-    }
+    // 单次扫描同时完成二进制检测、行尾检测和行切分
+    utils::TextScanResult scan = utils::TextScanner::scan(content.data(), content.size());
+    is_binary_ = scan.looksBinary();
 
     // 如果是二进制文件，不解析内容
     if (is_binary_) {
         lines_.push_back("");
         filepath_ = filepath;
-        modified_ = false;
+        resetVersion();
         return true;
     }
 
     if (content.empty()) {
         lines_.push_back("");
     } else {
-        detectLineEnding(content);
-
-        std::istringstream iss(content);
-        std::string line;
-        while (std::getline(iss, line)) {
-            // 移除行尾的\r（如果有）
-            if (!line.empty() && line.back() == '\r') {
-                line.pop_back();
-            }
-            lines_.push_back(line);
-        }
-
-        // 如果内容以换行符结尾，添加空行
-        if (!content.empty() && (content.back() == '\n' || content.back() == '\r')) {
-            if (lines_.empty() || !lines_.back().empty()) {
-                lines_.push_back("");
-            }
-        }
+        detectLineEnding(scan);
+        // 先收集到连续的 vector，再整体移交给分块存储
+        lines_ = utils::TextScanner::splitLines(content, scan);
     }
 
     filepath_ = filepath;
-    modified_ = false;
-    // 保存原始内容快照
-    saveOriginalContent();
+    resetVersion();
     return true;
 }
 
-bool Document::save() {
-    if (filepath_.empty()) {
+bool Document::loadMapped(const std::string& filepath) {
+    std::string error;
+    std::shared_ptr<MappedFile> file = MappedFile::open(filepath, &error);
+    if (!file) {
+        LOG_WARNING("Memory-mapped load failed, falling back: " + error);
         return false;
     }
-    return saveAs(filepath_);
+
+    lines_.clear();
+    // 只扫描开头部分做二进制和行尾检测，完整的行索引交给后台线程
+    utils::TextScanResult probe = utils::TextScanner::scan(
+        file->data(), std::min(file->size(), LINE_ENDING_PROBE_BYTES), false);
+    is_binary_ = probe.looksBinary();
+    if (is_binary_) {
+        lines_.push_back("");
+        filepath_ = filepath;
+        resetVersion();
+        return true;
+    }
+
+    detectLineEnding(probe);
+
+    // 同步索引第一块，保证首屏可以立即渲染；其余部分交给后台线程
+    MappedLineChunk first;
+    size_t next_offset = 0;
+    bool reached_end = LazyLineLoader::scanChunk(*file, 0, first, next_offset);
+    lines_.appendMapped(file, first.base, first.bounds);
+    if (!reached_end) {
+        loader_ = std::make_unique<LazyLineLoader>(file, next_offset, load_notifier_);
+    }
+
+    filepath_ = filepath;
+    resetVersion();
+    LOG("Memory-mapped load started: " + filepath + " (" + std::to_string(file->size()) +
+        " bytes)");
+    return true;
 }
 
-bool Document::saveAs(const std::string& filepath) {
-    // nano风格的安全保存：
-    // 1. 获取原文件权限
-    // 2. 写入临时文件
-    // 3. 创建备份（可选）
-    // 4. 原子性替换原文件
-
-    struct stat file_stat;
-    bool file_exists = (stat(filepath.c_str(), &file_stat) == 0);
-    mode_t original_mode = file_exists ? file_stat.st_mode : 0644;
-
-    // 创建临时文件名
-    std::string temp_file = filepath + ".tmp~";
-
-    // 写入临时文件
-    {
-        std::ofstream file(temp_file, std::ios::binary | std::ios::trunc);
-        if (!file.is_open()) {
-            last_error_ = "Cannot create temporary file: " + std::string(strerror(errno));
-            return false;
-        }
+bool Document::pollLoading() {
+    if (!loader_) {
+        return false;
+    }
 
-        // 写入所有行
-        for (size_t i = 0; i < lines_.size(); ++i) {
-            file << lines_[i];
+    // 先判断是否完成再取结果，保证完成前发布的最后一批不会丢失
+    bool finished = loader_->isFinished();
+    if (finished) {
+        loader_->wait();
+    }
 
-            // 添加行尾（除了最后一行如果为空）
-            if (i < lines_.size() - 1 || !lines_.back().empty()) {
-                file << applyLineEnding(lines_[i]);
-            }
-        }
+    std::vector<MappedLineChunk> chunks = loader_->takeChunks();
+    for (const auto& chunk : chunks) {
+        lines_.appendMapped(loader_->file(), chunk.base, chunk.bounds);
+    }
 
-        // 检查写入是否成功
-        if (!file.good()) {
-            file.close();
-            std::remove(temp_file.c_str());
-            last_error_ = "Write error: " + std::string(strerror(errno));
-            return false;
-        }
+    if (finished) {
+        LOG("Memory-mapped load finished: " + std::to_string(lines_.size()) + " lines");
+        loader_.reset();
+    }
+    return finished || !chunks.empty();
+}
 
-        file.close();
+void Document::finishLoading() {
+    if (loader_) {
+        loader_->wait();
+        pollLoading();
+    }
+}
 
-        // 确保数据已写入磁盘
-        if (file.fail()) {
-            std::remove(temp_file.c_str());
-            last_error_ = "Failed to close temporary file";
-            return false;
-        }
+int Document::loadProgress() const {
+    if (!loader_ || loader_->file()->size() == 0) {
+        return 100;
     }
+    return static_cast<int>(loader_->scannedBytes() * 100 / loader_->file()->size());
+}
 
-    // 如果原文件存在，创建临时备份（用于安全保存）
-    std::string backup_file = filepath + "~";
-    bool backup_created = false;
+void Document::setLoadNotifier(std::function<void()> notifier) {
+    load_notifier_ = std::move(notifier);
+    if (loader_) {
+        loader_->setNotify(load_notifier_);
+    }
+    if (saver_) {
+        saver_->setNotify(load_notifier_);
+    }
+}
+
+bool Document::save() {
+    if (filepath_.empty()) {
+        return false;
+    }
+    return saveAs(filepath_);
+}
 
-    if (file_exists) {
-        // 删除旧备份
-        std::remove(backup_file.c_str());
+bool Document::saveAs(const std::string& filepath) {
+    // 保存前必须拿到完整内容
+    finishLoading();
+    finishSaving();
 
-        // 创建新备份
-        if (std::rename(filepath.c_str(), backup_file.c_str()) == 0) {
-            backup_created = true;
-        }
-        // 备份失败不是致命错误，继续保存
+    last_save_ = SaveJob::write(lines_, filepath, applyLineEnding(""), fsync_on_save_);
+    if (!last_save_.success) {
+        last_error_ = last_save_.error;
+        return false;
     }
+    completeSave(filepath, version_);
+    return true;
+}
 
-    // 原子性替换：重命名临时文件为目标文件
-    if (std::rename(temp_file.c_str(), filepath.c_str()) != 0) {
-        std::remove(temp_file.c_str());
-        // 如果备份存在，尝试恢复
-        if (backup_created) {
-            std::rename(backup_file.c_str(), filepath.c_str());
-        }
-        last_error_ = "Cannot rename temp file: " + std::string(strerror(errno));
+bool Document::startSave(const std::string& filepath) {
+    finishLoading();
+    if (saver_) {
+        last_error_ = "A save is already in progress";
+        return false;
+    }
+    saving_version_ = version_;
+    saver_ = std::make_unique<SaveJob>(lines_, filepath, applyLineEnding(""), fsync_on_save_,
+                                       load_notifier_);
+    return true;
+}
+
+bool Document::pollSaving() {
+    if (!saver_ || !saver_->isFinished()) {
         return false;
     }
+    saver_->wait();
+    last_save_ = saver_->result();
+    std::string filepath = saver_->filepath();
+    saver_.reset();
 
-    // 恢复原文件权限
-    if (file_exists) {
-        chmod(filepath.c_str(), original_mode);
+    if (!last_save_.success) {
+        last_error_ = last_save_.error;
+        return true;
     }
+    completeSave(filepath, saving_version_);
+    return true;
+}
 
-    // 保存成功后，删除备份文件（避免残留备份文件）
-    if (backup_created) {
-        std::remove(backup_file.c_str());
+void Document::finishSaving() {
+    if (saver_) {
+        saver_->wait();
+        pollSaving();
     }
+}
+
+int Document::saveProgress() const {
+    return saver_ ? saver_->progress() : 100;
+}
 
+void Document::completeSave(const std::string& filepath, uint64_t version) {
     // 更新文档状态
     filepath_ = filepath;
-    modified_ = false;
-    // 保存原始内容快照（保存后的内容就是新的原始内容）
-    saveOriginalContent();
-    clearHistory(); // 清除撤销历史，因为已经保存了
+    // 保留撤销历史：撤销/重做回到该版本时文档重新变为未修改
+    saved_version_ = version;
     last_error_.clear();
 
-    return true;
+    // 已保存的文件成为新的日志基准
+    stopJournal();
+    lines_.clearDirty();
+    startJournal();
+    if (journal_ && version != version_) {
+        // 后台保存期间又有修改：新日志以一条全文记录开始
+        journal_->compact(lines_);
+    }
 }
 
 bool Document::reload() {
@@ -240,14 +285,48 @@ const std::string& Document::getLine(size_t row) const {
 }
 
 std::string Document::getContent() const {
-    std::string content;
-    for (size_t i = 0; i < lines_.size(); ++i) {
-        content += lines_[i];
-        if (i < lines_.size() - 1) {
-            content += "\n"; // 添加换行符，除了最后一行
-        }
+    return snapshot().getContent();
+}
+
+DocumentSnapshot Document::snapshot() const {
+    return DocumentSnapshot(std::make_shared<const LineBuffer>(lines_), version_, filepath_);
+}
+
+bool Document::takeLineChanges(LineBuffer::ChangeTracker tracker, size_t& first, size_t& end,
+                               size_t& replaced) {
+    if (!lines_.hasChangedLines(tracker)) {
+        return false;
+    }
+    first = lines_.changedBegin(tracker);
+    end = lines_.changedEnd(tracker);
+    replaced = lines_.changedReplacedLines(tracker);
+    lines_.clearChanged(tracker);
+    return true;
+}
+
+void Document::syncColumnIndex() {
+    size_t first = 0;
+    size_t end = 0;
+    size_t replaced = 0;
+    if (takeLineChanges(LineBuffer::COLUMN_INDEX, first, end, replaced)) {
+        column_index_.applyChange(first, end, replaced);
     }
-    return content;
+}
+
+size_t Document::columnAt(size_t row, size_t byte) {
+    if (row >= lines_.size()) {
+        return 0;
+    }
+    syncColumnIndex();
+    return column_index_.columnAt(row, lines_.view(row), byte);
+}
+
+size_t Document::byteAt(size_t row, size_t column) {
+    if (row >= lines_.size()) {
+        return 0;
+    }
+    syncColumnIndex();
+    return column_index_.byteAt(row, lines_.view(row), column);
 }
 
 std::string Document::getFileName() const {
@@ -351,15 +430,37 @@ void Document::deleteChar(size_t row, size_t col) {
     }
 }
 
-void Document::deleteRange(size_t start_row, size_t /*start_col*/, size_t end_row,
-                           size_t /*end_col*/) {
+void Document::deleteRange(size_t start_row, size_t start_col, size_t end_row, size_t end_col) {
     if (start_row >= lines_.size() || end_row >= lines_.size()) {
         return;
     }
 
-    // 简化实现：后续可以优化
-    // 注意：这里没有调用 pushChange，因为这是一个简化的实现
-    // 如果需要完整的撤销支持，应该在这里记录删除的内容
+    // 确保开始位置在结束位置之前
+    if (start_row > end_row || (start_row == end_row && start_col > end_col)) {
+        std::swap(start_row, end_row);
+        std::swap(start_col, end_col);
+    }
+
+    start_col = std::min(start_col, lines_[start_row].length());
+    end_col = std::min(end_col, lines_[end_row].length());
+    if (start_row == end_row && start_col == end_col) {
+        return;
+    }
+
+    // 记录被删除的内容（用于撤销）
+    std::string deleted = getSelection(start_row, start_col, end_row, end_col);
+
+    if (start_row == end_row) {
+        lines_[start_row].erase(start_col, end_col - start_col);
+    } else {
+        // 合并首尾两行，再一次性删除中间的行（分块存储上为 O(log n + 删除行数)）
+        std::string tail = lines_[end_row].substr(end_col);
+        lines_[start_row].erase(start_col);
+        lines_[start_row] += tail;
+        lines_.erase(start_row + 1, end_row + 1);
+    }
+
+    pushChange(DocumentChange(DocumentChange::Type::DELETE, start_row, start_col, deleted, ""));
 }
 
 void Document::replaceLine(size_t row, const std::string& content) {
@@ -380,7 +481,7 @@ bool Document::undo(size_t* out_row, size_t* out_col, DocumentChange::Type* out_
     }
 
     DocumentChange change = undo_stack_.back();
-    undo_stack_.pop_back();
+    undo_stack_.popBack();
     LOG("[UNDO] Applying undo for operation: type=" +
         std::to_string(static_cast<int>(change.type)) + " row=" + std::to_string(change.row) +
         " col=" + std::to_string(change.col) +
@@ -549,7 +650,7 @@ bool Document::undo(size_t* out_row, size_t* out_col, DocumentChange::Type* out_
             } else {
                 // 尝试查找包含新行第一部分内容的行
                 for (size_t i = 0; i < lines_.size(); ++i) {
-                    if (lines_[i] == change.new_content && i + 1 < lines_.size()) {
+                    if (getLine(i) == change.new_content && i + 1 < lines_.size()) {
                         target_row = i;
                         found_target = true;
                         break;
@@ -632,7 +733,7 @@ bool Document::undo(size_t* out_row, size_t* out_col, DocumentChange::Type* out_
     }
 
     // 将操作移到重做栈（用于重做功能）
-    redo_stack_.push_back(change);
+    redo_stack_.push(change);
 
     // 返回操作类型（用于智能光标定位）
     if (out_type) {
@@ -645,11 +746,9 @@ bool Document::undo(size_t* out_row, size_t* out_col, DocumentChange::Type* out_
     LOG("[UNDO] Completed undo operation: type=" + std::to_string(static_cast<int>(change.type)) +
         " success=" + (success ? "true" : "false") + " cursor=" + cursor_pos);
 
-    // VSCode 行为：如果撤销栈为空，说明回到了初始状态，清除修改标志
-    if (undo_stack_.empty()) {
-        modified_ = false;
-        LOG("[UNDO] Reached initial state, cleared modified flag");
-    }
+    // 恢复修改前的版本号；回到保存时的版本即视为未修改
+    version_ = change.version_before;
+    journalEdits();
 
     return success;
 }
@@ -660,7 +759,7 @@ bool Document::redo(size_t* out_row, size_t* out_col) {
     }
 
     DocumentChange change = redo_stack_.back();
-    redo_stack_.pop_back();
+    redo_stack_.popBack();
     LOG("[REDO] Popped change: type=" + std::to_string(static_cast<int>(change.type)) +
         " row=" + std::to_string(change.row) + " col=" + std::to_string(change.col) +
         " old_len=" + std::to_string(change.old_content.length()) +
@@ -681,7 +780,24 @@ bool Document::redo(size_t* out_row, size_t* out_col) {
 
         case DocumentChange::Type::DELETE:
             if (change.row < lines_.size()) {
-                lines_[change.row].erase(change.col, change.old_content.length());
+                size_t last_newline = change.old_content.rfind('\n');
+                if (last_newline == std::string::npos) {
+                    lines_[change.row].erase(change.col, change.old_content.length());
+                } else {
+                    // 多行删除（deleteRange）：与 deleteRange 相同，合并首尾两行并删除中间的行
+                    size_t newlines = static_cast<size_t>(std::count(
+                        change.old_content.begin(), change.old_content.end(), '\n'));
+                    size_t end_row = std::min(change.row + newlines, lines_.size() - 1);
+                    size_t end_col = change.old_content.length() - last_newline - 1;
+                    std::string tail = end_col < lines_[end_row].length()
+                                           ? lines_[end_row].substr(end_col)
+                                           : std::string();
+                    lines_[change.row].erase(std::min(change.col, lines_[change.row].length()));
+                    lines_[change.row] += tail;
+                    if (end_row > change.row) {
+                        lines_.erase(change.row + 1, end_row + 1);
+                    }
+                }
             }
             // 光标应该回到删除开始的位置
             if (out_row)
@@ -758,15 +874,9 @@ bool Document::redo(size_t* out_row, size_t* out_col) {
             break;
     }
 
-    undo_stack_.push_back(change);
-
-    // 如果重做后撤销栈为空，说明回到了原始状态，清除修改状态
-    // 否则说明文件被修改了，设置修改状态为 true
-    if (undo_stack_.empty()) {
-        modified_ = false;
-    } else {
-        modified_ = true;
-    }
+    undo_stack_.push(change);
+    version_ = change.version_after;
+    journalEdits();
 
     return true;
 }
@@ -787,19 +897,20 @@ void Document::pushChange(const DocumentChange& change) {
         change.type == DocumentChange::Type::NEWLINE) {
         LOG("[PUSHCHANGE] Atomic operation: adding new undo point for " +
             std::to_string(static_cast<int>(change.type)));
-        undo_stack_.push_back(change);
-        if (undo_stack_.size() > MAX_UNDO_STACK) {
-            undo_stack_.pop_front();
-        }
+        DocumentChange recorded = change;
+        recorded.version_before = version_;
+        version_ = recorded.version_after = ++next_version_;
+        undo_stack_.push(recorded);
         redo_stack_.clear(); // 新的修改清除重做栈
-        modified_ = true;
+        journalEdits();
         return;
     }
 
     // 尝试合并连续的INSERT或DELETE操作
     if (!undo_stack_.empty()) {
-        DocumentChange& last_change = undo_stack_.back();
+        DocumentChange last_change = undo_stack_.back();
         auto time_diff = change.timestamp - last_change.timestamp;
+        bool merged = false;
 
         // 只在时间阈值内尝试合并
         if (time_diff < MERGE_THRESHOLD && change.row == last_change.row) {
@@ -812,8 +923,7 @@ void Document::pushChange(const DocumentChange& change) {
                     LOG("[PUSHCHANGE] Merging consecutive INSERT operations at row=" +
                         std::to_string(change.row));
                     last_change.new_content += change.new_content;
-                    last_change.timestamp = change.timestamp;
-                    return; // 合并完成，不创建新撤销点
+                    merged = true;
                 }
                 // 或者是在同一位置的插入（覆盖输入）
                 else if (change.col == last_change.col) {
@@ -821,8 +931,7 @@ void Document::pushChange(const DocumentChange& change) {
                         std::to_string(change.row) + " col=" + std::to_string(change.col));
                     // 这种情况较少见，但可能发生在快速输入时
                     last_change.new_content += change.new_content;
-                    last_change.timestamp = change.timestamp;
-                    return;
+                    merged = true;
                 }
             }
 
@@ -833,8 +942,7 @@ void Document::pushChange(const DocumentChange& change) {
                 if (change.col == last_change.col) {
                     LOG("[PUSHCHANGE] Merging consecutive forward DELETE operations");
                     last_change.old_content += change.old_content;
-                    last_change.timestamp = change.timestamp;
-                    return;
+                    merged = true;
                 }
                 // 向前删除（Backspace键）：位置连续
                 else if (change.col + change.old_content.length() == last_change.col) {
@@ -842,22 +950,30 @@ void Document::pushChange(const DocumentChange& change) {
                     // 将新的删除内容插入到开头
                     last_change.old_content = change.old_content + last_change.old_content;
                     last_change.col = change.col; // 更新删除起始位置
-                    last_change.timestamp = change.timestamp;
-                    return;
+                    merged = true;
                 }
             }
         }
+
+        if (merged) {
+            // 合并完成，不创建新撤销点
+            last_change.timestamp = change.timestamp;
+            version_ = last_change.version_after = ++next_version_;
+            undo_stack_.replaceBack(last_change);
+            journalEdits();
+            return;
+        }
     }
 
     // 创建新的撤销点
     LOG("[PUSHCHANGE] Creating new undo point for operation type=" +
         std::to_string(static_cast<int>(change.type)));
-    undo_stack_.push_back(change);
-    if (undo_stack_.size() > MAX_UNDO_STACK) {
-        undo_stack_.pop_front();
-    }
+    DocumentChange recorded = change;
+    recorded.version_before = version_;
+    version_ = recorded.version_after = ++next_version_;
+    undo_stack_.push(recorded);
     redo_stack_.clear(); // 新的修改清除重做栈
-    modified_ = true;
+    journalEdits();
 }
 
 void Document::clearHistory() {
@@ -865,6 +981,11 @@ void Document::clearHistory() {
     redo_stack_.clear();
 }
 
+void Document::setUndoByteBudget(size_t bytes) {
+    undo_stack_.setByteBudget(bytes);
+    redo_stack_.setByteBudget(bytes);
+}
+
 std::string Document::getSelection(size_t start_row, size_t start_col, size_t end_row,
                                    size_t end_col) const {
     if (start_row >= lines_.size() || end_row >= lines_.size()) {
@@ -895,10 +1016,10 @@ std::string Document::getSelection(size_t start_row, size_t start_col, size_t en
     return result;
 }
 
-void Document::detectLineEnding(const std::string& content) {
-    if (content.find("\r\n") != std::string::npos) {
+void Document::detectLineEnding(const utils::TextScanResult& scan) {
+    if (scan.crlf_count > 0) {
         line_ending_ = LineEnding::CRLF;
-    } else if (content.find('\r') != std::string::npos) {
+    } else if (scan.cr_count > 0) {
         line_ending_ = LineEnding::CR;
     } else {
         line_ending_ = LineEnding::LF;
@@ -917,34 +1038,186 @@ std::string Document::applyLineEnding(const std::string& /* line */) const {
     }
 }
 
-void Document::saveOriginalContent() {
-    original_lines_ = lines_;
+void Document::setModified(bool modified) {
+    if (modified) {
+        // 内容在撤销历史之外被修改：分配新版本号。
+        // 编辑器常在记录修改后再直接调整行内容，这部分无法单独撤销，
+        // 因此归入最近一条撤销记录，保证重做后版本号一致
+        uint64_t previous = version_;
+        version_ = ++next_version_;
+        if (!undo_stack_.empty() && undo_stack_.backVersionAfter() == previous) {
+            undo_stack_.setBackVersionAfter(version_);
+        }
+        journalEdits();
+    } else {
+        markSaved();
+    }
+}
+
+void Document::markSaved() {
+    saved_version_ = version_;
+}
+
+void Document::resetVersion() {
+    // 内容被整体替换：新版本号使旧的撤销记录无法再回到"未修改"状态
+    version_ = ++next_version_;
+    markSaved();
+
+    // 加载的内容即日志基准
+    lines_.clearDirty();
+    attachJournal();
+
+    // 内容整体替换，逐行词法状态和语法树全部重建
+    for (size_t i = 0; i < LineBuffer::CHANGE_TRACKER_COUNT; ++i) {
+        lines_.clearChanged(static_cast<LineBuffer::ChangeTracker>(i));
+    }
+    syntax_state_.reset();
+    highlight_state_.reset();
+    render_state_.reset();
+    column_index_.clear();
 }
 
-bool Document::isContentSameAsOriginal() const {
-    // 比较当前内容与原始内容是否完全相同
-    if (lines_.size() != original_lines_.size()) {
+void Document::attachJournal() {
+    // 之前的日志作废；内容与磁盘一致时若留有上次崩溃的日志，等待用户选择是否回放
+    stopJournal();
+    recovery_pending_ = false;
+    if (!journal_enabled_ || filepath_.empty() || is_binary_) {
+        return;
+    }
+    // 另一个实例正在编辑同一文件：它的日志不是崩溃遗留，也不能被覆盖，本文档不写日志
+    if (EditJournal::inUse(filepath_)) {
+        LOG_WARNING("Edit journal in use by another instance, crash recovery disabled: " +
+                    filepath_);
+        return;
+    }
+    EditJournal::Contents contents;
+    if (!lines_.hasDirtyLines() && EditJournal::read(filepath_, contents, nullptr) &&
+        !contents.records.empty()) {
+        if (EditJournal::baseMatches(contents)) {
+            recovery_pending_ = true;
+            LOG("Found edit journal from a previous session: " + filepath_);
+            return;
+        }
+        LOG_WARNING("Discarding edit journal, file changed on disk since it was written: " +
+                    filepath_);
+    }
+    startJournal();
+}
+
+void Document::setJournalEnabled(bool enabled) {
+    if (enabled == journal_enabled_) {
+        return;
+    }
+    journal_enabled_ = enabled;
+    attachJournal();
+    // 启用前已有的修改（加载以来的改动窗口）作为第一条记录
+    journalEdits();
+}
+
+void Document::startJournal() {
+    if (!journal_enabled_ || filepath_.empty() || is_binary_) {
+        return;
+    }
+    std::string error;
+    journal_ = EditJournal::create(filepath_, &error);
+    if (!journal_) {
+        LOG_WARNING("Crash recovery disabled for " + filepath_ + ": " + error);
+    }
+}
+
+void Document::stopJournal() {
+    if (journal_) {
+        journal_->discard();
+        journal_.reset();
+    }
+}
+
+void Document::journalEdits() {
+    if (!journal_ || !lines_.hasDirtyLines()) {
+        return;
+    }
+    // 撤销回保存点时内容未必逐字节还原（部分撤销记录是有损的），因此不据版本号清空日志
+    if (journal_->needsCompaction()) {
+        journal_->compact(lines_);
+    } else {
+        journal_->append(lines_, lines_.dirtyBegin(), lines_.dirtyEnd(),
+                         lines_.dirtyReplacedLines());
+    }
+    lines_.clearDirty();
+}
+
+bool Document::recoverFromJournal() {
+    if (!recovery_pending_) {
+        return false;
+    }
+    // 日志以完整的原文件为基准；等待选择期间已被编辑的内容不能再作为回放基准
+    finishLoading();
+    if (lines_.hasDirtyLines()) {
+        last_error_ = "Document was edited before recovery";
         return false;
     }
 
-    for (size_t i = 0; i < lines_.size(); ++i) {
-        if (lines_[i] != original_lines_[i]) {
-            return false;
+    EditJournal::Contents contents;
+    std::string error;
+    if (!EditJournal::read(filepath_, contents, &error)) {
+        last_error_ = "Cannot read journal: " + error;
+        discardRecoveryJournal();
+        return false;
+    }
+
+    size_t applied = 0;
+    for (auto& record : contents.records) {
+        size_t available = record.first <= lines_.size() ? lines_.size() - record.first : 0;
+        if (record.first > lines_.size() ||
+            (record.replaced != EditJournal::REPLACE_ALL && record.replaced > available)) {
+            LOG_WARNING("Edit journal record " + std::to_string(applied) +
+                        " does not match the document, stopping replay");
+            break;
         }
+        lines_.erase(record.first, record.first + std::min(record.replaced, available));
+        lines_.insert(record.first, std::move(record.lines));
+        ++applied;
+    }
+    if (lines_.empty()) {
+        lines_.push_back("");
     }
 
+    recovery_pending_ = false;
+    version_ = ++next_version_; // 与已保存版本不同：文档处于已修改状态
+    lines_.clearDirty();
+    LOG("Recovered " + std::to_string(applied) + " journal records for " + filepath_);
+
+    // 完整回放时日志本身就描述了当前内容，截掉损坏的尾部后继续追加；否则以全文重写
+    if (applied == contents.records.size()) {
+        journal_ = EditJournal::resume(filepath_, contents.valid_bytes, &error);
+    }
+    if (!journal_) {
+        startJournal();
+        if (journal_) {
+            journal_->compact(lines_);
+        }
+    }
     return true;
 }
 
+void Document::discardRecoveryJournal() {
+    recovery_pending_ = false;
+    std::error_code ec;
+    std::filesystem::remove(EditJournal::journalPath(filepath_), ec);
+    startJournal();
+}
+
 // 折叠范围管理
 void Document::setFoldingRanges(const std::vector<pnana::features::FoldingRange>& ranges) {
     folding_ranges_ = ranges;
     // 注意：不要在这里清理folded_lines_，因为setFolded方法会单独调用来设置折叠状态
+    fold_index_.rebuild(folding_ranges_, folded_lines_);
 }
 
 void Document::clearFoldingRanges() {
     folding_ranges_.clear();
     folded_lines_.clear();
+    fold_index_.clear();
 }
 
 void Document::setFolded(int start_line, bool folded) {
@@ -955,12 +1228,14 @@ void Document::setFolded(int start_line, bool folded) {
         for (const auto& range : folding_ranges_) {
             if (range.startLine == start_line) {
                 folded_lines_.insert(start_line);
+                fold_index_.rebuild(folding_ranges_, folded_lines_);
                 return;
             }
         }
         // no-op for debug
     } else {
         folded_lines_.erase(start_line);
+        fold_index_.rebuild(folding_ranges_, folded_lines_);
         // no-op for debug
     }
 }
@@ -970,13 +1245,7 @@ bool Document::isFolded(int line) const {
 }
 
 bool Document::isLineInFoldedRange(int line) const {
-    for (const auto& range : folding_ranges_) {
-        if (folded_lines_.count(range.startLine) && range.containsLine(line) &&
-            line != range.startLine) {
-            return true;
-        }
-    }
-    return false;
+    return line >= 0 && fold_index_.isHidden(static_cast<size_t>(line));
 }
 
 void Document::toggleFold(int start_line) {
@@ -989,6 +1258,7 @@ void Document::toggleFold(int start_line) {
 
 void Document::unfoldAll() {
     folded_lines_.clear();
+    fold_index_.clear();
 }
 
 void Document::foldAll() {
@@ -996,36 +1266,51 @@ void Document::foldAll() {
     for (const auto& range : folding_ranges_) {
         folded_lines_.insert(range.startLine);
     }
+    fold_index_.rebuild(folding_ranges_, folded_lines_);
 }
 
 std::vector<size_t> Document::getVisibleLines(size_t start_line, size_t end_line) const {
     std::vector<size_t> visible_lines;
     size_t max_line = std::min(end_line, lineCount() - 1);
 
-    for (size_t line = start_line; line <= max_line; ++line) {
-        if (!isLineInFoldedRange(static_cast<int>(line))) {
-            visible_lines.push_back(line);
-        }
+    // 跳过整段隐藏区间，不再逐行检查
+    for (size_t line = fold_index_.nextVisible(start_line); line <= max_line;
+         line = fold_index_.nextVisible(line + 1)) {
+        visible_lines.push_back(line);
     }
 
     return visible_lines;
 }
 
+std::vector<size_t> Document::getVisibleLineWindow(size_t first_display_line, size_t count) const {
+    std::vector<size_t> visible_lines;
+    size_t visible_count = getVisibleLineCount();
+    if (first_display_line >= visible_count) {
+        return visible_lines;
+    }
+    size_t line_count = lineCount();
+    visible_lines.reserve(std::min(count, visible_count - first_display_line));
+    for (size_t line = fold_index_.displayToActual(first_display_line);
+         line < line_count && visible_lines.size() < count;
+         line = fold_index_.nextVisible(line + 1)) {
+        visible_lines.push_back(line);
+    }
+    return visible_lines;
+}
+
 size_t Document::getVisibleLineCount() const {
-    return getVisibleLines(0, lineCount() - 1).size();
+    return fold_index_.visibleCount(lineCount());
 }
 
 size_t Document::displayLineToActualLine(size_t display_line) const {
-    auto visible_lines = getVisibleLines(0, lineCount() - 1);
-    if (display_line < visible_lines.size()) {
-        return visible_lines[display_line];
+    if (display_line < getVisibleLineCount()) {
+        return fold_index_.displayToActual(display_line);
     }
     return lineCount() - 1; // 返回最后一行
 }
 
 size_t Document::actualLineToDisplayLine(size_t actual_line) const {
-    auto visible_lines = getVisibleLines(0, actual_line);
-    return visible_lines.size() - 1; // 返回可见行索引
+    return fold_index_.actualToDisplay(std::min(actual_line, lineCount() - 1)); // 返回可见行索引
 }
 
 } // namespace core
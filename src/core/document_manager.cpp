@@ -4,7 +4,10 @@
 namespace pnana {
 namespace core {
 
-DocumentManager::DocumentManager() : current_index_(0), next_untitled_number_(1) {
+DocumentManager::DocumentManager()
+    : current_index_(0), next_untitled_number_(1),
+      undo_byte_budget_(UndoHistory::DEFAULT_BYTE_BUDGET), journal_enabled_(true),
+      fsync_on_save_(false) {
     // 不自动创建文档，让用户主动创建
 }
 
@@ -18,6 +21,9 @@ size_t DocumentManager::openDocument(const std::string& filepath) {
 
     // 创建新文档
     auto doc = std::make_unique<Document>(filepath);
+    doc->setUndoByteBudget(undo_byte_budget_);
+    doc->setJournalEnabled(journal_enabled_);
+    doc->setFsyncOnSave(fsync_on_save_);
     documents_.push_back(std::move(doc));
     size_t new_index = documents_.size() - 1;
     switchToDocument(new_index);
@@ -26,6 +32,9 @@ size_t DocumentManager::openDocument(const std::string& filepath) {
 
 size_t DocumentManager::createNewDocument() {
     auto doc = std::make_unique<Document>();
+    doc->setUndoByteBudget(undo_byte_budget_);
+    doc->setJournalEnabled(journal_enabled_);
+    doc->setFsyncOnSave(fsync_on_save_);
     documents_.push_back(std::move(doc));
     size_t new_index = documents_.size() - 1;
     next_untitled_number_++;
@@ -152,5 +161,26 @@ std::vector<DocumentManager::TabInfo> DocumentManager::getAllTabs() const {
     return tabs;
 }
 
+void DocumentManager::setUndoByteBudget(size_t bytes) {
+    undo_byte_budget_ = bytes;
+    for (auto& doc : documents_) {
+        doc->setUndoByteBudget(bytes);
+    }
+}
+
+void DocumentManager::setJournalEnabled(bool enabled) {
+    journal_enabled_ = enabled;
+    for (auto& doc : documents_) {
+        doc->setJournalEnabled(enabled);
+    }
+}
+
+void DocumentManager::setFsyncOnSave(bool enabled) {
+    fsync_on_save_ = enabled;
+    for (auto& doc : documents_) {
+        doc->setFsyncOnSave(enabled);
+    }
+}
+
 } // namespace core
 } // namespace pnana
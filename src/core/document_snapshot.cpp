@@ -0,0 +1,28 @@
+#include "core/document_snapshot.h"
+#include <algorithm>
+
+namespace pnana {
+namespace core {
+
+size_t DocumentSnapshot::contentSize(size_t max_lines) const {
+    const size_t count = std::min(max_lines, lines_->size());
+    size_t total = count > 0 ? count - 1 : 0;
+    lines_->forEachLine(0, count, [&total](std::string_view line) {
+        total += line.size();
+    });
+    return total;
+}
+
+std::string DocumentSnapshot::getContent(size_t max_lines) const {
+    std::string content;
+    content.reserve(contentSize(max_lines));
+    forEachChunk(
+        [&content](std::string_view chunk) {
+            content += chunk;
+        },
+        max_lines);
+    return content;
+}
+
+} // namespace core
+} // namespace pnana
@@ -0,0 +1,454 @@
+#include "core/edit_journal.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace pnana {
+namespace core {
+
+namespace {
+
+// 版本 2：负载长度和行长度为 64 位（版本 1 的 32 位长度在单条记录超过 4 GiB 时溢出）
+constexpr char JOURNAL_MAGIC[4] = {'P', 'N', 'J', '2'};
+constexpr size_t FRAME_HEADER_BYTES = 12; // 负载长度（64 位）+ 校验和
+
+void putU32(std::string& out, uint32_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void putU64(std::string& out, uint64_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// 从 data[pos] 读取定长整数，越界时返回 false
+template <typename T>
+bool getInt(const std::string& data, size_t end, size_t& pos, T& value) {
+    if (pos + sizeof(T) > end) {
+        return false;
+    }
+    std::memcpy(&value, data.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+uint32_t checksum(const char* data, size_t size) {
+    // FNV-1a：只用于发现写了一半的记录，不需要抗碰撞
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+size_t headerSize(const std::string& target) {
+    return sizeof(JOURNAL_MAGIC) + sizeof(uint32_t) + target.size() + 2 * sizeof(int64_t);
+}
+
+void baseStat(const std::string& target, int64_t& size, int64_t& mtime) {
+    std::error_code ec;
+    auto file_size = fs::file_size(target, ec);
+    if (ec) {
+        size = -1;
+        mtime = 0;
+        return;
+    }
+    size = static_cast<int64_t>(file_size);
+    auto write_time = fs::last_write_time(target, ec);
+    mtime = ec ? 0 : static_cast<int64_t>(write_time.time_since_epoch().count());
+}
+
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// 打开日志并加排他锁：锁在 fd 关闭（包括进程崩溃）时自动释放，
+// 因此加锁失败说明另一个实例正在写这份日志。失败时返回 -1，errno 为 EWOULDBLOCK
+int openLocked(const std::string& path, int flags) {
+    while (true) {
+        int fd = ::open(path.c_str(), flags | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            return -1;
+        }
+        if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+            int saved = errno;
+            ::close(fd);
+            errno = saved;
+            return -1;
+        }
+        // 等锁期间持有者可能已删除文件：锁住的是已被删除的 inode 时重新打开
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_nlink > 0) {
+            return fd;
+        }
+        ::close(fd);
+    }
+}
+
+std::string lockError(const std::string& what) {
+    if (errno == EWOULDBLOCK) {
+        return what + ": journal is in use by another instance";
+    }
+    return what + ": " + std::string(strerror(errno));
+}
+
+} // namespace
+
+EditJournal::EditJournal(int fd, std::string path, size_t header_size, size_t size,
+                         int64_t base_size)
+    : fd_(fd), path_(std::move(path)), header_size_(header_size), logical_size_(size),
+      compact_threshold_(
+          std::max(COMPACT_BYTES, 2 * static_cast<size_t>(std::max<int64_t>(base_size, 0)))) {}
+
+EditJournal::~EditJournal() {
+    stopWorker();
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+std::string EditJournal::journalPath(const std::string& target) {
+    std::error_code ec;
+    fs::path absolute = fs::absolute(target, ec);
+    std::string key = ec ? target : absolute.lexically_normal().string();
+
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+
+    const char* home = std::getenv("HOME");
+    fs::path dir = home ? fs::path(home) / ".config" / "pnana" / "journal"
+                        : fs::temp_directory_path(ec) / "pnana-journal";
+    return (dir / (fs::path(key).filename().string() + "." + hex + ".journal")).string();
+}
+
+std::unique_ptr<EditJournal> EditJournal::create(const std::string& target, std::string* error) {
+    std::string path = journalPath(target);
+    std::error_code ec;
+    fs::create_directories(fs::path(path).parent_path(), ec);
+
+    // 加锁之后才截断，不破坏另一个实例正在使用的日志
+    int fd = openLocked(path, O_WRONLY | O_CREAT | O_APPEND);
+    if (fd < 0 || ftruncate(fd, 0) != 0) {
+        if (error) {
+            *error = lockError("Cannot create journal");
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return nullptr;
+    }
+
+    int64_t base_size = 0;
+    int64_t base_mtime = 0;
+    baseStat(target, base_size, base_mtime);
+
+    std::string header(JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+    putU32(header, static_cast<uint32_t>(target.size()));
+    header += target;
+    putU64(header, static_cast<uint64_t>(base_size));
+    putU64(header, static_cast<uint64_t>(base_mtime));
+    // 头部很小，直接同步写入；落盘交给第一次组提交
+    if (!writeAll(fd, header.data(), header.size())) {
+        if (error) {
+            *error = "Cannot write journal: " + std::string(strerror(errno));
+        }
+        ::close(fd);
+        ::unlink(path.c_str());
+        return nullptr;
+    }
+
+    return std::unique_ptr<EditJournal>(
+        new EditJournal(fd, std::move(path), header.size(), header.size(), base_size));
+}
+
+std::unique_ptr<EditJournal> EditJournal::resume(const std::string& target, size_t valid_bytes,
+                                                 std::string* error) {
+    std::string path = journalPath(target);
+    int fd = openLocked(path, O_WRONLY | O_APPEND);
+    if (fd < 0 || ftruncate(fd, static_cast<off_t>(valid_bytes)) != 0) {
+        if (error) {
+            *error = lockError("Cannot reopen journal");
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return nullptr;
+    }
+    // 恢复时原文件与日志基准一致，其当前大小即基准大小
+    int64_t base_size = 0;
+    int64_t base_mtime = 0;
+    baseStat(target, base_size, base_mtime);
+    return std::unique_ptr<EditJournal>(
+        new EditJournal(fd, std::move(path), headerSize(target), valid_bytes, base_size));
+}
+
+bool EditJournal::read(const std::string& target, Contents& contents, std::string* error) {
+    std::ifstream file(journalPath(target), std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    size_t pos = 0;
+    uint32_t target_len = 0;
+    if (data.size() < sizeof(JOURNAL_MAGIC) ||
+        std::memcmp(data.data(), JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0) {
+        if (error) {
+            *error = "Invalid journal header";
+        }
+        return false;
+    }
+    pos = sizeof(JOURNAL_MAGIC);
+    if (!getInt(data, data.size(), pos, target_len) || pos + target_len > data.size()) {
+        if (error) {
+            *error = "Truncated journal header";
+        }
+        return false;
+    }
+    contents.target = data.substr(pos, target_len);
+    pos += target_len;
+    if (!getInt(data, data.size(), pos, contents.base_size) ||
+        !getInt(data, data.size(), pos, contents.base_mtime)) {
+        if (error) {
+            *error = "Truncated journal header";
+        }
+        return false;
+    }
+
+    contents.records.clear();
+    contents.valid_bytes = pos;
+    // 逐条读取；长度越界或校验失败说明是崩溃时未写完的尾部，之后的内容全部忽略
+    while (pos + FRAME_HEADER_BYTES <= data.size()) {
+        uint64_t length = 0;
+        uint32_t sum = 0;
+        getInt(data, data.size(), pos, length);
+        getInt(data, data.size(), pos, sum);
+        if (length > data.size() - pos || checksum(data.data() + pos, length) != sum) {
+            break;
+        }
+
+        size_t end = pos + length;
+        Record record;
+        uint64_t first = 0;
+        uint64_t replaced = 0;
+        uint64_t count = 0;
+        bool ok = getInt(data, end, pos, first) && getInt(data, end, pos, replaced) &&
+                  getInt(data, end, pos, count);
+        for (uint64_t i = 0; ok && i < count; ++i) {
+            uint64_t line_len = 0;
+            ok = getInt(data, end, pos, line_len) && line_len <= end - pos;
+            if (ok) {
+                record.lines.emplace_back(data, pos, line_len);
+                pos += line_len;
+            }
+        }
+        if (!ok) {
+            break;
+        }
+        record.first = static_cast<size_t>(first);
+        record.replaced = static_cast<size_t>(replaced);
+        contents.records.push_back(std::move(record));
+        pos = end;
+        contents.valid_bytes = end;
+    }
+    return true;
+}
+
+bool EditJournal::inUse(const std::string& target) {
+    int fd = ::open(journalPath(target).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    bool locked = flock(fd, LOCK_SH | LOCK_NB) != 0 && errno == EWOULDBLOCK;
+    ::close(fd);
+    return locked;
+}
+
+bool EditJournal::baseMatches(const Contents& contents) {
+    int64_t size = 0;
+    int64_t mtime = 0;
+    baseStat(contents.target, size, mtime);
+    return size == contents.base_size && (size < 0 || mtime == contents.base_mtime);
+}
+
+void EditJournal::append(const LineBuffer& lines, size_t first, size_t end, size_t replaced) {
+    std::string frame;
+    putU64(frame, 0); // 长度和校验和稍后回填
+    putU32(frame, 0);
+    putU64(frame, first);
+    putU64(frame, replaced);
+    putU64(frame, end - first);
+    // 只读视图：映射块中未修改的行不会被转换为 std::string
+    lines.forEachLine(first, end, [&frame](std::string_view line) {
+        putU64(frame, line.size());
+        frame.append(line.data(), line.size());
+    });
+    uint64_t length = frame.size() - FRAME_HEADER_BYTES;
+    uint32_t sum = checksum(frame.data() + FRAME_HEADER_BYTES, length);
+    std::memcpy(&frame[0], &length, sizeof(length));
+    std::memcpy(&frame[sizeof(length)], &sum, sizeof(sum));
+
+    startWorker();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (failed_) {
+            return;
+        }
+        pending_ += frame;
+        ++queued_seq_;
+    }
+    logical_size_ += frame.size();
+    wake_.notify_one();
+}
+
+void EditJournal::reset() {
+    startWorker();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.clear();
+        truncate_pending_ = true;
+        ++queued_seq_;
+    }
+    logical_size_ = header_size_;
+    wake_.notify_one();
+}
+
+void EditJournal::compact(const LineBuffer& lines) {
+    reset();
+    append(lines, 0, lines.size(), REPLACE_ALL);
+    compact_threshold_ = std::max(COMPACT_BYTES, logical_size_ * 2);
+}
+
+void EditJournal::flush() {
+    if (!worker_.joinable()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t target = queued_seq_;
+    flush_requested_ = true;
+    wake_.notify_one();
+    durable_.wait(lock, [this, target]() {
+        return durable_seq_ >= target || failed_;
+    });
+}
+
+void EditJournal::discard() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.clear();
+        truncate_pending_ = false;
+        failed_ = true; // 之后的记录不再写入
+    }
+    stopWorker();
+    // 先删除再关闭（释放锁），其他实例不会锁住一个随即被删除的文件
+    if (fd_ >= 0) {
+        ::unlink(path_.c_str());
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void EditJournal::startWorker() {
+    if (!worker_.joinable()) {
+        worker_ = std::thread(&EditJournal::run, this);
+    }
+}
+
+void EditJournal::stopWorker() {
+    if (!worker_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_one();
+    worker_.join();
+}
+
+void EditJournal::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this]() {
+            return stop_ || flush_requested_ || queued_seq_ != durable_seq_;
+        });
+        if (queued_seq_ == durable_seq_) {
+            if (stop_) {
+                break;
+            }
+            flush_requested_ = false;
+            continue;
+        }
+
+        // 组提交：等待一个提交间隔，让期间的连续按键合并为一次 write + fsync
+        if (!stop_ && !flush_requested_) {
+            wake_.wait_for(lock, COMMIT_INTERVAL, [this]() {
+                return stop_ || flush_requested_;
+            });
+        }
+
+        std::string batch;
+        batch.swap(pending_);
+        bool truncate = truncate_pending_;
+        truncate_pending_ = false;
+        flush_requested_ = false;
+        uint64_t seq = queued_seq_;
+        bool skip = failed_;
+        lock.unlock();
+
+        bool ok = true;
+        if (!skip) {
+            if (truncate && ftruncate(fd_, static_cast<off_t>(header_size_)) != 0) {
+                ok = false;
+            }
+            if (ok && !batch.empty() && !writeAll(fd_, batch.data(), batch.size())) {
+                ok = false;
+            }
+            if (ok && fsync(fd_) != 0) {
+                ok = false;
+            }
+            if (!ok) {
+                LOG_WARNING("Edit journal write failed, crash recovery disabled: " + path_ +
+                            " (" + std::string(strerror(errno)) + ")");
+            }
+        }
+
+        lock.lock();
+        if (!ok) {
+            failed_ = true;
+            pending_.clear();
+        }
+        durable_seq_ = seq;
+        durable_.notify_all();
+    }
+}
+
+} // namespace core
+} // namespace pnana
@@ -6,6 +6,7 @@
 #include "ui/icons.h"
 #include "utils/file_type_detector.h"
 #include "utils/logger.h"
+#include "utils/text_scanner.h"
 #ifdef BUILD_LUA_SUPPORT
 #include "plugins/plugin_manager.h"
 #endif
@@ -54,7 +55,9 @@ Editor::Editor()
       last_debug_stats_time_(std::chrono::steady_clock::now()), rendering_paused_(false),
       needs_render_(false), last_call_time_(std::chrono::steady_clock::now()),
       last_render_time_(std::chrono::steady_clock::now()), pending_cursor_update_(false),
-      screen_(ScreenInteractive::Fullscreen()) {
+      screen_(ScreenInteractive::Fullscreen()), background_highlighter_([this] {
+          screen_.PostEvent(Event::Custom);
+      }) {
     // 初始化 last_rendered_element_ 为有效的 ftxui 元素，避免空元素导致的崩溃
     last_rendered_element_ = ftxui::text("Initializing...");
     // 确保首次调用 renderUI() 时不会被增量渲染逻辑跳过，强制进行一次完整渲染
@@ -126,6 +129,15 @@ void Editor::run() {
     screen_.PostEvent(Event::Custom);
     screen_.Loop(main_component_);
 
+    // 屏幕退出后不再接收后台加载的通知
+    for (size_t i = 0; i < document_manager_.getDocumentCount(); ++i) {
+        if (Document* doc = document_manager_.getDocument(i)) {
+            doc->setLoadNotifier(nullptr);
+        }
+    }
+    // 后台搜索的通知同样指向 screen_，退出前取消
+    search_engine_.clearSearch();
+
 #ifdef BUILD_LSP_SUPPORT
     // 清理 LSP 客户端
     shutdownLsp();
@@ -160,6 +172,8 @@ void Editor::zoomReset() {
 
 void Editor::setTheme(const std::string& theme_name) {
     theme_.setTheme(theme_name);
+    // 同名主题的配色也可能被重新加载，直接丢弃已缓存的行
+    line_render_cache_.clear();
 
     // 更新配置并保存
     auto& config = config_manager_.getConfig();
@@ -178,8 +192,17 @@ void Editor::loadConfig(const std::string& config_path) {
     // 加载配置文件
     config_manager_.loadConfig(config_path);
 
-    // 从配置获取主题名称并应用
     const auto& config = config_manager_.getConfig();
+
+    // 撤销历史内存上限
+    document_manager_.setUndoByteBudget(static_cast<size_t>(config.editor.undo_memory_limit_mb)
+                                        << 20);
+    // 崩溃恢复日志（启用时已打开的文档可能发现上次留下的日志）
+    document_manager_.setJournalEnabled(config.editor.crash_recovery);
+    offerJournalRecovery();
+    document_manager_.setFsyncOnSave(config.editor.fsync_on_save);
+
+    // 从配置获取主题名称并应用
     std::string theme_name = config.current_theme;
     if (theme_name.empty()) {
         theme_name = config.editor.theme;
@@ -479,15 +502,11 @@ bool Editor::isMarkdownPreviewActive() const {
     return markdown_preview_enabled_;
 }
 
-ftxui::Element Editor::renderMarkdownPreview() {
-    // Render preview using MarkdownRenderer directly (lightweight)
-    pnana::features::MarkdownRenderConfig cfg;
-    int half_width = std::max(10, getScreenWidth() / 2 - 4);
-    cfg.max_width = half_width;
-    cfg.use_color = true;
-    cfg.theme = theme_.getCurrentThemeName();
+// 渲染 Markdown 内容；渲染结果没有可见字符时退回纯文本
+static ftxui::Element renderMarkdownContent(const std::string& content,
+                                            const pnana::features::MarkdownRenderConfig& cfg,
+                                            int height) {
     pnana::features::MarkdownRenderer renderer(cfg);
-    std::string content = getCurrentDocumentContent();
     if (content.empty())
         return ftxui::text("");
 
@@ -495,8 +514,7 @@ ftxui::Element Editor::renderMarkdownPreview() {
 
     // Diagnostic/fallback: render to an off-screen buffer and check if visible characters exist.
     try {
-        int height = std::max(10, getScreenHeight() - 6);
-        ftxui::Screen screen(half_width, height);
+        ftxui::Screen screen(cfg.max_width, height);
         ftxui::Render(screen, elem);
         std::string out = screen.ToString();
         // check for any non-space visible characters
@@ -524,6 +542,36 @@ ftxui::Element Editor::renderMarkdownPreview() {
     return elem;
 }
 
+ftxui::Element Editor::renderMarkdownPreview() {
+    // Render preview using MarkdownRenderer directly (lightweight)
+    pnana::features::MarkdownRenderConfig cfg;
+    int half_width = std::max(10, getScreenWidth() / 2 - 4);
+    cfg.max_width = half_width;
+    cfg.use_color = true;
+    cfg.theme = theme_.getCurrentThemeName();
+    int height = std::max(10, getScreenHeight() - 6);
+
+    const Document* doc = getCurrentDocument();
+    if (!doc)
+        return ftxui::text("");
+    // 内容未变（同一文档的同一版本）时不再重新解析和试渲染
+    if (markdown_preview_cache_ && markdown_preview_doc_ == doc &&
+        markdown_preview_path_ == doc->getFilePath() &&
+        markdown_preview_version_ == doc->getVersion() && markdown_preview_width_ == half_width &&
+        markdown_preview_height_ == height && markdown_preview_theme_ == cfg.theme) {
+        return markdown_preview_cache_;
+    }
+    DocumentSnapshot snapshot = doc->snapshot();
+    markdown_preview_doc_ = doc;
+    markdown_preview_path_ = snapshot.filepath();
+    markdown_preview_version_ = snapshot.version();
+    markdown_preview_width_ = half_width;
+    markdown_preview_height_ = height;
+    markdown_preview_theme_ = cfg.theme;
+    markdown_preview_cache_ = renderMarkdownContent(snapshot.getContent(), cfg, height);
+    return markdown_preview_cache_;
+}
+
 std::string Editor::getCurrentDocumentContent() const {
     const Document* doc = getCurrentDocument();
     if (!doc) {
@@ -785,28 +833,8 @@ void Editor::convertFileEncoding(const std::string& new_encoding) {
             std::string utf8_content =
                 features::EncodingConverter::encodingToUtf8(new_file_bytes, new_encoding);
 
-            // 更新文档内容
-            std::vector<std::string> new_lines;
-            std::istringstream iss(utf8_content);
-            std::string line;
-            while (std::getline(iss, line)) {
-                // 移除行尾的\r（如果有）
-                if (!line.empty() && line.back() == '\r') {
-                    line.pop_back();
-                }
-                new_lines.push_back(line);
-            }
-
-            // 如果内容以换行符结尾，添加空行
-            if (!utf8_content.empty() &&
-                (utf8_content.back() == '\n' || utf8_content.back() == '\r')) {
-                if (new_lines.empty() || !new_lines.back().empty()) {
-                    new_lines.push_back("");
-                }
-            }
-
-            // 更新文档行
-            doc->getLines() = new_lines;
+            // 更新文档内容（与 Document::load 使用相同的切分规则）
+            doc->getLines() = utils::TextScanner::splitLines(utf8_content);
             doc->setModified(false);
         } else {
             // 如果文件为空，重新加载
@@ -1090,6 +1118,63 @@ void Editor::setStatusMessage(const std::string& message) {
     status_message_ = message;
 }
 
+void Editor::pollDocumentLoading() {
+    for (size_t i = 0; i < document_manager_.getDocumentCount(); ++i) {
+        Document* doc = document_manager_.getDocument(i);
+        if (!doc) {
+            continue;
+        }
+        if (doc->isSaving()) {
+            bool finished = doc->pollSaving();
+            if (doc == getCurrentDocument()) {
+                if (finished) {
+                    showSaveResult(doc);
+                } else {
+                    setStatusMessage(std::string(pnana::ui::icons::SAVED) + " Saving " +
+                                     doc->getFileName() + "... " +
+                                     std::to_string(doc->saveProgress()) + "%");
+                }
+                force_ui_update_ = true;
+            }
+        }
+        if (!doc->isLoading()) {
+            continue;
+        }
+        doc->pollLoading();
+        if (doc != getCurrentDocument()) {
+            continue;
+        }
+        if (doc->isLoading()) {
+            setStatusMessage(std::string(pnana::ui::icons::OPEN) + " Loading " +
+                             doc->getFileName() + "... " + std::to_string(doc->loadProgress()) +
+                             "%");
+        } else {
+            setStatusMessage(std::string(pnana::ui::icons::OPEN) + " Opened: " +
+                             doc->getFileName() + " (" + std::to_string(doc->lineCount()) +
+                             " lines)");
+        }
+        force_ui_update_ = true;
+    }
+}
+
+void Editor::showSaveResult(Document* doc) {
+    const SaveJob::Result& result = doc->getLastSaveResult();
+    if (result.success) {
+        // nano风格：显示写入的行数
+        setStatusMessage(std::string(pnana::ui::icons::SAVED) + " Wrote " +
+                         std::to_string(result.lines) + " lines (" +
+                         std::to_string(result.bytes) + " bytes) to " + doc->getFileName());
+        return;
+    }
+
+    // 显示详细错误信息
+    if (doc->getLastError().empty()) {
+        setStatusMessage(std::string(pnana::ui::icons::ERROR) + " Failed to save file");
+    } else {
+        setStatusMessage(std::string(pnana::ui::icons::ERROR) + " Error: " + doc->getLastError());
+    }
+}
+
 std::string Editor::getFileType() const {
     const Document* doc = getCurrentDocument();
     if (!doc) {
@@ -1386,6 +1471,7 @@ void Editor::openDocumentInActiveRegion(const std::string& file_path) {
     if (new_doc_index == static_cast<size_t>(-1)) {
         return; // 打开失败
     }
+    offerJournalRecovery();
 
     // 设置为激活区域的文档
     if (split_view_manager_.hasSplits()) {
@@ -1,63 +1,8 @@
 // 光标移动相关实现
 
-#include <cstddef>
-#include <string>
-
-// 获取UTF-8字符的辅助函数
-std::string getUtf8CharAt(const std::string& str, size_t pos) {
-    if (pos >= str.length()) {
-        return " ";
-    }
-
-    unsigned char first_byte = static_cast<unsigned char>(str[pos]);
-
-    // 单字节ASCII字符
-    if ((first_byte & 0x80) == 0) {
-        return str.substr(pos, 1);
-    }
-
-    // 多字节UTF-8字符
-    int bytes_needed;
-    if ((first_byte & 0xE0) == 0xC0) {
-        bytes_needed = 2;
-    } else if ((first_byte & 0xF0) == 0xE0) {
-        bytes_needed = 3;
-    } else if ((first_byte & 0xF8) == 0xF0) {
-        bytes_needed = 4;
-    } else {
-        // 无效的UTF-8，退回到单字节
-        return str.substr(pos, 1);
-    }
-
-    // 确保有足够的字节
-    if (pos + bytes_needed > str.length()) {
-        return str.substr(pos, 1);
-    }
-
-    return str.substr(pos, bytes_needed);
-}
-
-// 检查字符是否为中文字符（保留用于可能的未来功能）
-bool isChineseChar(const std::string& ch) {
-    if (ch.length() < 3) {
-        return false;
-    }
-
-    // 中文UTF-8范围：E4-B8-80 到 E9-BF-BF (基本汉字)
-    if (ch.length() == 3) {
-        unsigned char b1 = static_cast<unsigned char>(ch[0]);
-        unsigned char b2 = static_cast<unsigned char>(ch[1]);
-        unsigned char b3 = static_cast<unsigned char>(ch[2]);
-
-        // 基本检查：是否为3字节UTF-8且在中文范围内
-        return (b1 >= 0xE4 && b1 <= 0xE9) && (b2 >= 0x80 && b2 <= 0xBF) &&
-               (b3 >= 0x80 && b3 <= 0xBF);
-    }
-
-    return false;
-}
 #include "core/editor.h"
 #include "utils/logger.h"
+#include "utils/unicode_width.h"
 #include <algorithm>
 
 namespace pnana {
@@ -74,24 +19,12 @@ void Editor::moveCursorUp() {
     if (!doc)
         return;
 
-    // 获取可见行列表
-    std::vector<size_t> visible_lines = doc->getVisibleLines();
-    if (visible_lines.empty())
-        return;
-
-    // 找到当前光标在可见行中的位置
-    size_t current_visible_index = 0;
-    for (size_t i = 0; i < visible_lines.size(); ++i) {
-        if (visible_lines[i] == cursor_row_) {
-            current_visible_index = i;
-            break;
-        }
-    }
+    // 找到当前光标在可见行中的位置（折叠索引，O(log 折叠数)）
+    size_t current_visible_index = doc->actualLineToDisplayLine(cursor_row_);
 
     // 如果不是第一行，移动到上一可见行
     if (current_visible_index > 0) {
-        cursor_row_ = visible_lines[current_visible_index - 1];
-        adjustCursor();
+        moveCursorToRow(doc->displayLineToActualLine(current_visible_index - 1));
         // 立即调整视图偏移，使光标移动更流畅
         adjustViewOffset();
     }
@@ -110,24 +43,12 @@ void Editor::moveCursorDown() {
     if (!doc)
         return;
 
-    // 获取可见行列表
-    std::vector<size_t> visible_lines = doc->getVisibleLines();
-    if (visible_lines.empty())
-        return;
-
-    // 找到当前光标在可见行中的位置
-    size_t current_visible_index = 0;
-    for (size_t i = 0; i < visible_lines.size(); ++i) {
-        if (visible_lines[i] == cursor_row_) {
-            current_visible_index = i;
-            break;
-        }
-    }
+    // 找到当前光标在可见行中的位置（折叠索引，O(log 折叠数)）
+    size_t current_visible_index = doc->actualLineToDisplayLine(cursor_row_);
 
     // 如果不是最后一行，移动到下一可见行
-    if (current_visible_index < visible_lines.size() - 1) {
-        cursor_row_ = visible_lines[current_visible_index + 1];
-        adjustCursor();
+    if (current_visible_index + 1 < doc->getVisibleLineCount()) {
+        moveCursorToRow(doc->displayLineToActualLine(current_visible_index + 1));
         // 立即调整视图偏移，使光标移动更流畅
         adjustViewOffset();
     }
@@ -150,21 +71,8 @@ void Editor::moveCursorLeft() {
     const std::string& line = doc->getLine(cursor_row_);
 
     if (cursor_col_ > 0) {
-        // Nano风格：向左移动到前一个字符的起始位置
-        // 从当前位置向前查找UTF-8字符的起始位置
-        size_t new_pos = cursor_col_ - 1;
-
-        // 如果当前位置不是UTF-8字符的起始，找到前一个字符的起始
-        while (new_pos > 0) {
-            unsigned char byte = static_cast<unsigned char>(line[new_pos]);
-            // 检查是否为UTF-8字符的起始字节
-            if ((byte & 0xC0) != 0x80) { // 不是延续字节
-                break;
-            }
-            new_pos--;
-        }
-
-        cursor_col_ = new_pos;
+        // Nano风格：向左移动到前一个字形簇的开头（组合字符、emoji 序列整体跳过）
+        cursor_col_ = utils::UnicodeWidth::prevGrapheme(line, cursor_col_);
     } else if (cursor_row_ > 0) {
         cursor_row_--;
         cursor_col_ = doc->getLine(cursor_row_).length();
@@ -189,20 +97,8 @@ void Editor::moveCursorRight() {
     size_t line_len = line.length();
 
     if (cursor_col_ < line_len) {
-        // Nano风格：向右移动到下一个字符的起始位置
-        // 从当前位置开始查找下一个UTF-8字符的起始位置
-        size_t new_pos = cursor_col_;
-
-        // 跳过当前字符
-        std::string current_char = getUtf8CharAt(line, new_pos);
-        new_pos += current_char.length();
-
-        // 确保不超过行长度
-        if (new_pos > line_len) {
-            new_pos = line_len;
-        }
-
-        cursor_col_ = new_pos;
+        // Nano风格：向右移动到下一个字形簇的开头
+        cursor_col_ = utils::UnicodeWidth::nextGrapheme(line, cursor_col_);
     } else if (cursor_row_ < doc->lineCount() - 1) {
         cursor_row_++;
         cursor_col_ = 0;
@@ -231,6 +127,8 @@ void Editor::moveCursorPageUp() {
     // 计算当前光标在可见区域中的位置
     size_t cursor_visible_row =
         (cursor_row_ >= view_offset_row_) ? (cursor_row_ - view_offset_row_) : 0;
+    // 翻页前后保持光标的显示列
+    const size_t column = cursorDisplayColumn();
 
     // 向上滚动一页：视图向上移动一页
     size_t old_view_offset = view_offset_row_;
@@ -243,11 +141,6 @@ void Editor::moveCursorPageUp() {
     // 如果视图已经到达顶部，将光标移到文件开头（保持列位置）
     if (view_offset_row_ == 0 && old_view_offset == 0) {
         cursor_row_ = 0;
-        // 保持列位置，但确保不超过行长度
-        size_t line_len = doc->getLine(0).length();
-        if (cursor_col_ > line_len) {
-            cursor_col_ = line_len;
-        }
     } else {
         // 保持光标在屏幕中的相对位置，但确保在新视图范围内
         // 如果光标原本在屏幕上半部分，移到新视图顶部；否则保持相对位置
@@ -266,6 +159,7 @@ void Editor::moveCursorPageUp() {
     }
 
     adjustCursor();
+    cursor_col_ = doc->byteAt(cursor_row_, column);
     // 确保视图偏移正确（处理边界情况）
     adjustViewOffset();
 }
@@ -289,6 +183,8 @@ void Editor::moveCursorPageDown() {
     // 计算当前光标在可见区域中的位置
     size_t cursor_visible_row =
         (cursor_row_ >= view_offset_row_) ? (cursor_row_ - view_offset_row_) : 0;
+    // 翻页前后保持光标的显示列
+    const size_t column = cursorDisplayColumn();
 
     // 向下滚动一页：视图向下移动一页
     size_t max_offset =
@@ -303,10 +199,6 @@ void Editor::moveCursorPageDown() {
     // 如果视图已经到达底部，将光标移到文件末尾（保持列位置，但确保不超过行长度）
     if (view_offset_row_ == max_offset && old_view_offset == max_offset && max_offset > 0) {
         cursor_row_ = total_lines - 1;
-        size_t line_len = doc->getLine(cursor_row_).length();
-        if (cursor_col_ > line_len) {
-            cursor_col_ = line_len;
-        }
     } else {
         // 保持光标在屏幕中的相对位置，但确保在新视图范围内
         // 如果光标原本在屏幕下半部分，移到新视图底部；否则保持相对位置
@@ -330,6 +222,7 @@ void Editor::moveCursorPageDown() {
     }
 
     adjustCursor();
+    cursor_col_ = doc->byteAt(cursor_row_, column);
     // 确保视图偏移正确（处理边界情况）
     adjustViewOffset();
 }
@@ -499,6 +392,26 @@ void Editor::adjustCursor() {
     }
 }
 
+size_t Editor::cursorDisplayColumn() {
+    Document* doc = getCurrentDocument();
+    if (!doc || cursor_row_ >= doc->lineCount()) {
+        return cursor_col_;
+    }
+    // 长行由文档按行缓存的检查点换算，不必从行首扫描
+    return doc->columnAt(cursor_row_, cursor_col_);
+}
+
+void Editor::moveCursorToRow(size_t row) {
+    Document* doc = getCurrentDocument();
+    if (!doc) {
+        return;
+    }
+    const size_t column = cursorDisplayColumn();
+    cursor_row_ = row;
+    adjustCursor();
+    cursor_col_ = doc->byteAt(cursor_row_, column);
+}
+
 void Editor::adjustViewOffset() {
     // 统一计算屏幕高度：减去标签栏(1) + 分隔符(1) + 状态栏(1) + 输入框(1) + 帮助栏(1) + 分隔符(1) =
     // 6行
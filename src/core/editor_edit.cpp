@@ -3,6 +3,7 @@
 #include "core/editor.h"
 #include "utils/clipboard.h"
 #include "utils/logger.h"
+#include "utils/unicode_width.h"
 #include <iostream>
 #include <sstream>
 
@@ -385,8 +386,7 @@ void Editor::extendSelectionUp() {
     }
     // 直接移动光标，不调用 moveCursorUp（避免取消选中）
     if (cursor_row_ > 0) {
-        cursor_row_--;
-        adjustCursor();
+        moveCursorToRow(cursor_row_ - 1);
         adjustViewOffset();
     }
 }
@@ -397,8 +397,7 @@ void Editor::extendSelectionDown() {
     }
     // 直接移动光标，不调用 moveCursorDown（避免取消选中）
     if (cursor_row_ < getCurrentDocument()->lineCount() - 1) {
-        cursor_row_++;
-        adjustCursor();
+        moveCursorToRow(cursor_row_ + 1);
         adjustViewOffset();
     }
 }
@@ -409,7 +408,8 @@ void Editor::extendSelectionLeft() {
     }
     // 直接移动光标，不调用 moveCursorLeft（避免取消选中）
     if (cursor_col_ > 0) {
-        cursor_col_--;
+        cursor_col_ = utils::UnicodeWidth::prevGrapheme(getCurrentDocument()->getLine(cursor_row_),
+                                                        cursor_col_);
     } else if (cursor_row_ > 0) {
         cursor_row_--;
         cursor_col_ = getCurrentDocument()->getLine(cursor_row_).length();
@@ -423,9 +423,9 @@ void Editor::extendSelectionRight() {
         startSelection();
     }
     // 直接移动光标，不调用 moveCursorRight（避免取消选中）
-    size_t line_len = getCurrentDocument()->getLine(cursor_row_).length();
-    if (cursor_col_ < line_len) {
-        cursor_col_++;
+    const std::string& line = getCurrentDocument()->getLine(cursor_row_);
+    if (cursor_col_ < line.length()) {
+        cursor_col_ = utils::UnicodeWidth::nextGrapheme(line, cursor_col_);
     } else if (cursor_row_ < getCurrentDocument()->lineCount() - 1) {
         cursor_row_++;
         cursor_col_ = 0;
@@ -2,7 +2,6 @@
 #include "core/editor.h"
 #include "ui/icons.h"
 #include "utils/logger.h"
-#include "utils/text_analyzer.h"
 #include <filesystem>
 #include <iostream>
 
@@ -33,50 +32,19 @@ bool Editor::openFile(const std::string& filepath) {
         }
 
         LOG("Document obtained, line count: " + std::to_string(doc->lineCount()));
-        LOG("Step 3: Detecting Chinese content (limited check)...");
-
-        // 检测文件是否包含大量中文字符（排除注释）
-        // 限制检测行数和字符数，避免大文件卡住
-        bool has_chinese = false;
-        try {
-            std::string file_type = getFileType();
-            LOG("File type: " + file_type);
-
-            // 只检测前50行，避免大文件卡住
-            size_t max_check_lines = std::min(doc->lineCount(), static_cast<size_t>(50));
-            LOG("Checking first " + std::to_string(max_check_lines) + " lines");
-
-            std::vector<std::string> lines;
-            for (size_t i = 0; i < max_check_lines; ++i) {
-                lines.push_back(doc->getLine(i));
-            }
-
-            LOG("Lines collected, checking Chinese content...");
-            // 限制检测字符数为500，加快处理速度
-            has_chinese = utils::TextAnalyzer::hasChineseContent(lines, file_type, 500, 10);
-            LOG("Chinese detection completed, result: " +
-                std::string(has_chinese ? "true" : "false"));
-        } catch (const std::exception& e) {
-            LOG_WARNING("Chinese detection exception: " + std::string(e.what()));
-            has_chinese = false; // 检测失败，默认不禁用语法高亮
-        } catch (...) {
-            LOG_WARNING("Chinese detection unknown exception");
-            has_chinese = false;
+        if (doc->isLoading()) {
+            // 大文件：后台继续建立行索引，每有新结果就触发一次刷新
+            doc->setLoadNotifier([this]() {
+                screen_.PostEvent(ftxui::Event::Custom);
+            });
         }
-
-        LOG("Step 4: Setting syntax highlighter...");
-        // 更新语法高亮器（中文文件禁用语法高亮）
+        LOG("Step 3: Setting syntax highlighter...");
+        // 更新语法高亮器（含中日韩文字的文件同样高亮，显示列由 Unicode 宽度表计算）
         try {
-            if (has_chinese) {
-                syntax_highlighting_ = false;
-                syntax_highlighter_.setFileType("text");
-                LOG("Syntax highlighting disabled (Chinese file)");
-            } else {
-                std::string file_type = getFileType();
-                syntax_highlighter_.setFileType(file_type);
-                syntax_highlighting_ = true; // 确保语法高亮开启
-                LOG("Syntax highlighting enabled, file type: " + file_type);
-            }
+            std::string file_type = getFileType();
+            syntax_highlighter_.setFileType(file_type);
+            syntax_highlighting_ = true; // 确保语法高亮开启
+            LOG("Syntax highlighting enabled, file type: " + file_type);
         } catch (const std::exception& e) {
             LOG_WARNING("Syntax highlighter exception: " + std::string(e.what()));
         } catch (...) {
@@ -84,7 +52,7 @@ bool Editor::openFile(const std::string& filepath) {
         }
 
 #ifdef BUILD_LSP_SUPPORT
-        LOG("Step 5: Updating LSP document...");
+        LOG("Step 4: Updating LSP document...");
         // 通知 LSP 服务器文件已打开
         // 注意：如果 LSP 初始化失败或文件类型不支持，不应该阻塞文件打开
         try {
@@ -100,10 +68,10 @@ bool Editor::openFile(const std::string& filepath) {
             // LSP 更新失败不影响文件打开
         }
 #else
-        LOG("Step 5: LSP support not compiled");
+        LOG("Step 4: LSP support not compiled");
 #endif
 
-        LOG("Step 6: Setting status message...");
+        LOG("Step 5: Setting status message...");
         // 使用之前已获取的doc变量
         if (doc) {
             setStatusMessage(std::string(pnana::ui::icons::OPEN) +
@@ -141,6 +109,8 @@ bool Editor::openFile(const std::string& filepath) {
             }
         }
 
+        offerJournalRecovery();
+
         LOG("=== openFile() SUCCESS ===");
         return true;
     } catch (const std::exception& e) {
@@ -158,7 +128,7 @@ bool Editor::openFile(const std::string& filepath) {
     }
 }
 
-bool Editor::saveFile() {
+bool Editor::saveFile(bool wait) {
     Document* doc = getCurrentDocument();
     if (!doc)
         return false;
@@ -170,28 +140,34 @@ bool Editor::saveFile() {
         return false;
     }
 
-    size_t line_count = doc->lineCount();
-    size_t byte_count = 0;
-    for (size_t i = 0; i < line_count; ++i) {
-        byte_count += doc->getLine(i).length() + 1; // +1 for newline
+    if (doc->isSaving() && wait) {
+        // 先完成上一次后台保存，再保存当前内容
+        doc->finishSaving();
+    }
+    if (doc->isSaving()) {
+        setStatusMessage(std::string(pnana::ui::icons::WARNING) + " Still saving " +
+                         doc->getFileName() + "... " + std::to_string(doc->saveProgress()) + "%");
+        return false;
     }
 
-    if (doc->save()) {
-        // nano风格：显示写入的行数
-        std::string msg = std::string(pnana::ui::icons::SAVED) + " Wrote " +
-                          std::to_string(line_count) + " lines (" + std::to_string(byte_count) +
-                          " bytes) to " + doc->getFileName();
-        setStatusMessage(msg);
+    // 大文件：在后台写出当前内容的快照，期间可以继续编辑，结果由 pollDocumentLoading() 显示
+    if (!wait && doc->lineCount() >= Document::BACKGROUND_SAVE_LINES) {
+        doc->setLoadNotifier([this]() {
+            screen_.PostEvent(ftxui::Event::Custom);
+        });
+        if (!doc->startSave(doc->getFilePath())) {
+            setStatusMessage(std::string(pnana::ui::icons::ERROR) + " Error: " +
+                             doc->getLastError());
+            return false;
+        }
+        setStatusMessage(std::string(pnana::ui::icons::SAVED) + " Saving " + doc->getFileName() +
+                         "...");
         return true;
     }
 
-    // 显示详细错误信息
-    std::string error_msg = std::string(pnana::ui::icons::ERROR) + " Error: " + doc->getLastError();
-    if (error_msg.empty() || doc->getLastError().empty()) {
-        error_msg = std::string(pnana::ui::icons::ERROR) + " Failed to save file";
-    }
-    setStatusMessage(error_msg);
-    return false;
+    bool saved = doc->save();
+    showSaveResult(doc);
+    return saved;
 }
 
 bool Editor::saveFileAs(const std::string& filepath) {
@@ -199,12 +175,6 @@ bool Editor::saveFileAs(const std::string& filepath) {
     if (!doc)
         return false;
 
-    size_t line_count = doc->lineCount();
-    size_t byte_count = 0;
-    for (size_t i = 0; i < line_count; ++i) {
-        byte_count += doc->getLine(i).length() + 1; // +1 for newline
-    }
-
     if (doc->saveAs(filepath)) {
         // 更新语法高亮器（文件类型可能改变）
         syntax_highlighter_.setFileType(getFileType());
@@ -228,9 +198,10 @@ bool Editor::saveFileAs(const std::string& filepath) {
         }
 
         // nano风格：显示写入的行数
+        const SaveJob::Result& result = doc->getLastSaveResult();
         std::string msg = std::string(pnana::ui::icons::SAVED) + " Wrote " +
-                          std::to_string(line_count) + " lines (" + std::to_string(byte_count) +
-                          " bytes) to " + filepath;
+                          std::to_string(result.lines) + " lines (" +
+                          std::to_string(result.bytes) + " bytes) to " + filepath;
         setStatusMessage(msg);
         return true;
     }
@@ -346,6 +317,71 @@ void Editor::startSaveAs() {
     }
 }
 
+void Editor::offerJournalRecovery() {
+    if (dialog_.isVisible()) {
+        // 文档保持等待选择的状态，稍后再问（见 handleInput）
+        journal_recovery_queued_ = true;
+        return;
+    }
+    journal_recovery_queued_ = false;
+    // 一次询问所有留有崩溃日志的文档（对话框回调中不能再弹出新的对话框）
+    std::vector<std::string> paths;
+    std::string names;
+    for (size_t i = 0; i < document_manager_.getDocumentCount(); ++i) {
+        Document* doc = document_manager_.getDocument(i);
+        if (doc && doc->hasRecoveryJournal()) {
+            paths.push_back(doc->getFilePath());
+            names += "\n  " + doc->getFileName();
+        }
+    }
+    if (paths.empty()) {
+        return;
+    }
+
+    dialog_.showConfirm(
+        "Recover Unsaved Changes",
+        "Found unsaved changes from a session that did not exit cleanly:" + names +
+            "\n\nRecover them?",
+        [this, paths]() {
+            size_t recovered = 0;
+            for (const auto& path : paths) {
+                int index = document_manager_.findDocumentByPath(path);
+                if (index < 0) {
+                    continue;
+                }
+                Document* doc = document_manager_.getDocument(static_cast<size_t>(index));
+                if (!doc) {
+                    continue;
+                }
+                if (doc->recoverFromJournal()) {
+                    recovered++;
+                } else {
+                    LOG_ERROR("Journal recovery failed for " + path + ": " + doc->getLastError());
+                }
+            }
+            adjustCursor();
+            if (recovered == paths.size()) {
+                setStatusMessage(std::string(pnana::ui::icons::SUCCESS) +
+                                 " Recovered unsaved changes in " + std::to_string(recovered) +
+                                 " file(s)");
+            } else {
+                setStatusMessage(std::string(pnana::ui::icons::ERROR) + " Recovered " +
+                                 std::to_string(recovered) + " of " +
+                                 std::to_string(paths.size()) + " file(s), see log");
+            }
+        },
+        [this, paths]() {
+            for (const auto& path : paths) {
+                int index = document_manager_.findDocumentByPath(path);
+                if (index >= 0) {
+                    document_manager_.getDocument(static_cast<size_t>(index))
+                        ->discardRecoveryJournal();
+                }
+            }
+            setStatusMessage("Discarded unsaved changes from the previous session");
+        });
+}
+
 void Editor::quit() {
     Document* doc = getCurrentDocument();
     if (doc && doc->isModified()) {
@@ -5,6 +5,8 @@
 #include "input/key_action.h"
 #include "ui/icons.h"
 #include "utils/logger.h"
+#include "utils/unicode_width.h"
+#include <algorithm>
 #include <filesystem>
 #include <ftxui/component/event.hpp>
 #include <iostream>
@@ -19,11 +21,18 @@ namespace core {
 
 // 事件处理
 void Editor::handleInput(Event event) {
+    // 打开文件时因其他对话框推迟的崩溃恢复询问
+    if (journal_recovery_queued_ && !dialog_.isVisible()) {
+        offerJournalRecovery();
+    }
+
     // 特殊处理Event::Custom（我们的渲染触发事件）
     if (event == Event::Custom) {
         LOG("[DEBUG EVENT] Received Event::Custom - this should trigger a render update");
-        // Event::Custom是我们手动触发的渲染更新事件，不需要额外处理
-        // 直接返回，让FTXUI重新渲染
+        // Event::Custom是我们手动触发的渲染更新事件，只需取回大文件后台加载和后台搜索的结果
+        // 然后直接返回，让FTXUI重新渲染
+        pollDocumentLoading();
+        pollSearchResults();
         return;
     }
 
@@ -1044,8 +1053,7 @@ void Editor::handleNormalMode(Event event) {
         }
         // 直接移动光标，不调用 moveCursorUp（避免取消选中）
         if (cursor_row_ > 0) {
-            cursor_row_--;
-            adjustCursor();
+            moveCursorToRow(cursor_row_ - 1);
             adjustViewOffset();
         }
     } else if (event == Event::ArrowDownCtrl) {
@@ -1059,8 +1067,7 @@ void Editor::handleNormalMode(Event event) {
         }
         // 直接移动光标，不调用 moveCursorDown（避免取消选中）
         if (cursor_row_ < getCurrentDocument()->lineCount() - 1) {
-            cursor_row_++;
-            adjustCursor();
+            moveCursorToRow(cursor_row_ + 1);
             adjustViewOffset();
         }
     } else if (event == Event::ArrowLeftCtrl) {
@@ -1074,7 +1081,8 @@ void Editor::handleNormalMode(Event event) {
         }
         // 直接移动光标，不调用 moveCursorLeft（避免取消选中）
         if (cursor_col_ > 0) {
-            cursor_col_--;
+            cursor_col_ = utils::UnicodeWidth::prevGrapheme(
+                getCurrentDocument()->getLine(cursor_row_), cursor_col_);
         } else if (cursor_row_ > 0) {
             cursor_row_--;
             cursor_col_ = getCurrentDocument()->getLine(cursor_row_).length();
@@ -1091,9 +1099,9 @@ void Editor::handleNormalMode(Event event) {
             startSelection();
         }
         // 直接移动光标，不调用 moveCursorRight（避免取消选中）
-        size_t line_len = getCurrentDocument()->getLine(cursor_row_).length();
-        if (cursor_col_ < line_len) {
-            cursor_col_++;
+        const std::string& line = getCurrentDocument()->getLine(cursor_row_);
+        if (cursor_col_ < line.length()) {
+            cursor_col_ = utils::UnicodeWidth::nextGrapheme(line, cursor_col_);
         } else if (cursor_row_ < getCurrentDocument()->lineCount() - 1) {
             cursor_row_++;
             cursor_col_ = 0;
@@ -1503,11 +1511,15 @@ void Editor::performSearch(const std::string& pattern, const features::SearchOpt
         return;
     }
 
+    current_search_options_ = options;
+
     // 执行搜索
     const auto& lines = getCurrentDocument()->getLines();
-    search_engine_.search(pattern, lines, options);
-
-    current_search_options_ = options;
+    if (lines.size() >= features::SearchEngine::PARALLEL_MIN_LINES) {
+        startBackgroundSearch(pattern, options, true);
+        return;
+    }
+    search_engine_.search(pattern, *getCurrentDocument(), options);
 
     if (search_engine_.hasMatches()) {
         search_highlight_active_ = true;
@@ -1557,18 +1569,22 @@ void Editor::performReplace(const std::string& replacement) {
         return;
     }
 
+    // 修改文档后 match 指向的匹配会被更新，先记下位置
+    const size_t row = match->line;
+    const size_t column = match->column;
+
     // 删除匹配的文本
-    doc->deleteRange(match->line, match->column, match->line, match->column + match->length);
+    doc->deleteRange(row, column, row, column + match->length);
 
     // 插入替换文本
     if (!replacement.empty()) {
-        doc->insertText(match->line, match->column, replacement);
+        doc->insertText(row, column, replacement);
     }
 
-    // 重新搜索以更新匹配
-    const auto& pattern = search_engine_.getPattern();
-    const auto& lines = doc->getLines();
-    search_engine_.search(pattern, lines, current_search_options_);
+    // 只重新搜索改动的行，其余匹配平移；当前匹配移到替换文本之后的下一个
+    // （替换文本本身可能包含模式，如 "foo" 替换为 "foobar"，不能再选中它）
+    search_engine_.applyEdits(*doc);
+    search_engine_.jumpToMatchAt(row, column + replacement.size());
 
     // 更新搜索结果显示
     if (search_engine_.hasMatches()) {
@@ -1584,12 +1600,18 @@ void Editor::performReplace(const std::string& replacement) {
 }
 
 void Editor::performReplaceAll(const std::string& replacement) {
-    if (!getCurrentDocument() || !search_highlight_active_ || !search_engine_.hasMatches()) {
+    Document* doc = getCurrentDocument();
+    if (doc && search_highlight_active_) {
+        // 后台搜索进行中时匹配列表还不完整（增量搜索还把可见区域之前的匹配另外攒着），
+        // 先让结果跟上最近的修改，再等搜索完成
+        search_engine_.applyEdits(*doc);
+        search_engine_.finish();
+    }
+    if (!doc || !search_highlight_active_ || !search_engine_.hasMatches()) {
         setStatusMessage("No active search to replace");
         return;
     }
 
-    Document* doc = getCurrentDocument();
     const auto& matches = search_engine_.getAllMatches();
     size_t replaced_count = 0;
 
@@ -1682,7 +1704,21 @@ void Editor::executeSearch(bool move_cursor) {
     }
 
     features::SearchOptions options;
-    search_engine_.search(input_buffer_, getCurrentDocument()->getLines(), options);
+    Document* doc = getCurrentDocument();
+    // 边输入边搜索：延长上一次的模式时只确认上一次的匹配位置；大文档先出可见行的结果，
+    // 其余部分在后台完成，下一次按键时取消
+    features::SearchScope scope;
+    scope.first_visible = view_offset_row_;
+    scope.last_visible = view_offset_row_ + static_cast<size_t>(std::max(1, screen_.dimy() - 6));
+    search_engine_.searchIncremental(input_buffer_, *doc, options, scope, [this]() {
+        screen_.PostEvent(Event::Custom);
+    });
+    if (search_engine_.isSearching()) {
+        search_jump_pending_ = move_cursor;
+        search_highlight_active_ = true;
+        pollSearchResults();
+        return;
+    }
 
     if (search_engine_.hasMatches()) {
         const auto* match = search_engine_.getCurrentMatch();
@@ -1703,6 +1739,50 @@ void Editor::executeSearch(bool move_cursor) {
     }
 }
 
+void Editor::startBackgroundSearch(const std::string& pattern,
+                                   const features::SearchOptions& options, bool move_cursor) {
+    // 工作线程每完成一批就请求重绘，由 handleInput 中的 Event::Custom 取回结果
+    search_engine_.searchAsync(pattern, *getCurrentDocument(), options, [this]() {
+        screen_.PostEvent(Event::Custom);
+    });
+    search_jump_pending_ = move_cursor;
+    search_highlight_active_ = true;
+    search_dialog_.updateResults(0, 0);
+    setStatusMessage("Searching for: " + pattern + "...");
+}
+
+void Editor::pollSearchResults() {
+    if (!search_engine_.isSearching()) {
+        return;
+    }
+    search_engine_.pollResults();
+
+    // 匹配按行序陆续到达：第一屏的结果先显示，匹配计数随后台进度增长
+    const std::string pattern = search_engine_.getPattern();
+    const size_t total = search_engine_.getTotalMatches();
+    if (total > 0) {
+        search_dialog_.updateResults(search_engine_.getCurrentMatchIndex(), total);
+        const auto* match = search_engine_.getCurrentMatch();
+        if (search_jump_pending_ && match) {
+            search_jump_pending_ = false;
+            cursor_row_ = match->line;
+            cursor_col_ = match->column;
+            adjustViewOffset();
+        }
+    }
+
+    if (search_engine_.isSearching()) {
+        setStatusMessage("Found " + std::to_string(total) + " matches for: " + pattern +
+                         " (searching...)");
+    } else if (total > 0) {
+        setStatusMessage("Found " + std::to_string(total) + " matches for: " + pattern);
+    } else {
+        search_highlight_active_ = false;
+        setStatusMessage("No matches found for: " + pattern);
+    }
+    force_ui_update_ = true;
+}
+
 void Editor::executeReplace() {
     setStatusMessage("Replace feature coming soon!");
 }
@@ -491,26 +491,16 @@ void Editor::updateLspDocument() {
 
         LOG("LSP: Client is connected, proceeding with document update");
 
-        // 获取文档内容
-        std::string content;
-        size_t line_count = doc->lineCount();
-
-        // 限制读取的行数，避免大文件卡住（最多读取前1000行）
-        size_t max_lines = std::min(line_count, static_cast<size_t>(1000));
-
-        for (size_t i = 0; i < max_lines; ++i) {
-            content += doc->getLine(i);
-            if (i < max_lines - 1) {
-                content += "\n";
-            }
-        }
+        // 获取文档内容快照：客户端按行转义后直接写入消息，不拼接整个文档
+        DocumentSnapshot snapshot = doc->snapshot();
+        LOG("[LSP_UPDATE] Snapshot version: " + std::to_string(snapshot.version()));
 
         // 检查是否已经打开过
         if (file_language_map_.find(uri) == file_language_map_.end()) {
             // 首次打开，发送 didOpen（同步发送以确保文档被正确添加）
             LOG("[LSP_UPDATE] Sending didOpen for new document: " + uri);
             try {
-                client->didOpen(uri, language_id, content);
+                client->didOpen(uri, language_id, snapshot);
                 LOG("[LSP_UPDATE] didOpen sent successfully");
 
                 // 初始化折叠管理器
@@ -571,7 +561,7 @@ void Editor::updateLspDocument() {
             pending_document_version_ = version + 1;
 
             try {
-                client->didChange(uri, content, version);
+                client->didChange(uri, snapshot, version);
                 LOG("[LSP_UPDATE] didChange sent successfully (version: " +
                     std::to_string(version) + ")");
                 // Schedule folding ranges refresh for this document (debounced by request manager).
@@ -809,7 +799,8 @@ void Editor::triggerCompletion() {
         editor_left_offset += file_browser_width_ + 1; // file browser + separator
     }
     int line_number_width = show_line_numbers_ ? 6 : 0; // 估算行号宽度（包含空格）
-    int relative_col = static_cast<int>(cursor_col_) - static_cast<int>(view_offset_col_);
+    int relative_col =
+        static_cast<int>(cursorDisplayColumn()) - static_cast<int>(view_offset_col_);
     if (relative_col < 0)
         relative_col = 0;
     int cursor_screen_col = editor_left_offset + line_number_width + relative_col;
@@ -1294,7 +1285,7 @@ void Editor::toggleFold() {
         return;
     }
 
-    bool was_modified = doc->isModified();
+    // 折叠只改变显示，不修改内容：文档的版本号和修改状态都保持不变
     int cursor_line = static_cast<int>(cursor_row_);
 
     const auto& ranges = folding_manager_->getFoldingRanges();
@@ -1321,7 +1312,6 @@ void Editor::toggleFold() {
             }
 
             setStatusMessage(now_folded ? "Folded" : "Unfolded");
-            doc->setModified(was_modified);
             force_ui_update_ = true;
             last_render_time_ = std::chrono::steady_clock::now() - std::chrono::milliseconds(200);
             return;
@@ -1347,7 +1337,6 @@ void Editor::toggleFold() {
             }
 
             setStatusMessage(now_folded ? "Folded" : "Unfolded");
-            doc->setModified(was_modified);
             force_ui_update_ = true;
             last_render_time_ = std::chrono::steady_clock::now() - std::chrono::milliseconds(200);
             return;
@@ -1381,7 +1370,6 @@ void Editor::toggleFold() {
         }
 
         setStatusMessage(now_folded ? "Folded" : "Unfolded");
-        doc->setModified(was_modified);
         force_ui_update_ = true;
         last_render_time_ = std::chrono::steady_clock::now() - std::chrono::milliseconds(200);
         return;
@@ -1411,15 +1399,10 @@ void Editor::foldAll() {
     if (!doc)
         return;
 
-    // 保存当前的修改状态
-    bool was_modified = doc->isModified();
-
+    // 折叠不修改内容，文档的版本号和修改状态保持不变
     folding_manager_->foldAll();
     setStatusMessage("Folded all regions");
 
-    // 恢复修改状态（折叠不应该改变文件的修改状态）
-    doc->setModified(was_modified);
-
     // 强制UI更新
     force_ui_update_ = true;
     last_render_time_ = std::chrono::steady_clock::now() - std::chrono::milliseconds(200);
@@ -1433,15 +1416,10 @@ void Editor::unfoldAll() {
     if (!doc)
         return;
 
-    // 保存当前的修改状态
-    bool was_modified = doc->isModified();
-
+    // 折叠不修改内容，文档的版本号和修改状态保持不变
     folding_manager_->unfoldAll();
     setStatusMessage("Unfolded all regions");
 
-    // 恢复修改状态（折叠不应该改变文件的修改状态）
-    doc->setModified(was_modified);
-
     // 强制UI更新
     force_ui_update_ = true;
     last_render_time_ = std::chrono::steady_clock::now() - std::chrono::milliseconds(200);
@@ -5,6 +5,7 @@
 #include "ui/create_folder_dialog.h"
 #include "ui/cursor_config_dialog.h"
 #include "ui/icons.h"
+#include "ui/line_decorations.h"
 #include "ui/new_file_prompt.h"
 #include "ui/save_as_dialog.h"
 #include "ui/statusbar.h"
@@ -15,6 +16,7 @@
 #include "features/image_preview.h"
 #endif
 #include "utils/logger.h"
+#include "utils/unicode_width.h"
 
 using namespace pnana::ui::icons;
 
@@ -78,6 +80,34 @@ using namespace ftxui;
 namespace pnana {
 namespace core {
 
+// 水平滚动时光标与左右边缘至少保留的列数（类似 Vim 的 sidescrolloff）
+static const size_t SIDE_SCROLL_OFF = 8;
+// 行文本在可见列之外多取的列数，终端对个别字符的宽度与宽度表不一致时右侧也不会留空
+static const size_t WINDOW_MARGIN_COLUMNS = 16;
+
+// 从 pos 向右走 columns 列后的位置（按字形簇前进，宽度取自 Unicode 宽度表）
+static size_t forwardColumns(const std::string& line, size_t pos, size_t columns) {
+    while (pos < line.length() && columns > 0) {
+        columns -= std::min<size_t>(columns, utils::UnicodeWidth::graphemeWidth(line, pos));
+        pos = utils::UnicodeWidth::nextGrapheme(line, pos);
+    }
+    return pos;
+}
+
+// 水平滚动后的起始显示列：光标所在的显示列 cursor 落在 [first_col 起的 width 列) 内，
+// 并与两侧边缘保留 SIDE_SCROLL_OFF 列。各行从同一显示列开始，渲染时逐行换算为字节偏移
+static size_t followCursorColumn(size_t cursor, size_t first_col, size_t width) {
+    const size_t keep = std::min(SIDE_SCROLL_OFF, width / 4); // 窄窗口时少保留一些
+    if (cursor < first_col + keep) {
+        return cursor > keep ? cursor - keep : 0;
+    }
+    const size_t span = width > keep + 1 ? width - keep - 1 : 0;
+    if (cursor <= first_col + span) {
+        return first_col;
+    }
+    return cursor - span;
+}
+
 // UI渲染
 Element Editor::renderUI() {
     // 检查是否暂停渲染
@@ -363,6 +393,18 @@ Element Editor::renderTabbar() {
 }
 
 Element Editor::renderEditor() {
+    // 每帧开始时同步行渲染缓存的高亮上下文（主题、后端、文件类型变化时缓存整体失效）
+    line_render_cache_.beginFrame();
+    line_render_cache_.setContext(
+        theme_.getCurrentThemeName() + '\n' +
+        std::to_string(static_cast<int>(syntax_highlighter_.getBackend())) + '\n' +
+        syntax_highlighter_.getFileType() + '\n' + (syntax_highlighting_ ? "1" : "0"));
+
+    // 搜索匹配跟随编辑：平移改动之后的匹配，只重新搜索改动过的行
+    if (Document* current = getCurrentDocument()) {
+        search_engine_.applyEdits(*current);
+    }
+
     // 如果启用了分屏（区域数量 > 1），使用分屏渲染
     if (split_view_manager_.hasSplits()) {
         return renderSplitEditor();
@@ -489,9 +531,8 @@ Element Editor::renderEditor() {
     // 6行
     int screen_height = screen_.dimy() - 6;
 
-    // 获取可见行（考虑折叠状态）
-    std::vector<size_t> visible_lines = doc->getVisibleLines();
-    size_t total_visible_lines = visible_lines.size();
+    // 可见行数（考虑折叠状态），由折叠索引直接得到，不再遍历整个文档
+    size_t total_visible_lines = doc->getVisibleLineCount();
 
     // 只在可见行数少于屏幕高度时，确保从0开始显示（这样最后一行也能显示）
     // 如果可见行数大于屏幕高度，保持当前的视图偏移，让用户自己滚动
@@ -508,27 +549,28 @@ Element Editor::renderEditor() {
     // 限制渲染的行数，避免大文件卡住
     const size_t MAX_RENDER_LINES = 200; // 最多渲染200行
     size_t render_count = std::min(max_lines - view_offset_row_, MAX_RENDER_LINES);
+    // 只取出本屏需要的可见行
+    std::vector<size_t> visible_lines = doc->getVisibleLineWindow(view_offset_row_, render_count);
+    updateBackgroundHighlight(doc, visible_lines);
+
+    // 水平滚动：各行从同一显示列开始渲染，光标移出可见列时跟随滚动
+    int area_width = screen_.dimx();
+    if (isMarkdownPreviewActive()) {
+        area_width = (area_width - 1) / 2;
+    } else if (file_browser_.isVisible()) {
+        area_width -= file_browser_width_ + 1; // +1 是分隔符
+    }
+    size_t text_width = lineTextWidth(area_width - 2); // 减去边框
+    if (cursor_row_ < doc->lineCount()) {
+        view_offset_col_ = followCursorColumn(cursorDisplayColumn(), view_offset_col_, text_width);
+    }
 
     try {
-        for (size_t i = view_offset_row_; i < view_offset_row_ + render_count; ++i) {
-            size_t actual_line_index = visible_lines[i];
+        for (size_t actual_line_index : visible_lines) {
             try {
-                // 性能优化：对于超长行，跳过语法高亮
-                std::string line_content = doc->getLine(actual_line_index);
-                if (line_content.length() > 5000) {
-                    // 超长行，使用简单渲染
-                    Elements simple_line;
-                    if (show_line_numbers_) {
-                        simple_line.push_back(renderLineNumber(doc, actual_line_index,
-                                                               actual_line_index == cursor_row_));
-                    }
-                    simple_line.push_back(text(line_content.substr(0, 5000) + "...") |
-                                          color(theme_.getColors().foreground));
-                    lines.push_back(hbox(simple_line));
-                } else {
-                    lines.push_back(
-                        renderLine(doc, actual_line_index, actual_line_index == cursor_row_));
-                }
+                lines.push_back(renderLine(doc, actual_line_index,
+                                           actual_line_index == cursor_row_, view_offset_col_,
+                                           text_width));
             } catch (const std::exception& e) {
                 // 如果渲染某一行失败，使用空行替代
                 Elements error_line;
@@ -724,9 +766,8 @@ Element Editor::renderEditorRegion(const features::ViewRegion& region, Document*
 
     Elements lines;
 
-    // 获取可见行（考虑折叠状态）
-    std::vector<size_t> visible_lines = doc->getVisibleLines();
-    size_t total_visible_lines = visible_lines.size();
+    // 可见行数（考虑折叠状态）
+    size_t total_visible_lines = doc->getVisibleLineCount();
     int region_height = region.height;
 
     // 获取该区域的状态
@@ -742,11 +783,23 @@ Element Editor::renderEditorRegion(const features::ViewRegion& region, Document*
     size_t start_line = region_view_offset_row;
     size_t max_lines = std::min(start_line + region_height, total_visible_lines);
 
-    // 渲染可见行
-    for (size_t i = start_line; i < max_lines && i < start_line + region_height; ++i) {
-        size_t actual_line_index = visible_lines[i];
+    // 渲染可见行（只取出本区域需要的部分）
+    size_t window = max_lines > start_line ? max_lines - start_line : 0;
+    std::vector<size_t> visible_lines = doc->getVisibleLineWindow(start_line, window);
+    updateBackgroundHighlight(doc, visible_lines);
+
+    // 水平偏移：活动区域跟随光标，其他区域保持各自保存的偏移
+    size_t text_width = lineTextWidth(region.width);
+    size_t first_col = region_index < region_states_.size()
+                           ? region_states_[region_index].view_offset_col
+                           : view_offset_col_;
+    if (region.is_active && cursor_row_ < doc->lineCount()) {
+        view_offset_col_ = followCursorColumn(cursorDisplayColumn(), view_offset_col_, text_width);
+        first_col = view_offset_col_;
+    }
+    for (size_t actual_line_index : visible_lines) {
         bool is_current = (region.is_active && actual_line_index == region_cursor_row);
-        lines.push_back(renderLine(doc, actual_line_index, is_current));
+        lines.push_back(renderLine(doc, actual_line_index, is_current, first_col, text_width));
     }
 
     // 填充空行
@@ -763,58 +816,15 @@ Element Editor::renderEditorRegion(const features::ViewRegion& region, Document*
     return vbox(lines);
 }
 
-// 获取UTF-8字符的辅助函数
-std::string getUtf8CharAt(const std::string& str, size_t pos) {
-    if (pos >= str.length()) {
-        return " ";
-    }
-
-    unsigned char first_byte = static_cast<unsigned char>(str[pos]);
-
-    // 单字节ASCII字符
-    if ((first_byte & 0x80) == 0) {
-        return str.substr(pos, 1);
-    }
-
-    // 多字节UTF-8字符
-    int bytes_needed;
-    if ((first_byte & 0xE0) == 0xC0) {
-        bytes_needed = 2;
-    } else if ((first_byte & 0xF0) == 0xE0) {
-        bytes_needed = 3;
-    } else if ((first_byte & 0xF8) == 0xF0) {
-        bytes_needed = 4;
-    } else {
-        // 无效的UTF-8，退回到单字节
-        return str.substr(pos, 1);
-    }
-
-    // 确保有足够的字节
-    if (pos + bytes_needed > str.length()) {
-        return str.substr(pos, 1);
-    }
-
-    return str.substr(pos, bytes_needed);
-}
-
-// 检查字符是否为中文字符（保留用于可能的未来功能）
-bool isChineseChar(const std::string& ch) {
-    if (ch.length() < 3) {
-        return false;
-    }
-
-    // 中文UTF-8范围：E4-B8-80 到 E9-BF-BF (基本汉字)
-    if (ch.length() == 3) {
-        unsigned char b1 = static_cast<unsigned char>(ch[0]);
-        unsigned char b2 = static_cast<unsigned char>(ch[1]);
-        unsigned char b3 = static_cast<unsigned char>(ch[2]);
-
-        // 基本检查：是否为3字节UTF-8且在中文范围内
-        return (b1 >= 0xE4 && b1 <= 0xE9) && (b2 >= 0x80 && b2 <= 0xBF) &&
-               (b3 >= 0x80 && b3 <= 0xBF);
+size_t Editor::lineTextWidth(int area_width) const {
+    int gutter = 0;
+#ifdef BUILD_LSP_SUPPORT
+    gutter += 1; // 折叠指示器
+#endif
+    if (show_line_numbers_) {
+        gutter += 7; // 6 列行号加 1 列空格
     }
-
-    return false;
+    return static_cast<size_t>(std::max(1, area_width - gutter));
 }
 
 // 渲染光标元素的辅助函数
@@ -896,7 +906,32 @@ Element Editor::renderCursorElement(const std::string& cursor_char, size_t curso
     return cursor_elem;
 }
 
-Element Editor::renderLine(Document* doc, size_t line_num, bool is_current) {
+void Editor::updateBackgroundHighlight(Document* doc, const std::vector<size_t>& visible_lines) {
+    // 原生分词器的高亮交给后台线程：先处理这些行，再预读前后的行
+    if (!syntax_highlighting_ || visible_lines.empty() || syntax_highlighter_.usesDocumentTree()) {
+        return;
+    }
+    background_highlighter_.update(*doc, syntax_highlighter_.getFileType(), visible_lines.front(),
+                                   visible_lines.back() + 1);
+}
+
+pnana::ui::RowSpanCache& Editor::rowSpanCache(Document& doc) {
+    auto& slot = doc.renderState();
+    if (!slot) {
+        slot = std::make_shared<pnana::ui::RowSpanCache>();
+    }
+    auto* cache = static_cast<pnana::ui::RowSpanCache*>(slot.get());
+    size_t first = 0;
+    size_t end = 0;
+    size_t replaced = 0;
+    if (doc.takeLineChanges(core::LineBuffer::RENDER_ROWS, first, end, replaced)) {
+        cache->applyChange(first, end, replaced);
+    }
+    return *cache;
+}
+
+Element Editor::renderLine(Document* doc, size_t line_num, bool is_current, size_t first_col,
+                           size_t text_width) {
     Elements line_elements;
 
     // 行内容
@@ -957,28 +992,34 @@ Element Editor::renderLine(Document* doc, size_t line_num, bool is_current) {
         return hbox({text("~") | color(theme_.getColors().comment)});
     }
 
-    std::string content;
+    // 引用文档中的行，超长行也不复制
+    static const std::string empty_line;
+    const std::string* line_text = &empty_line;
     try {
-        content = doc->getLine(line_num);
-    } catch (const std::exception& e) {
-        content = "";
+        line_text = &doc->getLine(line_num);
     } catch (...) {
-        content = "";
+        line_text = &empty_line;
     }
+    const std::string& content = *line_text;
+
+    // 水平窗口 [window_begin, window_end)：只有这部分字节参与高亮和渲染。
+    // 起点是覆盖第 first_col 列的字形簇，由文档按行缓存的检查点换算，长行也不必从行首扫描
+    const size_t window_begin = std::min(doc->byteAt(line_num, first_col), content.length());
+    const size_t window_end =
+        forwardColumns(content, window_begin, text_width + WINDOW_MARGIN_COLUMNS);
 
-    // 获取当前行的搜索匹配
+    // 获取当前行的搜索匹配（匹配按行号有序，二分定位即可）
     std::vector<features::SearchMatch> line_matches;
     if (search_highlight_active_ && search_engine_.hasMatches()) {
         const auto& all_matches = search_engine_.getAllMatches();
-        for (const auto& match : all_matches) {
-            if (match.line == line_num) {
-                line_matches.push_back(match);
-            }
-        }
+        auto range = std::equal_range(
+            all_matches.begin(), all_matches.end(), features::SearchMatch(line_num, 0, 0),
+            [](const features::SearchMatch& a, const features::SearchMatch& b) {
+                return a.line < b.line;
+            });
+        line_matches.assign(range.first, range.second);
     }
 
-    Element content_elem;
-
     // 检查当前行是否在选中范围内
     bool line_in_selection = false;
     size_t selection_start_col = 0;
@@ -1019,307 +1060,115 @@ Element Editor::renderLine(Document* doc, size_t line_num, bool is_current) {
         }
     }
 
-    // 渲染带搜索高亮和选中高亮的行内容
-    auto renderLineWithHighlights = [&](const std::string& line_content, size_t cursor_pos,
-                                        bool has_cursor) -> Element {
-        Elements parts;
-        auto& colors = theme_.getColors();
-
-        // 性能优化：如果行太长，限制语法高亮处理
-        const size_t MAX_HIGHLIGHT_LENGTH = 5000; // 最多处理5000字符
-        bool line_too_long = line_content.length() > MAX_HIGHLIGHT_LENGTH;
-
-        // 辅助函数：渲染文本段，应用选中高亮
-        auto renderSegment = [&](const std::string& segment_text, size_t /* start_pos */,
-                                 bool is_selected) -> Element {
-            if (segment_text.empty()) {
-                return ftxui::text("");
+    // 组装装饰层：语法层之上依次叠加诊断、搜索匹配、选中和光标
+    pnana::ui::LineDecorations decorations;
+    for (const auto& match : line_matches) {
+        decorations.matches.push_back({match.column, match.column + match.length});
+    }
+    if (line_in_selection) {
+        decorations.has_selection = true;
+        decorations.selection = {selection_start_col, selection_end_col};
+    }
+    if (is_current) {
+        decorations.has_cursor = true;
+        decorations.cursor = cursor_col_;
+    }
+#ifdef BUILD_LSP_SUPPORT
+    if (lsp_enabled_) {
+        std::lock_guard<std::mutex> lock(diagnostics_mutex_);
+        for (const auto& diagnostic : current_file_diagnostics_) {
+            size_t start_line = static_cast<size_t>(diagnostic.range.start.line);
+            size_t end_line = static_cast<size_t>(diagnostic.range.end.line);
+            if (line_num < start_line || line_num > end_line) {
+                continue;
             }
-
-            Element elem;
-            if (syntax_highlighting_ && !line_too_long) {
-                try {
-                    elem = syntax_highlighter_.highlightLine(segment_text);
-                } catch (...) {
-                    elem = ftxui::text(segment_text) | color(colors.foreground);
-                }
-            } else {
-                elem = ftxui::text(segment_text) | color(colors.foreground);
+            // LSP 的列以 UTF-16 码元计，换算为行内字节偏移
+            size_t start = line_num == start_line
+                               ? utils::UnicodeWidth::utf16ToByte(
+                                     content, static_cast<size_t>(diagnostic.range.start.character))
+                               : 0;
+            size_t end = line_num == end_line
+                             ? utils::UnicodeWidth::utf16ToByte(
+                                   content, static_cast<size_t>(diagnostic.range.end.character))
+                             : content.length();
+            if (end <= start) {
+                end = utils::UnicodeWidth::nextGrapheme(content, start); // 空范围至少标出一个字符
             }
-
-            // 如果这段文本在选中范围内，添加选中背景色
-            if (is_selected) {
-                elem = elem | bgcolor(colors.selection);
+            if (start < end) {
+                decorations.diagnostics.push_back({start, end, diagnostic.severity});
             }
+        }
+    }
+#endif
 
-            return elem;
-        };
-
-        // 处理选中高亮：将行内容按照选中范围分割
-        if (line_in_selection) {
-            // 有选中内容，需要分段渲染
-            size_t pos = 0;
-
-            while (pos < line_content.length()) {
-                if (pos < selection_start_col) {
-                    // 选中前的部分
-                    std::string before_selection =
-                        line_content.substr(pos, selection_start_col - pos);
-                    if (has_cursor && cursor_pos < selection_start_col && cursor_pos >= pos) {
-                        // 光标在选中前的部分
-                        size_t before_cursor = cursor_pos - pos;
-                        std::string before = before_selection.substr(0, before_cursor);
-                        std::string cursor_char =
-                            before_cursor < before_selection.length()
-                                ? getUtf8CharAt(before_selection, before_cursor)
-                                : " ";
-                        std::string after = before_cursor < before_selection.length()
-                                                ? before_selection.substr(before_cursor + 1)
-                                                : "";
-
-                        if (!before.empty()) {
-                            parts.push_back(renderSegment(before, pos, false));
-                        }
-                        parts.push_back(
-                            renderCursorElement(cursor_char, cursor_pos, line_content.length()));
-                        if (!after.empty()) {
-                            parts.push_back(renderSegment(after, cursor_pos + 1, false));
-                        }
-                        pos = selection_start_col;
-                    } else {
-                        parts.push_back(renderSegment(before_selection, pos, false));
-                        pos = selection_start_col;
-                    }
-                } else if (pos < selection_end_col) {
-                    // 选中部分
-                    std::string selected = line_content.substr(pos, selection_end_col - pos);
-                    if (has_cursor && cursor_pos >= pos && cursor_pos < selection_end_col) {
-                        // 光标在选中部分内
-                        size_t before_cursor = cursor_pos - pos;
-                        std::string before = selected.substr(0, before_cursor);
-                        std::string cursor_char = before_cursor < selected.length()
-                                                      ? getUtf8CharAt(selected, before_cursor)
-                                                      : " ";
-                        std::string after = before_cursor < selected.length()
-                                                ? selected.substr(before_cursor + 1)
-                                                : "";
-
-                        if (!before.empty()) {
-                            Element before_elem = renderSegment(before, pos, true);
-                            parts.push_back(before_elem);
-                        }
-                        // 光标在选中部分，也需要选中背景色
-                        Element cursor_elem =
-                            renderCursorElement(cursor_char, cursor_pos, line_content.length());
-                        cursor_elem = cursor_elem | bgcolor(colors.selection);
-                        parts.push_back(cursor_elem);
-                        if (!after.empty()) {
-                            Element after_elem = renderSegment(after, cursor_pos + 1, true);
-                            parts.push_back(after_elem);
-                        }
-                        pos = selection_end_col;
-                    } else {
-                        parts.push_back(renderSegment(selected, pos, true));
-                        pos = selection_end_col;
-                    }
-                } else {
-                    // 选中后的部分
-                    std::string after_selection = line_content.substr(pos);
-                    if (has_cursor && cursor_pos >= pos) {
-                        // 光标在选中后的部分
-                        size_t before_cursor = cursor_pos - pos;
-                        std::string before = after_selection.substr(0, before_cursor);
-                        std::string cursor_char =
-                            before_cursor < after_selection.length()
-                                ? getUtf8CharAt(after_selection, before_cursor)
-                                : " ";
-                        std::string after = before_cursor < after_selection.length()
-                                                ? after_selection.substr(before_cursor + 1)
-                                                : "";
-
-                        if (!before.empty()) {
-                            parts.push_back(renderSegment(before, pos, false));
-                        }
-                        parts.push_back(
-                            renderCursorElement(cursor_char, cursor_pos, line_content.length()));
-                        if (!after.empty()) {
-                            parts.push_back(renderSegment(after, cursor_pos + 1, false));
-                        }
-                    } else {
-                        parts.push_back(renderSegment(after_selection, pos, false));
-                    }
-                    break;
-                }
-            }
-        } else if (line_matches.empty()) {
-            // 没有搜索匹配和选中，正常渲染
-            if (has_cursor && cursor_pos <= line_content.length()) {
-                std::string before = line_content.substr(0, cursor_pos);
-                std::string cursor_char = cursor_pos < line_content.length()
-                                              ? getUtf8CharAt(line_content, cursor_pos)
-                                              : " ";
-                std::string after =
-                    cursor_pos < line_content.length() ? line_content.substr(cursor_pos + 1) : "";
-
-                if (!before.empty()) {
-                    parts.push_back(renderSegment(before, 0, false));
-                }
-                // 使用配置的光标样式渲染
-                parts.push_back(
-                    renderCursorElement(cursor_char, cursor_pos, line_content.length()));
-                if (!after.empty()) {
-                    parts.push_back(renderSegment(after, cursor_pos + 1, false));
+    // 语法层的样式区间先于缓存查找算出，缓存的元素只在区间也相同时复用：
+    // Tree-sitter 按整个文档解析时从语法树取出；原生分词器的结果由后台线程生成，
+    // 尚未到达的行本帧按普通文本显示。区间按行缓存，行未改动且高亮结果不变时直接沿用
+    if (syntax_highlighting_) {
+        const bool document_tree = syntax_highlighter_.usesDocumentTree();
+        pnana::ui::RowSpanCache::Key key;
+        key.context = line_render_cache_.generation();
+        key.epoch = document_tree ? (doc->getVersion() << 1) | (doc->isLoading() ? 1 : 0)
+                                  : background_highlighter_.epoch();
+        key.begin = window_begin;
+        key.end = window_end;
+        pnana::ui::RowSpanCache& row_spans = rowSpanCache(*doc);
+        if (const auto* cached = row_spans.find(line_num, key)) {
+            decorations.spans = *cached;
+        } else {
+            if (document_tree) {
+                decorations.spans = syntax_highlighter_.highlightSpans(*doc, line_num, content,
+                                                                       window_begin, window_end);
+            } else if (const auto* styles = background_highlighter_.lineStyles(*doc, line_num)) {
+                // 结果覆盖整行才使用（与行文本对不上时按普通文本显示）
+                if (styles->runs.empty() ? content.empty()
+                                         : styles->runs.back().end == content.length()) {
+                    decorations.spans =
+                        syntax_highlighter_.spansForRuns(styles->runs, window_begin, window_end);
                 }
-            } else {
-                // 没有光标，渲染整行
-                parts.push_back(renderSegment(line_content, 0, false));
             }
-        } else {
-            // 有搜索匹配，需要同时处理搜索高亮和选中高亮
-            size_t pos = 0;
-            size_t match_idx = 0;
-
-            while (pos < line_content.length()) {
-                // 检查是否有匹配从当前位置开始
-                bool found_match = false;
-                for (size_t i = match_idx; i < line_matches.size(); ++i) {
-                    if (line_matches[i].column == pos) {
-                        // 找到匹配，高亮显示
-                        size_t match_len = line_matches[i].length;
-                        size_t match_end = pos + match_len;
-
-                        // 检查光标是否在匹配范围内
-                        bool cursor_in_match =
-                            has_cursor && cursor_pos >= pos && cursor_pos < match_end;
-
-                        // 检查匹配是否在选中范围内
-                        bool match_in_selection = line_in_selection && pos < selection_end_col &&
-                                                  match_end > selection_start_col;
-
-                        if (cursor_in_match) {
-                            // 光标在匹配内，需要分割匹配文本
-                            size_t before_cursor = cursor_pos - pos;
-                            size_t after_cursor = match_end - cursor_pos;
-
-                            if (before_cursor > 0) {
-                                std::string before = line_content.substr(pos, before_cursor);
-                                bool is_selected = match_in_selection && pos >= selection_start_col;
-                                Element before_elem = renderSegment(before, pos, is_selected);
-                                // 如果不在选中范围内，应用搜索高亮
-                                if (!is_selected) {
-                                    before_elem = before_elem | bgcolor(Color::GrayDark);
-                                }
-                                parts.push_back(before_elem);
-                            }
-
-                            // 光标位置的字符
-                            std::string cursor_char = getUtf8CharAt(line_content, cursor_pos);
-                            Element cursor_elem =
-                                renderCursorElement(cursor_char, cursor_pos, line_content.length());
-                            // 选中高亮优先于搜索高亮
-                            if (match_in_selection && cursor_pos >= selection_start_col &&
-                                cursor_pos < selection_end_col) {
-                                cursor_elem = cursor_elem | bgcolor(colors.selection);
-                            } else {
-                                cursor_elem = cursor_elem | bgcolor(Color::GrayDark);
-                            }
-                            parts.push_back(cursor_elem);
-
-                            if (after_cursor > 1) {
-                                std::string after =
-                                    line_content.substr(cursor_pos + 1, after_cursor - 1);
-                                bool is_selected =
-                                    match_in_selection && cursor_pos + 1 >= selection_start_col;
-                                Element after_elem =
-                                    renderSegment(after, cursor_pos + 1, is_selected);
-                                // 如果不在选中范围内，应用搜索高亮
-                                if (!is_selected) {
-                                    after_elem = after_elem | bgcolor(Color::GrayDark);
-                                }
-                                parts.push_back(after_elem);
-                            }
-                        } else {
-                            // 光标不在匹配内，正常高亮匹配
-                            std::string match_text = line_content.substr(pos, match_len);
-                            Element match_elem = renderSegment(match_text, pos, match_in_selection);
-                            // 如果不在选中范围内，应用搜索高亮
-                            if (!match_in_selection) {
-                                match_elem = match_elem | bgcolor(Color::GrayDark);
-                            }
-                            parts.push_back(match_elem);
-                        }
+            row_spans.insert(line_num, key, decorations.spans);
+        }
+    }
 
-                        pos = match_end;
-                        match_idx = i + 1;
-                        found_match = true;
-                        break;
-                    }
-                }
+    // 行比窗口长时只渲染窗口内的部分，各装饰层换算为相对窗口的偏移
+    std::string window_text;
+    if (window_begin > 0 || window_end < content.length()) {
+        window_text = content.substr(window_begin, window_end - window_begin);
+        decorations = pnana::ui::clipDecorations(decorations, window_begin, window_end);
+    }
+    const std::string& shown =
+        window_begin > 0 || window_end < content.length() ? window_text : content;
 
-                if (!found_match) {
-                    // 没有匹配，找到下一个匹配的位置
-                    size_t next_match_pos = line_content.length();
-                    for (size_t i = match_idx; i < line_matches.size(); ++i) {
-                        if (line_matches[i].column > pos &&
-                            line_matches[i].column < next_match_pos) {
-                            next_match_pos = line_matches[i].column;
-                        }
-                    }
+    // 只有语法层的行只取决于行文本，直接复用缓存的渲染结果
+    bool cacheable = decorations.plain();
 
-                    std::string segment = line_content.substr(pos, next_match_pos - pos);
-
-                    // 检查这段是否在选中范围内
-                    bool segment_in_selection = line_in_selection && pos < selection_end_col &&
-                                                next_match_pos > selection_start_col;
-
-                    // 检查光标是否在这个段内
-                    if (has_cursor && cursor_pos >= pos && cursor_pos < next_match_pos) {
-                        size_t before_cursor = cursor_pos - pos;
-                        std::string before = segment.substr(0, before_cursor);
-                        std::string cursor_char = before_cursor < segment.length()
-                                                      ? segment.substr(before_cursor, 1)
-                                                      : " ";
-                        std::string after = before_cursor < segment.length()
-                                                ? segment.substr(before_cursor + 1)
-                                                : "";
-
-                        if (!before.empty()) {
-                            parts.push_back(renderSegment(
-                                before, pos, segment_in_selection && pos >= selection_start_col));
-                        }
-                        Element cursor_elem =
-                            renderCursorElement(cursor_char, cursor_pos, line_content.length());
-                        if (segment_in_selection && cursor_pos >= selection_start_col &&
-                            cursor_pos < selection_end_col) {
-                            cursor_elem = cursor_elem | bgcolor(colors.selection);
-                        }
-                        parts.push_back(cursor_elem);
-                        if (!after.empty()) {
-                            parts.push_back(renderSegment(
-                                after, cursor_pos + 1,
-                                segment_in_selection && cursor_pos + 1 >= selection_start_col));
-                        }
-                    } else {
-                        // 没有光标，正常渲染
-                        parts.push_back(renderSegment(segment, pos, segment_in_selection));
-                    }
+    Element content_elem;
+    if (cacheable) {
+        if (const auto* cached = line_render_cache_.find(shown, decorations.spans)) {
+            content_elem = cached->element;
+        }
+    }
 
-                    pos = next_match_pos;
-                }
+    if (!content_elem) {
+        auto& colors = theme_.getColors();
+        try {
+            pnana::ui::LineDecorationColors decoration_colors{
+                colors.foreground, colors.selection, Color::GrayDark, Color::Red, Color::Yellow};
+            content_elem = pnana::ui::renderDecoratedLine(
+                shown, decorations, decoration_colors, [&](const std::string& cursor_char) {
+                    return renderCursorElement(cursor_char, decorations.cursor, shown.length());
+                });
+            if (cacheable) {
+                line_render_cache_.insert(shown, content_elem, decorations.spans);
             }
+        } catch (const std::exception& e) {
+            // 如果高亮失败，使用简单文本
+            content_elem = text(shown) | color(colors.foreground);
+        } catch (...) {
+            // 如果高亮失败，使用简单文本
+            content_elem = text(shown) | color(colors.foreground);
         }
-
-        return hbox(parts);
-    };
-
-    try {
-        content_elem = renderLineWithHighlights(content, cursor_col_, is_current);
-    } catch (const std::exception& e) {
-        // 如果高亮失败，使用简单文本
-        content_elem = text(content) | color(theme_.getColors().foreground);
-    } catch (...) {
-        // 如果高亮失败，使用简单文本
-        content_elem = text(content) | color(theme_.getColors().foreground);
     }
 
     line_elements.push_back(content_elem);
@@ -1528,14 +1377,15 @@ Element Editor::renderStatusbar() {
 
     return statusbar_.render(
         getCurrentDocument()->getFileName(), getCurrentDocument()->isModified(),
-        getCurrentDocument()->isReadOnly(), cursor_row_, cursor_col_,
+        getCurrentDocument()->isReadOnly(), cursor_row_, cursorDisplayColumn(),
         getCurrentDocument()->lineCount(), getCurrentDocument()->getEncoding(), line_ending,
         getFileType(), display_message, region_manager_.getRegionName(), syntax_highlighting_,
         selection_active_,
         selection_active_
             ? (cursor_row_ != selection_start_row_ || cursor_col_ != selection_start_col_ ? 1 : 0)
             : 0,
-        git_branch, git_uncommitted_count, current_ssh_config_.host, current_ssh_config_.user);
+        git_branch, git_uncommitted_count, current_ssh_config_.host, current_ssh_config_.user,
+        getCurrentDocument()->getUndoMemoryUsage());
 }
 
 Element Editor::renderHelpbar() {
@@ -0,0 +1,91 @@
+#include "core/fold_index.h"
+#include <algorithm>
+
+namespace pnana {
+namespace core {
+
+void FoldIndex::rebuild(const std::vector<pnana::features::FoldingRange>& ranges,
+                        const std::set<int>& folded_lines) {
+    intervals_.clear();
+    if (folded_lines.empty()) {
+        return;
+    }
+
+    std::vector<std::pair<size_t, size_t>> hidden;
+    for (const auto& range : ranges) {
+        if (range.startLine < 0 || range.endLine <= range.startLine ||
+            !folded_lines.count(range.startLine)) {
+            continue;
+        }
+        // 起始行本身保持可见，隐藏 (startLine, endLine]
+        hidden.emplace_back(static_cast<size_t>(range.startLine) + 1,
+                            static_cast<size_t>(range.endLine) + 1);
+    }
+    std::sort(hidden.begin(), hidden.end());
+
+    // 合并重叠和相邻的区间（嵌套折叠只计算一次）
+    size_t total = 0;
+    for (const auto& [start, end] : hidden) {
+        if (!intervals_.empty() && start <= intervals_.back().end) {
+            Interval& last = intervals_.back();
+            if (end > last.end) {
+                total += end - last.end;
+                last.end = end;
+            }
+            continue;
+        }
+        intervals_.push_back({start, end, total});
+        total += end - start;
+    }
+}
+
+size_t FoldIndex::upperBound(size_t line) const {
+    auto it = std::upper_bound(intervals_.begin(), intervals_.end(), line,
+                               [](size_t value, const Interval& interval) {
+                                   return value < interval.start;
+                               });
+    return static_cast<size_t>(it - intervals_.begin());
+}
+
+bool FoldIndex::isHidden(size_t line) const {
+    size_t index = upperBound(line);
+    return index > 0 && line < intervals_[index - 1].end;
+}
+
+size_t FoldIndex::hiddenBefore(size_t line) const {
+    if (line == 0) {
+        return 0;
+    }
+    // 最后一个 start <= line - 1 的区间
+    size_t index = upperBound(line - 1);
+    if (index == 0) {
+        return 0;
+    }
+    const Interval& interval = intervals_[index - 1];
+    return interval.hidden_before + std::min(line, interval.end) - interval.start;
+}
+
+size_t FoldIndex::displayToActual(size_t display_line) const {
+    // 区间 i 之前最后一个可见行的显示行号为 start - hidden_before - 1，
+    // 找到最后一个起点显示位置 <= display_line 的区间，跳过它及之前的全部隐藏行
+    auto it = std::upper_bound(intervals_.begin(), intervals_.end(), display_line,
+                               [](size_t value, const Interval& interval) {
+                                   return value < interval.start - interval.hidden_before;
+                               });
+    if (it == intervals_.begin()) {
+        return display_line;
+    }
+    const Interval& interval = *(it - 1);
+    return display_line + interval.hidden_before + (interval.end - interval.start);
+}
+
+size_t FoldIndex::nextVisible(size_t line) const {
+    size_t index = upperBound(line);
+    if (index > 0 && line < intervals_[index - 1].end) {
+        return intervals_[index - 1].end;
+    }
+    return line;
+}
+
+} // namespace core
+} // namespace pnana
@@ -0,0 +1,118 @@
+#include "core/lazy_line_loader.h"
+#include "utils/text_scanner.h"
+#include <algorithm>
+
+namespace pnana {
+namespace core {
+
+LazyLineLoader::LazyLineLoader(std::shared_ptr<const MappedFile> file, size_t offset,
+                               NotifyCallback notify)
+    : file_(std::move(file)), notify_(std::move(notify)) {
+    scanned_ = offset;
+    worker_ = std::thread(&LazyLineLoader::run, this, offset);
+}
+
+LazyLineLoader::~LazyLineLoader() {
+    cancelled_ = true;
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+bool LazyLineLoader::scanChunk(const MappedFile& file, size_t offset, MappedLineChunk& chunk,
+                               size_t& next_offset) {
+    const char* data = file.data() + offset;
+    size_t remaining = file.size() - offset;
+    size_t window = std::min(remaining, MAX_CHUNK_BYTES);
+
+    // 一次向量化扫描找出本块最多 CHUNK_LINES 个换行符
+    size_t newlines[CHUNK_LINES];
+    size_t found = utils::TextScanner::findNewlines(data, window, newlines, CHUNK_LINES);
+
+    auto bounds = std::make_shared<std::vector<uint32_t>>();
+    bounds->reserve(found + 2);
+    bounds->push_back(0);
+    for (size_t i = 0; i < found; ++i) {
+        bounds->push_back(static_cast<uint32_t>(newlines[i] + 1));
+    }
+
+    bool reached_end = false;
+    if (found < CHUNK_LINES) {
+        if (window == remaining) {
+            // 最后一行没有换行符（内容以换行结尾时为空行），延伸到文件末尾
+            bounds->push_back(static_cast<uint32_t>(remaining));
+            reached_end = true;
+        } else if (found == 0) {
+            // 单行超过块字节上限：继续向后找到该行结尾
+            size_t newline = 0;
+            if (utils::TextScanner::findNewlines(data + window, remaining - window, &newline,
+                                                 1) == 1) {
+                bounds->push_back(static_cast<uint32_t>(window + newline + 1));
+            } else {
+                bounds->push_back(static_cast<uint32_t>(remaining));
+                reached_end = true;
+            }
+        }
+        // 其余情况：块字节数已达上限，本块在最后一个换行处结束
+    }
+
+    chunk.base = offset;
+    next_offset = offset + bounds->back();
+    chunk.bounds = std::move(bounds);
+    return reached_end;
+}
+
+void LazyLineLoader::run(size_t offset) {
+    std::vector<MappedLineChunk> local;
+    local.reserve(PUBLISH_CHUNKS);
+
+    auto publish = [this, &local]() {
+        NotifyCallback notify;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& chunk : local) {
+                pending_.push_back(std::move(chunk));
+            }
+            notify = notify_;
+        }
+        local.clear();
+        if (notify) {
+            notify();
+        }
+    };
+
+    bool reached_end = false;
+    while (!cancelled_ && !reached_end) {
+        MappedLineChunk chunk;
+        reached_end = scanChunk(*file_, offset, chunk, offset);
+        scanned_ = offset;
+        local.push_back(std::move(chunk));
+        if (local.size() >= PUBLISH_CHUNKS) {
+            publish();
+        }
+    }
+
+    finished_ = true;
+    publish();
+}
+
+std::vector<MappedLineChunk> LazyLineLoader::takeChunks() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<MappedLineChunk> result;
+    result.swap(pending_);
+    return result;
+}
+
+void LazyLineLoader::setNotify(NotifyCallback notify) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    notify_ = std::move(notify);
+}
+
+void LazyLineLoader::wait() {
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+} // namespace core
+} // namespace pnana
@@ -0,0 +1,416 @@
+#include "core/line_buffer.h"
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+
+namespace pnana {
+namespace core {
+
+LineBuffer::LineBuffer(const std::vector<std::string>& lines) {
+    assign(std::vector<std::string>(lines));
+}
+
+LineBuffer::LineBuffer(std::vector<std::string>&& lines) {
+    assign(std::move(lines));
+}
+
+LineBuffer& LineBuffer::operator=(const std::vector<std::string>& lines) {
+    assign(std::vector<std::string>(lines));
+    return *this;
+}
+
+LineBuffer& LineBuffer::operator=(std::vector<std::string>&& lines) {
+    assign(std::move(lines));
+    return *this;
+}
+
+void LineBuffer::assign(std::vector<std::string>&& lines) {
+    chunks_.clear();
+    if (lines.size() <= MAX_CHUNK_LINES) {
+        // 小文件：单块，直接接管 vector 的存储
+        if (!lines.empty()) {
+            Chunk chunk;
+            chunk.lines = std::make_shared<std::vector<std::string>>(std::move(lines));
+            chunks_.push_back(std::move(chunk));
+        }
+    } else {
+        chunks_.reserve(lines.size() / TARGET_CHUNK_LINES + 1);
+        for (size_t start = 0; start < lines.size(); start += TARGET_CHUNK_LINES) {
+            size_t end = std::min(start + TARGET_CHUNK_LINES, lines.size());
+            Chunk chunk;
+            std::vector<std::string>& target = chunk.mutableLines();
+            target.reserve(end - start);
+            std::move(lines.begin() + start, lines.begin() + end, std::back_inserter(target));
+            chunks_.push_back(std::move(chunk));
+        }
+    }
+    rebuildIndex();
+    touch(0, size_);
+}
+
+void LineBuffer::Chunk::materialize() {
+    if (!source) {
+        return;
+    }
+    size_t count = size();
+    std::vector<std::string> owned;
+    owned.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        owned.emplace_back(view(i));
+    }
+    lines = std::make_shared<std::vector<std::string>>(std::move(owned));
+    source.reset();
+    bounds.reset();
+    base = 0;
+}
+
+std::vector<std::string>& LineBuffer::Chunk::mutableLines() {
+    materialize();
+    if (!lines) {
+        lines = std::make_shared<std::vector<std::string>>();
+    } else if (lines.use_count() > 1) {
+        // 快照仍持有这份存储：复制后再修改，快照看到的内容不变
+        lines = std::make_shared<std::vector<std::string>>(*lines);
+    } else {
+        // 其他线程刚释放快照：与其引用计数的递减同步，之后的修改不会与它的读取重叠
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return *lines;
+}
+
+const std::vector<std::string>& LineBuffer::ownedLines(size_t chunk) const {
+    static const std::vector<std::string> empty;
+    chunks_[chunk].materialize();
+    return chunks_[chunk].lines ? *chunks_[chunk].lines : empty;
+}
+
+std::vector<std::string>& LineBuffer::ownedLines(size_t chunk) {
+    return chunks_[chunk].mutableLines();
+}
+
+void LineBuffer::appendMapped(std::shared_ptr<const MappedFile> source, size_t base,
+                              std::shared_ptr<const std::vector<uint32_t>> bounds) {
+    if (!source || !bounds || bounds->size() < 2) {
+        return;
+    }
+    Chunk chunk;
+    chunk.source = std::move(source);
+    chunk.base = base;
+    chunk.bounds = std::move(bounds);
+    size_t count = chunk.size();
+    chunks_.push_back(std::move(chunk));
+    size_ += count;
+    // 追加的是原文件内容，不算改动
+    dirty_.append(count);
+    for (auto& window : changed_) {
+        window.append(count);
+    }
+    // 末尾追加：Fenwick 树只需扩展一个节点
+    size_t n = chunks_.size();
+    size_t value = count;
+    // 新节点覆盖区间 (n - lowbit(n), n]，其中除自身外的部分由已有节点求和得到
+    size_t lowbit = n & (~n + 1);
+    for (size_t i = n - 1; i > n - lowbit; i -= i & (~i + 1)) {
+        value += fenwick_[i];
+    }
+    fenwick_.resize(n + 1);
+    fenwick_[n] = value;
+}
+
+void LineBuffer::rebuildIndex() {
+    size_t n = chunks_.size();
+    fenwick_.assign(n + 1, 0);
+    size_ = 0;
+    for (size_t i = 0; i < n; ++i) {
+        fenwick_[i + 1] = chunks_[i].size();
+        size_ += chunks_[i].size();
+    }
+    // O(n) 原地构建 Fenwick 树
+    for (size_t i = 1; i <= n; ++i) {
+        size_t parent = i + (i & (~i + 1));
+        if (parent <= n) {
+            fenwick_[parent] += fenwick_[i];
+        }
+    }
+}
+
+void LineBuffer::fenwickAdd(size_t chunk, long long delta) {
+    for (size_t i = chunk + 1; i < fenwick_.size(); i += i & (~i + 1)) {
+        fenwick_[i] = static_cast<size_t>(static_cast<long long>(fenwick_[i]) + delta);
+    }
+}
+
+void LineBuffer::locate(size_t row, size_t& chunk, size_t& offset) const {
+    if (chunks_.empty()) {
+        chunk = 0;
+        offset = 0;
+        return;
+    }
+    if (row >= size_) {
+        chunk = chunks_.size() - 1;
+        offset = chunks_.back().size() + (row - size_);
+        return;
+    }
+
+    // Fenwick 树上二分：找到最后一个前缀和 <= row 的位置
+    size_t n = chunks_.size();
+    size_t step = 1;
+    while ((step << 1) <= n) {
+        step <<= 1;
+    }
+    size_t pos = 0;
+    size_t remaining = row;
+    for (; step > 0; step >>= 1) {
+        if (pos + step <= n && fenwick_[pos + step] <= remaining) {
+            pos += step;
+            remaining -= fenwick_[pos];
+        }
+    }
+    chunk = pos;
+    offset = remaining;
+}
+
+std::string& LineBuffer::operator[](size_t row) {
+    touch(row, row + 1);
+    size_t chunk, offset;
+    locate(row, chunk, offset);
+    return ownedLines(chunk)[offset];
+}
+
+const std::string& LineBuffer::operator[](size_t row) const {
+    size_t chunk, offset;
+    locate(row, chunk, offset);
+    return ownedLines(chunk)[offset];
+}
+
+std::string_view LineBuffer::view(size_t row) const {
+    size_t chunk, offset;
+    locate(row, chunk, offset);
+    return chunks_[chunk].view(offset);
+}
+
+void LineBuffer::clear() {
+    chunks_.clear();
+    fenwick_.assign(1, 0);
+    size_ = 0;
+    touch(0, 0);
+}
+
+void LineBuffer::push_back(const std::string& line) {
+    insert(size_, std::string(line));
+}
+
+void LineBuffer::push_back(std::string&& line) {
+    insert(size_, std::move(line));
+}
+
+void LineBuffer::pop_back() {
+    if (size_ > 0) {
+        erase(size_ - 1);
+    }
+}
+
+bool LineBuffer::splitIfNeeded(size_t chunk) {
+    if (chunks_[chunk].size() <= MAX_CHUNK_LINES) {
+        return false;
+    }
+    std::vector<std::string>& lines = ownedLines(chunk);
+    size_t half = lines.size() / 2;
+    Chunk tail;
+    std::vector<std::string>& tail_lines = tail.mutableLines();
+    tail_lines.reserve(lines.size() - half);
+    std::move(lines.begin() + half, lines.end(), std::back_inserter(tail_lines));
+    lines.erase(lines.begin() + half, lines.end());
+    chunks_.insert(chunks_.begin() + chunk + 1, std::move(tail));
+    rebuildIndex();
+    return true;
+}
+
+void LineBuffer::insert(size_t row, std::string line) {
+    if (chunks_.empty()) {
+        chunks_.push_back(Chunk{});
+        chunks_.back().mutableLines().push_back(std::move(line));
+        rebuildIndex();
+        touch(0, 1);
+        return;
+    }
+
+    row = std::min(row, size_);
+    size_t chunk, offset;
+    locate(row, chunk, offset);
+    std::vector<std::string>& lines = ownedLines(chunk);
+    lines.insert(lines.begin() + offset, std::move(line));
+    size_++;
+    fenwickAdd(chunk, 1);
+    splitIfNeeded(chunk);
+    touch(row, row + 1);
+}
+
+void LineBuffer::insert(size_t row, std::vector<std::string> lines) {
+    if (lines.empty()) {
+        return;
+    }
+    if (chunks_.empty()) {
+        assign(std::move(lines));
+        return;
+    }
+
+    row = std::min(row, size_);
+    const size_t count = lines.size();
+    size_t chunk, offset;
+    locate(row, chunk, offset);
+    std::vector<std::string>& target = ownedLines(chunk);
+
+    if (target.size() + count <= MAX_CHUNK_LINES) {
+        target.insert(target.begin() + offset, std::make_move_iterator(lines.begin()),
+                      std::make_move_iterator(lines.end()));
+        size_ += count;
+        fenwickAdd(chunk, static_cast<long long>(count));
+        touch(row, row + count);
+        return;
+    }
+
+    // 大块插入：在插入点切开当前块，新内容按目标块大小切分后放在中间
+    Chunk tail;
+    std::move(target.begin() + offset, target.end(), std::back_inserter(tail.mutableLines()));
+    target.erase(target.begin() + offset, target.end());
+
+    std::vector<Chunk> pieces;
+    pieces.reserve(lines.size() / TARGET_CHUNK_LINES + 2);
+    for (size_t start = 0; start < lines.size(); start += TARGET_CHUNK_LINES) {
+        size_t end = std::min(start + TARGET_CHUNK_LINES, lines.size());
+        Chunk piece;
+        std::vector<std::string>& piece_lines = piece.mutableLines();
+        piece_lines.reserve(end - start);
+        std::move(lines.begin() + start, lines.begin() + end, std::back_inserter(piece_lines));
+        pieces.push_back(std::move(piece));
+    }
+    pieces.push_back(std::move(tail));
+
+    chunks_.insert(chunks_.begin() + chunk + 1, std::make_move_iterator(pieces.begin()),
+                   std::make_move_iterator(pieces.end()));
+    compact();
+    touch(row, row + count);
+}
+
+void LineBuffer::erase(size_t first, size_t last) {
+    last = std::min(last, size_);
+    if (first >= last) {
+        return;
+    }
+
+    size_t chunk, offset;
+    locate(first, chunk, offset);
+    size_t remaining = last - first;
+
+    // 常见情况：只影响一个块且该块不会变得过小，直接更新索引
+    size_t chunk_size = chunks_[chunk].size();
+    if (offset + remaining <= chunk_size &&
+        (chunk_size - remaining >= MERGE_CHUNK_LINES || chunks_.size() == 1) &&
+        chunk_size > remaining) {
+        std::vector<std::string>& lines = ownedLines(chunk);
+        lines.erase(lines.begin() + offset, lines.begin() + offset + remaining);
+        size_ -= remaining;
+        fenwickAdd(chunk, -static_cast<long long>(remaining));
+        touch(first, first);
+        return;
+    }
+
+    while (remaining > 0 && chunk < chunks_.size()) {
+        Chunk& current = chunks_[chunk];
+        size_t count = std::min(remaining, current.size() - offset);
+        if (offset == 0 && count == current.size()) {
+            // 整块删除：映射块无需先转换
+            current = Chunk{};
+        } else {
+            std::vector<std::string>& lines = ownedLines(chunk);
+            lines.erase(lines.begin() + offset, lines.begin() + offset + count);
+        }
+        remaining -= count;
+        chunk++;
+        offset = 0;
+    }
+    compact();
+    touch(first, first);
+}
+
+LineBuffer::iterator LineBuffer::insert(const_iterator pos, std::string line) {
+    size_t index = pos.index();
+    insert(index, std::move(line));
+    return iterator(this, index);
+}
+
+LineBuffer::iterator LineBuffer::erase(const_iterator pos) {
+    size_t index = pos.index();
+    erase(index, index + 1);
+    return iterator(this, index);
+}
+
+LineBuffer::iterator LineBuffer::erase(const_iterator first, const_iterator last) {
+    size_t index = first.index();
+    erase(index, last.index());
+    return iterator(this, index);
+}
+
+void LineBuffer::compact() {
+    std::vector<Chunk> merged;
+    merged.reserve(chunks_.size());
+    for (auto& chunk : chunks_) {
+        if (chunk.size() == 0) {
+            continue;
+        }
+        if (!merged.empty()) {
+            Chunk& prev = merged.back();
+            bool small = prev.size() < MERGE_CHUNK_LINES || chunk.size() < MERGE_CHUNK_LINES;
+            if (small && prev.size() + chunk.size() <= MAX_CHUNK_LINES) {
+                std::vector<std::string>& target = prev.mutableLines();
+                chunk.materialize();
+                if (chunk.lines.use_count() > 1) {
+                    // 仍与快照共享：只能复制
+                    target.insert(target.end(), chunk.lines->begin(), chunk.lines->end());
+                } else {
+                    std::move(chunk.lines->begin(), chunk.lines->end(),
+                              std::back_inserter(target));
+                }
+                continue;
+            }
+        }
+        merged.push_back(std::move(chunk));
+    }
+    chunks_ = std::move(merged);
+    rebuildIndex();
+}
+
+std::vector<std::string> LineBuffer::toVector() const {
+    std::vector<std::string> result;
+    result.reserve(size_);
+    forEachLine([&result](std::string_view line) {
+        result.emplace_back(line);
+    });
+    return result;
+}
+
+bool LineBuffer::operator==(const LineBuffer& other) const {
+    if (size_ != other.size_) {
+        return false;
+    }
+    // 双游标按视图比较，避免转换映射块
+    size_t other_chunk = 0;
+    size_t other_offset = 0;
+    for (const auto& chunk : chunks_) {
+        for (size_t i = 0, n = chunk.size(); i < n; ++i) {
+            while (other_offset >= other.chunks_[other_chunk].size()) {
+                other_chunk++;
+                other_offset = 0;
+            }
+            if (chunk.view(i) != other.chunks_[other_chunk].view(other_offset)) {
+                return false;
+            }
+            other_offset++;
+        }
+    }
+    return true;
+}
+
+} // namespace core
+} // namespace pnana
@@ -0,0 +1,53 @@
+#include "core/line_column_index.h"
+#include <vector>
+
+namespace pnana {
+namespace core {
+
+utils::ColumnIndex* LineColumnIndex::rowIndex(size_t row, std::string_view line) {
+    if (line.size() <= utils::ColumnIndex::CHECKPOINT_BYTES) {
+        return nullptr;
+    }
+    auto it = rows_.find(row);
+    if (it == rows_.end()) {
+        if (rows_.size() >= MAX_ROWS) {
+            rows_.clear();
+        }
+        it = rows_.emplace(row, utils::ColumnIndex()).first;
+    }
+    return &it->second;
+}
+
+size_t LineColumnIndex::columnAt(size_t row, std::string_view line, size_t byte) {
+    if (utils::ColumnIndex* index = rowIndex(row, line)) {
+        return index->columnAt(line, byte);
+    }
+    return utils::UnicodeWidth::columnAt(line, byte);
+}
+
+size_t LineColumnIndex::byteAt(size_t row, std::string_view line, size_t column) {
+    if (utils::ColumnIndex* index = rowIndex(row, line)) {
+        return index->byteAt(line, column);
+    }
+    return utils::UnicodeWidth::byteAt(line, column);
+}
+
+void LineColumnIndex::applyChange(size_t first, size_t end, size_t replaced) {
+    // 被替换的旧行丢弃，之后的行平移到新行号
+    const size_t old_end = first + replaced;
+    rows_.erase(rows_.lower_bound(first), rows_.lower_bound(old_end));
+    if (end == old_end) {
+        return;
+    }
+    std::vector<decltype(rows_)::node_type> moved;
+    for (auto it = rows_.lower_bound(old_end); it != rows_.end();) {
+        moved.push_back(rows_.extract(it++));
+    }
+    for (auto& node : moved) {
+        node.key() = node.key() - old_end + end;
+        rows_.insert(std::move(node));
+    }
+}
+
+} // namespace core
+} // namespace pnana
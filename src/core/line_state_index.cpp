@@ -0,0 +1,116 @@
+#include "core/line_state_index.h"
+#include <algorithm>
+
+namespace pnana {
+namespace core {
+
+void LineStateIndex::setContext(const std::string& context) {
+    if (context != context_) {
+        context_ = context;
+        clear();
+    }
+}
+
+void LineStateIndex::clear() {
+    states_.clear();
+    barriers_.clear();
+    valid_ = 0;
+}
+
+uint8_t LineStateIndex::entryState(size_t row, const LineBuffer& lines, const LexFn& lex) {
+    if (valid_ == 0) {
+        // 第 0 行总是从初始状态开始
+        if (states_.empty()) {
+            states_.push_back(0);
+        } else {
+            states_[0] = 0;
+        }
+        valid_ = 1;
+    }
+    row = std::min(row, lines.size());
+    while (valid_ <= row) {
+        size_t prev = valid_ - 1;
+        store(valid_, lex(lines.view(prev), states_[prev]));
+    }
+    return states_[row];
+}
+
+void LineStateIndex::recordExitState(size_t row, uint8_t state) {
+    // 只有第 row 行的开头已验证、第 row + 1 行尚未验证时才有意义
+    if (valid_ == row + 1) {
+        store(row + 1, state);
+    }
+}
+
+void LineStateIndex::store(size_t row, uint8_t state) {
+    if (row >= states_.size()) {
+        states_.resize(row + 1, UNKNOWN);
+        states_[row] = state;
+        valid_ = row + 1;
+        return;
+    }
+
+    uint8_t old = states_[row];
+    states_[row] = state;
+    valid_ = row + 1;
+    if (old != state || old == UNKNOWN) {
+        return;
+    }
+
+    // 收敛：后面的旧值都仍然成立，延伸到下一个边界或未知的检查点为止
+    auto barrier = std::upper_bound(barriers_.begin(), barriers_.end(), row);
+    barriers_.erase(barriers_.begin(), barrier);
+    size_t limit = barriers_.empty() ? states_.size() : std::min(barriers_.front(), states_.size());
+    auto unknown = std::find(states_.begin() + valid_, states_.begin() + limit, UNKNOWN);
+    valid_ = static_cast<size_t>(unknown - states_.begin());
+}
+
+void LineStateIndex::applyChange(size_t first, size_t end, size_t replaced) {
+    if (states_.empty()) {
+        return;
+    }
+
+    // 第 first 行开头的状态只取决于之前未改动的行，保留；
+    // 改动后的第一行未改动的行（新行号 tail）及之后的检查点平移后待验证，
+    // 中间的新行状态未知
+    const size_t tail = std::max(end, first + 1);
+    const size_t old_tail = first + replaced + (tail - end); // tail 对应的旧行号
+    const bool has_tail = old_tail < states_.size();
+
+    std::vector<uint8_t> tail_states;
+    if (has_tail) {
+        tail_states.assign(states_.begin() + old_tail, states_.end());
+    }
+    states_.resize(std::min(first + 1, states_.size()));
+    if (has_tail) {
+        states_.resize(tail, UNKNOWN);
+        states_.insert(states_.end(), tail_states.begin(), tail_states.end());
+    }
+
+    // 边界随行号平移，落在被替换部分的边界失效
+    std::vector<size_t> barriers;
+    barriers.reserve(barriers_.size() + 1);
+    for (size_t barrier : barriers_) {
+        if (barrier <= first) {
+            barriers.push_back(barrier);
+        }
+        if (has_tail && barrier >= old_tail) {
+            barriers.push_back(barrier - old_tail + tail);
+        }
+    }
+    if (has_tail) {
+        barriers.push_back(tail);
+        // 原先已验证部分的末尾也是边界：之前的检查点属于修改前的内容，之后的还是更早的旧值
+        if (valid_ > old_tail) {
+            barriers.push_back(valid_ - old_tail + tail);
+        }
+    }
+    std::sort(barriers.begin(), barriers.end());
+    barriers.erase(std::unique(barriers.begin(), barriers.end()), barriers.end());
+    barriers_ = std::move(barriers);
+
+    valid_ = std::min(valid_, std::min(first + 1, states_.size()));
+}
+
+} // namespace core
+} // namespace pnana
@@ -0,0 +1,56 @@
+#include "core/mapped_file.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace pnana {
+namespace core {
+
+MappedFile::~MappedFile() {
+    if (data_ && size_ > 0) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+}
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::string& filepath, std::string* error) {
+    int fd = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        if (error) {
+            *error = "Cannot open file: " + std::string(strerror(errno));
+        }
+        return nullptr;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode)) {
+        if (error) {
+            *error = "Cannot map file: not a regular file";
+        }
+        ::close(fd);
+        return nullptr;
+    }
+
+    size_t size = static_cast<size_t>(file_stat.st_size);
+    const char* data = nullptr;
+    if (size > 0) {
+        void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            if (error) {
+                *error = "Cannot map file: " + std::string(strerror(errno));
+            }
+            ::close(fd);
+            return nullptr;
+        }
+        data = static_cast<const char*>(addr);
+    }
+    // 映射建立后即可关闭描述符
+    ::close(fd);
+
+    return std::shared_ptr<MappedFile>(new MappedFile(data, size));
+}
+
+} // namespace core
+} // namespace pnana
@@ -0,0 +1,260 @@
+#include "core/save_job.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+
+namespace pnana {
+namespace core {
+
+namespace {
+
+#ifdef IOV_MAX
+constexpr size_t MAX_IOVECS = IOV_MAX;
+#else
+constexpr size_t MAX_IOVECS = 1024;
+#endif
+
+// 写出一批 iovec，处理部分写入和 EINTR
+bool writeBatch(int fd, std::vector<iovec>& iov) {
+    size_t index = 0;
+    while (index < iov.size()) {
+        int count = static_cast<int>(std::min(iov.size() - index, MAX_IOVECS));
+        ssize_t written = ::writev(fd, iov.data() + index, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        size_t remaining = static_cast<size_t>(written);
+        while (index < iov.size() && remaining >= iov[index].iov_len) {
+            remaining -= iov[index].iov_len;
+            ++index;
+        }
+        if (remaining > 0) {
+            iov[index].iov_base = static_cast<char*>(iov[index].iov_base) + remaining;
+            iov[index].iov_len -= remaining;
+        }
+    }
+    iov.clear();
+    return true;
+}
+
+// fsync 文件所在目录，使重命名本身落盘
+void syncParentDirectory(const std::string& filepath) {
+    size_t slash = filepath.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "." : filepath.substr(0, slash);
+    if (dir.empty()) {
+        dir = "/";
+    }
+    int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+}
+
+} // namespace
+
+SaveJob::SaveJob(LineBuffer lines, std::string filepath, std::string line_ending, bool sync,
+                 NotifyCallback notify)
+    : lines_(std::move(lines)), filepath_(std::move(filepath)),
+      line_ending_(std::move(line_ending)), sync_(sync), notify_(std::move(notify)) {
+    worker_ = std::thread(&SaveJob::run, this);
+}
+
+SaveJob::~SaveJob() {
+    wait();
+}
+
+void SaveJob::wait() {
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+int SaveJob::progress() const {
+    size_t total = total_.load();
+    if (total == 0) {
+        return finished_.load() ? 100 : 0;
+    }
+    return static_cast<int>(written_.load() * 100 / total);
+}
+
+void SaveJob::setNotify(NotifyCallback notify) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    notify_ = std::move(notify);
+}
+
+void SaveJob::notify() {
+    NotifyCallback notify;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        notify = notify_;
+    }
+    if (notify) {
+        notify();
+    }
+}
+
+void SaveJob::run() {
+    total_ = byteSize(lines_, line_ending_);
+    size_t next_notify = NOTIFY_BYTES;
+    result_ = write(lines_, filepath_, line_ending_, sync_, [this, &next_notify](size_t written) {
+        written_ = written;
+        if (written >= next_notify) {
+            next_notify = written + NOTIFY_BYTES;
+            notify();
+        }
+    });
+    // 快照在这里释放，主线程之后修改这些块时无需再复制
+    lines_.clear();
+    finished_ = true;
+    notify();
+}
+
+size_t SaveJob::byteSize(const LineBuffer& lines, const std::string& line_ending) {
+    const size_t line_count = lines.size();
+    size_t total = 0;
+    size_t i = 0;
+    lines.forEachLine([&](std::string_view line) {
+        total += line.size();
+        if (i < line_count - 1 || !line.empty()) {
+            total += line_ending.size();
+        }
+        ++i;
+    });
+    return total;
+}
+
+SaveJob::Result SaveJob::write(const LineBuffer& lines, const std::string& filepath,
+                               const std::string& line_ending, bool sync,
+                               const ProgressCallback& progress) {
+    // nano风格的安全保存：
+    // 1. 获取原文件权限
+    // 2. 写入临时文件
+    // 3. 创建备份（可选）
+    // 4. 原子性替换原文件
+    Result result;
+
+    struct stat file_stat;
+    bool file_exists = (stat(filepath.c_str(), &file_stat) == 0);
+    mode_t original_mode = file_exists ? file_stat.st_mode : 0644;
+
+    // 创建临时文件名
+    std::string temp_file = filepath + ".tmp~";
+
+    int fd = ::open(temp_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        result.error = "Cannot create temporary file: " + std::string(strerror(errno));
+        return result;
+    }
+
+    // 写入所有行（顺序遍历视图，映射块无需转换为字符串）
+    const size_t line_count = lines.size();
+    std::vector<iovec> iov;
+    iov.reserve(std::min<size_t>(MAX_IOVECS, 2 * LineBuffer::MAX_CHUNK_LINES));
+    size_t batch_bytes = 0;
+    size_t i = 0;
+    bool ok = true;
+    auto add = [&](const char* data, size_t size) {
+        if (size == 0) {
+            return;
+        }
+        iov.push_back(iovec{const_cast<char*>(data), size});
+        batch_bytes += size;
+        result.bytes += size;
+    };
+    auto flush = [&]() {
+        if (ok && !iov.empty() && !writeBatch(fd, iov)) {
+            ok = false;
+        }
+        iov.clear();
+        batch_bytes = 0;
+        if (progress) {
+            progress(result.bytes);
+        }
+    };
+    lines.forEachLine([&](std::string_view line) {
+        if (!ok) {
+            return;
+        }
+        add(line.data(), line.size());
+        // 添加行尾（除了最后一行如果为空）
+        if (i < line_count - 1 || !line.empty()) {
+            add(line_ending.data(), line_ending.size());
+        }
+        ++i;
+        if (iov.size() + 2 > MAX_IOVECS || batch_bytes >= BATCH_BYTES) {
+            flush();
+        }
+    });
+    flush();
+
+    // 检查写入是否成功
+    if (!ok || (sync && ::fsync(fd) != 0)) {
+        result.error = "Write error: " + std::string(strerror(errno));
+        ::close(fd);
+        std::remove(temp_file.c_str());
+        return result;
+    }
+    if (::close(fd) != 0) {
+        result.error = "Failed to close temporary file: " + std::string(strerror(errno));
+        std::remove(temp_file.c_str());
+        return result;
+    }
+
+    // 如果原文件存在，创建临时备份（用于安全保存）
+    std::string backup_file = filepath + "~";
+    bool backup_created = false;
+
+    if (file_exists) {
+        // 删除旧备份
+        std::remove(backup_file.c_str());
+
+        // 创建新备份
+        if (std::rename(filepath.c_str(), backup_file.c_str()) == 0) {
+            backup_created = true;
+        }
+        // 备份失败不是致命错误，继续保存
+    }
+
+    // 原子性替换：重命名临时文件为目标文件
+    if (std::rename(temp_file.c_str(), filepath.c_str()) != 0) {
+        result.error = "Cannot rename temp file: " + std::string(strerror(errno));
+        std::remove(temp_file.c_str());
+        // 如果备份存在，尝试恢复
+        if (backup_created) {
+            std::rename(backup_file.c_str(), filepath.c_str());
+        }
+        return result;
+    }
+
+    // 恢复原文件权限
+    if (file_exists) {
+        chmod(filepath.c_str(), original_mode);
+    }
+
+    // 保存成功后，删除备份文件（避免残留备份文件）
+    if (backup_created) {
+        std::remove(backup_file.c_str());
+    }
+
+    if (sync) {
+        syncParentDirectory(filepath);
+    }
+
+    result.success = true;
+    result.lines = line_count;
+    return result;
+}
+
+} // namespace core
+} // namespace pnana
@@ -0,0 +1,129 @@
+#include "core/undo_history.h"
+#include <algorithm>
+
+namespace pnana {
+namespace core {
+
+UndoHistory::UndoHistory(size_t byte_budget) : byte_budget_(byte_budget) {}
+
+void UndoHistory::setByteBudget(size_t bytes) {
+    byte_budget_ = bytes;
+    evictToBudget();
+}
+
+void UndoHistory::push(const DocumentChange& change) {
+    append(change);
+    evictToBudget();
+}
+
+void UndoHistory::append(const DocumentChange& change) {
+    const std::string& old_content = change.old_content;
+    const std::string& base_new = change.new_content;
+    const std::string& base_after = change.after_cursor;
+    size_t base_size = base_new.size() + base_after.size();
+    auto base_at = [&](size_t i) {
+        return i < base_new.size() ? base_new[i] : base_after[i - base_new.size()];
+    };
+
+    // old_content 相对 new_content + after_cursor 的公共前后缀
+    size_t limit = std::min(old_content.size(), base_size);
+    size_t prefix = 0;
+    while (prefix < limit && old_content[prefix] == base_at(prefix)) {
+        ++prefix;
+    }
+    size_t suffix = 0;
+    while (suffix < limit - prefix &&
+           old_content[old_content.size() - 1 - suffix] == base_at(base_size - 1 - suffix)) {
+        ++suffix;
+    }
+
+    Record record;
+    record.type = change.type;
+    record.row = change.row;
+    record.col = change.col;
+    record.timestamp = change.timestamp;
+    record.version_before = change.version_before;
+    record.version_after = change.version_after;
+    record.offset = arena_base_ + arena_.size();
+    record.after_len = base_after.size();
+    record.new_len = base_new.size();
+    record.old_mid_len = old_content.size() - prefix - suffix;
+    record.old_prefix = prefix;
+    record.old_suffix = suffix;
+
+    arena_.append(base_after);
+    arena_.append(base_new);
+    arena_.append(old_content, prefix, record.old_mid_len);
+    records_.push_back(record);
+    live_bytes_ += sizeof(Record) + record.payloadSize();
+}
+
+DocumentChange UndoHistory::back() const {
+    const Record& record = records_.back();
+    const char* payload = arena_.data() + (record.offset - arena_base_);
+
+    std::string after(payload, record.after_len);
+    std::string new_content(payload + record.after_len, record.new_len);
+    std::string base = new_content + after;
+    std::string old_content;
+    old_content.reserve(record.old_prefix + record.old_mid_len + record.old_suffix);
+    old_content.append(base, 0, record.old_prefix);
+    old_content.append(payload + record.after_len + record.new_len, record.old_mid_len);
+    old_content.append(base, base.size() - record.old_suffix, record.old_suffix);
+
+    DocumentChange change(record.type, record.row, record.col, old_content, new_content, after);
+    change.timestamp = record.timestamp;
+    change.version_before = record.version_before;
+    change.version_after = record.version_after;
+    return change;
+}
+
+void UndoHistory::replaceBack(const DocumentChange& change) {
+    // 最新一条记录总位于 arena 末尾，截掉后重新编码即可
+    popBack();
+    append(change);
+    evictToBudget();
+}
+
+void UndoHistory::popBack() {
+    const Record& record = records_.back();
+    arena_.resize(record.offset - arena_base_);
+    live_bytes_ -= sizeof(Record) + record.payloadSize();
+    records_.pop_back();
+}
+
+void UndoHistory::clear() {
+    records_.clear();
+    arena_.clear();
+    arena_.shrink_to_fit();
+    arena_base_ = 0;
+    live_bytes_ = 0;
+}
+
+void UndoHistory::evictToBudget() {
+    bool evicted = false;
+    while (records_.size() > 1 && live_bytes_ > byte_budget_) {
+        live_bytes_ -= sizeof(Record) + records_.front().payloadSize();
+        records_.pop_front();
+        evicted = true;
+    }
+    if (evicted) {
+        compactArena();
+    }
+}
+
+void UndoHistory::compactArena() {
+    // 截掉已淘汰记录的负载；只在死区超过一半时搬移，保证均摊 O(1)
+    size_t dead = records_.front().offset - arena_base_;
+    if (dead * 2 < arena_.size()) {
+        return;
+    }
+    arena_.erase(0, dead);
+    arena_base_ += dead;
+    if (arena_.capacity() > arena_.size() * 4) {
+        arena_.shrink_to_fit();
+    }
+}
+
+} // namespace core
+} // namespace pnana
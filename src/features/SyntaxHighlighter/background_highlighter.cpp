@@ -0,0 +1,428 @@
+#include "features/SyntaxHighlighter/background_highlighter.h"
+#include "core/document.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <vector>
+
+namespace pnana {
+namespace features {
+
+namespace {
+
+constexpr size_t NO_ROW = static_cast<size_t>(-1);
+
+// 槽位数组每页的行数（页在工作线程第一次写入时分配）
+constexpr size_t PAGE_ROWS = 256;
+
+// 每分词这么多行检查一次是否有新的任务
+constexpr size_t YIELD_ROWS = 64;
+
+// 跳到远处时推进词法状态检查点的分段大小
+constexpr size_t STATE_STEP_ROWS = 4096;
+
+// 行修改窗口：原来从 first 开始的 replaced 行变成了现在的 [first, end)
+struct LineChange {
+    bool any = false; // 是否有修改
+    bool all = false; // 整体作废（如文件类型变化），没有可沿用的行
+    size_t first = 0;
+    size_t end = 0;
+    size_t replaced = 0;
+
+    static LineChange lines(size_t first, size_t end, size_t replaced) {
+        LineChange change;
+        change.any = true;
+        change.first = first;
+        change.end = end;
+        change.replaced = replaced;
+        return change;
+    }
+    static LineChange everything() {
+        LineChange change;
+        change.any = true;
+        change.all = true;
+        return change;
+    }
+
+    // 现在的第 row 行修改前的行号；被改动的行返回 NO_ROW
+    size_t oldRow(size_t row) const {
+        if (all) {
+            return NO_ROW;
+        }
+        if (!any || row < first) {
+            return row;
+        }
+        if (row < end) {
+            return NO_ROW;
+        }
+        return row - end + first + replaced;
+    }
+
+    // 先本次、再 next 的两次修改合并为一次（在两次修改之间的行号上求并集）
+    LineChange then(const LineChange& next) const {
+        if (!any) {
+            return next;
+        }
+        if (!next.any) {
+            return *this;
+        }
+        if (all || next.all) {
+            return everything();
+        }
+        const size_t lo = std::min(first, next.first);
+        const size_t hi = std::max(end, next.first + next.replaced);
+        const size_t old_end = hi - end + first + replaced;
+        const size_t new_end = hi - next.first - next.replaced + next.end;
+        return lines(lo, new_end, old_end - lo);
+    }
+};
+
+} // namespace
+
+// 文档某一版本的高亮结果：每行一个原子指针槽位，工作线程发布、界面线程读取
+struct BackgroundHighlighter::Generation {
+    struct Page {
+        Page() {
+            for (auto& slot : slots) {
+                slot.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+        std::array<std::atomic<const LineStyles*>, PAGE_ROWS> slots;
+        std::array<std::shared_ptr<const LineStyles>, PAGE_ROWS> holders; // 只由工作线程访问
+    };
+
+    Generation(core::DocumentSnapshot content, std::string type, LineChange line_change,
+               uint64_t number)
+        : snapshot(std::move(content)), file_type(std::move(type)), change(line_change),
+          serial(number), pages((snapshot.lineCount() + PAGE_ROWS - 1) / PAGE_ROWS) {}
+
+    ~Generation() {
+        for (auto& page : pages) {
+            delete page.load(std::memory_order_acquire);
+        }
+    }
+
+    Generation(const Generation&) = delete;
+    Generation& operator=(const Generation&) = delete;
+
+    // 任意线程：第 row 行已发布的结果
+    const LineStyles* find(size_t row) const {
+        if (row >= snapshot.lineCount()) {
+            return nullptr;
+        }
+        const Page* page = pages[row / PAGE_ROWS].load(std::memory_order_acquire);
+        return page ? page->slots[row % PAGE_ROWS].load(std::memory_order_acquire) : nullptr;
+    }
+
+    // 工作线程：与 find() 相同，但返回共享所有权（供下一版本复用）
+    std::shared_ptr<const LineStyles> published(size_t row) const {
+        if (row >= snapshot.lineCount()) {
+            return nullptr;
+        }
+        const Page* page = pages[row / PAGE_ROWS].load(std::memory_order_relaxed);
+        return page ? page->holders[row % PAGE_ROWS] : nullptr;
+    }
+
+    // 工作线程：发布第 row 行
+    void publish(size_t row, std::shared_ptr<const LineStyles> styles) {
+        auto& entry = pages[row / PAGE_ROWS];
+        Page* page = entry.load(std::memory_order_relaxed);
+        if (!page) {
+            page = new Page();
+            entry.store(page, std::memory_order_release);
+        }
+        auto& holder = page->holders[row % PAGE_ROWS];
+        holder = std::move(styles);
+        page->slots[row % PAGE_ROWS].store(holder.get(), std::memory_order_release);
+    }
+
+    const core::DocumentSnapshot snapshot;
+    const std::string file_type;
+    const LineChange change; // 相对同一文档上一版本的修改
+    const uint64_t serial;   // 同一文档内依次递增
+    std::vector<std::atomic<Page*>> pages;
+    std::atomic<bool> ready{false}; // 提交时的可见行已全部发布
+};
+
+// 按文档保存的状态（Document::highlightState()）
+struct BackgroundHighlighter::DocumentState {
+    // 界面线程
+    std::shared_ptr<Generation> current;   // 最近提交的版本
+    std::shared_ptr<Generation> displayed; // current 就绪之前代为显示的上一版本
+    LineChange pending; // current 之后文档的修改，current 就绪后随下一版本一起提交
+    uint64_t next_serial = 0;
+    size_t first_row = 0;
+    size_t last_row = 0;
+
+    // 工作线程
+    core::LineStateIndex line_states;
+    std::shared_ptr<Generation> processed; // line_states 已更新到的版本
+    std::shared_ptr<Generation> previous;  // processed 的上一版本，用于复用未改动的行
+};
+
+BackgroundHighlighter::BackgroundHighlighter(std::function<void()> notify)
+    : notify_(std::move(notify)), theme_(), highlighter_(theme_, SyntaxHighlightBackend::NATIVE) {
+    lex_ = [this](std::string_view line, uint8_t state) {
+        return highlighter_.lexLine(std::string(line), state);
+    };
+    worker_ = std::thread([this] {
+        run();
+    });
+}
+
+BackgroundHighlighter::~BackgroundHighlighter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        jobs_.clear();
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void BackgroundHighlighter::update(core::Document& doc, const std::string& file_type,
+                                   size_t first_row, size_t last_row) {
+    auto& slot = doc.highlightState();
+    if (!slot) {
+        slot = std::make_shared<DocumentState>();
+    }
+    auto state = std::static_pointer_cast<DocumentState>(slot);
+
+    size_t first = 0;
+    size_t end = 0;
+    size_t replaced = 0;
+    if (doc.takeLineChanges(core::LineBuffer::LINE_STATES, first, end, replaced)) {
+        state->pending = state->pending.then(LineChange::lines(first, end, replaced));
+        epoch_.fetch_add(1, std::memory_order_release);
+    }
+    // 撤销/重做回到了 current 的版本：内容与快照一致，累积的修改不再适用
+    if (state->current && state->current->snapshot.version() == doc.getVersion()) {
+        state->pending = LineChange();
+    }
+
+    // 内容或文件类型变化时提交新版本；上一版本的可见行还没发布完时先累积修改，
+    // 保证工作线程按顺序处理每个版本，同时快速输入时不会堆积过期的版本
+    const auto& current = state->current;
+    const bool stale = !current || current->snapshot.version() != doc.getVersion() ||
+                       current->file_type != file_type;
+    if (stale && (!current || current->ready.load(std::memory_order_acquire))) {
+        LineChange change = state->pending;
+        if (current && current->file_type != file_type) {
+            change = LineChange::everything();
+        }
+        state->displayed = state->current;
+        state->current = std::make_shared<Generation>(doc.snapshot(), file_type, change,
+                                                      state->next_serial++);
+        state->pending = LineChange();
+        epoch_.fetch_add(1, std::memory_order_release);
+    } else {
+        if (current->ready.load(std::memory_order_acquire) && state->displayed) {
+            state->displayed.reset();
+            epoch_.fetch_add(1, std::memory_order_release);
+        }
+        if (first_row == state->first_row && last_row == state->last_row) {
+            return;
+        }
+    }
+
+    state->first_row = first_row;
+    state->last_row = last_row;
+    submit({state, state->current, first_row, last_row});
+}
+
+const LineStyles* BackgroundHighlighter::lineStyles(core::Document& doc, size_t row) const {
+    const auto* state = static_cast<const DocumentState*>(doc.highlightState().get());
+    if (!state || !state->current) {
+        return nullptr;
+    }
+
+    // 文档行号 -> current 的行号 -> displayed 的行号；改动过的行没有可沿用的结果
+    row = state->pending.oldRow(row);
+    if (row == NO_ROW) {
+        return nullptr;
+    }
+    if (const LineStyles* styles = state->current->find(row)) {
+        return styles;
+    }
+    if (!state->displayed) {
+        return nullptr;
+    }
+    row = state->current->change.oldRow(row);
+    return row == NO_ROW ? nullptr : state->displayed->find(row);
+}
+
+bool BackgroundHighlighter::covers(const Job& newer, const Job& older) {
+    if (newer.state != older.state) {
+        return false;
+    }
+    if (newer.generation != older.generation) {
+        return true;
+    }
+    const size_t begin =
+        newer.first_row > LOOK_BEHIND_ROWS ? newer.first_row - LOOK_BEHIND_ROWS : 0;
+    return older.first_row >= begin && older.last_row <= newer.last_row + LOOK_AHEAD_ROWS;
+}
+
+void BackgroundHighlighter::submit(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.erase(std::remove_if(jobs_.begin(), jobs_.end(),
+                                   [&](const Job& pending) {
+                                       return covers(job, pending);
+                                   }),
+                    jobs_.end());
+        jobs_.push_back(std::move(job));
+    }
+    cv_.notify_one();
+}
+
+void BackgroundHighlighter::run() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] {
+                return stop_ || !jobs_.empty();
+            });
+            if (stop_) {
+                return;
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        process(job);
+    }
+}
+
+bool BackgroundHighlighter::yield(const Job& job) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stop_) {
+        return true;
+    }
+    if (jobs_.empty()) {
+        return false;
+    }
+    bool superseded = std::any_of(jobs_.begin(), jobs_.end(), [&](const Job& pending) {
+        return covers(pending, job);
+    });
+    if (!superseded) {
+        jobs_.push_back(job); // 已发布的行不会重复分词，继续时从中断处接着做
+    }
+    return true;
+}
+
+void BackgroundHighlighter::process(const Job& job) {
+    DocumentState& state = *job.state;
+    Generation& generation = *job.generation;
+
+    // 第一次处理某个版本：按修改窗口更新检查点；版本不连续或整体作废时重建
+    if (state.processed != job.generation) {
+        const bool follows = state.processed && !generation.change.all &&
+                             generation.serial == state.processed->serial + 1;
+        if (!follows) {
+            state.line_states.clear();
+        } else if (generation.change.any) {
+            state.line_states.applyChange(generation.change.first, generation.change.end,
+                                          generation.change.replaced);
+        }
+        state.line_states.setContext(generation.file_type);
+        state.previous = follows ? state.processed : nullptr;
+        state.processed = job.generation;
+    }
+    highlighter_.setFileType(generation.file_type);
+
+    const size_t count = generation.snapshot.lineCount();
+    const size_t first = std::min(job.first_row, count);
+    const size_t last = std::min(std::max(job.last_row, first), count);
+
+    // 跳到远处时先分段推进检查点，期间仍能响应新的任务
+    if (highlighter_.hasMultiLineState()) {
+        const core::LineBuffer& lines = generation.snapshot.lines();
+        while (state.line_states.validRows() < first) {
+            state.line_states.entryState(
+                std::min(state.line_states.validRows() + STATE_STEP_ROWS, first), lines, lex_);
+            if (yield(job)) {
+                return;
+            }
+        }
+    }
+
+    // 先做事再检查新任务，被打断的任务每一轮都有进展
+    size_t styled = 0;
+    auto interrupted = [&](bool did_style) {
+        return did_style && ++styled % YIELD_ROWS == 0 && yield(job);
+    };
+
+    // 可见行：发布完后通知重绘
+    bool published = false;
+    for (size_t row = first; row < last; ++row) {
+        bool did_style = styleRow(state, generation, row);
+        published = published || did_style;
+        if (interrupted(did_style)) {
+            notify_();
+            return;
+        }
+    }
+    if (!generation.ready.exchange(true, std::memory_order_acq_rel)) {
+        published = true;
+    }
+    if (published) {
+        notify_();
+    }
+
+    // 向下预读、向上回看
+    const size_t ahead_end = std::min(count, last + LOOK_AHEAD_ROWS);
+    for (size_t row = last; row < ahead_end; ++row) {
+        if (interrupted(styleRow(state, generation, row))) {
+            return;
+        }
+    }
+    const size_t behind_begin = first > LOOK_BEHIND_ROWS ? first - LOOK_BEHIND_ROWS : 0;
+    for (size_t row = first; row-- > behind_begin;) {
+        if (interrupted(styleRow(state, generation, row))) {
+            return;
+        }
+    }
+    state.previous.reset();
+}
+
+bool BackgroundHighlighter::styleRow(DocumentState& state, Generation& generation, size_t row) {
+    if (generation.find(row)) {
+        return false;
+    }
+
+    const core::LineBuffer& lines = generation.snapshot.lines();
+    const bool multi_line = highlighter_.hasMultiLineState();
+    const uint8_t entry_state = multi_line ? state.line_states.entryState(row, lines, lex_) : 0;
+
+    // 未改动且开头状态相同的行直接沿用上一版本的结果
+    std::shared_ptr<const LineStyles> styles;
+    if (state.previous) {
+        size_t old_row = generation.change.oldRow(row);
+        if (old_row != NO_ROW) {
+            styles = state.previous->published(old_row);
+            if (styles && styles->entry_state != entry_state) {
+                styles.reset();
+            }
+        }
+    }
+    if (!styles) {
+        auto line_styles = std::make_shared<LineStyles>();
+        line_styles->entry_state = entry_state;
+        line_styles->exit_state = highlighter_.tokenizeRuns(std::string(lines.view(row)),
+                                                            entry_state, line_styles->runs);
+        styles = std::move(line_styles);
+    }
+
+    if (multi_line) {
+        state.line_states.recordExitState(row, styles->exit_state);
+    }
+    generation.publish(row, std::move(styles));
+    epoch_.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+} // namespace features
+} // namespace pnana
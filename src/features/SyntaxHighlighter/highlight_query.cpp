@@ -0,0 +1,338 @@
+#include "features/SyntaxHighlighter/highlight_query.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace pnana {
+namespace features {
+
+namespace {
+
+// "; inherits: a,b" 最多展开的层数
+constexpr int MAX_INHERIT_DEPTH = 4;
+
+// 节点覆盖的文本（跨行时以 "\n" 连接）
+std::string nodeText(const core::LineBuffer& lines, TSNode node) {
+    TSPoint start = ts_node_start_point(node);
+    TSPoint end = ts_node_end_point(node);
+    std::string text;
+    for (uint32_t row = start.row; row <= end.row && row < lines.size(); ++row) {
+        std::string_view line = lines.view(row);
+        size_t from = row == start.row ? std::min<size_t>(start.column, line.size()) : 0;
+        size_t to = row == end.row ? std::min<size_t>(end.column, line.size()) : line.size();
+        if (row != start.row) {
+            text += '\n';
+        }
+        if (from < to) {
+            text.append(line.data() + from, to - from);
+        }
+    }
+    return text;
+}
+
+// 读取 <dir>/<language>/highlights.scm，并按首行的 "; inherits: a,b" 先拼接被继承语言的查询
+bool readQuerySource(const std::string& language_name, int depth, std::string& source,
+                     std::string& origin) {
+    for (const auto& dir : HighlightQuery::searchPaths()) {
+        fs::path path = fs::path(dir) / language_name / "highlights.scm";
+        std::error_code ec;
+        if (!fs::is_regular_file(path, ec)) {
+            continue;
+        }
+
+        std::ifstream file(path, std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(file)),
+                            std::istreambuf_iterator<char>());
+        if (!file.good() && !file.eof()) {
+            LOG_WARNING("Failed to read highlight query: " + path.string());
+            return false;
+        }
+
+        const std::string INHERITS = "; inherits:";
+        if (depth < MAX_INHERIT_DEPTH && content.compare(0, INHERITS.size(), INHERITS) == 0) {
+            std::stringstream ss(
+                content.substr(INHERITS.size(), content.find('\n') - INHERITS.size()));
+            std::string parent;
+            while (std::getline(ss, parent, ',')) {
+                parent.erase(0, parent.find_first_not_of(" \t\r"));
+                parent.erase(parent.find_last_not_of(" \t\r") + 1);
+                if (!parent.empty()) {
+                    std::string parent_origin;
+                    readQuerySource(parent, depth + 1, source, parent_origin);
+                }
+            }
+        }
+
+        source += content;
+        source += '\n';
+        origin = path.string();
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+HighlightQuery::~HighlightQuery() {
+    if (cursor_) {
+        ts_query_cursor_delete(cursor_);
+    }
+    if (query_) {
+        ts_query_delete(query_);
+    }
+}
+
+std::vector<std::string> HighlightQuery::searchPaths() {
+    std::vector<std::string> paths;
+    if (const char* home = getenv("HOME")) {
+        paths.push_back(std::string(home) + "/.config/pnana/queries");
+    }
+    paths.push_back("/usr/local/share/pnana/queries");
+    paths.push_back("/usr/share/pnana/queries");
+    return paths;
+}
+
+std::unique_ptr<HighlightQuery> HighlightQuery::load(const TSLanguage* language,
+                                                     const std::string& language_name) {
+    std::string source;
+    std::string origin;
+    if (!language || language_name.empty() ||
+        !readQuerySource(language_name, 0, source, origin)) {
+        return nullptr;
+    }
+    return compile(language, source, origin);
+}
+
+std::unique_ptr<HighlightQuery> HighlightQuery::compile(const TSLanguage* language,
+                                                        const std::string& source,
+                                                        const std::string& origin) {
+    uint32_t error_offset = 0;
+    TSQueryError error_type = TSQueryErrorNone;
+    TSQuery* query = ts_query_new(language, source.c_str(), static_cast<uint32_t>(source.length()),
+                                  &error_offset, &error_type);
+    if (!query) {
+        LOG_WARNING("Failed to compile highlight query " + origin + " at offset " +
+                    std::to_string(error_offset) + " (error " +
+                    std::to_string(static_cast<int>(error_type)) + ")");
+        return nullptr;
+    }
+
+    std::unique_ptr<HighlightQuery> result(new HighlightQuery());
+    result->query_ = query;
+    result->cursor_ = ts_query_cursor_new();
+
+    // capture 名称只在这里解析一次，执行时直接按编号取样式
+    uint32_t capture_count = ts_query_capture_count(query);
+    result->capture_styles_.resize(capture_count, HighlightStyle::NONE);
+    for (uint32_t i = 0; i < capture_count; ++i) {
+        uint32_t length = 0;
+        const char* name = ts_query_capture_name_for_id(query, i, &length);
+        result->capture_styles_[i] = styleForCapture(std::string(name, length));
+    }
+
+    uint32_t pattern_count = ts_query_pattern_count(query);
+    result->predicates_.resize(pattern_count);
+    for (uint32_t i = 0; i < pattern_count; ++i) {
+        if (!result->parsePredicates(i)) {
+            ts_query_disable_pattern(query, i);
+        }
+    }
+
+    LOG("Loaded highlight query " + origin + " (" + std::to_string(pattern_count) +
+        " patterns, " + std::to_string(capture_count) + " captures)");
+    return result;
+}
+
+HighlightStyle HighlightQuery::styleForCapture(const std::string& name) {
+    // 按顺序匹配，更具体的名称在前；匹配整个名称或以 "前缀." 开头
+    static const std::pair<const char*, HighlightStyle> STYLES[] = {
+        {"keyword.directive", HighlightStyle::PREPROCESSOR},
+        {"keyword.import", HighlightStyle::PREPROCESSOR},
+        {"function.macro", HighlightStyle::PREPROCESSOR},
+        {"constant.builtin", HighlightStyle::KEYWORD},
+        {"constant.numeric", HighlightStyle::NUMBER},
+        {"keyword", HighlightStyle::KEYWORD},
+        {"conditional", HighlightStyle::KEYWORD},
+        {"repeat", HighlightStyle::KEYWORD},
+        {"exception", HighlightStyle::KEYWORD},
+        {"storageclass", HighlightStyle::KEYWORD},
+        {"boolean", HighlightStyle::KEYWORD},
+        {"tag", HighlightStyle::KEYWORD},
+        {"include", HighlightStyle::PREPROCESSOR},
+        {"preproc", HighlightStyle::PREPROCESSOR},
+        {"define", HighlightStyle::PREPROCESSOR},
+        {"string", HighlightStyle::STRING},
+        {"character", HighlightStyle::STRING},
+        {"escape", HighlightStyle::STRING},
+        {"comment", HighlightStyle::COMMENT},
+        {"number", HighlightStyle::NUMBER},
+        {"float", HighlightStyle::NUMBER},
+        {"function", HighlightStyle::FUNCTION},
+        {"method", HighlightStyle::FUNCTION},
+        {"constructor", HighlightStyle::TYPE},
+        {"type", HighlightStyle::TYPE},
+        {"attribute", HighlightStyle::TYPE},
+        {"operator", HighlightStyle::OPERATOR},
+    };
+
+    for (const auto& entry : STYLES) {
+        size_t length = std::char_traits<char>::length(entry.first);
+        if (name.compare(0, length, entry.first) == 0 &&
+            (name.length() == length || name[length] == '.')) {
+            return entry.second;
+        }
+    }
+    return HighlightStyle::NONE;
+}
+
+bool HighlightQuery::parsePredicates(uint32_t pattern) {
+    uint32_t step_count = 0;
+    const TSQueryPredicateStep* steps =
+        ts_query_predicates_for_pattern(query_, pattern, &step_count);
+
+    auto stringValue = [this](uint32_t id) {
+        uint32_t length = 0;
+        const char* value = ts_query_string_value_for_id(query_, id, &length);
+        return std::string(value, length);
+    };
+
+    // 每个谓词为：名称、参数……、Done
+    for (uint32_t i = 0; i < step_count;) {
+        uint32_t end = i;
+        while (end < step_count && steps[end].type != TSQueryPredicateStepTypeDone) {
+            ++end;
+        }
+
+        if (end - i >= 2 && steps[i].type == TSQueryPredicateStepTypeString &&
+            steps[i + 1].type == TSQueryPredicateStepTypeCapture) {
+            std::string name = stringValue(steps[i].value_id);
+            Predicate predicate;
+            bool supported = true;
+            if (name == "eq?" || name == "not-eq?") {
+                predicate.kind = Predicate::EQ;
+            } else if (name == "match?" || name == "not-match?") {
+                predicate.kind = Predicate::MATCH;
+            } else if (name == "any-of?" || name == "not-any-of?") {
+                predicate.kind = Predicate::ANY_OF;
+            } else {
+                supported = false; // #set!、#is? 等不影响是否匹配，忽略
+            }
+            predicate.negate = name.compare(0, 4, "not-") == 0;
+            predicate.capture = steps[i + 1].value_id;
+            for (uint32_t k = i + 2; k < end; ++k) {
+                if (steps[k].type == TSQueryPredicateStepTypeCapture) {
+                    predicate.other_capture = steps[k].value_id;
+                } else {
+                    predicate.values.push_back(stringValue(steps[k].value_id));
+                }
+            }
+            // 只有 #eq? 可以与另一个 capture 比较；#match?、#any-of? 需要字面量参数
+            if (predicate.values.empty() &&
+                (predicate.kind != Predicate::EQ || predicate.other_capture < 0)) {
+                supported = false;
+            }
+
+            if (supported && predicate.kind == Predicate::MATCH) {
+                try {
+                    predicate.regex = std::regex(predicate.values[0], std::regex::ECMAScript |
+                                                                          std::regex::optimize);
+                } catch (const std::regex_error&) {
+                    LOG_WARNING("Disabling highlight pattern " + std::to_string(pattern) +
+                                ", unsupported regex: " + predicate.values[0]);
+                    return false;
+                }
+            }
+            if (supported) {
+                predicates_[pattern].push_back(std::move(predicate));
+            }
+        }
+        i = end + 1;
+    }
+    return true;
+}
+
+bool HighlightQuery::matchPredicates(const TSQueryMatch& match,
+                                     const core::LineBuffer& lines) const {
+    auto captureText = [&](uint32_t capture, std::string& text) {
+        for (uint16_t i = 0; i < match.capture_count; ++i) {
+            if (match.captures[i].index == capture) {
+                text = nodeText(lines, match.captures[i].node);
+                return true;
+            }
+        }
+        return false;
+    };
+
+    for (const auto& predicate : predicates_[match.pattern_index]) {
+        std::string text;
+        if (!captureText(predicate.capture, text)) {
+            continue; // 可选的 capture 不存在时谓词不起作用
+        }
+
+        bool result = false;
+        switch (predicate.kind) {
+            case Predicate::EQ:
+                if (predicate.other_capture >= 0) {
+                    std::string other;
+                    result = captureText(static_cast<uint32_t>(predicate.other_capture), other) &&
+                             text == other;
+                } else {
+                    result = text == predicate.values[0];
+                }
+                break;
+            case Predicate::MATCH:
+                result = std::regex_search(text, predicate.regex);
+                break;
+            case Predicate::ANY_OF:
+                result = std::find(predicate.values.begin(), predicate.values.end(), text) !=
+                         predicate.values.end();
+                break;
+        }
+        if (result == predicate.negate) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void HighlightQuery::run(TSNode root, uint32_t start_byte, uint32_t end_byte,
+                         const core::LineBuffer& lines, const CaptureFn& fn) {
+    ts_query_cursor_set_byte_range(cursor_, start_byte, end_byte);
+    ts_query_cursor_exec(cursor_, query_, root);
+
+    TSQueryMatch match;
+    uint32_t capture_index = 0;
+    uint32_t last_start = UINT32_MAX;
+    uint32_t last_end = 0;
+    while (ts_query_cursor_next_capture(cursor_, &match, &capture_index)) {
+        const TSQueryCapture& capture = match.captures[capture_index];
+        HighlightStyle style = capture_styles_[capture.index];
+        if (style == HighlightStyle::NONE) {
+            continue;
+        }
+
+        // 同一节点已由更靠前的模式着色
+        uint32_t node_start = ts_node_start_byte(capture.node);
+        uint32_t node_end = ts_node_end_byte(capture.node);
+        if (node_start == last_start && node_end == last_end) {
+            continue;
+        }
+        if (!predicates_[match.pattern_index].empty() && !matchPredicates(match, lines)) {
+            continue;
+        }
+
+        last_start = node_start;
+        last_end = node_end;
+        fn(capture.node, style);
+    }
+}
+
+} // namespace features
+} // namespace pnana
@@ -4,6 +4,7 @@
 #include "features/SyntaxHighlighter/syntax_highlighter_tree_sitter.h"
 #endif
 #include "features/SyntaxHighlighter/makefile_syntax_constants.h"
+#include "features/SyntaxHighlighter/table_lexer.h"
 #include <algorithm>
 #include <cctype>
 #include <cstring>
@@ -43,14 +44,24 @@ inline bool isAsciiAlpha(unsigned char c) {
     size_t len = getUtf8CharLength(c);
     return std::min(pos + len, str.length());
 }
+
+// 专门的分词器每次最多处理的字节数，超长行分块处理（表驱动分词器线性扫描，不分块）
+constexpr size_t LEX_CHUNK_LENGTH = 8192;
+
+// 按语言名查找关键字/类型集合，没有时返回 nullptr
+const pnana::features::WordSet* findWordSet(
+    const std::map<std::string, pnana::features::WordSet>& sets, const std::string& language) {
+    auto it = sets.find(language);
+    return it != sets.end() ? &it->second : nullptr;
+}
 } // namespace
 
 namespace pnana {
 namespace features {
 
 SyntaxHighlighter::SyntaxHighlighter(ui::Theme& theme, SyntaxHighlightBackend backend)
-    : theme_(theme), current_file_type_("text"), backend_(backend), in_multiline_comment_(false),
-      in_multiline_string_(false) {
+    : theme_(theme), current_file_type_("text"), backend_(backend), current_keywords_(nullptr),
+      current_types_(nullptr), in_multiline_comment_(false), in_multiline_string_(false) {
     initializeLanguages();
 
     // 如果使用 Tree-sitter 后端且可用，初始化 Tree-sitter
@@ -841,6 +852,15 @@ void SyntaxHighlighter::initializeLanguages() {
 
     types_["meson"] = {"str", "int", "bool", "list", "dict", "exe", "lib", "dep", "inc", "tgt"};
 
+    // Standard ML
+    keywords_["sml"] = {"abstype",  "and",     "andalso", "as",        "case",   "datatype",
+                        "do",       "else",    "end",     "exception", "fn",     "fun",
+                        "handle",   "if",      "in",      "infix",     "infixr", "let",
+                        "local",    "nonfix",  "of",      "op",        "open",   "orelse",
+                        "raise",    "rec",     "then",    "type",      "val",    "with",
+                        "withtype", "while",   "sig",     "signature", "struct", "structure",
+                        "functor",  "include", "sharing", "where",     "true",   "false"};
+
     // TOML 配置格式
     keywords_["toml"] = {"true", "false", "null", "nan", "inf", "-inf"};
 
@@ -882,6 +902,15 @@ void SyntaxHighlighter::setFileType(const std::string& file_type) {
     if (current_file_type_ != file_type) {
         current_file_type_ = file_type;
 
+        // 有声明式定义的语言使用表驱动分词器，关键字表按其 word_set 查找
+        table_lexer_.reset();
+        current_keywords_ = findWordSet(keywords_, file_type);
+        current_types_ = findWordSet(types_, file_type);
+        if (const LanguageSpec* spec = TableLexer::findSpec(file_type)) {
+            table_lexer_ = std::make_unique<TableLexer>(
+                *spec, findWordSet(keywords_, spec->word_set), findWordSet(types_, spec->word_set));
+        }
+
         // 如果使用 Tree-sitter，更新其文件类型
         // 即使 Tree-sitter 不支持该文件类型，也调用 setFileType 以确保状态正确重置
 #ifdef BUILD_TREE_SITTER_SUPPORT
@@ -928,6 +957,214 @@ ftxui::Element SyntaxHighlighter::highlightLine(const std::string& line) {
     return highlightLineNative(line);
 }
 
+bool SyntaxHighlighter::hasMultiLineState() const {
+    if (usesDocumentTree()) {
+        return false;
+    }
+    if (table_lexer_) {
+        return table_lexer_->hasMultiLineState();
+    }
+    return current_file_type_ == "cpp" || current_file_type_ == "c";
+}
+
+uint8_t SyntaxHighlighter::lexLine(const std::string& line, uint8_t state) {
+    setMultiLineState(state);
+    if (!line.empty()) {
+        if (table_lexer_) {
+            TokenRuns runs;
+            return table_lexer_->scan(line, state, runs);
+        }
+        // 超长行与 locateTokens 相同地分块，块边界处的状态才一致
+        if (line.length() > LEX_CHUNK_LENGTH) {
+            locateTokens(line);
+        } else {
+            tokenize(line);
+        }
+    }
+    return getMultiLineState();
+}
+
+StyleSpans SyntaxHighlighter::highlightSpans(const std::string& line) {
+    if (line.empty()) {
+        return {};
+    }
+
+#ifdef BUILD_TREE_SITTER_SUPPORT
+    if (backend_ == SyntaxHighlightBackend::TREE_SITTER && tree_sitter_highlighter_ &&
+        tree_sitter_highlighter_->supportsFileType(current_file_type_)) {
+        try {
+            return tree_sitter_highlighter_->highlightSpans(line);
+        } catch (...) {
+            // Tree-sitter 处理失败，回退到原生实现
+        }
+    }
+#endif
+
+    return highlightSpansNative(line);
+}
+
+bool SyntaxHighlighter::usesDocumentTree() const {
+#ifdef BUILD_TREE_SITTER_SUPPORT
+    return backend_ == SyntaxHighlightBackend::TREE_SITTER && tree_sitter_highlighter_ &&
+           tree_sitter_highlighter_->supportsFileType(current_file_type_);
+#else
+    return false;
+#endif
+}
+
+StyleSpans SyntaxHighlighter::highlightSpans(core::Document& doc, size_t row,
+                                             const std::string& line, size_t begin, size_t end) {
+    end = std::min(end, line.length());
+    if (begin >= end) {
+        return {};
+    }
+#ifdef BUILD_TREE_SITTER_SUPPORT
+    if (usesDocumentTree()) {
+        try {
+            StyleSpans spans;
+            if (tree_sitter_highlighter_->highlightDocumentLine(doc, row, spans, begin, end)) {
+                return spans;
+            }
+        } catch (...) {
+            // 语法树不可用，回退到按行高亮
+        }
+    }
+#else
+    (void)doc;
+    (void)row;
+#endif
+
+    if (begin == 0 && end == line.length()) {
+        return highlightSpans(line);
+    }
+    // 文档正在加载或过大而退回按行解析时，超长行只解析窗口内的部分
+    StyleSpans spans = highlightSpans(line.substr(begin, end - begin));
+    for (auto& span : spans) {
+        span.start += begin;
+        span.end += begin;
+    }
+    return spans;
+}
+
+uint8_t SyntaxHighlighter::tokenizeRuns(const std::string& line, uint8_t state,
+                                        TokenRuns& runs) {
+    setMultiLineState(state);
+    runs.clear();
+    if (!line.empty()) {
+        runs = locateTokens(line);
+    }
+    return getMultiLineState();
+}
+
+StyleSpans SyntaxHighlighter::spansForRuns(const TokenRuns& runs, size_t begin,
+                                           size_t end) const {
+    // runs 首尾相接，二分找到第一个与范围相交的区间
+    auto first = std::upper_bound(runs.begin(), runs.end(), begin,
+                                  [](size_t pos, const TokenRun& run) { return pos < run.end; });
+    StyleSpans spans;
+    for (auto it = first; it != runs.end() && it->start < end; ++it) {
+        const TokenRun& run = *it;
+        Color run_color = getColorForToken(run.type);
+        if (!spans.empty() && spans.back().end == run.start && spans.back().color == run_color) {
+            spans.back().end = run.end; // 相邻同色合并，减少元素数量
+        } else {
+            spans.push_back({run.start, run.end, run_color});
+        }
+    }
+    return spans;
+}
+
+SyntaxHighlighter::TokenRuns SyntaxHighlighter::locateTokens(const std::string& line) {
+    TokenRuns runs;
+    if (table_lexer_) {
+        // 表驱动分词器直接给出区间，不需要定位 token
+        setMultiLineState(table_lexer_->scan(line, getMultiLineState(), runs));
+        return runs;
+    }
+    if (line.length() <= LEX_CHUNK_LENGTH) {
+        appendTokenRuns(line, 0, tokenize(line), runs);
+        return runs;
+    }
+
+    // 超长行分块分词：块尾可能截断最后一个 token（如字符串），丢弃它并从它的起点开始下一块。
+    // 被丢弃的 token 在块内开始，开始处不在块注释或块字符串中，多行状态从 0 继续；
+    // 整块只有一个 token 时（很长的字符串或注释）块长加倍后重新分词
+    size_t start = 0;
+    size_t chunk_length = LEX_CHUNK_LENGTH;
+    while (start < line.length()) {
+        size_t end = std::min(line.length(), start + chunk_length);
+        while (end < line.length() && (static_cast<unsigned char>(line[end]) & 0xC0) == 0x80) {
+            end++; // 不切开 UTF-8 字符
+        }
+        const size_t run_count = runs.size();
+        const size_t last_end = runs.empty() ? 0 : runs.back().end;
+        const uint8_t state = getMultiLineState();
+        std::string chunk = line.substr(start, end - start);
+        appendTokenRuns(chunk, start, tokenize(chunk), runs);
+        if (end == line.length()) {
+            break;
+        }
+        if (runs.back().start > start) {
+            start = runs.back().start;
+            runs.pop_back();
+            setMultiLineState(0);
+            chunk_length = LEX_CHUNK_LENGTH;
+        } else {
+            runs.resize(run_count); // 撤销本块（第一个区间可能并入了上一块的最后一个区间）
+            if (!runs.empty()) {
+                runs.back().end = last_end;
+            }
+            setMultiLineState(state);
+            chunk_length *= 2;
+        }
+    }
+    return runs;
+}
+
+void SyntaxHighlighter::appendTokenRuns(const std::string& text, size_t offset,
+                                        const std::vector<Token>& tokens, TokenRuns& runs) {
+    // 定位每个 token 在行内的位置：多数分词器的 token 首尾相接，
+    // 个别分词器（如 markdown）会跳过部分字符，未覆盖的部分按普通文本处理
+    size_t pos = 0;
+    auto addRun = [&runs, offset](size_t start, size_t end, TokenType type) {
+        if (!runs.empty() && runs.back().end == offset + start && runs.back().type == type) {
+            runs.back().end = offset + end;
+        } else {
+            runs.push_back({offset + start, offset + end, type});
+        }
+    };
+    for (const auto& token : tokens) {
+        const std::string& token_text = token.text;
+        if (token_text.empty()) {
+            continue;
+        }
+        size_t start;
+        if (text.compare(pos, token_text.length(), token_text) == 0) {
+            start = pos;
+        } else if (token.start >= pos && token.start <= text.length() &&
+                   text.compare(token.start, token_text.length(), token_text) == 0) {
+            start = token.start;
+        } else {
+            start = text.find(token_text, pos);
+            if (start == std::string::npos) {
+                continue;
+            }
+        }
+        if (start > pos) {
+            addRun(pos, start, TokenType::NORMAL);
+        }
+        pos = start + token_text.length();
+        addRun(start, pos, token.type);
+    }
+    if (pos < text.length()) {
+        addRun(pos, text.length(), TokenType::NORMAL);
+    }
+}
+
+StyleSpans SyntaxHighlighter::highlightSpansNative(const std::string& line) {
+    return spansForRuns(locateTokens(line));
+}
+
 ftxui::Element SyntaxHighlighter::highlightLineNative(const std::string& line) {
     if (line.empty()) {
         return text("");
@@ -970,6 +1207,19 @@ ftxui::Element SyntaxHighlighter::highlightLineNative(const std::string& line) {
 }
 
 std::vector<Token> SyntaxHighlighter::tokenize(const std::string& line) {
+    if (table_lexer_) {
+        // 声明式定义的语言：由分类表分词，再按区间切出 token
+        TokenRuns runs;
+        setMultiLineState(table_lexer_->scan(line, getMultiLineState(), runs));
+        std::vector<Token> tokens;
+        tokens.reserve(runs.size());
+        for (const auto& run : runs) {
+            tokens.push_back({line.substr(run.start, run.end - run.start), run.type, run.start,
+                              run.end});
+        }
+        return tokens;
+    }
+
     if (current_file_type_ == "cpp" || current_file_type_ == "c") {
         return tokenizeCpp(line);
     } else if (current_file_type_ == "python") {
@@ -980,86 +1230,21 @@ std::vector<Token> SyntaxHighlighter::tokenize(const std::string& line) {
         return tokenizeJSON(line);
     } else if (current_file_type_ == "markdown") {
         return tokenizeMarkdown(line);
-    } else if (current_file_type_ == "shell") {
-        return tokenizeShell(line);
-    } else if (current_file_type_ == "lua") {
-        return tokenizeLua(line);
-    } else if (current_file_type_ == "cmake") {
-        return tokenizeCMake(line);
-    } else if (current_file_type_ == "tcl") {
-        return tokenizeTCL(line);
-    } else if (current_file_type_ == "fortran") {
-        return tokenizeFortran(line);
-    } else if (current_file_type_ == "haskell") {
-        return tokenizeHaskell(line);
     } else if (current_file_type_ == "yaml" || current_file_type_ == "yml") {
         return tokenizeYAML(line);
     } else if (current_file_type_ == "xml") {
         return tokenizeXML(line);
     } else if (current_file_type_ == "html" || current_file_type_ == "htm") {
         return tokenizeHTML(line);
-    } else if (current_file_type_ == "meson") {
-        return tokenizeMeson(line);
-    } else if (current_file_type_ == "toml") {
-        return tokenizeTOML(line);
     } else if (current_file_type_ == "css" || current_file_type_ == "scss" ||
                current_file_type_ == "sass") {
         return tokenizeCSS(line);
-    } else if (current_file_type_ == "sql") {
-        return tokenizeSQL(line);
-    } else if (current_file_type_ == "ruby" || current_file_type_ == "rb") {
-        return tokenizeRuby(line);
     } else if (current_file_type_ == "php") {
         return tokenizePHP(line);
-    } else if (current_file_type_ == "swift") {
-        return tokenizeSwift(line);
-    } else if (current_file_type_ == "kotlin" || current_file_type_ == "kt") {
-        return tokenizeKotlin(line);
-    } else if (current_file_type_ == "scala") {
-        return tokenizeScala(line);
-    } else if (current_file_type_ == "r" || current_file_type_ == "R") {
-        return tokenizeR(line);
-    } else if (current_file_type_ == "perl" || current_file_type_ == "pl" ||
-               current_file_type_ == "pm") {
-        return tokenizePerl(line);
     } else if (current_file_type_ == "dockerfile") {
         return tokenizeDockerfile(line);
     } else if (current_file_type_ == "makefile") {
         return tokenizeMakefile(line);
-    } else if (current_file_type_ == "vim" || current_file_type_ == "vimrc") {
-        return tokenizeVim(line);
-    } else if (current_file_type_ == "powershell" || current_file_type_ == "ps1") {
-        return tokenizePowerShell(line);
-    } else if (current_file_type_ == "elixir") {
-        return tokenizeElixir(line);
-    } else if (current_file_type_ == "clojure") {
-        return tokenizeClojure(line);
-    } else if (current_file_type_ == "erlang") {
-        return tokenizeErlang(line);
-    } else if (current_file_type_ == "julia") {
-        return tokenizeJulia(line);
-    } else if (current_file_type_ == "dart") {
-        return tokenizeDart(line);
-    } else if (current_file_type_ == "nim") {
-        return tokenizeNim(line);
-    } else if (current_file_type_ == "crystal") {
-        return tokenizeCrystal(line);
-    } else if (current_file_type_ == "zig") {
-        return tokenizeZig(line);
-    } else if (current_file_type_ == "ocaml") {
-        return tokenizeOCaml(line);
-    } else if (current_file_type_ == "coq") {
-        return tokenizeCoq(line);
-    } else if (current_file_type_ == "agda") {
-        return tokenizeAgda(line);
-    } else if (current_file_type_ == "idris") {
-        return tokenizeIdris(line);
-    } else if (current_file_type_ == "purescript") {
-        return tokenizePureScript(line);
-    } else if (current_file_type_ == "reason") {
-        return tokenizeReason(line);
-    } else if (current_file_type_ == "sml") {
-        return tokenizeSML(line);
     } else if (current_file_type_ == "lisp" || current_file_type_ == "cl" ||
                current_file_type_ == "commonlisp" || current_file_type_ == "scheme" ||
                current_file_type_ == "scm") {
@@ -1068,108 +1253,9 @@ std::vector<Token> SyntaxHighlighter::tokenize(const std::string& line) {
         return tokenizeLLVMIR(line);
     } else if (current_file_type_ == "asm" || current_file_type_ == "s" ||
                current_file_type_ == "riscv" || current_file_type_ == "mips" ||
-               current_file_type_ == "arm" || current_file_type_ == "x86") {
+               current_file_type_ == "arm" || current_file_type_ == "x86" ||
+               current_file_type_ == "assembly") {
         return tokenizeAssembly(line);
-    } else if (current_file_type_ == "groovy") {
-        return tokenizeGroovy(line);
-    } else if (current_file_type_ == "coffeescript") {
-        return tokenizeCoffeeScript(line);
-    } else if (current_file_type_ == "pug") {
-        return tokenizePug(line);
-    } else if (current_file_type_ == "stylus") {
-        return tokenizeStylus(line);
-    } else if (current_file_type_ == "sass") {
-        return tokenizeSass(line);
-    } else if (current_file_type_ == "less") {
-        return tokenizeLess(line);
-    } else if (current_file_type_ == "postcss") {
-        return tokenizePostCSS(line);
-    } else if (current_file_type_ == "graphql") {
-        return tokenizeGraphQL(line);
-    } else if (current_file_type_ == "vue") {
-        return tokenizeVue(line);
-    } else if (current_file_type_ == "svelte") {
-        return tokenizeSvelte(line);
-    } else if (current_file_type_ == "fsharp") {
-        return tokenizeFSharp(line);
-    } else if (current_file_type_ == "csharp") {
-        return tokenizeCSharp(line);
-    } else if (current_file_type_ == "vb") {
-        return tokenizeVB(line);
-    } else if (current_file_type_ == "assembly") {
-        return tokenizeAssembly(line);
-    } else if (current_file_type_ == "webassembly") {
-        return tokenizeWebAssembly(line);
-    } else if (current_file_type_ == "verilog") {
-        return tokenizeVerilog(line);
-    } else if (current_file_type_ == "vhdl") {
-        return tokenizeVHDL(line);
-    } else if (current_file_type_ == "matlab") {
-        return tokenizeMATLAB(line);
-    } else if (current_file_type_ == "octave") {
-        return tokenizeOctave(line);
-    } else if (current_file_type_ == "racket") {
-        return tokenizeRacket(line);
-    } else if (current_file_type_ == "scheme") {
-        return tokenizeScheme(line);
-    } else if (current_file_type_ == "commonlisp") {
-        return tokenizeCommonLisp(line);
-    } else if (current_file_type_ == "emacslisp") {
-        return tokenizeEmacsLisp(line);
-    } else if (current_file_type_ == "prolog") {
-        return tokenizeProlog(line);
-    } else if (current_file_type_ == "mercury") {
-        return tokenizeMercury(line);
-    } else if (current_file_type_ == "alloy") {
-        return tokenizeAlloy(line);
-    } else if (current_file_type_ == "dafny") {
-        return tokenizeDafny(line);
-    } else if (current_file_type_ == "lean") {
-        return tokenizeLean(line);
-    } else if (current_file_type_ == "ballerina") {
-        return tokenizeBallerina(line);
-    } else if (current_file_type_ == "cadence") {
-        return tokenizeCadence(line);
-    } else if (current_file_type_ == "clarity") {
-        return tokenizeClarity(line);
-    } else if (current_file_type_ == "solidity") {
-        return tokenizeSolidity(line);
-    } else if (current_file_type_ == "vyper") {
-        return tokenizeVyper(line);
-    } else if (current_file_type_ == "carbon") {
-        return tokenizeCarbon(line);
-    } else if (current_file_type_ == "vala") {
-        return tokenizeVala(line);
-    } else if (current_file_type_ == "genie") {
-        return tokenizeGenie(line);
-    } else if (current_file_type_ == "dlang") {
-        return tokenizeD(line);
-    } else if (current_file_type_ == "pony") {
-        return tokenizePony(line);
-    } else if (current_file_type_ == "vlang") {
-        return tokenizeV(line);
-    } else if (current_file_type_ == "odin") {
-        return tokenizeOdin(line);
-    } else if (current_file_type_ == "jai") {
-        return tokenizeJai(line);
-    } else if (current_file_type_ == "nelua") {
-        return tokenizeNelua(line);
-    } else if (current_file_type_ == "wren") {
-        return tokenizeWren(line);
-    } else if (current_file_type_ == "moonscript") {
-        return tokenizeMoonScript(line);
-    } else if (current_file_type_ == "fantom") {
-        return tokenizeFantom(line);
-    } else if (current_file_type_ == "smalltalk") {
-        return tokenizeSmalltalk(line);
-    } else if (current_file_type_ == "apl") {
-        return tokenizeAPL(line);
-    } else if (current_file_type_ == "jlang") {
-        return tokenizeJ(line);
-    } else if (current_file_type_ == "klang") {
-        return tokenizeK(line);
-    } else if (current_file_type_ == "qlang") {
-        return tokenizeQ(line);
     }
 
     // 默认：不高亮
@@ -2012,337 +2098,108 @@ std::vector<Token> SyntaxHighlighter::tokenizeMarkdown(const std::string& line)
     return tokens;
 }
 
-std::vector<Token> SyntaxHighlighter::tokenizeShell(const std::string& line) {
-    std::vector<Token> tokens;
-    size_t i = 0;
+ftxui::Color SyntaxHighlighter::getColorForToken(TokenType type) const {
+    auto& colors = theme_.getColors();
 
-    while (i < line.length()) {
-        if (std::isspace(line[i])) {
-            size_t start = i;
-            while (i < line.length() && std::isspace(line[i]))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NORMAL, start, i});
-            continue;
-        }
+    switch (type) {
+        case TokenType::KEYWORD:
+            return colors.keyword;
+        case TokenType::STRING:
+            return colors.string;
+        case TokenType::COMMENT:
+            return colors.comment;
+        case TokenType::NUMBER:
+            return colors.number;
+        case TokenType::FUNCTION:
+            return colors.function;
+        case TokenType::TYPE:
+            return colors.type;
+        case TokenType::OPERATOR:
+            return colors.operator_color;
+        case TokenType::PREPROCESSOR:
+            return colors.keyword; // 使用关键字颜色
+        case TokenType::NORMAL:
+        default:
+            return colors.foreground;
+    }
+}
 
-        // 注释
-        if (line[i] == '#') {
-            tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
-            break;
-        }
+bool SyntaxHighlighter::isKeyword(std::string_view word) const {
+    return current_keywords_ && current_keywords_->contains(word);
+}
 
-        // 字符串
-        if (line[i] == '"' || line[i] == '\'') {
-            char quote = line[i];
-            size_t start = i;
-            i++;
-            while (i < line.length() && line[i] != quote) {
-                if (line[i] == '\\' && i + 1 < line.length())
-                    i += 2;
-                else
-                    i++;
-            }
-            if (i < line.length())
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
+bool SyntaxHighlighter::isType(std::string_view word) const {
+    return current_types_ && current_types_->contains(word);
+}
 
-        // 变量
-        if (line[i] == '$') {
-            size_t start = i;
-            i++;
-            if (i < line.length() && line[i] == '{') {
-                while (i < line.length() && line[i] != '}')
-                    i++;
-                if (i < line.length())
-                    i++;
-            } else {
-                while (i < line.length() && (std::isalnum(line[i]) || line[i] == '_'))
-                    i++;
-            }
-            tokens.push_back({line.substr(start, i - start), TokenType::TYPE, start, i});
-            continue;
-        }
+bool SyntaxHighlighter::isOperator(char ch) const {
+    return ch == '+' || ch == '-' || ch == '*' || ch == '/' || ch == '%' || ch == '=' ||
+           ch == '<' || ch == '>' || ch == '!' || ch == '&' || ch == '|' || ch == '^' ||
+           ch == '~' || ch == '?' || ch == ':' || ch == '(' || ch == ')' || ch == '[' ||
+           ch == ']' || ch == '{' || ch == '}' || ch == ',' || ch == ';' || ch == '.' || ch == '-';
+}
 
-        // 命令/关键字（支持ASCII字符，正确处理UTF-8多字节字符如中文）
-        unsigned char c = static_cast<unsigned char>(line[i]);
-        if (isAsciiAlpha(c)) {
-            size_t start = i;
-            // 只匹配ASCII字母数字、下划线和-，跳过UTF-8多字节字符（如中文）
-            while (i < line.length()) {
-                unsigned char ch = static_cast<unsigned char>(line[i]);
-                if (isAsciiAlnum(ch) || ch == '_' || ch == '-') {
-                    i++;
-                } else if ((ch & 0x80) != 0) {
-                    // UTF-8多字节字符（如中文），作为普通文本处理，停止标识符匹配
-                    break;
-                } else {
-                    // 其他ASCII字符，停止
-                    break;
-                }
-            }
-            std::string word = line.substr(start, i - start);
+bool SyntaxHighlighter::isMultiCharOperator(const std::string& text, size_t pos) const {
+    if (pos + 1 >= text.length())
+        return false;
 
-            TokenType type = isKeyword(word) ? TokenType::KEYWORD : TokenType::NORMAL;
-            tokens.push_back({word, type, start, i});
-            continue;
-        }
+    char ch1 = text[pos];
+    char ch2 = text[pos + 1];
 
-        // 其他
-        tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-        i++;
+    // 双字符操作符
+    if ((ch1 == '=' && ch2 == '=') || (ch1 == '!' && ch2 == '=') || (ch1 == '<' && ch2 == '=') ||
+        (ch1 == '>' && ch2 == '=') || (ch1 == '&' && ch2 == '&') || (ch1 == '|' && ch2 == '|') ||
+        (ch1 == '<' && ch2 == '<') || (ch1 == '>' && ch2 == '>') || (ch1 == '+' && ch2 == '+') ||
+        (ch1 == '-' && ch2 == '-') || (ch1 == '+' && ch2 == '=') || (ch1 == '-' && ch2 == '=') ||
+        (ch1 == '*' && ch2 == '=') || (ch1 == '/' && ch2 == '=') || (ch1 == '%' && ch2 == '=') ||
+        (ch1 == '&' && ch2 == '=') || (ch1 == '|' && ch2 == '=') || (ch1 == '^' && ch2 == '=') ||
+        (ch1 == '-' && ch2 == '>')) {
+        return true;
     }
 
-    return tokens;
+    return false;
 }
 
-std::vector<Token> SyntaxHighlighter::tokenizeLua(const std::string& line) {
-    std::vector<Token> tokens;
-    size_t i = 0;
+size_t SyntaxHighlighter::parseNumber(const std::string& line, size_t start) {
+    size_t i = start;
 
-    while (i < line.length()) {
-        // 跳过空白
-        if (std::isspace(line[i])) {
-            size_t start = i;
-            while (i < line.length() && std::isspace(line[i]))
+    // 十六进制
+    if (i + 1 < line.length() && line[i] == '0' && (line[i + 1] == 'x' || line[i + 1] == 'X')) {
+        i += 2;
+        while (i < line.length() && (std::isxdigit(line[i]) || line[i] == '\''))
+            i++;
+        // 后缀
+        if (i < line.length() &&
+            (line[i] == 'u' || line[i] == 'U' || line[i] == 'l' || line[i] == 'L')) {
+            i++;
+            if (i < line.length() && (line[i] == 'l' || line[i] == 'L'))
                 i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NORMAL, start, i});
-            continue;
         }
+        return i;
+    }
 
-        // 单行注释
-        if (line[i] == '-' && i + 1 < line.length() && line[i + 1] == '-') {
-            tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
-            break;
+    // 八进制或二进制
+    if (i < line.length() && line[i] == '0') {
+        i++;
+        if (i < line.length() && (line[i] == 'b' || line[i] == 'B')) {
+            // 二进制
+            i++;
+            while (i < line.length() && (line[i] == '0' || line[i] == '1' || line[i] == '\''))
+                i++;
+        } else {
+            // 八进制
+            while (i < line.length() && ((line[i] >= '0' && line[i] <= '7') || line[i] == '\''))
+                i++;
         }
-
-        // 多行注释 --[[ ... ]]
-        if (i + 3 < line.length() && line.substr(i, 4) == "--[[") {
-            size_t start = i;
-            i += 4;
-            size_t end_pos = line.find("]]", i);
-            if (end_pos != std::string::npos) {
-                i = end_pos + 2;
-                tokens.push_back({line.substr(start, i - start), TokenType::COMMENT, start, i});
-            } else {
-                tokens.push_back({line.substr(start), TokenType::COMMENT, start, line.length()});
-                break;
-            }
-            continue;
-        }
-
-        // 字符串（支持单引号和双引号）
-        if (line[i] == '"' || line[i] == '\'') {
-            char quote = line[i];
-            size_t start = i;
-            i++;
-            while (i < line.length()) {
-                if (line[i] == '\\' && i + 1 < line.length()) {
-                    i += 2; // 跳过转义字符
-                } else if (line[i] == quote) {
-                    i++;
-                    break;
-                } else {
-                    i++;
-                }
-            }
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        // 长字符串 [[ ... ]]
-        if (i + 1 < line.length() && line[i] == '[' && line[i + 1] == '[') {
-            size_t start = i;
-            i += 2;
-            size_t end_pos = line.find("]]", i);
-            if (end_pos != std::string::npos) {
-                i = end_pos + 2;
-                tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            } else {
-                tokens.push_back({line.substr(start), TokenType::STRING, start, line.length()});
-                break;
-            }
-            continue;
-        }
-
-        // 数字（支持十六进制、科学计数法）
-        if (std::isdigit(line[i]) ||
-            (line[i] == '.' && i + 1 < line.length() && std::isdigit(line[i + 1]))) {
-            size_t start = i;
-            i = parseNumber(line, start);
-            tokens.push_back({line.substr(start, i - start), TokenType::NUMBER, start, i});
-            continue;
-        }
-
-        // 多字符操作符
-        if (i + 1 < line.length()) {
-            std::string two_char = line.substr(i, 2);
-            if (two_char == "==" || two_char == "~=" || two_char == "<=" || two_char == ">=" ||
-                two_char == ".." || two_char == "//" || two_char == "::") {
-                tokens.push_back({two_char, TokenType::OPERATOR, i, i + 2});
-                i += 2;
-                continue;
-            }
-        }
-
-        // 标识符/关键字（支持ASCII字符，正确处理UTF-8多字节字符如中文）
-        unsigned char c = static_cast<unsigned char>(line[i]);
-        if (isAsciiAlpha(c) || line[i] == '_') {
-            size_t start = i;
-            // 只匹配ASCII字母数字和下划线，跳过UTF-8多字节字符（如中文）
-            while (i < line.length()) {
-                unsigned char ch = static_cast<unsigned char>(line[i]);
-                if (isAsciiAlnum(ch) || ch == '_') {
-                    i++;
-                } else if ((ch & 0x80) != 0) {
-                    // UTF-8多字节字符（如中文），作为普通文本处理，停止标识符匹配
-                    break;
-                } else {
-                    // 其他ASCII字符，停止
-                    break;
-                }
-            }
-            std::string word = line.substr(start, i - start);
-
-            TokenType type = TokenType::NORMAL;
-            if (isKeyword(word)) {
-                type = TokenType::KEYWORD;
-            } else if (isType(word)) {
-                type = TokenType::TYPE;
-            } else if (i < line.length() && line[i] == '(') {
-                type = TokenType::FUNCTION;
-            }
-
-            tokens.push_back({word, type, start, i});
-            continue;
-        }
-
-        // 单字符操作符
-        if (isOperator(line[i])) {
-            tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-            i++;
-            continue;
-        }
-
-        // 其他
-        tokens.push_back({std::string(1, line[i]), TokenType::NORMAL, i, i + 1});
-        i++;
-    }
-
-    return tokens;
-}
-
-ftxui::Color SyntaxHighlighter::getColorForToken(TokenType type) const {
-    auto& colors = theme_.getColors();
-
-    switch (type) {
-        case TokenType::KEYWORD:
-            return colors.keyword;
-        case TokenType::STRING:
-            return colors.string;
-        case TokenType::COMMENT:
-            return colors.comment;
-        case TokenType::NUMBER:
-            return colors.number;
-        case TokenType::FUNCTION:
-            return colors.function;
-        case TokenType::TYPE:
-            return colors.type;
-        case TokenType::OPERATOR:
-            return colors.operator_color;
-        case TokenType::PREPROCESSOR:
-            return colors.keyword; // 使用关键字颜色
-        case TokenType::NORMAL:
-        default:
-            return colors.foreground;
-    }
-}
-
-bool SyntaxHighlighter::isKeyword(const std::string& word) const {
-    auto it = keywords_.find(current_file_type_);
-    if (it == keywords_.end())
-        return false;
-
-    return std::find(it->second.begin(), it->second.end(), word) != it->second.end();
-}
-
-bool SyntaxHighlighter::isType(const std::string& word) const {
-    auto it = types_.find(current_file_type_);
-    if (it == types_.end())
-        return false;
-
-    return std::find(it->second.begin(), it->second.end(), word) != it->second.end();
-}
-
-bool SyntaxHighlighter::isOperator(char ch) const {
-    return ch == '+' || ch == '-' || ch == '*' || ch == '/' || ch == '%' || ch == '=' ||
-           ch == '<' || ch == '>' || ch == '!' || ch == '&' || ch == '|' || ch == '^' ||
-           ch == '~' || ch == '?' || ch == ':' || ch == '(' || ch == ')' || ch == '[' ||
-           ch == ']' || ch == '{' || ch == '}' || ch == ',' || ch == ';' || ch == '.' || ch == '-';
-}
-
-bool SyntaxHighlighter::isMultiCharOperator(const std::string& text, size_t pos) const {
-    if (pos + 1 >= text.length())
-        return false;
-
-    char ch1 = text[pos];
-    char ch2 = text[pos + 1];
-
-    // 双字符操作符
-    if ((ch1 == '=' && ch2 == '=') || (ch1 == '!' && ch2 == '=') || (ch1 == '<' && ch2 == '=') ||
-        (ch1 == '>' && ch2 == '=') || (ch1 == '&' && ch2 == '&') || (ch1 == '|' && ch2 == '|') ||
-        (ch1 == '<' && ch2 == '<') || (ch1 == '>' && ch2 == '>') || (ch1 == '+' && ch2 == '+') ||
-        (ch1 == '-' && ch2 == '-') || (ch1 == '+' && ch2 == '=') || (ch1 == '-' && ch2 == '=') ||
-        (ch1 == '*' && ch2 == '=') || (ch1 == '/' && ch2 == '=') || (ch1 == '%' && ch2 == '=') ||
-        (ch1 == '&' && ch2 == '=') || (ch1 == '|' && ch2 == '=') || (ch1 == '^' && ch2 == '=') ||
-        (ch1 == '-' && ch2 == '>')) {
-        return true;
-    }
-
-    return false;
-}
-
-size_t SyntaxHighlighter::parseNumber(const std::string& line, size_t start) {
-    size_t i = start;
-
-    // 十六进制
-    if (i + 1 < line.length() && line[i] == '0' && (line[i + 1] == 'x' || line[i + 1] == 'X')) {
-        i += 2;
-        while (i < line.length() && (std::isxdigit(line[i]) || line[i] == '\''))
-            i++;
-        // 后缀
-        if (i < line.length() &&
-            (line[i] == 'u' || line[i] == 'U' || line[i] == 'l' || line[i] == 'L')) {
-            i++;
-            if (i < line.length() && (line[i] == 'l' || line[i] == 'L'))
-                i++;
-        }
-        return i;
-    }
-
-    // 八进制或二进制
-    if (i < line.length() && line[i] == '0') {
-        i++;
-        if (i < line.length() && (line[i] == 'b' || line[i] == 'B')) {
-            // 二进制
-            i++;
-            while (i < line.length() && (line[i] == '0' || line[i] == '1' || line[i] == '\''))
-                i++;
-        } else {
-            // 八进制
-            while (i < line.length() && ((line[i] >= '0' && line[i] <= '7') || line[i] == '\''))
-                i++;
-        }
-        // 后缀
-        if (i < line.length() &&
-            (line[i] == 'u' || line[i] == 'U' || line[i] == 'l' || line[i] == 'L')) {
-            i++;
-            if (i < line.length() && (line[i] == 'l' || line[i] == 'L'))
-                i++;
-        }
-        return i;
-    }
+        // 后缀
+        if (i < line.length() &&
+            (line[i] == 'u' || line[i] == 'U' || line[i] == 'l' || line[i] == 'L')) {
+            i++;
+            if (i < line.length() && (line[i] == 'l' || line[i] == 'L'))
+                i++;
+        }
+        return i;
+    }
 
     // 十进制或浮点数
     while (i < line.length() && (std::isdigit(line[i]) || line[i] == '\''))
@@ -2496,7 +2353,7 @@ bool SyntaxHighlighter::isTreeSitterAvailable() {
 #endif
 }
 
-std::vector<Token> SyntaxHighlighter::tokenizeCMake(const std::string& line) {
+std::vector<Token> SyntaxHighlighter::tokenizeYAML(const std::string& line) {
     std::vector<Token> tokens;
     size_t i = 0;
 
@@ -2509,11 +2366,13 @@ std::vector<Token> SyntaxHighlighter::tokenizeCMake(const std::string& line) {
             continue;
         }
 
+        // 注释
         if (line[i] == '#') {
             tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
             break;
         }
 
+        // 字符串
         if (line[i] == '"' || line[i] == '\'') {
             char quote = line[i];
             size_t start = i;
@@ -2530,66 +2389,39 @@ std::vector<Token> SyntaxHighlighter::tokenizeCMake(const std::string& line) {
             continue;
         }
 
-        if (line[i] == '$') {
-            size_t start = i;
-            i++;
-            if (i < line.length() && line[i] == '{') {
-                i++;
-                while (i < line.length() && line[i] != '}')
-                    i++;
-                if (i < line.length())
-                    i++;
-            } else if (i + 4 < line.length() && line.substr(i, 4) == "ENV{") {
-                i += 4;
-                while (i < line.length() && line[i] != '}')
-                    i++;
-                if (i < line.length())
-                    i++;
-            }
-            tokens.push_back({line.substr(start, i - start), TokenType::TYPE, start, i});
+        // 布尔值和null
+        if (line.substr(i, 4) == "true" || line.substr(i, 5) == "false" ||
+            line.substr(i, 4) == "null" || line.substr(i, 3) == "yes" ||
+            line.substr(i, 2) == "no" || line.substr(i, 2) == "on" || line.substr(i, 3) == "off") {
+            size_t len = 0;
+            if (line.substr(i, 5) == "false")
+                len = 5;
+            else if (line.substr(i, 4) == "true" || line.substr(i, 4) == "null")
+                len = 4;
+            else if (line.substr(i, 3) == "yes" || line.substr(i, 3) == "off")
+                len = 3;
+            else if (line.substr(i, 2) == "no" || line.substr(i, 2) == "on")
+                len = 2;
+            tokens.push_back({line.substr(i, len), TokenType::KEYWORD, i, i + len});
+            i += len;
             continue;
         }
 
+        // 数字
         if (std::isdigit(line[i]) ||
-            (line[i] == '.' && i + 1 < line.length() && std::isdigit(line[i + 1]))) {
+            (line[i] == '-' && i + 1 < line.length() && std::isdigit(line[i + 1]))) {
             size_t start = i;
-            i = parseNumber(line, start);
+            if (line[i] == '-')
+                i++;
+            while (i < line.length() &&
+                   (std::isdigit(line[i]) || line[i] == '.' || line[i] == 'e' || line[i] == 'E' ||
+                    line[i] == '+' || line[i] == '-'))
+                i++;
             tokens.push_back({line.substr(start, i - start), TokenType::NUMBER, start, i});
             continue;
         }
 
-        unsigned char c = static_cast<unsigned char>(line[i]);
-        if (isAsciiAlpha(c) || line[i] == '_') {
-            size_t start = i;
-            while (i < line.length()) {
-                unsigned char ch = static_cast<unsigned char>(line[i]);
-                if (isAsciiAlnum(ch) || ch == '_') {
-                    i++;
-                } else if ((ch & 0x80) != 0) {
-                    break;
-                } else {
-                    break;
-                }
-            }
-            std::string word = line.substr(start, i - start);
-            TokenType type = TokenType::NORMAL;
-            if (isKeyword(word)) {
-                type = TokenType::KEYWORD;
-            } else if (isType(word)) {
-                type = TokenType::TYPE;
-            } else if (i < line.length() && line[i] == '(') {
-                type = TokenType::FUNCTION;
-            }
-            tokens.push_back({word, type, start, i});
-            continue;
-        }
-
-        if (isOperator(line[i])) {
-            tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-            i++;
-            continue;
-        }
-
+        // 其他
         tokens.push_back({std::string(1, line[i]), TokenType::NORMAL, i, i + 1});
         i++;
     }
@@ -2597,11 +2429,12 @@ std::vector<Token> SyntaxHighlighter::tokenizeCMake(const std::string& line) {
     return tokens;
 }
 
-std::vector<Token> SyntaxHighlighter::tokenizeTCL(const std::string& line) {
+std::vector<Token> SyntaxHighlighter::tokenizeXML(const std::string& line) {
     std::vector<Token> tokens;
     size_t i = 0;
 
     while (i < line.length()) {
+        // 跳过空白
         if (std::isspace(line[i])) {
             size_t start = i;
             while (i < line.length() && std::isspace(line[i]))
@@ -2610,139 +2443,94 @@ std::vector<Token> SyntaxHighlighter::tokenizeTCL(const std::string& line) {
             continue;
         }
 
-        if (line[i] == '#') {
-            tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
-            break;
-        }
-
-        if (line[i] == '{') {
-            size_t start = i;
-            i++;
-            int brace_count = 1;
-            while (i < line.length() && brace_count > 0) {
-                if (line[i] == '{')
-                    brace_count++;
-                else if (line[i] == '}')
-                    brace_count--;
-                i++;
-            }
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        if (line[i] == '"') {
+        // XML注释
+        if (i + 3 < line.length() && line.substr(i, 4) == "<!--") {
             size_t start = i;
-            i++;
-            while (i < line.length() && line[i] != '"') {
-                if (line[i] == '\\' && i + 1 < line.length())
-                    i += 2;
-                else
-                    i++;
+            i += 4;
+            size_t end_pos = line.find("-->", i);
+            if (end_pos != std::string::npos) {
+                i = end_pos + 3;
+                tokens.push_back({line.substr(start, i - start), TokenType::COMMENT, start, i});
+            } else {
+                tokens.push_back({line.substr(start), TokenType::COMMENT, start, line.length()});
+                break;
             }
-            if (i < line.length())
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
             continue;
         }
 
-        if (line[i] == '$') {
+        // XML标签开始
+        if (line[i] == '<') {
             size_t start = i;
             i++;
-            if (i < line.length() && line[i] == '{') {
+            if (i < line.length() && line[i] == '/') {
+                // 闭合标签
                 i++;
-                while (i < line.length() && line[i] != '}')
-                    i++;
-                if (i < line.length())
-                    i++;
-            } else {
-                while (i < line.length() && (std::isalnum(line[i]) || line[i] == '_'))
-                    i++;
             }
-            tokens.push_back({line.substr(start, i - start), TokenType::TYPE, start, i});
-            continue;
-        }
 
-        if (std::isdigit(line[i]) ||
-            (line[i] == '.' && i + 1 < line.length() && std::isdigit(line[i + 1]))) {
-            size_t start = i;
-            i = parseNumber(line, start);
-            tokens.push_back({line.substr(start, i - start), TokenType::NUMBER, start, i});
-            continue;
-        }
+            // 标签名
+            while (i < line.length() &&
+                   (std::isalnum(line[i]) || line[i] == '_' || line[i] == '-' || line[i] == ':'))
+                i++;
 
-        unsigned char c = static_cast<unsigned char>(line[i]);
-        if (isAsciiAlpha(c) || line[i] == '_' || line[i] == ':') {
-            size_t start = i;
-            while (i < line.length()) {
-                unsigned char ch = static_cast<unsigned char>(line[i]);
-                if (isAsciiAlnum(ch) || ch == '_' || ch == ':') {
+            // 属性
+            while (i < line.length() && line[i] != '>' && line[i] != '/') {
+                if (line[i] == '=') {
+                    // 属性值
                     i++;
-                } else if ((ch & 0x80) != 0) {
-                    break;
+                    while (i < line.length() && std::isspace(line[i]))
+                        i++;
+                    if (i < line.length() && (line[i] == '"' || line[i] == '\'')) {
+                        char quote = line[i];
+                        i++;
+                        while (i < line.length() && line[i] != quote) {
+                            if (line[i] == '&' && i + 1 < line.length() && line[i + 1] == ' ') {
+                                i++; // 转义字符
+                            }
+                            i++;
+                        }
+                        if (i < line.length())
+                            i++;
+                    } else {
+                        while (i < line.length() && !std::isspace(line[i]) && line[i] != '>' &&
+                               line[i] != '/')
+                            i++;
+                    }
                 } else {
-                    break;
+                    i++;
                 }
             }
-            std::string word = line.substr(start, i - start);
-            TokenType type = TokenType::NORMAL;
-            if (isKeyword(word)) {
-                type = TokenType::KEYWORD;
-            } else if (isType(word)) {
-                type = TokenType::TYPE;
-            } else if (i < line.length() && line[i] == '(') {
-                type = TokenType::FUNCTION;
-            }
-            tokens.push_back({word, type, start, i});
-            continue;
-        }
 
-        if (isOperator(line[i])) {
-            tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-            i++;
+            if (i < line.length() && line[i] == '/')
+                i++;
+            if (i < line.length() && line[i] == '>')
+                i++;
+
+            tokens.push_back({line.substr(start, i - start), TokenType::KEYWORD, start, i});
             continue;
         }
 
-        tokens.push_back({std::string(1, line[i]), TokenType::NORMAL, i, i + 1});
-        i++;
-    }
-
-    return tokens;
-}
-
-std::vector<Token> SyntaxHighlighter::tokenizeFortran(const std::string& line) {
-    std::vector<Token> tokens;
-    size_t i = 0;
-
-    if (line.length() > 0 &&
-        (line[0] == 'C' || line[0] == 'c' || line[0] == '*' || line[0] == '!')) {
-        tokens.push_back({line, TokenType::COMMENT, 0, line.length()});
-        return tokens;
-    }
-
-    while (i < line.length()) {
-        if (std::isspace(line[i])) {
+        // 实体引用
+        if (line[i] == '&') {
             size_t start = i;
-            while (i < line.length() && std::isspace(line[i]))
+            i++;
+            while (i < line.length() && line[i] != ';')
                 i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NORMAL, start, i});
+            if (i < line.length())
+                i++;
+            tokens.push_back({line.substr(start, i - start), TokenType::TYPE, start, i});
             continue;
         }
 
-        if (line[i] == '!') {
-            tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
-            break;
-        }
-
+        // 字符串内容
         if (line[i] == '"' || line[i] == '\'') {
             char quote = line[i];
             size_t start = i;
             i++;
             while (i < line.length() && line[i] != quote) {
-                if (line[i] == quote && i + 1 < line.length() && line[i + 1] == quote) {
-                    i += 2;
-                } else {
-                    i++;
+                if (line[i] == '&' && i + 1 < line.length() && line[i + 1] == ' ') {
+                    i++; // 转义字符
                 }
+                i++;
             }
             if (i < line.length())
                 i++;
@@ -2750,57 +2538,7 @@ std::vector<Token> SyntaxHighlighter::tokenizeFortran(const std::string& line) {
             continue;
         }
 
-        if (std::isdigit(line[i]) ||
-            (line[i] == '.' && i + 1 < line.length() && std::isdigit(line[i + 1]))) {
-            size_t start = i;
-            while (i < line.length() && (std::isdigit(line[i]) || line[i] == '.'))
-                i++;
-            if (i < line.length() &&
-                (line[i] == 'e' || line[i] == 'E' || line[i] == 'd' || line[i] == 'D')) {
-                i++;
-                if (i < line.length() && (line[i] == '+' || line[i] == '-'))
-                    i++;
-                while (i < line.length() && std::isdigit(line[i]))
-                    i++;
-            }
-            tokens.push_back({line.substr(start, i - start), TokenType::NUMBER, start, i});
-            continue;
-        }
-
-        unsigned char c = static_cast<unsigned char>(line[i]);
-        if (isAsciiAlpha(c) || line[i] == '_') {
-            size_t start = i;
-            while (i < line.length()) {
-                unsigned char ch = static_cast<unsigned char>(line[i]);
-                if (isAsciiAlnum(ch) || ch == '_') {
-                    i++;
-                } else if ((ch & 0x80) != 0) {
-                    break;
-                } else {
-                    break;
-                }
-            }
-            std::string word = line.substr(start, i - start);
-            std::string word_lower = word;
-            std::transform(word_lower.begin(), word_lower.end(), word_lower.begin(), ::tolower);
-            TokenType type = TokenType::NORMAL;
-            if (isKeyword(word_lower)) {
-                type = TokenType::KEYWORD;
-            } else if (isType(word_lower)) {
-                type = TokenType::TYPE;
-            } else if (i < line.length() && line[i] == '(') {
-                type = TokenType::FUNCTION;
-            }
-            tokens.push_back({word, type, start, i});
-            continue;
-        }
-
-        if (isOperator(line[i])) {
-            tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-            i++;
-            continue;
-        }
-
+        // 其他
         tokens.push_back({std::string(1, line[i]), TokenType::NORMAL, i, i + 1});
         i++;
     }
@@ -2808,11 +2546,12 @@ std::vector<Token> SyntaxHighlighter::tokenizeFortran(const std::string& line) {
     return tokens;
 }
 
-std::vector<Token> SyntaxHighlighter::tokenizeHaskell(const std::string& line) {
+std::vector<Token> SyntaxHighlighter::tokenizeCSS(const std::string& line) {
     std::vector<Token> tokens;
     size_t i = 0;
 
     while (i < line.length()) {
+        // 跳过空白
         if (std::isspace(line[i])) {
             size_t start = i;
             while (i < line.length() && std::isspace(line[i]))
@@ -2821,27 +2560,27 @@ std::vector<Token> SyntaxHighlighter::tokenizeHaskell(const std::string& line) {
             continue;
         }
 
-        if (i + 1 < line.length() && line[i] == '-' && line[i + 1] == '-') {
-            tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
-            break;
-        }
-
-        if (i + 1 < line.length() && line[i] == '{' && line[i + 1] == '-') {
+        // 注释
+        if (i + 1 < line.length() && line[i] == '/' && line[i + 1] == '*') {
             size_t start = i;
             i += 2;
-            while (i + 1 < line.length() && !(line[i] == '-' && line[i + 1] == '}')) {
-                i++;
+            size_t end_pos = line.find("*/", i);
+            if (end_pos != std::string::npos) {
+                i = end_pos + 2;
+                tokens.push_back({line.substr(start, i - start), TokenType::COMMENT, start, i});
+            } else {
+                tokens.push_back({line.substr(start), TokenType::COMMENT, start, line.length()});
+                break;
             }
-            if (i + 1 < line.length())
-                i += 2;
-            tokens.push_back({line.substr(start, i - start), TokenType::COMMENT, start, i});
             continue;
         }
 
-        if (line[i] == '"') {
+        // 字符串
+        if (line[i] == '"' || line[i] == '\'') {
+            char quote = line[i];
             size_t start = i;
             i++;
-            while (i < line.length() && line[i] != '"') {
+            while (i < line.length() && line[i] != quote) {
                 if (line[i] == '\\' && i + 1 < line.length())
                     i += 2;
                 else
@@ -2853,1483 +2592,34 @@ std::vector<Token> SyntaxHighlighter::tokenizeHaskell(const std::string& line) {
             continue;
         }
 
-        if (line[i] == '\'') {
-            size_t start = i;
-            i++;
-            if (i < line.length() && line[i] == '\\' && i + 1 < line.length()) {
-                i += 2;
-            } else if (i < line.length()) {
-                i++;
-            }
-            if (i < line.length() && line[i] == '\'')
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
+        // 数字
         if (std::isdigit(line[i]) ||
-            (line[i] == '.' && i + 1 < line.length() && std::isdigit(line[i + 1]))) {
+            (line[i] == '.' && i + 1 < line.length() && std::isdigit(line[i + 1])) ||
+            (line[i] == '-' && i + 1 < line.length() && std::isdigit(line[i + 1]))) {
             size_t start = i;
-            i = parseNumber(line, start);
-            tokens.push_back({line.substr(start, i - start), TokenType::NUMBER, start, i});
-            continue;
-        }
-
-        if (i + 1 < line.length()) {
-            std::string two_char = line.substr(i, 2);
-            if (two_char == "->" || two_char == "=>" || two_char == "::" || two_char == "++" ||
-                two_char == "==" || two_char == "/=" || two_char == "<=" || two_char == ">=" ||
-                two_char == "&&" || two_char == "||" || two_char == ">>" || two_char == ">>=" ||
-                two_char == "=<<" || two_char == "<$>" || two_char == "<*>") {
-                tokens.push_back({two_char, TokenType::OPERATOR, i, i + 2});
-                i += 2;
-                continue;
-            }
-        }
-
-        unsigned char c = static_cast<unsigned char>(line[i]);
-        if (isAsciiAlpha(c) || line[i] == '_') {
-            size_t start = i;
-            while (i < line.length()) {
-                unsigned char ch = static_cast<unsigned char>(line[i]);
-                if (isAsciiAlnum(ch) || ch == '_' || ch == '\'') {
-                    i++;
-                } else if ((ch & 0x80) != 0) {
-                    break;
-                } else {
-                    break;
-                }
-            }
-            std::string word = line.substr(start, i - start);
-            TokenType type = TokenType::NORMAL;
-            if (isKeyword(word)) {
-                type = TokenType::KEYWORD;
-            } else if (isType(word)) {
-                type = TokenType::TYPE;
-            } else if (i < line.length() && line[i] == '(') {
-                type = TokenType::FUNCTION;
-            } else if (!word.empty() && std::isupper(static_cast<unsigned char>(word[0]))) {
-                type = TokenType::TYPE;
-            }
-            tokens.push_back({word, type, start, i});
-            continue;
-        }
-
-        if (isOperator(line[i])) {
-            tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-            i++;
-            continue;
-        }
-
-        tokens.push_back({std::string(1, line[i]), TokenType::NORMAL, i, i + 1});
-        i++;
-    }
-
-    return tokens;
-}
-
-std::vector<Token> SyntaxHighlighter::tokenizeYAML(const std::string& line) {
-    std::vector<Token> tokens;
-    size_t i = 0;
-
-    while (i < line.length()) {
-        if (std::isspace(line[i])) {
-            size_t start = i;
-            while (i < line.length() && std::isspace(line[i]))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NORMAL, start, i});
-            continue;
-        }
-
-        // 注释
-        if (line[i] == '#') {
-            tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
-            break;
-        }
-
-        // 字符串
-        if (line[i] == '"' || line[i] == '\'') {
-            char quote = line[i];
-            size_t start = i;
-            i++;
-            while (i < line.length() && line[i] != quote) {
-                if (line[i] == '\\' && i + 1 < line.length())
-                    i += 2;
-                else
-                    i++;
-            }
-            if (i < line.length())
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        // 布尔值和null
-        if (line.substr(i, 4) == "true" || line.substr(i, 5) == "false" ||
-            line.substr(i, 4) == "null" || line.substr(i, 3) == "yes" ||
-            line.substr(i, 2) == "no" || line.substr(i, 2) == "on" || line.substr(i, 3) == "off") {
-            size_t len = 0;
-            if (line.substr(i, 5) == "false")
-                len = 5;
-            else if (line.substr(i, 4) == "true" || line.substr(i, 4) == "null")
-                len = 4;
-            else if (line.substr(i, 3) == "yes" || line.substr(i, 3) == "off")
-                len = 3;
-            else if (line.substr(i, 2) == "no" || line.substr(i, 2) == "on")
-                len = 2;
-            tokens.push_back({line.substr(i, len), TokenType::KEYWORD, i, i + len});
-            i += len;
-            continue;
-        }
-
-        // 数字
-        if (std::isdigit(line[i]) ||
-            (line[i] == '-' && i + 1 < line.length() && std::isdigit(line[i + 1]))) {
-            size_t start = i;
-            if (line[i] == '-')
-                i++;
-            while (i < line.length() &&
-                   (std::isdigit(line[i]) || line[i] == '.' || line[i] == 'e' || line[i] == 'E' ||
-                    line[i] == '+' || line[i] == '-'))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NUMBER, start, i});
-            continue;
-        }
-
-        // 其他
-        tokens.push_back({std::string(1, line[i]), TokenType::NORMAL, i, i + 1});
-        i++;
-    }
-
-    return tokens;
-}
-
-std::vector<Token> SyntaxHighlighter::tokenizeXML(const std::string& line) {
-    std::vector<Token> tokens;
-    size_t i = 0;
-
-    while (i < line.length()) {
-        // 跳过空白
-        if (std::isspace(line[i])) {
-            size_t start = i;
-            while (i < line.length() && std::isspace(line[i]))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NORMAL, start, i});
-            continue;
-        }
-
-        // XML注释
-        if (i + 3 < line.length() && line.substr(i, 4) == "<!--") {
-            size_t start = i;
-            i += 4;
-            size_t end_pos = line.find("-->", i);
-            if (end_pos != std::string::npos) {
-                i = end_pos + 3;
-                tokens.push_back({line.substr(start, i - start), TokenType::COMMENT, start, i});
-            } else {
-                tokens.push_back({line.substr(start), TokenType::COMMENT, start, line.length()});
-                break;
-            }
-            continue;
-        }
-
-        // XML标签开始
-        if (line[i] == '<') {
-            size_t start = i;
-            i++;
-            if (i < line.length() && line[i] == '/') {
-                // 闭合标签
-                i++;
-            }
-
-            // 标签名
-            while (i < line.length() &&
-                   (std::isalnum(line[i]) || line[i] == '_' || line[i] == '-' || line[i] == ':'))
-                i++;
-
-            // 属性
-            while (i < line.length() && line[i] != '>' && line[i] != '/') {
-                if (line[i] == '=') {
-                    // 属性值
-                    i++;
-                    while (i < line.length() && std::isspace(line[i]))
-                        i++;
-                    if (i < line.length() && (line[i] == '"' || line[i] == '\'')) {
-                        char quote = line[i];
-                        i++;
-                        while (i < line.length() && line[i] != quote) {
-                            if (line[i] == '&' && i + 1 < line.length() && line[i + 1] == ' ') {
-                                i++; // 转义字符
-                            }
-                            i++;
-                        }
-                        if (i < line.length())
-                            i++;
-                    } else {
-                        while (i < line.length() && !std::isspace(line[i]) && line[i] != '>' &&
-                               line[i] != '/')
-                            i++;
-                    }
-                } else {
-                    i++;
-                }
-            }
-
-            if (i < line.length() && line[i] == '/')
-                i++;
-            if (i < line.length() && line[i] == '>')
-                i++;
-
-            tokens.push_back({line.substr(start, i - start), TokenType::KEYWORD, start, i});
-            continue;
-        }
-
-        // 实体引用
-        if (line[i] == '&') {
-            size_t start = i;
-            i++;
-            while (i < line.length() && line[i] != ';')
-                i++;
-            if (i < line.length())
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::TYPE, start, i});
-            continue;
-        }
-
-        // 字符串内容
-        if (line[i] == '"' || line[i] == '\'') {
-            char quote = line[i];
-            size_t start = i;
-            i++;
-            while (i < line.length() && line[i] != quote) {
-                if (line[i] == '&' && i + 1 < line.length() && line[i + 1] == ' ') {
-                    i++; // 转义字符
-                }
-                i++;
-            }
-            if (i < line.length())
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        // 其他
-        tokens.push_back({std::string(1, line[i]), TokenType::NORMAL, i, i + 1});
-        i++;
-    }
-
-    return tokens;
-}
-
-std::vector<Token> SyntaxHighlighter::tokenizeCSS(const std::string& line) {
-    std::vector<Token> tokens;
-    size_t i = 0;
-
-    while (i < line.length()) {
-        // 跳过空白
-        if (std::isspace(line[i])) {
-            size_t start = i;
-            while (i < line.length() && std::isspace(line[i]))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NORMAL, start, i});
-            continue;
-        }
-
-        // 注释
-        if (i + 1 < line.length() && line[i] == '/' && line[i + 1] == '*') {
-            size_t start = i;
-            i += 2;
-            size_t end_pos = line.find("*/", i);
-            if (end_pos != std::string::npos) {
-                i = end_pos + 2;
-                tokens.push_back({line.substr(start, i - start), TokenType::COMMENT, start, i});
-            } else {
-                tokens.push_back({line.substr(start), TokenType::COMMENT, start, line.length()});
-                break;
-            }
-            continue;
-        }
-
-        // 字符串
-        if (line[i] == '"' || line[i] == '\'') {
-            char quote = line[i];
-            size_t start = i;
-            i++;
-            while (i < line.length() && line[i] != quote) {
-                if (line[i] == '\\' && i + 1 < line.length())
-                    i += 2;
-                else
-                    i++;
-            }
-            if (i < line.length())
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        // 数字
-        if (std::isdigit(line[i]) ||
-            (line[i] == '.' && i + 1 < line.length() && std::isdigit(line[i + 1])) ||
-            (line[i] == '-' && i + 1 < line.length() && std::isdigit(line[i + 1]))) {
-            size_t start = i;
-            if (line[i] == '-')
-                i++;
-            while (i < line.length() && (std::isdigit(line[i]) || line[i] == '.'))
-                i++;
-            // 单位
-            while (i < line.length() && (std::isalpha(line[i]) || line[i] == '%'))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NUMBER, start, i});
-            continue;
-        }
-
-        // CSS选择器和属性名
-        unsigned char c = static_cast<unsigned char>(line[i]);
-        if (std::isalpha(c) || line[i] == '_' || line[i] == '-' || line[i] == '#') {
-            size_t start = i;
-            while (i < line.length() &&
-                   (std::isalnum(line[i]) || line[i] == '_' || line[i] == '-' || line[i] == '#' ||
-                    line[i] == '.' || line[i] == ':'))
-                i++;
-            std::string word = line.substr(start, i - start);
-            TokenType type = TokenType::NORMAL;
-            if (isKeyword(word)) {
-                type = TokenType::KEYWORD;
-            }
-            tokens.push_back({word, type, start, i});
-            continue;
-        }
-
-        // 其他
-        tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-        i++;
-    }
-
-    return tokens;
-}
-
-std::vector<Token> SyntaxHighlighter::tokenizeSQL(const std::string& line) {
-    std::vector<Token> tokens;
-    size_t i = 0;
-
-    while (i < line.length()) {
-        // 跳过空白
-        if (std::isspace(line[i])) {
-            size_t start = i;
-            while (i < line.length() && std::isspace(line[i]))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NORMAL, start, i});
-            continue;
-        }
-
-        // 注释
-        if (i + 1 < line.length() && line[i] == '-' && line[i + 1] == '-') {
-            tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
-            break;
-        }
-        if (i + 1 < line.length() && line[i] == '/' && line[i + 1] == '*') {
-            size_t start = i;
-            i += 2;
-            size_t end_pos = line.find("*/", i);
-            if (end_pos != std::string::npos) {
-                i = end_pos + 2;
-                tokens.push_back({line.substr(start, i - start), TokenType::COMMENT, start, i});
-            } else {
-                tokens.push_back({line.substr(start), TokenType::COMMENT, start, line.length()});
-                break;
-            }
-            continue;
-        }
-
-        // 字符串
-        if (line[i] == '"' || line[i] == '\'') {
-            char quote = line[i];
-            size_t start = i;
-            i++;
-            while (i < line.length() && line[i] != quote) {
-                if (line[i] == '\\' && i + 1 < line.length())
-                    i += 2;
-                else
-                    i++;
-            }
-            if (i < line.length())
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        // 数字
-        if (std::isdigit(line[i]) ||
-            (line[i] == '.' && i + 1 < line.length() && std::isdigit(line[i + 1]))) {
-            size_t start = i;
-            while (i < line.length() && (std::isdigit(line[i]) || line[i] == '.'))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NUMBER, start, i});
-            continue;
-        }
-
-        // 标识符/关键字
-        unsigned char c = static_cast<unsigned char>(line[i]);
-        if (std::isalpha(c) || line[i] == '_' || line[i] == '@') {
-            size_t start = i;
-            while (i < line.length() && (std::isalnum(line[i]) || line[i] == '_' || line[i] == '$'))
-                i++;
-            std::string word = line.substr(start, i - start);
-            std::string upper_word = word;
-            std::transform(upper_word.begin(), upper_word.end(), upper_word.begin(), ::toupper);
-            TokenType type = TokenType::NORMAL;
-            if (isKeyword(upper_word)) {
-                type = TokenType::KEYWORD;
-            } else if (isType(upper_word)) {
-                type = TokenType::TYPE;
-            }
-            tokens.push_back({word, type, start, i});
-            continue;
-        }
-
-        // 其他
-        tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-        i++;
-    }
-
-    return tokens;
-}
-
-std::vector<Token> SyntaxHighlighter::tokenizeRuby(const std::string& line) {
-    std::vector<Token> tokens;
-    size_t i = 0;
-
-    while (i < line.length()) {
-        // 跳过空白
-        if (std::isspace(line[i])) {
-            size_t start = i;
-            while (i < line.length() && std::isspace(line[i]))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NORMAL, start, i});
-            continue;
-        }
-
-        // 注释
-        if (line[i] == '#') {
-            tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
-            break;
-        }
-
-        // 字符串
-        if (line[i] == '"' || line[i] == '\'') {
-            char quote = line[i];
-            size_t start = i;
-            i++;
-            while (i < line.length() && line[i] != quote) {
-                if (line[i] == '\\' && i + 1 < line.length())
-                    i += 2;
-                else
-                    i++;
-            }
-            if (i < line.length())
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        // 符号
-        if (line[i] == ':') {
-            size_t start = i;
-            i++;
-            if (i < line.length() && line[i] == ':') {
-                i++;
-                tokens.push_back({"::", TokenType::OPERATOR, start, i});
-                continue;
-            } else if (i < line.length() &&
-                       (std::isalpha(line[i]) || line[i] == '_' || line[i] == '@')) {
-                while (i < line.length() && (std::isalnum(line[i]) || line[i] == '_' ||
-                                             line[i] == '@' || line[i] == '?' || line[i] == '!'))
-                    i++;
-                tokens.push_back({line.substr(start, i - start), TokenType::TYPE, start, i});
-                continue;
-            }
-        }
-
-        // 数字
-        if (std::isdigit(line[i]) ||
-            (line[i] == '.' && i + 1 < line.length() && std::isdigit(line[i + 1]))) {
-            size_t start = i;
-            while (i < line.length() &&
-                   (std::isdigit(line[i]) || line[i] == '.' || line[i] == 'e' || line[i] == 'E' ||
-                    line[i] == '+' || line[i] == '-'))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NUMBER, start, i});
-            continue;
-        }
-
-        // 标识符/关键字
-        unsigned char c = static_cast<unsigned char>(line[i]);
-        if (std::isalpha(c) || line[i] == '_' || line[i] == '@' || line[i] == '$') {
-            size_t start = i;
-            while (i < line.length() && (std::isalnum(line[i]) || line[i] == '_' ||
-                                         line[i] == '@' || line[i] == '$' || line[i] == '?'))
-                i++;
-            std::string word = line.substr(start, i - start);
-            TokenType type = TokenType::NORMAL;
-            if (isKeyword(word)) {
-                type = TokenType::KEYWORD;
-            } else if (isType(word)) {
-                type = TokenType::TYPE;
-            } else if (i < line.length() && line[i] == '(') {
-                type = TokenType::FUNCTION;
-            } else if (word[0] == '@' || word[0] == '$') {
-                type = TokenType::TYPE;
-            }
-            tokens.push_back({word, type, start, i});
-            continue;
-        }
-
-        // 其他
-        if (isOperator(line[i])) {
-            tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-            i++;
-            continue;
-        }
-
-        tokens.push_back({std::string(1, line[i]), TokenType::NORMAL, i, i + 1});
-        i++;
-    }
-
-    return tokens;
-}
-
-std::vector<Token> SyntaxHighlighter::tokenizePHP(const std::string& line) {
-    std::vector<Token> tokens;
-    size_t i = 0;
-
-    // 检查是否在PHP代码块中（简化处理）
-    bool in_php =
-        (line.find("<?php") != std::string::npos) || (line.find("<?=") != std::string::npos);
-
-    while (i < line.length()) {
-        // 跳过空白
-        if (std::isspace(line[i])) {
-            size_t start = i;
-            while (i < line.length() && std::isspace(line[i]))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NORMAL, start, i});
-            continue;
-        }
-
-        // PHP开始标签
-        if (i + 4 < line.length() && line.substr(i, 5) == "<?php") {
-            tokens.push_back({line.substr(i, 5), TokenType::KEYWORD, i, i + 5});
-            i += 5;
-            in_php = true;
-            continue;
-        }
-        if (i + 1 < line.length() && line.substr(i, 2) == "<?") {
-            tokens.push_back({line.substr(i, 2), TokenType::KEYWORD, i, i + 2});
-            i += 2;
-            in_php = true;
-            continue;
-        }
-
-        // PHP结束标签
-        if (i + 1 < line.length() && line.substr(i, 2) == "?>") {
-            tokens.push_back({line.substr(i, 2), TokenType::KEYWORD, i, i + 2});
-            i += 2;
-            in_php = false;
-            continue;
-        }
-
-        // 如果不在PHP代码中，按HTML处理
-        if (!in_php) {
-            return tokenizeXML(line);
-        }
-
-        // 单行注释
-        if (i + 1 < line.length() && line[i] == '/' && line[i + 1] == '/') {
-            tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
-            break;
-        }
-
-        // 多行注释
-        if (i + 1 < line.length() && line[i] == '/' && line[i + 1] == '*') {
-            size_t start = i;
-            i += 2;
-            size_t end_pos = line.find("*/", i);
-            if (end_pos != std::string::npos) {
-                i = end_pos + 2;
-                tokens.push_back({line.substr(start, i - start), TokenType::COMMENT, start, i});
-            } else {
-                tokens.push_back({line.substr(start), TokenType::COMMENT, start, line.length()});
-                break;
-            }
-            continue;
-        }
-
-        // 字符串
-        if (line[i] == '"' || line[i] == '\'') {
-            char quote = line[i];
-            size_t start = i;
-            i++;
-            while (i < line.length() && line[i] != quote) {
-                if (line[i] == '\\' && i + 1 < line.length())
-                    i += 2;
-                else
-                    i++;
-            }
-            if (i < line.length())
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        // 变量
-        if (line[i] == '$') {
-            size_t start = i;
-            i++;
-            while (i < line.length() && (std::isalnum(line[i]) || line[i] == '_'))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::TYPE, start, i});
-            continue;
-        }
-
-        // 数字
-        if (std::isdigit(line[i]) ||
-            (line[i] == '.' && i + 1 < line.length() && std::isdigit(line[i + 1]))) {
-            size_t start = i;
-            while (i < line.length() && (std::isdigit(line[i]) || line[i] == '.'))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NUMBER, start, i});
-            continue;
-        }
-
-        // 标识符/关键字
-        unsigned char c = static_cast<unsigned char>(line[i]);
-        if (std::isalpha(c) || line[i] == '_') {
-            size_t start = i;
-            while (i < line.length() && (std::isalnum(line[i]) || line[i] == '_'))
-                i++;
-            std::string word = line.substr(start, i - start);
-            TokenType type = TokenType::NORMAL;
-            if (isKeyword(word)) {
-                type = TokenType::KEYWORD;
-            } else if (isType(word)) {
-                type = TokenType::TYPE;
-            } else if (i < line.length() && line[i] == '(') {
-                type = TokenType::FUNCTION;
-            }
-            tokens.push_back({word, type, start, i});
-            continue;
-        }
-
-        // 其他
-        if (isOperator(line[i])) {
-            tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-            i++;
-            continue;
-        }
-
-        tokens.push_back({std::string(1, line[i]), TokenType::NORMAL, i, i + 1});
-        i++;
-    }
-
-    return tokens;
-}
-
-std::vector<Token> SyntaxHighlighter::tokenizeSwift(const std::string& line) {
-    std::vector<Token> tokens;
-    size_t i = 0;
-
-    while (i < line.length()) {
-        // 跳过空白
-        if (std::isspace(line[i])) {
-            size_t start = i;
-            while (i < line.length() && std::isspace(line[i]))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NORMAL, start, i});
-            continue;
-        }
-
-        // 单行注释
-        if (i + 1 < line.length() && line[i] == '/' && line[i + 1] == '/') {
-            tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
-            break;
-        }
-
-        // 多行注释
-        if (i + 1 < line.length() && line[i] == '/' && line[i + 1] == '*') {
-            size_t start = i;
-            i += 2;
-            size_t end_pos = line.find("*/", i);
-            if (end_pos != std::string::npos) {
-                i = end_pos + 2;
-                tokens.push_back({line.substr(start, i - start), TokenType::COMMENT, start, i});
-            } else {
-                tokens.push_back({line.substr(start), TokenType::COMMENT, start, line.length()});
-                break;
-            }
-            continue;
-        }
-
-        // 字符串
-        if (line[i] == '"' || line[i] == '\'') {
-            char quote = line[i];
-            size_t start = i;
-            i++;
-            while (i < line.length() && line[i] != quote) {
-                if (line[i] == '\\' && i + 1 < line.length())
-                    i += 2;
-                else
-                    i++;
-            }
-            if (i < line.length())
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        // 数字
-        if (std::isdigit(line[i]) ||
-            (line[i] == '.' && i + 1 < line.length() && std::isdigit(line[i + 1]))) {
-            size_t start = i;
-            while (i < line.length() && (std::isdigit(line[i]) || line[i] == '.'))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NUMBER, start, i});
-            continue;
-        }
-
-        // 标识符/关键字
-        unsigned char c = static_cast<unsigned char>(line[i]);
-        if (std::isalpha(c) || line[i] == '_') {
-            size_t start = i;
-            while (i < line.length() && (std::isalnum(line[i]) || line[i] == '_'))
-                i++;
-            std::string word = line.substr(start, i - start);
-            TokenType type = TokenType::NORMAL;
-            if (isKeyword(word)) {
-                type = TokenType::KEYWORD;
-            } else if (isType(word)) {
-                type = TokenType::TYPE;
-            } else if (i < line.length() && line[i] == '(') {
-                type = TokenType::FUNCTION;
-            }
-            tokens.push_back({word, type, start, i});
-            continue;
-        }
-
-        // 其他
-        if (isOperator(line[i])) {
-            tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-            i++;
-            continue;
-        }
-
-        tokens.push_back({std::string(1, line[i]), TokenType::NORMAL, i, i + 1});
-        i++;
-    }
-
-    return tokens;
-}
-
-std::vector<Token> SyntaxHighlighter::tokenizeKotlin(const std::string& line) {
-    std::vector<Token> tokens;
-    size_t i = 0;
-
-    while (i < line.length()) {
-        // 跳过空白
-        if (std::isspace(line[i])) {
-            size_t start = i;
-            while (i < line.length() && std::isspace(line[i]))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NORMAL, start, i});
-            continue;
-        }
-
-        // 单行注释
-        if (i + 1 < line.length() && line[i] == '/' && line[i + 1] == '/') {
-            tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
-            break;
-        }
-
-        // 多行注释
-        if (i + 1 < line.length() && line[i] == '/' && line[i + 1] == '*') {
-            size_t start = i;
-            i += 2;
-            size_t end_pos = line.find("*/", i);
-            if (end_pos != std::string::npos) {
-                i = end_pos + 2;
-                tokens.push_back({line.substr(start, i - start), TokenType::COMMENT, start, i});
-            } else {
-                tokens.push_back({line.substr(start), TokenType::COMMENT, start, line.length()});
-                break;
-            }
-            continue;
-        }
-
-        // 字符串
-        if (line[i] == '"' || line[i] == '\'') {
-            char quote = line[i];
-            size_t start = i;
-            i++;
-            while (i < line.length() && line[i] != quote) {
-                if (line[i] == '\\' && i + 1 < line.length())
-                    i += 2;
-                else
-                    i++;
-            }
-            if (i < line.length())
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        // 数字
-        if (std::isdigit(line[i]) ||
-            (line[i] == '.' && i + 1 < line.length() && std::isdigit(line[i + 1]))) {
-            size_t start = i;
-            while (i < line.length() && (std::isdigit(line[i]) || line[i] == '.'))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NUMBER, start, i});
-            continue;
-        }
-
-        // 标识符/关键字
-        unsigned char c = static_cast<unsigned char>(line[i]);
-        if (std::isalpha(c) || line[i] == '_') {
-            size_t start = i;
-            while (i < line.length() && (std::isalnum(line[i]) || line[i] == '_'))
-                i++;
-            std::string word = line.substr(start, i - start);
-            TokenType type = TokenType::NORMAL;
-            if (isKeyword(word)) {
-                type = TokenType::KEYWORD;
-            } else if (isType(word)) {
-                type = TokenType::TYPE;
-            } else if (i < line.length() && line[i] == '(') {
-                type = TokenType::FUNCTION;
-            }
-            tokens.push_back({word, type, start, i});
-            continue;
-        }
-
-        // 其他
-        if (isOperator(line[i])) {
-            tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-            i++;
-            continue;
-        }
-
-        tokens.push_back({std::string(1, line[i]), TokenType::NORMAL, i, i + 1});
-        i++;
-    }
-
-    return tokens;
-}
-
-std::vector<Token> SyntaxHighlighter::tokenizeScala(const std::string& line) {
-    std::vector<Token> tokens;
-    size_t i = 0;
-
-    while (i < line.length()) {
-        // 跳过空白
-        if (std::isspace(line[i])) {
-            size_t start = i;
-            while (i < line.length() && std::isspace(line[i]))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NORMAL, start, i});
-            continue;
-        }
-
-        // 单行注释
-        if (i + 1 < line.length() && line[i] == '/' && line[i + 1] == '/') {
-            tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
-            break;
-        }
-
-        // 多行注释
-        if (i + 1 < line.length() && line[i] == '/' && line[i + 1] == '*') {
-            size_t start = i;
-            i += 2;
-            size_t end_pos = line.find("*/", i);
-            if (end_pos != std::string::npos) {
-                i = end_pos + 2;
-                tokens.push_back({line.substr(start, i - start), TokenType::COMMENT, start, i});
-            } else {
-                tokens.push_back({line.substr(start), TokenType::COMMENT, start, line.length()});
-                break;
-            }
-            continue;
-        }
-
-        // 字符串
-        if (line[i] == '"' || line[i] == '\'') {
-            char quote = line[i];
-            size_t start = i;
-            i++;
-            while (i < line.length() && line[i] != quote) {
-                if (line[i] == '\\' && i + 1 < line.length())
-                    i += 2;
-                else
-                    i++;
-            }
-            if (i < line.length())
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        // 数字
-        if (std::isdigit(line[i]) ||
-            (line[i] == '.' && i + 1 < line.length() && std::isdigit(line[i + 1]))) {
-            size_t start = i;
-            while (i < line.length() && (std::isdigit(line[i]) || line[i] == '.'))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NUMBER, start, i});
-            continue;
-        }
-
-        // 标识符/关键字
-        unsigned char c = static_cast<unsigned char>(line[i]);
-        if (std::isalpha(c) || line[i] == '_') {
-            size_t start = i;
-            while (i < line.length() && (std::isalnum(line[i]) || line[i] == '_'))
-                i++;
-            std::string word = line.substr(start, i - start);
-            TokenType type = TokenType::NORMAL;
-            if (isKeyword(word)) {
-                type = TokenType::KEYWORD;
-            } else if (isType(word)) {
-                type = TokenType::TYPE;
-            } else if (i < line.length() && line[i] == '(') {
-                type = TokenType::FUNCTION;
-            }
-            tokens.push_back({word, type, start, i});
-            continue;
-        }
-
-        // 其他
-        if (isOperator(line[i])) {
-            tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-            i++;
-            continue;
-        }
-
-        tokens.push_back({std::string(1, line[i]), TokenType::NORMAL, i, i + 1});
-        i++;
-    }
-
-    return tokens;
-}
-
-std::vector<Token> SyntaxHighlighter::tokenizeR(const std::string& line) {
-    std::vector<Token> tokens;
-    size_t i = 0;
-
-    while (i < line.length()) {
-        // 跳过空白
-        if (std::isspace(line[i])) {
-            size_t start = i;
-            while (i < line.length() && std::isspace(line[i]))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NORMAL, start, i});
-            continue;
-        }
-
-        // 注释
-        if (line[i] == '#') {
-            tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
-            break;
-        }
-
-        // 字符串
-        if (line[i] == '"' || line[i] == '\'') {
-            char quote = line[i];
-            size_t start = i;
-            i++;
-            while (i < line.length() && line[i] != quote) {
-                if (line[i] == '\\' && i + 1 < line.length())
-                    i += 2;
-                else
-                    i++;
-            }
-            if (i < line.length())
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        // 数字
-        if (std::isdigit(line[i]) ||
-            (line[i] == '.' && i + 1 < line.length() && std::isdigit(line[i + 1]))) {
-            size_t start = i;
-            while (i < line.length() &&
-                   (std::isdigit(line[i]) || line[i] == '.' || line[i] == 'e' || line[i] == 'E' ||
-                    line[i] == '+' || line[i] == '-'))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NUMBER, start, i});
-            continue;
-        }
-
-        // 标识符/关键字
-        unsigned char c = static_cast<unsigned char>(line[i]);
-        if (std::isalpha(c) || line[i] == '_' || line[i] == '.') {
-            size_t start = i;
-            while (i < line.length() && (std::isalnum(line[i]) || line[i] == '_' || line[i] == '.'))
-                i++;
-            std::string word = line.substr(start, i - start);
-            TokenType type = TokenType::NORMAL;
-            if (isKeyword(word)) {
-                type = TokenType::KEYWORD;
-            } else if (isType(word)) {
-                type = TokenType::TYPE;
-            } else if (i < line.length() && line[i] == '(') {
-                type = TokenType::FUNCTION;
-            }
-            tokens.push_back({word, type, start, i});
-            continue;
-        }
-
-        // 其他
-        if (isOperator(line[i])) {
-            tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-            i++;
-            continue;
-        }
-
-        tokens.push_back({std::string(1, line[i]), TokenType::NORMAL, i, i + 1});
-        i++;
-    }
-
-    return tokens;
-}
-
-std::vector<Token> SyntaxHighlighter::tokenizePerl(const std::string& line) {
-    std::vector<Token> tokens;
-    size_t i = 0;
-
-    while (i < line.length()) {
-        // 跳过空白
-        if (std::isspace(line[i])) {
-            size_t start = i;
-            while (i < line.length() && std::isspace(line[i]))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NORMAL, start, i});
-            continue;
-        }
-
-        // 注释
-        if (line[i] == '#') {
-            tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
-            break;
-        }
-
-        // 字符串
-        if (line[i] == '"' || line[i] == '\'') {
-            char quote = line[i];
-            size_t start = i;
-            i++;
-            while (i < line.length() && line[i] != quote) {
-                if (line[i] == '\\' && i + 1 < line.length())
-                    i += 2;
-                else
-                    i++;
-            }
-            if (i < line.length())
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        // 变量
-        if (line[i] == '$' || line[i] == '@' || line[i] == '%') {
-            size_t start = i;
-            i++;
-            while (i < line.length() && (std::isalnum(line[i]) || line[i] == '_'))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::TYPE, start, i});
-            continue;
-        }
-
-        // 数字
-        if (std::isdigit(line[i]) ||
-            (line[i] == '.' && i + 1 < line.length() && std::isdigit(line[i + 1]))) {
-            size_t start = i;
-            while (i < line.length() && (std::isdigit(line[i]) || line[i] == '.'))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NUMBER, start, i});
-            continue;
-        }
-
-        // 标识符/关键字
-        unsigned char c = static_cast<unsigned char>(line[i]);
-        if (std::isalpha(c) || line[i] == '_') {
-            size_t start = i;
-            while (i < line.length() && (std::isalnum(line[i]) || line[i] == '_'))
-                i++;
-            std::string word = line.substr(start, i - start);
-            TokenType type = TokenType::NORMAL;
-            if (isKeyword(word)) {
-                type = TokenType::KEYWORD;
-            } else if (isType(word)) {
-                type = TokenType::TYPE;
-            } else if (i < line.length() && line[i] == '(') {
-                type = TokenType::FUNCTION;
-            }
-            tokens.push_back({word, type, start, i});
-            continue;
-        }
-
-        // 其他
-        if (isOperator(line[i])) {
-            tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-            i++;
-            continue;
-        }
-
-        tokens.push_back({std::string(1, line[i]), TokenType::NORMAL, i, i + 1});
-        i++;
-    }
-
-    return tokens;
-}
-
-std::vector<Token> SyntaxHighlighter::tokenizeDockerfile(const std::string& line) {
-    std::vector<Token> tokens;
-    size_t i = 0;
-
-    while (i < line.length()) {
-        // 跳过空白
-        if (std::isspace(line[i])) {
-            size_t start = i;
-            while (i < line.length() && std::isspace(line[i]))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NORMAL, start, i});
-            continue;
-        }
-
-        // 注释
-        if (line[i] == '#') {
-            tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
-            break;
-        }
-
-        // 字符串
-        if (line[i] == '"' || line[i] == '\'') {
-            char quote = line[i];
-            size_t start = i;
-            i++;
-            while (i < line.length() && line[i] != quote) {
-                if (line[i] == '\\' && i + 1 < line.length())
-                    i += 2;
-                else
-                    i++;
-            }
-            if (i < line.length())
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        // 指令
-        unsigned char c = static_cast<unsigned char>(line[i]);
-        if (std::isalpha(c)) {
-            size_t start = i;
-            while (i < line.length() && std::isalpha(line[i]))
-                i++;
-            std::string word = line.substr(start, i - start);
-            std::string upper_word = word;
-            std::transform(upper_word.begin(), upper_word.end(), upper_word.begin(), ::toupper);
-            TokenType type = TokenType::NORMAL;
-            if (isKeyword(upper_word)) {
-                type = TokenType::KEYWORD;
-            }
-            tokens.push_back({word, type, start, i});
-            continue;
-        }
-
-        // 其他
-        tokens.push_back({std::string(1, line[i]), TokenType::NORMAL, i, i + 1});
-        i++;
-    }
-
-    return tokens;
-}
-
-std::vector<Token> SyntaxHighlighter::tokenizeMakefile(const std::string& line) {
-    std::vector<Token> tokens;
-    size_t i = 0;
-
-    while (i < line.length()) {
-        // 跳过空白
-        if (std::isspace(line[i])) {
-            size_t start = i;
-            while (i < line.length() && std::isspace(line[i]))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NORMAL, start, i});
-            continue;
-        }
-
-        // 注释 - 从行首#开始的注释
-        if (line[i] == '#') {
-            tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
-            break;
-        }
-
-        // 字符串 - 双引号
-        if (line[i] == '"') {
-            size_t start = i;
-            i++;
-            while (i < line.length()) {
-                if (line[i] == '\\' && i + 1 < line.length()) {
-                    i += 2; // 跳过转义字符
-                } else if (line[i] == '"') {
-                    i++;
-                    break;
-                } else {
-                    i++;
-                }
-            }
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        // 字符串 - 单引号
-        if (line[i] == '\'') {
-            size_t start = i;
-            i++;
-            while (i < line.length()) {
-                if (line[i] == '\\' && i + 1 < line.length()) {
-                    i += 2; // 跳过转义字符
-                } else if (line[i] == '\'') {
-                    i++;
-                    break;
-                } else {
-                    i++;
-                }
-            }
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        // 变量引用和函数调用 - $(...) 和 ${...}
-        if (line[i] == '$') {
-            size_t start = i;
-            i++;
-            if (i < line.length()) {
-                if (line[i] == '(' || line[i] == '{') {
-                    char end_char = (line[i] == '(') ? ')' : '}';
-                    i++;
-                    int paren_depth = 1;
-
-                    // 检查是否是函数调用（基于tree-sitter-make的语法）
-                    bool is_function = false;
-                    size_t func_check_start = i;
-                    std::string potential_func;
-
-                    // 收集函数名候选
-                    while (func_check_start < line.length() &&
-                           (std::isalnum(line[func_check_start]) || line[func_check_start] == '_' ||
-                            line[func_check_start] == '-')) {
-                        potential_func += line[func_check_start];
-                        func_check_start++;
-                    }
-
-                    // 检查是否是已知函数名（使用makefile语法常量）
-                    if (isMakefileFunction(potential_func)) {
-                        is_function = true;
-                    }
-
-                    while (i < line.length() && paren_depth > 0) {
-                        if (line[i] == end_char) {
-                            paren_depth--;
-                            if (paren_depth == 0) {
-                                i++;
-                                break;
-                            }
-                        } else if (line[i] == (end_char == ')' ? '(' : '{')) {
-                            paren_depth++;
-                        }
-                        i++;
-                    }
-
-                    TokenType var_type = is_function ? TokenType::FUNCTION : TokenType::TYPE;
-                    tokens.push_back({line.substr(start, i - start), var_type, start, i});
-                    continue;
-                } else {
-                    // 自动变量：$@, $%, $<, $?, $^, $+, $* 等
-                    // 基于tree-sitter-make的自动变量定义
-                    if (isMakefileAutomaticVar(line[i]) || std::isalnum(line[i]) ||
-                        line[i] == '_') {
-                        i++;
-                        tokens.push_back(
-                            {line.substr(start, i - start), TokenType::TYPE, start, i});
-                        continue;
-                    }
-                }
-            }
-        }
-
-        // 规则分隔符 - : 和 :: （基于tree-sitter-make）
-        if (line[i] == ':') {
-            size_t start = i;
-            i++;
-            if (i < line.length() && line[i] == ':') {
-                i++;
-            }
-            tokens.push_back({line.substr(start, i - start), TokenType::OPERATOR, start, i});
-            continue;
-        }
-
-        // 赋值运算符 - =, :=, ::=, +=, ?=, != （基于tree-sitter-make）
-        if (line[i] == '=' || line[i] == '+' || line[i] == '?' || line[i] == '!' ||
-            (line[i] == ':' && i + 1 < line.length() && line[i + 1] == '=')) {
-            size_t start = i;
-            if (line[i] == ':' && i + 2 < line.length() && line[i + 1] == ':' &&
-                line[i + 2] == '=') {
-                // ::= 运算符
-                i += 3;
-            } else if (line[i] == ':' && i + 1 < line.length() && line[i + 1] == '=') {
-                // := 运算符
-                i += 2;
-            } else {
-                // =, +=, ?=, != 运算符
-                i++;
-                if (i < line.length() && line[i] == '=') {
-                    i++;
-                }
-            }
-            tokens.push_back({line.substr(start, i - start), TokenType::OPERATOR, start, i});
-            continue;
-        }
-
-        // 运算符、括号和分隔符 （基于tree-sitter-make）
-        if (isMakefileOperator(line[i]) || isMakefileBracket(line[i]) ||
-            isMakefileDelimiter(line[i])) {
-            tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-            i++;
-            continue;
-        }
-
-        // 标识符和关键字识别
-        unsigned char c = static_cast<unsigned char>(line[i]);
-        if (std::isalpha(c) || line[i] == '_' || line[i] == '/' || line[i] == '.' ||
-            line[i] == '-' || line[i] == '%' || line[i] == '*' || line[i] == '?' ||
-            line[i] == '+' || line[i] == '@' || line[i] == '^' || line[i] == '|' ||
-            line[i] == '$') {
-            size_t start = i;
-            while (i < line.length() &&
-                   (std::isalnum(line[i]) || line[i] == '_' || line[i] == '/' || line[i] == '.' ||
-                    line[i] == '-' || line[i] == '%' || line[i] == '*' || line[i] == '?' ||
-                    line[i] == '+' || line[i] == '@' || line[i] == '^' || line[i] == '|' ||
-                    line[i] == '$')) {
-                i++;
-            }
-            std::string word = line.substr(start, i - start);
-            TokenType type = TokenType::NORMAL;
-
-            // 检查是否是指令关键字（基于tree-sitter-make）
-            if (isMakefileDirectiveKeyword(word)) {
-                type = TokenType::KEYWORD;
-            }
-            // 检查是否是常规关键字
-            else if (isKeyword(word)) {
-                type = TokenType::KEYWORD;
-            }
-            // 包含变量引用的标识符
-            else if (word.find('$') != std::string::npos) {
-                type = TokenType::TYPE;
-            }
-            // 文件路径相关的标识符
-            else if (word.find('/') != std::string::npos || word.find('.') != std::string::npos) {
-                type = TokenType::TYPE;
-            }
-            // 特殊makefile标识符（包含通配符等）
-            else if (word.find('%') != std::string::npos || word.find('*') != std::string::npos ||
-                     word.find('?') != std::string::npos) {
-                type = TokenType::TYPE;
-            }
-
-            tokens.push_back({word, type, start, i});
-            continue;
-        }
-
-        // 其他字符作为运算符
-        tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-        i++;
-    }
-
-    return tokens;
-}
-
-std::vector<Token> SyntaxHighlighter::tokenizeVim(const std::string& line) {
-    std::vector<Token> tokens;
-    size_t i = 0;
-
-    while (i < line.length()) {
-        // 跳过空白
-        if (std::isspace(line[i])) {
-            size_t start = i;
-            while (i < line.length() && std::isspace(line[i]))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NORMAL, start, i});
-            continue;
-        }
-
-        // 注释
-        if (line[i] == '"') {
-            tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
-            break;
-        }
-
-        // 字符串
-        if (line[i] == '\'') {
-            size_t start = i;
-            i++;
-            while (i < line.length() && line[i] != '\'') {
-                if (line[i] == '\\' && i + 1 < line.length())
-                    i += 2;
-                else
-                    i++;
-            }
-            if (i < line.length())
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        // 变量
-        if (line[i] == '&' || line[i] == 'g' || line[i] == 'b' || line[i] == 'w' ||
-            line[i] == 't' || line[i] == 's' || line[i] == 'l' || line[i] == 'a' ||
-            line[i] == 'v') {
-            if (i + 1 < line.length() && line[i + 1] == ':') {
-                size_t start = i;
-                i += 2;
-                while (i < line.length() && (std::isalnum(line[i]) || line[i] == '_'))
-                    i++;
-                tokens.push_back({line.substr(start, i - start), TokenType::TYPE, start, i});
-                continue;
-            }
-        }
-
-        // 数字
-        if (std::isdigit(line[i])) {
-            size_t start = i;
-            while (i < line.length() && std::isdigit(line[i]))
+            if (line[i] == '-')
+                i++;
+            while (i < line.length() && (std::isdigit(line[i]) || line[i] == '.'))
+                i++;
+            // 单位
+            while (i < line.length() && (std::isalpha(line[i]) || line[i] == '%'))
                 i++;
             tokens.push_back({line.substr(start, i - start), TokenType::NUMBER, start, i});
             continue;
         }
 
-        // 标识符/命令
+        // CSS选择器和属性名
         unsigned char c = static_cast<unsigned char>(line[i]);
-        if (std::isalpha(c) || line[i] == '_') {
+        if (std::isalpha(c) || line[i] == '_' || line[i] == '-' || line[i] == '#') {
             size_t start = i;
-            while (i < line.length() && (std::isalnum(line[i]) || line[i] == '_'))
+            while (i < line.length() &&
+                   (std::isalnum(line[i]) || line[i] == '_' || line[i] == '-' || line[i] == '#' ||
+                    line[i] == '.' || line[i] == ':'))
                 i++;
             std::string word = line.substr(start, i - start);
             TokenType type = TokenType::NORMAL;
             if (isKeyword(word)) {
                 type = TokenType::KEYWORD;
-            } else if (isType(word)) {
-                type = TokenType::TYPE;
             }
             tokens.push_back({word, type, start, i});
             continue;
@@ -4343,10 +2633,14 @@ std::vector<Token> SyntaxHighlighter::tokenizeVim(const std::string& line) {
     return tokens;
 }
 
-std::vector<Token> SyntaxHighlighter::tokenizePowerShell(const std::string& line) {
+std::vector<Token> SyntaxHighlighter::tokenizePHP(const std::string& line) {
     std::vector<Token> tokens;
     size_t i = 0;
 
+    // 检查是否在PHP代码块中（简化处理）
+    bool in_php =
+        (line.find("<?php") != std::string::npos) || (line.find("<?=") != std::string::npos);
+
     while (i < line.length()) {
         // 跳过空白
         if (std::isspace(line[i])) {
@@ -4357,17 +2651,44 @@ std::vector<Token> SyntaxHighlighter::tokenizePowerShell(const std::string& line
             continue;
         }
 
+        // PHP开始标签
+        if (i + 4 < line.length() && line.substr(i, 5) == "<?php") {
+            tokens.push_back({line.substr(i, 5), TokenType::KEYWORD, i, i + 5});
+            i += 5;
+            in_php = true;
+            continue;
+        }
+        if (i + 1 < line.length() && line.substr(i, 2) == "<?") {
+            tokens.push_back({line.substr(i, 2), TokenType::KEYWORD, i, i + 2});
+            i += 2;
+            in_php = true;
+            continue;
+        }
+
+        // PHP结束标签
+        if (i + 1 < line.length() && line.substr(i, 2) == "?>") {
+            tokens.push_back({line.substr(i, 2), TokenType::KEYWORD, i, i + 2});
+            i += 2;
+            in_php = false;
+            continue;
+        }
+
+        // 如果不在PHP代码中，按HTML处理
+        if (!in_php) {
+            return tokenizeXML(line);
+        }
+
         // 单行注释
-        if (line[i] == '#') {
+        if (i + 1 < line.length() && line[i] == '/' && line[i + 1] == '/') {
             tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
             break;
         }
 
         // 多行注释
-        if (i + 1 < line.length() && line[i] == '<' && line[i + 1] == '#') {
+        if (i + 1 < line.length() && line[i] == '/' && line[i + 1] == '*') {
             size_t start = i;
             i += 2;
-            size_t end_pos = line.find("#>", i);
+            size_t end_pos = line.find("*/", i);
             if (end_pos != std::string::npos) {
                 i = end_pos + 2;
                 tokens.push_back({line.substr(start, i - start), TokenType::COMMENT, start, i});
@@ -4384,7 +2705,7 @@ std::vector<Token> SyntaxHighlighter::tokenizePowerShell(const std::string& line
             size_t start = i;
             i++;
             while (i < line.length() && line[i] != quote) {
-                if (line[i] == '`' && i + 1 < line.length())
+                if (line[i] == '\\' && i + 1 < line.length())
                     i += 2;
                 else
                     i++;
@@ -4415,11 +2736,11 @@ std::vector<Token> SyntaxHighlighter::tokenizePowerShell(const std::string& line
             continue;
         }
 
-        // 标识符/命令
+        // 标识符/关键字
         unsigned char c = static_cast<unsigned char>(line[i]);
         if (std::isalpha(c) || line[i] == '_') {
             size_t start = i;
-            while (i < line.length() && (std::isalnum(line[i]) || line[i] == '_' || line[i] == '-'))
+            while (i < line.length() && (std::isalnum(line[i]) || line[i] == '_'))
                 i++;
             std::string word = line.substr(start, i - start);
             TokenType type = TokenType::NORMAL;
@@ -4448,13 +2769,12 @@ std::vector<Token> SyntaxHighlighter::tokenizePowerShell(const std::string& line
     return tokens;
 }
 
-// 通用的基础tokenize函数，为新添加的语言提供基本的语法高亮
-std::vector<Token> SyntaxHighlighter::tokenizeGeneric(const std::string& line) {
+std::vector<Token> SyntaxHighlighter::tokenizeDockerfile(const std::string& line) {
     std::vector<Token> tokens;
     size_t i = 0;
 
     while (i < line.length()) {
-        // 跳过空白字符
+        // 跳过空白
         if (std::isspace(line[i])) {
             size_t start = i;
             while (i < line.length() && std::isspace(line[i]))
@@ -4463,75 +2783,47 @@ std::vector<Token> SyntaxHighlighter::tokenizeGeneric(const std::string& line) {
             continue;
         }
 
-        // 注释处理（通用规则）
-        if (line.substr(i, 2) == "//" || line.substr(i, 2) == "#!") {
-            tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
-            break;
-        }
-        if (line.substr(i, 2) == "/*") {
-            size_t start = i;
-            i += 2;
-            while (i < line.length() - 1 && line.substr(i, 2) != "*/")
-                i++;
-            if (line.substr(i, 2) == "*/")
-                i += 2;
-            tokens.push_back({line.substr(start, i - start), TokenType::COMMENT, start, i});
-            continue;
-        }
-        if (line[i] == '#' || line[i] == ';') {
+        // 注释
+        if (line[i] == '#') {
             tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
             break;
         }
 
-        // 字符串处理
-        if (line[i] == '"' || line[i] == '\'' || line[i] == '`') {
+        // 字符串
+        if (line[i] == '"' || line[i] == '\'') {
             char quote = line[i];
             size_t start = i;
             i++;
             while (i < line.length() && line[i] != quote) {
                 if (line[i] == '\\' && i + 1 < line.length())
-                    i++; // 转义字符
-                i++;
+                    i += 2;
+                else
+                    i++;
             }
             if (i < line.length())
-                i++; // 包含结束引号
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        // 数字
-        if (std::isdigit(line[i]) ||
-            (line[i] == '.' && i + 1 < line.length() && std::isdigit(line[i + 1]))) {
-            size_t start = i;
-            bool hasDot = (line[i] == '.');
-            i++;
-            while (i < line.length() && (std::isdigit(line[i]) || (!hasDot && line[i] == '.'))) {
-                if (line[i] == '.')
-                    hasDot = true;
                 i++;
-            }
-            tokens.push_back({line.substr(start, i - start), TokenType::NUMBER, start, i});
+            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
             continue;
         }
 
-        // 标识符和关键字
-        if (std::isalpha(line[i]) || line[i] == '_') {
+        // 指令
+        unsigned char c = static_cast<unsigned char>(line[i]);
+        if (std::isalpha(c)) {
             size_t start = i;
-            while (i < line.length() && (std::isalnum(line[i]) || line[i] == '_'))
+            while (i < line.length() && std::isalpha(line[i]))
                 i++;
             std::string word = line.substr(start, i - start);
-            TokenType type = isKeyword(word) ? TokenType::KEYWORD : TokenType::NORMAL;
+            std::string upper_word = word;
+            std::transform(upper_word.begin(), upper_word.end(), upper_word.begin(), ::toupper);
+            TokenType type = TokenType::NORMAL;
+            if (isKeyword(upper_word)) {
+                type = TokenType::KEYWORD;
+            }
             tokens.push_back({word, type, start, i});
             continue;
         }
 
-        // 运算符
-        if (isOperator(line[i])) {
-            tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-            i++;
-            continue;
-        }
-
+        // 其他
         tokens.push_back({std::string(1, line[i]), TokenType::NORMAL, i, i + 1});
         i++;
     }
@@ -4539,50 +2831,7 @@ std::vector<Token> SyntaxHighlighter::tokenizeGeneric(const std::string& line) {
     return tokens;
 }
 
-// 新增语言的tokenize函数实现（使用通用实现）
-std::vector<Token> SyntaxHighlighter::tokenizeElixir(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeClojure(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeErlang(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeJulia(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeDart(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeNim(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeCrystal(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeZig(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeOCaml(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeCoq(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeAgda(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeIdris(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizePureScript(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeReason(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeSML(const std::string& line) {
+std::vector<Token> SyntaxHighlighter::tokenizeMakefile(const std::string& line) {
     std::vector<Token> tokens;
     size_t i = 0;
 
@@ -4596,138 +2845,198 @@ std::vector<Token> SyntaxHighlighter::tokenizeSML(const std::string& line) {
             continue;
         }
 
-        // 注释
-        if (line[i] == '(' && i + 1 < line.length() && line[i + 1] == '*') {
+        // 注释 - 从行首#开始的注释
+        if (line[i] == '#') {
+            tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
+            break;
+        }
+
+        // 字符串 - 双引号
+        if (line[i] == '"') {
             size_t start = i;
-            i += 2;
-            while (i < line.length() &&
-                   !(line[i] == '*' && i + 1 < line.length() && line[i + 1] == ')')) {
-                i++;
-            }
-            if (i < line.length()) {
-                i += 2;
+            i++;
+            while (i < line.length()) {
+                if (line[i] == '\\' && i + 1 < line.length()) {
+                    i += 2; // 跳过转义字符
+                } else if (line[i] == '"') {
+                    i++;
+                    break;
+                } else {
+                    i++;
+                }
             }
-            tokens.push_back({line.substr(start, i - start), TokenType::COMMENT, start, i});
+            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
             continue;
         }
 
-        // 字符串
-        if (line[i] == '"') {
+        // 字符串 - 单引号
+        if (line[i] == '\'') {
             size_t start = i;
             i++;
-            while (i < line.length() && line[i] != '"') {
-                if (line[i] == '\\' && i + 1 < line.length())
-                    i += 2;
-                else
+            while (i < line.length()) {
+                if (line[i] == '\\' && i + 1 < line.length()) {
+                    i += 2; // 跳过转义字符
+                } else if (line[i] == '\'') {
+                    i++;
+                    break;
+                } else {
                     i++;
+                }
             }
-            if (i < line.length())
-                i++;
             tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
             continue;
         }
 
-        // 字符字面量
-        if (line[i] == '#' && i + 1 < line.length() && line[i + 1] == '"') {
+        // 变量引用和函数调用 - $(...) 和 ${...}
+        if (line[i] == '$') {
             size_t start = i;
-            i += 2;
-            while (i < line.length() && line[i] != '"') {
-                if (line[i] == '\\' && i + 1 < line.length())
-                    i += 2;
-                else
+            i++;
+            if (i < line.length()) {
+                if (line[i] == '(' || line[i] == '{') {
+                    char end_char = (line[i] == '(') ? ')' : '}';
                     i++;
+                    int paren_depth = 1;
+
+                    // 检查是否是函数调用（基于tree-sitter-make的语法）
+                    bool is_function = false;
+                    size_t func_check_start = i;
+                    std::string potential_func;
+
+                    // 收集函数名候选
+                    while (func_check_start < line.length() &&
+                           (std::isalnum(line[func_check_start]) || line[func_check_start] == '_' ||
+                            line[func_check_start] == '-')) {
+                        potential_func += line[func_check_start];
+                        func_check_start++;
+                    }
+
+                    // 检查是否是已知函数名（使用makefile语法常量）
+                    if (isMakefileFunction(potential_func)) {
+                        is_function = true;
+                    }
+
+                    while (i < line.length() && paren_depth > 0) {
+                        if (line[i] == end_char) {
+                            paren_depth--;
+                            if (paren_depth == 0) {
+                                i++;
+                                break;
+                            }
+                        } else if (line[i] == (end_char == ')' ? '(' : '{')) {
+                            paren_depth++;
+                        }
+                        i++;
+                    }
+
+                    TokenType var_type = is_function ? TokenType::FUNCTION : TokenType::TYPE;
+                    tokens.push_back({line.substr(start, i - start), var_type, start, i});
+                    continue;
+                } else {
+                    // 自动变量：$@, $%, $<, $?, $^, $+, $* 等
+                    // 基于tree-sitter-make的自动变量定义
+                    if (isMakefileAutomaticVar(line[i]) || std::isalnum(line[i]) ||
+                        line[i] == '_') {
+                        i++;
+                        tokens.push_back(
+                            {line.substr(start, i - start), TokenType::TYPE, start, i});
+                        continue;
+                    }
+                }
             }
-            if (i < line.length())
+        }
+
+        // 规则分隔符 - : 和 :: （基于tree-sitter-make）
+        if (line[i] == ':') {
+            size_t start = i;
+            i++;
+            if (i < line.length() && line[i] == ':') {
                 i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
+            }
+            tokens.push_back({line.substr(start, i - start), TokenType::OPERATOR, start, i});
+            continue;
+        }
+
+        // 赋值运算符 - =, :=, ::=, +=, ?=, != （基于tree-sitter-make）
+        if (line[i] == '=' || line[i] == '+' || line[i] == '?' || line[i] == '!' ||
+            (line[i] == ':' && i + 1 < line.length() && line[i + 1] == '=')) {
+            size_t start = i;
+            if (line[i] == ':' && i + 2 < line.length() && line[i + 1] == ':' &&
+                line[i + 2] == '=') {
+                // ::= 运算符
+                i += 3;
+            } else if (line[i] == ':' && i + 1 < line.length() && line[i + 1] == '=') {
+                // := 运算符
+                i += 2;
+            } else {
+                // =, +=, ?=, != 运算符
+                i++;
+                if (i < line.length() && line[i] == '=') {
+                    i++;
+                }
+            }
+            tokens.push_back({line.substr(start, i - start), TokenType::OPERATOR, start, i});
             continue;
         }
 
-        // 括号
-        if (line[i] == '(' || line[i] == ')' || line[i] == '[' || line[i] == ']') {
+        // 运算符、括号和分隔符 （基于tree-sitter-make）
+        if (isMakefileOperator(line[i]) || isMakefileBracket(line[i]) ||
+            isMakefileDelimiter(line[i])) {
             tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
             i++;
             continue;
         }
 
-        // 标识符和关键字
+        // 标识符和关键字识别
         unsigned char c = static_cast<unsigned char>(line[i]);
-        if (std::isalpha(c) || line[i] == '_' || line[i] == '\'') {
+        if (std::isalpha(c) || line[i] == '_' || line[i] == '/' || line[i] == '.' ||
+            line[i] == '-' || line[i] == '%' || line[i] == '*' || line[i] == '?' ||
+            line[i] == '+' || line[i] == '@' || line[i] == '^' || line[i] == '|' ||
+            line[i] == '$') {
             size_t start = i;
             while (i < line.length() &&
-                   (std::isalnum(line[i]) || line[i] == '_' || line[i] == '\'')) {
+                   (std::isalnum(line[i]) || line[i] == '_' || line[i] == '/' || line[i] == '.' ||
+                    line[i] == '-' || line[i] == '%' || line[i] == '*' || line[i] == '?' ||
+                    line[i] == '+' || line[i] == '@' || line[i] == '^' || line[i] == '|' ||
+                    line[i] == '$')) {
                 i++;
             }
             std::string word = line.substr(start, i - start);
             TokenType type = TokenType::NORMAL;
 
-            // SML关键字
-            static const std::unordered_set<std::string> sml_keywords = {
-                "abstype",   "and",     "andalso",   "as",      "case",  "datatype",  "do",
-                "else",      "end",     "exception", "fn",      "fun",   "handle",    "if",
-                "in",        "infix",   "infixr",    "let",     "local", "nonfix",    "of",
-                "op",        "open",    "orelse",    "raise",   "rec",   "then",      "type",
-                "val",       "with",    "withtype",  "while",   "sig",   "signature", "struct",
-                "structure", "functor", "include",   "sharing", "where"};
-
-            if (sml_keywords.count(word) > 0) {
+            // 检查是否是指令关键字（基于tree-sitter-make）
+            if (isMakefileDirectiveKeyword(word)) {
+                type = TokenType::KEYWORD;
+            }
+            // 检查是否是常规关键字
+            else if (isKeyword(word)) {
                 type = TokenType::KEYWORD;
-            } else if (word == "true" || word == "false") {
-                type = TokenType::KEYWORD; // 布尔值
-            } else if (std::isupper(word[0])) {
-                type = TokenType::TYPE; // 大写开头的通常是类型或构造函数
+            }
+            // 包含变量引用的标识符
+            else if (word.find('$') != std::string::npos) {
+                type = TokenType::TYPE;
+            }
+            // 文件路径相关的标识符
+            else if (word.find('/') != std::string::npos || word.find('.') != std::string::npos) {
+                type = TokenType::TYPE;
+            }
+            // 特殊makefile标识符（包含通配符等）
+            else if (word.find('%') != std::string::npos || word.find('*') != std::string::npos ||
+                     word.find('?') != std::string::npos) {
+                type = TokenType::TYPE;
             }
 
             tokens.push_back({word, type, start, i});
             continue;
         }
 
-        // 其他
+        // 其他字符作为运算符
         tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
         i++;
     }
 
     return tokens;
 }
-std::vector<Token> SyntaxHighlighter::tokenizeGroovy(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeCoffeeScript(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizePug(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeStylus(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeSass(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeLess(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizePostCSS(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeGraphQL(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeVue(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeSvelte(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeFSharp(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeCSharp(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeVB(const std::string& line) {
-    return tokenizeGeneric(line);
-}
+
 std::vector<Token> SyntaxHighlighter::tokenizeAssembly(const std::string& line) {
     std::vector<Token> tokens;
     size_t i = 0;
@@ -5320,27 +3629,6 @@ std::vector<Token> SyntaxHighlighter::tokenizeLLVMIR(const std::string& line) {
     return tokens;
 }
 
-std::vector<Token> SyntaxHighlighter::tokenizeWebAssembly(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeVerilog(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeVHDL(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeMATLAB(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeOctave(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeRacket(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeScheme(const std::string& line) {
-    return tokenizeGeneric(line);
-}
 std::vector<Token> SyntaxHighlighter::tokenizeCommonLisp(const std::string& line) {
     std::vector<Token> tokens;
     size_t i = 0;
@@ -5743,304 +4031,6 @@ std::vector<Token> SyntaxHighlighter::tokenizeCommonLisp(const std::string& line
 
     return tokens;
 }
-std::vector<Token> SyntaxHighlighter::tokenizeEmacsLisp(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeProlog(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeMercury(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeAlloy(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeDafny(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeLean(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeBallerina(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeCadence(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeClarity(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeSolidity(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeVyper(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeCarbon(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeVala(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeGenie(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeD(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizePony(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeV(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeOdin(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeJai(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeNelua(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeWren(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeMoonScript(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeFantom(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeSmalltalk(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeAPL(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeJ(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeK(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-std::vector<Token> SyntaxHighlighter::tokenizeQ(const std::string& line) {
-    return tokenizeGeneric(line);
-}
-
-std::vector<Token> SyntaxHighlighter::tokenizeMeson(const std::string& line) {
-    std::vector<Token> tokens;
-    size_t i = 0;
-
-    while (i < line.length()) {
-        // 跳过空白
-        if (std::isspace(line[i])) {
-            size_t start = i;
-            while (i < line.length() && std::isspace(line[i]))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NORMAL, start, i});
-            continue;
-        }
-
-        // 注释
-        if (line[i] == '#') {
-            tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
-            break;
-        }
-
-        // 字符串
-        if (line[i] == '"' || line[i] == '\'') {
-            char quote = line[i];
-            size_t start = i;
-            i++;
-            while (i < line.length() && line[i] != quote) {
-                if (line[i] == '\\' && i + 1 < line.length())
-                    i += 2;
-                else
-                    i++;
-            }
-            if (i < line.length())
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        // 多行字符串开始
-        if (line.substr(i, 3) == "'''") {
-            size_t start = i;
-            i += 3;
-            while (i < line.length() && line.substr(i, 3) != "'''") {
-                i++;
-            }
-            if (i < line.length())
-                i += 3;
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        // 数字
-        if (std::isdigit(line[i]) ||
-            (line[i] == '-' && i + 1 < line.length() && std::isdigit(line[i + 1]))) {
-            size_t start = i;
-            if (line[i] == '-')
-                i++;
-            while (i < line.length() && (std::isdigit(line[i]) || line[i] == '.'))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NUMBER, start, i});
-            continue;
-        }
-
-        // 标识符和关键字
-        if (std::isalpha(line[i]) || line[i] == '_') {
-            size_t start = i;
-            while (i < line.length() && (std::isalnum(line[i]) || line[i] == '_'))
-                i++;
-            std::string word = line.substr(start, i - start);
-
-            // 检查是否是关键字
-            if (std::find(keywords_["meson"].begin(), keywords_["meson"].end(), word) !=
-                keywords_["meson"].end()) {
-                tokens.push_back({word, TokenType::KEYWORD, start, i});
-            }
-            // 检查是否是类型
-            else if (std::find(types_["meson"].begin(), types_["meson"].end(), word) !=
-                     types_["meson"].end()) {
-                tokens.push_back({word, TokenType::TYPE, start, i});
-            }
-            // 检查是否是布尔值
-            else if (word == "true" || word == "false") {
-                tokens.push_back({word, TokenType::KEYWORD, start, i});
-            } else {
-                tokens.push_back({word, TokenType::NORMAL, start, i});
-            }
-            continue;
-        }
-
-        // 操作符和标点符号
-        if (strchr("()[]{},.:;=+-*/%!&|^~<>?", line[i])) {
-            tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-            i++;
-            continue;
-        }
-
-        // 其他字符
-        tokens.push_back({std::string(1, line[i]), TokenType::NORMAL, i, i + 1});
-        i++;
-    }
-
-    return tokens;
-}
-
-std::vector<Token> SyntaxHighlighter::tokenizeTOML(const std::string& line) {
-    std::vector<Token> tokens;
-    size_t i = 0;
-
-    while (i < line.length()) {
-        // 跳过空白
-        if (std::isspace(line[i])) {
-            size_t start = i;
-            while (i < line.length() && std::isspace(line[i]))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NORMAL, start, i});
-            continue;
-        }
-
-        // 注释
-        if (line[i] == '#') {
-            tokens.push_back({line.substr(i), TokenType::COMMENT, i, line.length()});
-            break;
-        }
-
-        // 字符串
-        if (line[i] == '"' || line[i] == '\'') {
-            char quote = line[i];
-            size_t start = i;
-            i++;
-            while (i < line.length() && line[i] != quote) {
-                if (line[i] == '\\' && i + 1 < line.length())
-                    i += 2;
-                else
-                    i++;
-            }
-            if (i < line.length())
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        // 多行字符串开始
-        if (line.substr(i, 3) == "\"\"\"") {
-            size_t start = i;
-            i += 3;
-            while (i < line.length() && line.substr(i, 3) != "\"\"\"") {
-                i++;
-            }
-            if (i < line.length())
-                i += 3;
-            tokens.push_back({line.substr(start, i - start), TokenType::STRING, start, i});
-            continue;
-        }
-
-        // 数字
-        if (std::isdigit(line[i]) ||
-            (line[i] == '-' && i + 1 < line.length() && std::isdigit(line[i + 1])) ||
-            (line[i] == '+' && i + 1 < line.length() && std::isdigit(line[i + 1]))) {
-            size_t start = i;
-            if (line[i] == '-' || line[i] == '+')
-                i++;
-            while (i < line.length() &&
-                   (std::isdigit(line[i]) || line[i] == '.' || line[i] == 'e' || line[i] == 'E' ||
-                    line[i] == '-' || line[i] == '+'))
-                i++;
-            tokens.push_back({line.substr(start, i - start), TokenType::NUMBER, start, i});
-            continue;
-        }
-
-        // 数组和内联表
-        if (line[i] == '[' || line[i] == ']' || line[i] == '{') {
-            tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-            i++;
-            continue;
-        }
-
-        // 等号
-        if (line[i] == '=') {
-            tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-            i++;
-            continue;
-        }
-
-        // 标识符和关键字
-        if (std::isalpha(line[i]) || line[i] == '_') {
-            size_t start = i;
-            while (i < line.length() && (std::isalnum(line[i]) || line[i] == '_' || line[i] == '-'))
-                i++;
-            std::string word = line.substr(start, i - start);
-
-            // 检查是否是关键字
-            if (std::find(keywords_["toml"].begin(), keywords_["toml"].end(), word) !=
-                keywords_["toml"].end()) {
-                tokens.push_back({word, TokenType::KEYWORD, start, i});
-            } else {
-                tokens.push_back({word, TokenType::NORMAL, start, i});
-            }
-            continue;
-        }
-
-        // 点号（用于表路径）
-        if (line[i] == '.') {
-            tokens.push_back({std::string(1, line[i]), TokenType::OPERATOR, i, i + 1});
-            i++;
-            continue;
-        }
-
-        // 其他字符
-        tokens.push_back({std::string(1, line[i]), TokenType::NORMAL, i, i + 1});
-        i++;
-    }
-
-    return tokens;
-}
 
 std::vector<Token> SyntaxHighlighter::tokenizeHTML(const std::string& line) {
     std::vector<Token> tokens;
@@ -6090,8 +4080,7 @@ std::vector<Token> SyntaxHighlighter::tokenizeHTML(const std::string& line) {
                         i++;
                     if (i < line.length()) {
                         std::string tag_content = line.substr(start + 1, i - start - 1);
-                        if (std::find(keywords_["html"].begin(), keywords_["html"].end(),
-                                      tag_content) != keywords_["html"].end()) {
+                        if (keywords_["html"].contains(tag_content)) {
                             tokens.push_back({line.substr(start, i - start + 1), TokenType::KEYWORD,
                                               start, i + 1});
                         } else {
@@ -1,6 +1,9 @@
 #include "features/SyntaxHighlighter/syntax_highlighter_tree_sitter.h"
+#include "core/document.h"
 #include <algorithm>
+#include <climits>
 #include <cstring>
+#include <iterator>
 #include <tree_sitter/api.h>
 
 // Tree-sitter 语言定义（需要链接对应的语言库）
@@ -190,6 +193,68 @@ using namespace ftxui;
 namespace pnana {
 namespace features {
 
+namespace {
+
+// 追加样式区间，与前一个相邻且同色时合并
+void appendSpan(StyleSpans& spans, size_t start, size_t end, Color span_color) {
+    if (end <= start) {
+        return;
+    }
+    if (!spans.empty() && spans.back().end == start && spans.back().color == span_color) {
+        spans.back().end = end;
+    } else {
+        spans.push_back({start, end, span_color});
+    }
+}
+
+// TSInput 的读取回调：按 position 给出的行列直接返回 LineBuffer 中该行剩余部分，
+// 行尾补一个 "\n"，解析时不需要把整个文档拼接成一个字符串
+const char* readLineBuffer(void* payload, uint32_t /*byte_index*/, TSPoint position,
+                           uint32_t* bytes_read) {
+    static const char NEWLINE[] = "\n";
+    const auto* lines = static_cast<const core::LineBuffer*>(payload);
+    if (position.row < lines->size()) {
+        std::string_view line = lines->view(position.row);
+        if (position.column < line.size()) {
+            *bytes_read = static_cast<uint32_t>(line.size() - position.column);
+            return line.data() + position.column;
+        }
+        if (position.row + 1 < lines->size()) {
+            *bytes_read = 1;
+            return NEWLINE;
+        }
+    }
+    *bytes_read = 0;
+    return "";
+}
+
+} // namespace
+
+struct SyntaxHighlighterTreeSitter::DocumentTree {
+    // 行内一段样式，end 为该段结束的列
+    struct StyleRun {
+        uint32_t end;
+        HighlightStyle style;
+    };
+
+    TSTree* tree = nullptr;
+    const TSLanguage* language = nullptr;
+    size_t rows = 0;                  // 解析时的行数
+    size_t bytes = 0;                 // 解析时的总字节数（行间以 "\n" 分隔）
+    uint32_t last_line_bytes = 0;     // 解析时最后一行的字节数
+    std::vector<uint32_t> row_starts; // 每行开头的字节偏移
+
+    // 最近一次高亮查询的结果：[window_first, window_first + window_rows.size()) 行
+    size_t window_first = 0;
+    std::vector<std::vector<StyleRun>> window_rows;
+
+    ~DocumentTree() {
+        if (tree) {
+            ts_tree_delete(tree);
+        }
+    }
+};
+
 SyntaxHighlighterTreeSitter::SyntaxHighlighterTreeSitter(ui::Theme& theme)
     : theme_(theme), parser_(nullptr), current_language_(nullptr), current_file_type_("text") {
     parser_ = ts_parser_new();
@@ -215,6 +280,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_CPP
     TSLanguage* cpp_lang = tree_sitter_cpp();
     if (cpp_lang) {
+        language_names_[cpp_lang] = "cpp";
         language_map_["cpp"] = cpp_lang;
         language_map_["cxx"] = cpp_lang;
         language_map_["cc"] = cpp_lang;
@@ -228,6 +294,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_C
     TSLanguage* c_lang = tree_sitter_c();
     if (c_lang) {
+        language_names_[c_lang] = "c";
         language_map_["c"] = c_lang;
         language_map_["h"] = c_lang;
     }
@@ -237,6 +304,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_PYTHON
     TSLanguage* python_lang = tree_sitter_python();
     if (python_lang) {
+        language_names_[python_lang] = "python";
         language_map_["py"] = python_lang;
         language_map_["python"] = python_lang;
         language_map_["pyw"] = python_lang;
@@ -248,6 +316,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_JAVASCRIPT
     TSLanguage* js_lang = tree_sitter_javascript();
     if (js_lang) {
+        language_names_[js_lang] = "javascript";
         language_map_["js"] = js_lang;
         language_map_["javascript"] = js_lang;
         language_map_["jsx"] = js_lang;
@@ -259,6 +328,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_TYPESCRIPT
     TSLanguage* ts_lang = tree_sitter_typescript();
     if (ts_lang) {
+        language_names_[ts_lang] = "typescript";
         language_map_["ts"] = ts_lang;
         language_map_["typescript"] = ts_lang;
         language_map_["tsx"] = ts_lang;
@@ -269,6 +339,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_JSON
     TSLanguage* json_lang = tree_sitter_json();
     if (json_lang) {
+        language_names_[json_lang] = "json";
         language_map_["json"] = json_lang;
         language_map_["jsonc"] = json_lang;
     }
@@ -278,6 +349,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_MARKDOWN
     TSLanguage* md_lang = tree_sitter_markdown();
     if (md_lang) {
+        language_names_[md_lang] = "markdown";
         language_map_["md"] = md_lang;
         language_map_["markdown"] = md_lang;
     }
@@ -287,6 +359,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_BASH
     TSLanguage* bash_lang = tree_sitter_bash();
     if (bash_lang) {
+        language_names_[bash_lang] = "bash";
         language_map_["sh"] = bash_lang;
         language_map_["bash"] = bash_lang;
         language_map_["shell"] = bash_lang;
@@ -298,6 +371,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_RUST
     TSLanguage* rust_lang = tree_sitter_rust();
     if (rust_lang) {
+        language_names_[rust_lang] = "rust";
         language_map_["rs"] = rust_lang;
         language_map_["rust"] = rust_lang;
     }
@@ -307,6 +381,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_GO
     TSLanguage* go_lang = tree_sitter_go();
     if (go_lang) {
+        language_names_[go_lang] = "go";
         language_map_["go"] = go_lang;
     }
 #endif
@@ -315,6 +390,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_JAVA
     TSLanguage* java_lang = tree_sitter_java();
     if (java_lang) {
+        language_names_[java_lang] = "java";
         language_map_["java"] = java_lang;
     }
 #endif
@@ -323,6 +399,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_CMAKE
     TSLanguage* cmake_lang = tree_sitter_cmake();
     if (cmake_lang) {
+        language_names_[cmake_lang] = "cmake";
         language_map_["cmake"] = cmake_lang;
         language_map_["cmake.in"] = cmake_lang;
         language_map_["cmake.in.in"] = cmake_lang;
@@ -333,6 +410,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_TCL
     TSLanguage* tcl_lang = tree_sitter_tcl();
     if (tcl_lang) {
+        language_names_[tcl_lang] = "tcl";
         language_map_["tcl"] = tcl_lang;
         language_map_["tk"] = tcl_lang;
         language_map_["portfile"] = tcl_lang; // MacPorts portfiles
@@ -343,6 +421,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_FORTRAN
     TSLanguage* fortran_lang = tree_sitter_fortran();
     if (fortran_lang) {
+        language_names_[fortran_lang] = "fortran";
         language_map_["f90"] = fortran_lang;
         language_map_["f95"] = fortran_lang;
         language_map_["f03"] = fortran_lang;
@@ -359,6 +438,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_HASKELL
     TSLanguage* haskell_lang = tree_sitter_haskell();
     if (haskell_lang) {
+        language_names_[haskell_lang] = "haskell";
         language_map_["hs"] = haskell_lang;
         language_map_["haskell"] = haskell_lang;
         language_map_["lhs"] = haskell_lang; // Literate Haskell
@@ -369,6 +449,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_LUA
     TSLanguage* lua_lang = tree_sitter_lua();
     if (lua_lang) {
+        language_names_[lua_lang] = "lua";
         language_map_["lua"] = lua_lang;
         language_map_["lua5.1"] = lua_lang;
         language_map_["lua5.2"] = lua_lang;
@@ -382,6 +463,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_YAML
     TSLanguage* yaml_lang = tree_sitter_yaml();
     if (yaml_lang) {
+        language_names_[yaml_lang] = "yaml";
         language_map_["yaml"] = yaml_lang;
         language_map_["yml"] = yaml_lang;
     }
@@ -391,6 +473,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_XML
     TSLanguage* xml_lang = tree_sitter_xml();
     if (xml_lang) {
+        language_names_[xml_lang] = "xml";
         language_map_["xml"] = xml_lang;
         language_map_["html"] = xml_lang;
         language_map_["htm"] = xml_lang;
@@ -403,6 +486,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_CSS
     TSLanguage* css_lang = tree_sitter_css();
     if (css_lang) {
+        language_names_[css_lang] = "css";
         language_map_["css"] = css_lang;
         language_map_["scss"] = css_lang;
         language_map_["sass"] = css_lang;
@@ -414,6 +498,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_SQL
     TSLanguage* sql_lang = tree_sitter_sql();
     if (sql_lang) {
+        language_names_[sql_lang] = "sql";
         language_map_["sql"] = sql_lang;
         language_map_["mysql"] = sql_lang;
         language_map_["postgresql"] = sql_lang;
@@ -427,6 +512,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_RUBY
     TSLanguage* ruby_lang = tree_sitter_ruby();
     if (ruby_lang) {
+        language_names_[ruby_lang] = "ruby";
         language_map_["rb"] = ruby_lang;
         language_map_["ruby"] = ruby_lang;
         language_map_["rake"] = ruby_lang;
@@ -438,6 +524,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_PHP
     TSLanguage* php_lang = tree_sitter_php();
     if (php_lang) {
+        language_names_[php_lang] = "php";
         language_map_["php"] = php_lang;
         language_map_["phtml"] = php_lang;
         language_map_["php3"] = php_lang;
@@ -451,6 +538,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_SWIFT
     TSLanguage* swift_lang = tree_sitter_swift();
     if (swift_lang) {
+        language_names_[swift_lang] = "swift";
         language_map_["swift"] = swift_lang;
     }
 #endif
@@ -459,6 +547,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_KOTLIN
     TSLanguage* kotlin_lang = tree_sitter_kotlin();
     if (kotlin_lang) {
+        language_names_[kotlin_lang] = "kotlin";
         language_map_["kt"] = kotlin_lang;
         language_map_["kotlin"] = kotlin_lang;
         language_map_["kts"] = kotlin_lang;
@@ -469,6 +558,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_SCALA
     TSLanguage* scala_lang = tree_sitter_scala();
     if (scala_lang) {
+        language_names_[scala_lang] = "scala";
         language_map_["scala"] = scala_lang;
         language_map_["sc"] = scala_lang;
     }
@@ -478,6 +568,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_R
     TSLanguage* r_lang = tree_sitter_r();
     if (r_lang) {
+        language_names_[r_lang] = "r";
         language_map_["r"] = r_lang;
         language_map_["R"] = r_lang;
         language_map_["rmd"] = r_lang;
@@ -489,6 +580,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_PERL
     TSLanguage* perl_lang = tree_sitter_perl();
     if (perl_lang) {
+        language_names_[perl_lang] = "perl";
         language_map_["pl"] = perl_lang;
         language_map_["pm"] = perl_lang;
         language_map_["perl"] = perl_lang;
@@ -500,6 +592,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_DOCKERFILE
     TSLanguage* dockerfile_lang = tree_sitter_dockerfile();
     if (dockerfile_lang) {
+        language_names_[dockerfile_lang] = "dockerfile";
         language_map_["dockerfile"] = dockerfile_lang;
         language_map_["Dockerfile"] = dockerfile_lang;
         language_map_["containerfile"] = dockerfile_lang;
@@ -510,6 +603,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_VIM
     TSLanguage* vim_lang = tree_sitter_vim();
     if (vim_lang) {
+        language_names_[vim_lang] = "vim";
         language_map_["vim"] = vim_lang;
         language_map_["vimrc"] = vim_lang;
         language_map_["nvim"] = vim_lang;
@@ -521,6 +615,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_POWERSHELL
     TSLanguage* powershell_lang = tree_sitter_powershell();
     if (powershell_lang) {
+        language_names_[powershell_lang] = "powershell";
         language_map_["ps1"] = powershell_lang;
         language_map_["powershell"] = powershell_lang;
         language_map_["psm1"] = powershell_lang;
@@ -532,6 +627,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_MESON
     TSLanguage* meson_lang = tree_sitter_meson();
     if (meson_lang) {
+        language_names_[meson_lang] = "meson";
         language_map_["meson"] = meson_lang;
         language_map_["meson.build"] = meson_lang;
         language_map_["meson_options.txt"] = meson_lang;
@@ -542,6 +638,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_TOML
     TSLanguage* toml_lang = tree_sitter_toml();
     if (toml_lang) {
+        language_names_[toml_lang] = "toml";
         language_map_["toml"] = toml_lang;
         language_map_["Cargo.lock"] = toml_lang;   // Rust Cargo.lock files
         language_map_["Pipfile.lock"] = toml_lang; // Python Pipfile.lock
@@ -553,6 +650,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_NIM
     TSLanguage* nim_lang = tree_sitter_nim();
     if (nim_lang) {
+        language_names_[nim_lang] = "nim";
         language_map_["nim"] = nim_lang;
         language_map_["nims"] = nim_lang;   // Nim script files
         language_map_["nimble"] = nim_lang; // Nimble package files
@@ -564,6 +662,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_LISP
     TSLanguage* lisp_lang = tree_sitter_commonlisp();
     if (lisp_lang) {
+        language_names_[lisp_lang] = "commonlisp";
         language_map_["lisp"] = lisp_lang;
         language_map_["lsp"] = lisp_lang;
         language_map_["cl"] = lisp_lang;
@@ -577,6 +676,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_SML
     TSLanguage* sml_lang = tree_sitter_sml();
     if (sml_lang) {
+        language_names_[sml_lang] = "sml";
         language_map_["sml"] = sml_lang;
         language_map_["ml"] = sml_lang;
         language_map_["sig"] = sml_lang;
@@ -588,6 +688,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_LLVM
     TSLanguage* llvm_lang = tree_sitter_llvm();
     if (llvm_lang) {
+        language_names_[llvm_lang] = "llvm";
         language_map_["ll"] = llvm_lang;
         language_map_["llvm"] = llvm_lang;
         language_map_["llvm-ir"] = llvm_lang;
@@ -598,6 +699,7 @@ void SyntaxHighlighterTreeSitter::initializeLanguages() {
 #ifdef BUILD_TREE_SITTER_ASM
     TSLanguage* asm_lang = tree_sitter_asm();
     if (asm_lang) {
+        language_names_[asm_lang] = "asm";
         language_map_["asm"] = asm_lang;
         language_map_["s"] = asm_lang;
         language_map_["S"] = asm_lang;
@@ -672,79 +774,376 @@ ftxui::Element SyntaxHighlighterTreeSitter::parseAndHighlight(const std::string&
         return text(code) | color(theme_.getColors().foreground);
     }
 
+    Elements elements;
+    for (const auto& span : parseSpans(code)) {
+        elements.push_back(text(code.substr(span.start, span.end - span.start)) |
+                           color(span.color));
+    }
+    return hbox(elements);
+}
+
+StyleSpans SyntaxHighlighterTreeSitter::highlightSpans(const std::string& line) {
+    if (line.empty()) {
+        return {};
+    }
+    if (!parser_ || !current_language_) {
+        return {{0, line.length(), theme_.getColors().foreground}};
+    }
+    return parseSpans(line);
+}
+
+StyleSpans SyntaxHighlighterTreeSitter::parseSpans(const std::string& code) {
+    StyleSpans spans;
+
     // 解析代码
     TSTree* tree = ts_parser_parse_string(parser_, nullptr, code.c_str(), code.length());
     if (!tree) {
-        return text(code) | color(theme_.getColors().foreground);
+        spans.push_back({0, code.length(), theme_.getColors().foreground});
+        return spans;
     }
 
-    TSNode root_node = ts_tree_root_node(tree);
-
-    // 遍历语法树并生成高亮元素
-    Elements elements;
     size_t current_pos = 0;
-    traverseTree(root_node, code, elements, current_pos);
+    if (HighlightQuery* query = getQueryForLanguage(current_language_)) {
+        // 按查询结果着色；谓词需要的节点文本从按行拆分的代码中取
+        std::vector<std::string> code_lines;
+        size_t line_start = 0;
+        for (size_t pos = code.find('\n'); pos != std::string::npos;
+             pos = code.find('\n', line_start)) {
+            code_lines.push_back(code.substr(line_start, pos - line_start));
+            line_start = pos + 1;
+        }
+        code_lines.push_back(code.substr(line_start));
+        core::LineBuffer lines(std::move(code_lines));
+
+        paintQuery(*query, ts_tree_root_node(tree), 0, static_cast<uint32_t>(code.length()),
+                   lines);
+        for (size_t i = 0; i < code.length(); ++i) {
+            if (i + 1 == code.length() || byte_styles_[i + 1] != byte_styles_[i]) {
+                appendSpan(spans, current_pos, i + 1, getColorForStyle(byte_styles_[i]));
+                current_pos = i + 1;
+            }
+        }
+    } else {
+        // 遍历语法树生成样式区间
+        traverseTree(ts_tree_root_node(tree), code.length(), spans, current_pos);
+    }
 
     // 处理未覆盖的文本
     if (current_pos < code.length()) {
-        std::string remaining = code.substr(current_pos);
-        elements.push_back(text(remaining) | color(theme_.getColors().foreground));
+        spans.push_back({current_pos, code.length(), theme_.getColors().foreground});
     }
 
     ts_tree_delete(tree);
-
-    return hbox(elements);
+    return spans;
 }
 
-void SyntaxHighlighterTreeSitter::traverseTree(TSNode node, const std::string& source,
-                                               std::vector<ftxui::Element>& elements,
-                                               size_t& current_pos) const {
-    uint32_t start_byte = ts_node_start_byte(node);
-    uint32_t end_byte = ts_node_end_byte(node);
+void SyntaxHighlighterTreeSitter::traverseTree(TSNode node, size_t source_length,
+                                               StyleSpans& spans, size_t& current_pos) const {
+    size_t start_byte = std::min<size_t>(ts_node_start_byte(node), source_length);
+    size_t end_byte = std::min<size_t>(ts_node_end_byte(node), source_length);
 
     // 处理节点前的文本
     if (current_pos < start_byte) {
-        std::string before = source.substr(current_pos, start_byte - current_pos);
-        elements.push_back(text(before) | color(theme_.getColors().foreground));
+        appendSpan(spans, current_pos, start_byte, theme_.getColors().foreground);
         current_pos = start_byte;
     }
 
-    // 获取节点类型
-    const char* node_type_cstr = ts_node_type(node);
-    std::string node_type = node_type_cstr ? node_type_cstr : "";
-
-    // 获取节点文本
-    std::string node_text = getNodeText(node, source);
-
-    // 获取颜色
-    Color node_color = getColorForNodeType(node_type);
-
     // 如果是叶子节点，直接添加
-    if (ts_node_child_count(node) == 0) {
-        elements.push_back(text(node_text) | color(node_color));
-        current_pos = end_byte;
+    uint32_t child_count = ts_node_child_count(node);
+    if (child_count == 0) {
+        // 获取节点类型
+        const char* node_type_cstr = ts_node_type(node);
+        std::string node_type = node_type_cstr ? node_type_cstr : "";
+        appendSpan(spans, std::max(current_pos, start_byte), end_byte,
+                   getColorForNodeType(node_type));
+        current_pos = std::max(current_pos, end_byte);
     } else {
         // 递归处理子节点
-        uint32_t child_count = ts_node_child_count(node);
         for (uint32_t i = 0; i < child_count; ++i) {
-            TSNode child = ts_node_child(node, i);
-            traverseTree(child, source, elements, current_pos);
+            traverseTree(ts_node_child(node, i), source_length, spans, current_pos);
         }
     }
 }
 
-std::string SyntaxHighlighterTreeSitter::getNodeText(TSNode node, const std::string& source) const {
-    uint32_t start_byte = ts_node_start_byte(node);
-    uint32_t end_byte = ts_node_end_byte(node);
+bool SyntaxHighlighterTreeSitter::highlightDocumentLine(core::Document& doc, size_t row,
+                                                        StyleSpans& spans, size_t begin,
+                                                        size_t end) {
+    DocumentTree* state = syncDocumentTree(doc);
+    if (!state) {
+        return false;
+    }
+
+    spans.clear();
+    if (row >= doc.lineCount()) {
+        return true;
+    }
+    end = std::min(end, doc.getLines().view(row).size());
+    if (begin >= end) {
+        return true;
+    }
 
-    if (start_byte >= source.length()) {
-        return "";
+    if (HighlightQuery* query = getQueryForLanguage(current_language_)) {
+        if (row < state->window_first || row >= state->window_first + state->window_rows.size()) {
+            highlightWindow(*state, doc.getLines(), row, *query);
+        }
+        // 各段按结束列有序，二分找到第一段与范围相交的
+        const auto& runs = state->window_rows[row - state->window_first];
+        auto it = std::upper_bound(runs.begin(), runs.end(), begin,
+                                   [](size_t pos, const DocumentTree::StyleRun& run) {
+                                       return pos < run.end;
+                                   });
+        size_t current_pos = it == runs.begin() ? 0 : std::prev(it)->end;
+        for (; it != runs.end() && current_pos < end; ++it) {
+            appendSpan(spans, current_pos, it->end, getColorForStyle(it->style));
+            current_pos = it->end;
+        }
+        if (current_pos < end) {
+            appendSpan(spans, current_pos, end, theme_.getColors().foreground);
+        }
+        return true;
     }
 
-    size_t start = static_cast<size_t>(start_byte);
-    size_t end = std::min(static_cast<size_t>(end_byte), source.length());
+    // 游标按行号和列直接下降到与范围相交的子节点，不必遍历整棵树
+    TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(state->tree));
+    size_t current_pos = begin;
+    collectRowSpans(&cursor, static_cast<uint32_t>(row), end, spans, current_pos);
+    ts_tree_cursor_delete(&cursor);
+
+    if (current_pos < end) {
+        appendSpan(spans, current_pos, end, theme_.getColors().foreground);
+    }
+    return true;
+}
 
-    return source.substr(start, end - start);
+SyntaxHighlighterTreeSitter::DocumentTree*
+SyntaxHighlighterTreeSitter::syncDocumentTree(core::Document& doc) {
+    if (!parser_ || !current_language_ || doc.isLoading()) {
+        return nullptr;
+    }
+
+    auto& slot = doc.syntaxState();
+    const core::LineBuffer& lines = doc.getLines();
+    const size_t rows = lines.size();
+    if (rows == 0 || rows > MAX_TREE_LINES) {
+        slot.reset();
+        return nullptr;
+    }
+
+    size_t first = 0;
+    size_t end = 0;
+    size_t replaced = 0;
+    const bool changed = doc.takeLineChanges(core::LineBuffer::SYNTAX_TREE, first, end, replaced);
+
+    auto state = std::static_pointer_cast<DocumentTree>(slot);
+    if (state && state->tree && state->language == current_language_ && !changed) {
+        return state.get();
+    }
+
+    // 一次扫描得到每行的字节偏移、总字节数，以及修改窗口两端的字节偏移
+    std::vector<uint32_t> row_starts;
+    row_starts.reserve(rows);
+    size_t total = 0;
+    size_t first_byte = 0;
+    size_t end_byte = 0;
+    uint32_t last_line_bytes = 0;
+    size_t row = 0;
+    lines.forEachLine([&](std::string_view line) {
+        if (row == first) {
+            first_byte = total;
+        }
+        if (row == end) {
+            end_byte = total;
+        }
+        row_starts.push_back(static_cast<uint32_t>(total));
+        total += line.size() + 1;
+        last_line_bytes = static_cast<uint32_t>(line.size());
+        ++row;
+    });
+    if (first >= rows) {
+        first_byte = total;
+    }
+    if (end >= rows) {
+        end_byte = total;
+    }
+    total -= 1; // 最后一行之后没有换行
+    if (total > UINT32_MAX) {
+        slot.reset();
+        return nullptr;
+    }
+
+    TSInput input{};
+    input.payload = const_cast<core::LineBuffer*>(&lines);
+    input.read = readLineBuffer;
+    input.encoding = TSInputEncodingUTF8;
+
+    TSTree* old_tree = nullptr;
+    if (state && state->tree && state->language == current_language_ &&
+        replaced <= state->rows && state->rows - replaced + (end - first) == rows) {
+        // 原来的 [first, first + replaced) 行变成了现在的 [first, end)，前后的行都没有变。
+        // first 越过某一侧的末尾（在末尾追加或删除行）时，改动从上一行的行尾开始
+        TSInputEdit edit{};
+        edit.start_point = {static_cast<uint32_t>(first), 0};
+        size_t start_byte = first_byte;
+        if (start_byte > std::min(total, state->bytes)) {
+            start_byte -= 1;
+            uint32_t prev_bytes = static_cast<uint32_t>(lines.view(first - 1).size());
+            edit.start_point = {static_cast<uint32_t>(first - 1), prev_bytes};
+        }
+        const bool has_tail = end < rows;
+        const size_t new_end_byte = has_tail ? end_byte : total;
+        const size_t tail_bytes = total - new_end_byte;
+        edit.start_byte = static_cast<uint32_t>(start_byte);
+        edit.new_end_byte = static_cast<uint32_t>(new_end_byte);
+        edit.old_end_byte = static_cast<uint32_t>(state->bytes - tail_bytes);
+        if (has_tail) {
+            edit.new_end_point = {static_cast<uint32_t>(end), 0};
+            edit.old_end_point = {static_cast<uint32_t>(first + replaced), 0};
+        } else {
+            edit.new_end_point = {static_cast<uint32_t>(rows - 1), last_line_bytes};
+            edit.old_end_point = {static_cast<uint32_t>(state->rows - 1), state->last_line_bytes};
+        }
+        ts_tree_edit(state->tree, &edit);
+        old_tree = state->tree;
+    } else {
+        state = std::make_shared<DocumentTree>();
+        state->language = current_language_;
+        slot = state;
+    }
+
+    // 以旧树为基础重解析：未受影响的子树直接复用
+    TSTree* tree = ts_parser_parse(parser_, old_tree, input);
+    if (old_tree) {
+        ts_tree_delete(old_tree);
+    }
+    state->tree = tree;
+    if (!tree) {
+        slot.reset();
+        return nullptr;
+    }
+    state->rows = rows;
+    state->bytes = total;
+    state->last_line_bytes = last_line_bytes;
+    state->row_starts = std::move(row_starts);
+    state->window_rows.clear();
+    return state.get();
+}
+
+void SyntaxHighlighterTreeSitter::collectRowSpans(TSTreeCursor* cursor, uint32_t row,
+                                                  size_t end_col, StyleSpans& spans,
+                                                  size_t& current_pos) const {
+    TSNode node = ts_tree_cursor_current_node(cursor);
+
+    if (ts_node_child_count(node) == 0) {
+        // 跨行的叶子节点（块注释、多行字符串）按该行内的部分着色
+        TSPoint start = ts_node_start_point(node);
+        TSPoint end = ts_node_end_point(node);
+        size_t node_start = start.row < row ? 0 : std::min<size_t>(start.column, end_col);
+        size_t node_end = end.row > row ? end_col : std::min<size_t>(end.column, end_col);
+        if (current_pos < node_start) {
+            appendSpan(spans, current_pos, node_start, theme_.getColors().foreground);
+            current_pos = node_start;
+        }
+        const char* node_type_cstr = ts_node_type(node);
+        std::string node_type = node_type_cstr ? node_type_cstr : "";
+        appendSpan(spans, current_pos, node_end, getColorForNodeType(node_type));
+        current_pos = std::max(current_pos, node_end);
+        return;
+    }
+
+    // 第一个结束位置在 current_pos 之后的子节点，逐个处理到起点越过 end_col 为止
+    const uint32_t first_col = static_cast<uint32_t>(current_pos);
+    if (ts_tree_cursor_goto_first_child_for_point(cursor, {row, first_col}) < 0) {
+        return;
+    }
+    do {
+        TSPoint start = ts_node_start_point(ts_tree_cursor_current_node(cursor));
+        if (start.row > row || (start.row == row && start.column >= end_col)) {
+            break;
+        }
+        collectRowSpans(cursor, row, end_col, spans, current_pos);
+    } while (ts_tree_cursor_goto_next_sibling(cursor));
+    ts_tree_cursor_goto_parent(cursor);
+}
+
+HighlightQuery* SyntaxHighlighterTreeSitter::getQueryForLanguage(const TSLanguage* language) {
+    if (!language) {
+        return nullptr;
+    }
+    auto it = queries_.find(language);
+    if (it == queries_.end()) {
+        auto name = language_names_.find(language);
+        std::unique_ptr<HighlightQuery> query;
+        if (name != language_names_.end()) {
+            query = HighlightQuery::load(language, name->second);
+        }
+        it = queries_.emplace(language, std::move(query)).first;
+    }
+    return it->second.get();
+}
+
+void SyntaxHighlighterTreeSitter::paintQuery(HighlightQuery& query, TSNode root,
+                                             uint32_t start_byte, uint32_t end_byte,
+                                             const core::LineBuffer& lines) {
+    byte_styles_.assign(end_byte - start_byte, HighlightStyle::NONE);
+    // capture 按文档顺序给出，内层节点在外层之后，直接覆盖
+    query.run(root, start_byte, end_byte, lines, [&](TSNode node, HighlightStyle style) {
+        uint32_t from = std::max(ts_node_start_byte(node), start_byte);
+        uint32_t to = std::min(ts_node_end_byte(node), end_byte);
+        if (from < to) {
+            std::fill(byte_styles_.begin() + (from - start_byte),
+                      byte_styles_.begin() + (to - start_byte), style);
+        }
+    });
+}
+
+void SyntaxHighlighterTreeSitter::highlightWindow(DocumentTree& state,
+                                                  const core::LineBuffer& lines,
+                                                  size_t first_row, HighlightQuery& query) {
+    const size_t last_row = std::min(state.rows, first_row + HIGHLIGHT_WINDOW_ROWS);
+    const uint32_t start_byte = state.row_starts[first_row];
+    const uint32_t end_byte =
+        last_row < state.rows ? state.row_starts[last_row] : static_cast<uint32_t>(state.bytes);
+    paintQuery(query, ts_tree_root_node(state.tree), start_byte, end_byte, lines);
+
+    state.window_first = first_row;
+    state.window_rows.assign(last_row - first_row, {});
+    for (size_t row = first_row; row < last_row; ++row) {
+        auto& runs = state.window_rows[row - first_row];
+        const uint32_t offset = state.row_starts[row] - start_byte;
+        const uint32_t length = static_cast<uint32_t>(lines.view(row).size());
+        for (uint32_t col = 0; col < length; ++col) {
+            HighlightStyle style = byte_styles_[offset + col];
+            if (!runs.empty() && runs.back().style == style) {
+                runs.back().end = col + 1;
+            } else {
+                runs.push_back({col + 1, style});
+            }
+        }
+    }
+}
+
+ftxui::Color SyntaxHighlighterTreeSitter::getColorForStyle(HighlightStyle style) const {
+    auto& colors = theme_.getColors();
+    switch (style) {
+        case HighlightStyle::KEYWORD:
+        case HighlightStyle::PREPROCESSOR:
+            return colors.keyword;
+        case HighlightStyle::STRING:
+            return colors.string;
+        case HighlightStyle::COMMENT:
+            return colors.comment;
+        case HighlightStyle::NUMBER:
+            return colors.number;
+        case HighlightStyle::FUNCTION:
+            return colors.function;
+        case HighlightStyle::TYPE:
+            return colors.type;
+        case HighlightStyle::OPERATOR:
+            return colors.operator_color;
+        case HighlightStyle::NONE:
+            break;
+    }
+    return colors.foreground;
 }
 
 ftxui::Color SyntaxHighlighterTreeSitter::getColorForNodeType(const std::string& node_type) const {
@@ -0,0 +1,568 @@
+#include "features/SyntaxHighlighter/table_lexer.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iterator>
+#include <utility>
+
+namespace pnana {
+namespace features {
+
+namespace {
+
+using TokenRuns = SyntaxHighlighter::TokenRuns;
+
+// 字符分类位
+enum CharClass : uint8_t {
+    SPACE = 1 << 0,
+    IDENT_START = 1 << 1,
+    IDENT_PART = 1 << 2,
+    DIGIT = 1 << 3,
+    OPERATOR = 1 << 4,
+    SPECIAL = 1 << 5,  // 可能开始注释、字符串或变量，需要比较前缀
+    EXPONENT = 1 << 6, // 数字的指数标记
+    WORD = 1 << 7      // 字母、数字、'_'（变量名只由这些字符组成）
+};
+
+using CharClasses = std::array<uint8_t, 256>;
+
+constexpr void markChars(CharClasses& classes, const char* chars, uint8_t bits) {
+    for (; chars && *chars; ++chars) {
+        classes[static_cast<unsigned char>(*chars)] |= bits;
+    }
+}
+
+constexpr void markFirst(CharClasses& classes, const char* prefix) {
+    if (prefix && *prefix) {
+        classes[static_cast<unsigned char>(*prefix)] |= SPECIAL;
+    }
+}
+
+constexpr CharClasses classify(const LanguageSpec& spec) {
+    CharClasses classes{};
+    for (int c = 0; c < 256; ++c) {
+        uint8_t bits = 0;
+        if (c == ' ' || (c >= '\t' && c <= '\r')) {
+            bits |= SPACE;
+        }
+        if (c >= '0' && c <= '9') {
+            bits |= DIGIT | IDENT_PART | WORD;
+        }
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_') {
+            bits |= IDENT_START | IDENT_PART | WORD;
+        }
+        classes[c] = bits;
+    }
+    markChars(classes, spec.ident_start, IDENT_START | IDENT_PART);
+    markChars(classes, spec.ident_part, IDENT_PART);
+    markChars(classes, spec.operator_chars, OPERATOR);
+    markChars(classes, spec.exponent_chars, EXPONENT);
+
+    for (const char* prefix : spec.line_comments) {
+        markFirst(classes, prefix);
+    }
+    markFirst(classes, spec.block_comment_open);
+    markFirst(classes, spec.block_string_open);
+    markChars(classes, spec.quotes, SPECIAL);
+    markChars(classes, spec.string_prefixes, SPECIAL);
+    if (spec.char_quote) {
+        classes[static_cast<unsigned char>(spec.char_quote)] |= SPECIAL;
+    }
+    for (const char* sigil : spec.sigils) {
+        markFirst(classes, sigil);
+    }
+    return classes;
+}
+
+constexpr size_t LANGUAGE_COUNT = std::size(LANGUAGE_SPECS);
+
+template <size_t... I>
+constexpr std::array<CharClasses, LANGUAGE_COUNT> classifyAll(std::index_sequence<I...>) {
+    return {{classify(LANGUAGE_SPECS[I])...}};
+}
+
+// 每种语言的字符分类表，编译期生成
+constexpr std::array<CharClasses, LANGUAGE_COUNT> LANGUAGE_CLASSES =
+    classifyAll(std::make_index_sequence<LANGUAGE_COUNT>{});
+
+// 数字 DFA 的输入类别
+enum NumberClass : uint8_t {
+    NUM_ZERO,
+    NUM_ONE,
+    NUM_OCTAL,      // 2-7
+    NUM_DECIMAL,    // 8-9
+    NUM_HEX_LETTER, // 其余 a-f、A-F
+    NUM_X,
+    NUM_B,        // 二进制前缀，也是十六进制数字
+    NUM_O,
+    NUM_EXPONENT, // 该语言的指数标记（由字符分类表的 EXPONENT 位决定）
+    NUM_LETTER,   // 其余字母，只能出现在后缀中
+    NUM_DOT,
+    NUM_SIGN,
+    NUM_SEPARATOR, // 数字分隔符 '_'
+    NUM_OTHER,
+    NUM_CLASS_COUNT
+};
+
+// 数字 DFA 的状态
+enum NumberState : uint8_t {
+    START,
+    ZERO,
+    DECIMAL,
+    DOT, // 小数点之后还没有数字
+    FRACTION,
+    EXPONENT_MARK,
+    EXPONENT_SIGN,
+    EXPONENT_DIGITS,
+    HEX_PREFIX,
+    HEX,
+    BINARY_PREFIX,
+    BINARY,
+    OCTAL_PREFIX,
+    OCTAL,
+    SUFFIX, // 类型后缀或单位，如 10u、1.5f、12px
+    DEAD,
+    NUMBER_STATE_COUNT
+};
+
+constexpr std::array<uint8_t, 256> buildNumberClasses() {
+    std::array<uint8_t, 256> classes{};
+    for (int c = 0; c < 256; ++c) {
+        uint8_t cls = NUM_OTHER;
+        if (c == '0') {
+            cls = NUM_ZERO;
+        } else if (c == '1') {
+            cls = NUM_ONE;
+        } else if (c >= '2' && c <= '7') {
+            cls = NUM_OCTAL;
+        } else if (c == '8' || c == '9') {
+            cls = NUM_DECIMAL;
+        } else if (c == 'x' || c == 'X') {
+            cls = NUM_X;
+        } else if (c == 'b' || c == 'B') {
+            cls = NUM_B;
+        } else if (c == 'o' || c == 'O') {
+            cls = NUM_O;
+        } else if ((c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F')) {
+            cls = NUM_HEX_LETTER;
+        } else if ((c >= 'g' && c <= 'z') || (c >= 'G' && c <= 'Z')) {
+            cls = NUM_LETTER;
+        } else if (c == '.') {
+            cls = NUM_DOT;
+        } else if (c == '+' || c == '-') {
+            cls = NUM_SIGN;
+        } else if (c == '_') {
+            cls = NUM_SEPARATOR;
+        }
+        classes[c] = cls;
+    }
+    return classes;
+}
+
+constexpr std::array<uint8_t, 256> NUMBER_CLASSES = buildNumberClasses();
+
+using NumberDfa = std::array<std::array<uint8_t, NUM_CLASS_COUNT>, NUMBER_STATE_COUNT>;
+
+constexpr NumberDfa buildNumberDfa() {
+    NumberDfa dfa{};
+    for (auto& row : dfa) {
+        for (auto& next : row) {
+            next = DEAD;
+        }
+    }
+    auto on = [&dfa](NumberState from, std::initializer_list<NumberClass> inputs,
+                     NumberState to) {
+        for (NumberClass input : inputs) {
+            dfa[from][input] = to;
+        }
+    };
+    const std::initializer_list<NumberClass> DIGITS = {NUM_ZERO, NUM_ONE, NUM_OCTAL,
+                                                       NUM_DECIMAL};
+    const std::initializer_list<NumberClass> LETTERS = {NUM_HEX_LETTER, NUM_X,        NUM_B,
+                                                        NUM_O,          NUM_EXPONENT, NUM_LETTER};
+
+    on(START, {NUM_ZERO}, ZERO);
+    on(START, {NUM_ONE, NUM_OCTAL, NUM_DECIMAL}, DECIMAL);
+    on(START, {NUM_DOT}, DOT);
+
+    on(ZERO, LETTERS, SUFFIX);
+    on(ZERO, DIGITS, DECIMAL);
+    on(ZERO, {NUM_SEPARATOR}, DECIMAL);
+    on(ZERO, {NUM_X}, HEX_PREFIX);
+    on(ZERO, {NUM_B}, BINARY_PREFIX);
+    on(ZERO, {NUM_O}, OCTAL_PREFIX);
+    on(ZERO, {NUM_DOT}, DOT);
+    on(ZERO, {NUM_EXPONENT}, EXPONENT_MARK);
+
+    on(DECIMAL, LETTERS, SUFFIX);
+    on(DECIMAL, DIGITS, DECIMAL);
+    on(DECIMAL, {NUM_SEPARATOR}, DECIMAL);
+    on(DECIMAL, {NUM_DOT}, DOT);
+    on(DECIMAL, {NUM_EXPONENT}, EXPONENT_MARK);
+
+    // "1..2"、"1.foo" 中的点不属于数字
+    on(DOT, DIGITS, FRACTION);
+
+    on(FRACTION, LETTERS, SUFFIX);
+    on(FRACTION, DIGITS, FRACTION);
+    on(FRACTION, {NUM_SEPARATOR}, FRACTION);
+    on(FRACTION, {NUM_EXPONENT}, EXPONENT_MARK);
+
+    on(EXPONENT_MARK, LETTERS, SUFFIX);
+    on(EXPONENT_MARK, DIGITS, EXPONENT_DIGITS);
+    on(EXPONENT_MARK, {NUM_SIGN}, EXPONENT_SIGN);
+    on(EXPONENT_SIGN, DIGITS, EXPONENT_DIGITS);
+    on(EXPONENT_DIGITS, LETTERS, SUFFIX);
+    on(EXPONENT_DIGITS, DIGITS, EXPONENT_DIGITS);
+    on(EXPONENT_DIGITS, {NUM_SEPARATOR}, EXPONENT_DIGITS);
+
+    on(HEX_PREFIX, DIGITS, HEX);
+    on(HEX_PREFIX, {NUM_HEX_LETTER, NUM_B, NUM_EXPONENT}, HEX);
+    on(HEX, LETTERS, SUFFIX);
+    on(HEX, DIGITS, HEX);
+    on(HEX, {NUM_HEX_LETTER, NUM_B, NUM_EXPONENT, NUM_SEPARATOR}, HEX);
+
+    on(BINARY_PREFIX, {NUM_ZERO, NUM_ONE}, BINARY);
+    on(BINARY, LETTERS, SUFFIX);
+    on(BINARY, {NUM_ZERO, NUM_ONE, NUM_SEPARATOR}, BINARY);
+
+    on(OCTAL_PREFIX, {NUM_ZERO, NUM_ONE, NUM_OCTAL}, OCTAL);
+    on(OCTAL, LETTERS, SUFFIX);
+    on(OCTAL, {NUM_ZERO, NUM_ONE, NUM_OCTAL, NUM_SEPARATOR}, OCTAL);
+
+    on(SUFFIX, LETTERS, SUFFIX);
+    on(SUFFIX, DIGITS, SUFFIX);
+    on(SUFFIX, {NUM_SEPARATOR}, SUFFIX);
+    return dfa;
+}
+
+constexpr NumberDfa NUMBER_DFA = buildNumberDfa();
+
+// 可以在此结束的状态
+constexpr bool isAccepting(uint8_t state) {
+    return state == ZERO || state == DECIMAL || state == FRACTION || state == EXPONENT_MARK ||
+           state == EXPONENT_DIGITS || state == HEX || state == BINARY || state == OCTAL ||
+           state == SUFFIX;
+}
+
+// 关键字按大小写转换后比较时的最大长度，更长的单词不是关键字
+constexpr size_t MAX_FOLDED_WORD = 64;
+
+constexpr uint8_t MULTI_LINE_COMMENT = 1;
+constexpr uint8_t MULTI_LINE_STRING = 2;
+
+// 追加一段，与前一段类型相同时合并
+void addRun(TokenRuns& runs, size_t start, size_t end, TokenType type) {
+    if (!runs.empty() && runs.back().end == start && runs.back().type == type) {
+        runs.back().end = end;
+    } else {
+        runs.push_back({start, end, type});
+    }
+}
+
+bool startsWith(std::string_view line, size_t pos, const char* prefix) {
+    return prefix && *prefix && line.compare(pos, std::strlen(prefix), prefix) == 0;
+}
+
+// 从 pos 开始查找 close，找到时追加到 close 结束并返回 true，否则追加到行尾并返回 false
+bool closeBlock(std::string_view line, size_t start, size_t pos, const char* close,
+                TokenType type, TokenRuns& runs, size_t& end) {
+    size_t found = line.find(close, pos);
+    end = found == std::string_view::npos ? line.size() : found + std::strlen(close);
+    addRun(runs, start, end, type);
+    return found != std::string_view::npos;
+}
+
+bool contains(const WordSet* words, std::string_view word) {
+    return words && words->contains(word);
+}
+
+// UTF-8 字符的字节数
+size_t utf8Length(unsigned char first_byte) {
+    if ((first_byte & 0xE0) == 0xC0) {
+        return 2;
+    }
+    if ((first_byte & 0xF0) == 0xE0) {
+        return 3;
+    }
+    if ((first_byte & 0xF8) == 0xF0) {
+        return 4;
+    }
+    return 1;
+}
+
+} // namespace
+
+const LanguageSpec* TableLexer::findSpec(const std::string& file_type) {
+    if (file_type.empty()) {
+        return nullptr;
+    }
+    for (const auto& spec : LANGUAGE_SPECS) {
+        std::string_view names(spec.names);
+        size_t pos = 0;
+        while (pos < names.size()) {
+            size_t end = names.find(' ', pos);
+            if (end == std::string_view::npos) {
+                end = names.size();
+            }
+            if (names.substr(pos, end - pos) == file_type) {
+                return &spec;
+            }
+            pos = end + 1;
+        }
+    }
+    return nullptr;
+}
+
+TableLexer::TableLexer(const LanguageSpec& spec, const WordSet* keywords, const WordSet* types)
+    : spec_(spec), classes_(LANGUAGE_CLASSES[&spec - LANGUAGE_SPECS].data()), keywords_(keywords),
+      types_(types) {}
+
+bool TableLexer::hasMultiLineState() const {
+    return spec_.block_comment_open || spec_.block_string_open;
+}
+
+uint8_t TableLexer::scan(std::string_view line, uint8_t state, TokenRuns& runs) const {
+    runs.clear();
+    const size_t length = line.size();
+    size_t i = 0;
+
+    // 上一行延续下来的块注释或块字符串
+    if ((state & MULTI_LINE_COMMENT) && spec_.block_comment_close) {
+        if (closeBlock(line, 0, 0, spec_.block_comment_close, TokenType::COMMENT, runs, i)) {
+            state = 0;
+        }
+    } else if ((state & MULTI_LINE_STRING) && spec_.block_string_close) {
+        if (closeBlock(line, 0, 0, spec_.block_string_close, TokenType::STRING, runs, i)) {
+            state = 0;
+        }
+    } else {
+        state = 0;
+        if (length > 0 && line[0] != '\0' && std::strchr(spec_.line_start_comments, line[0])) {
+            addRun(runs, 0, length, TokenType::COMMENT);
+            return state;
+        }
+    }
+
+    while (i < length) {
+        unsigned char c = static_cast<unsigned char>(line[i]);
+        uint8_t bits = classes_[c];
+
+        if (bits & SPACE) {
+            size_t end = i + 1;
+            while (end < length && (classes_[static_cast<unsigned char>(line[end])] & SPACE)) {
+                end++;
+            }
+            addRun(runs, i, end, TokenType::NORMAL);
+            i = end;
+            continue;
+        }
+
+        if (bits & SPECIAL) {
+            size_t end = scanSpecial(line, i, state, runs);
+            if (end != i) {
+                i = end;
+                continue;
+            }
+        }
+
+        if ((bits & DIGIT) || (c == '.' && i + 1 < length &&
+                               (classes_[static_cast<unsigned char>(line[i + 1])] & DIGIT))) {
+            size_t end = scanNumber(line, i);
+            addRun(runs, i, end, TokenType::NUMBER);
+            i = end;
+            continue;
+        }
+
+        if (bits & IDENT_START) {
+            size_t end = i + 1;
+            while (end < length &&
+                   (classes_[static_cast<unsigned char>(line[end])] & IDENT_PART)) {
+                end++;
+            }
+            addRun(runs, i, end, classifyWord(line, i, end));
+            i = end;
+            continue;
+        }
+
+        if (bits & OPERATOR) {
+            addRun(runs, i, i + 1, TokenType::OPERATOR);
+            i++;
+            continue;
+        }
+
+        // 其余字符：多字节 UTF-8 字符整体成段
+        size_t end = std::min(i + utf8Length(c), length);
+        addRun(runs, i, end,
+               (spec_.flags & LanguageSpec::SYMBOLS_AS_OPERATORS) ? TokenType::OPERATOR
+                                                                   : TokenType::NORMAL);
+        i = end;
+    }
+    return state;
+}
+
+size_t TableLexer::scanSpecial(std::string_view line, size_t pos, uint8_t& state,
+                               TokenRuns& runs) const {
+    const size_t length = line.size();
+    const char c = line[pos];
+    size_t end = pos;
+
+    // 块注释优先于行注释（Lua 的 "--[[" 与 "--"）
+    if (startsWith(line, pos, spec_.block_comment_open)) {
+        if (!closeBlock(line, pos, pos + std::strlen(spec_.block_comment_open),
+                        spec_.block_comment_close, TokenType::COMMENT, runs, end)) {
+            state = MULTI_LINE_COMMENT;
+        }
+        return end;
+    }
+    for (const char* prefix : spec_.line_comments) {
+        if (startsWith(line, pos, prefix)) {
+            addRun(runs, pos, length, TokenType::COMMENT);
+            return length;
+        }
+    }
+    if (startsWith(line, pos, spec_.block_string_open)) {
+        if (!closeBlock(line, pos, pos + std::strlen(spec_.block_string_open),
+                        spec_.block_string_close, TokenType::STRING, runs, end)) {
+            state = MULTI_LINE_STRING;
+        }
+        return end;
+    }
+
+    if (std::strchr(spec_.quotes, c)) {
+        end = scanQuoted(line, pos, c);
+        addRun(runs, pos, end, TokenType::STRING);
+        return end;
+    }
+    if (pos + 1 < length && std::strchr(spec_.string_prefixes, c) &&
+        std::strchr(spec_.quotes, line[pos + 1]) && line[pos + 1] != '\0') {
+        end = scanQuoted(line, pos + 1, line[pos + 1]);
+        addRun(runs, pos, end, TokenType::STRING);
+        return end;
+    }
+    // 字符字面量必须闭合，否则引号按普通字符处理（如 VHDL 的 clk'event、OCaml 的 'a）
+    if (spec_.char_quote && c == spec_.char_quote && pos + 1 < length) {
+        end = pos + 1;
+        if (spec_.escape && line[end] == spec_.escape) {
+            end += 2;
+        } else {
+            end += utf8Length(static_cast<unsigned char>(line[end]));
+        }
+        if (end < length && line[end] == spec_.char_quote) {
+            addRun(runs, pos, end + 1, TokenType::STRING);
+            return end + 1;
+        }
+    }
+
+    // 变量前缀：紧跟在同一字符之后的不算（如 Ruby 的 "::"）
+    if (pos > 0 && line[pos - 1] == c) {
+        return pos;
+    }
+    for (const char* sigil : spec_.sigils) {
+        if (!sigil) {
+            break;
+        }
+        if (!startsWith(line, pos, sigil)) {
+            continue;
+        }
+        size_t sigil_length = std::strlen(sigil);
+        end = pos + sigil_length;
+        if (sigil[sigil_length - 1] == '{') {
+            size_t close = line.find('}', end);
+            end = close == std::string_view::npos ? length : close + 1;
+        } else {
+            size_t name_start = end;
+            while (end < length && (classes_[static_cast<unsigned char>(line[end])] & WORD)) {
+                end++;
+            }
+            if (end == name_start) {
+                continue; // 后面没有名称，按普通字符处理
+            }
+        }
+        addRun(runs, pos, end, TokenType::TYPE);
+        return end;
+    }
+    return pos;
+}
+
+size_t TableLexer::scanQuoted(std::string_view line, size_t pos, char quote) const {
+    const size_t length = line.size();
+    const bool doubled = (spec_.flags & LanguageSpec::DOUBLED_QUOTES) != 0;
+    size_t i = pos + 1;
+    while (i < length) {
+        char ch = line[i];
+        if (spec_.escape && ch == spec_.escape && i + 1 < length) {
+            i += 2;
+        } else if (ch == quote) {
+            if (doubled && i + 1 < length && line[i + 1] == quote) {
+                i += 2;
+            } else {
+                return i + 1;
+            }
+        } else {
+            i++;
+        }
+    }
+    return length;
+}
+
+size_t TableLexer::scanNumber(std::string_view line, size_t pos) const {
+    uint8_t state = START;
+    size_t accepted = pos;
+    for (size_t i = pos; i < line.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(line[i]);
+        uint8_t input =
+            (classes_[c] & EXPONENT) ? static_cast<uint8_t>(NUM_EXPONENT) : NUMBER_CLASSES[c];
+        state = NUMBER_DFA[state][input];
+        if (state == DEAD) {
+            break;
+        }
+        if (isAccepting(state)) {
+            accepted = i + 1;
+        }
+    }
+    return accepted;
+}
+
+TokenType TableLexer::classifyWord(std::string_view line, size_t start, size_t end) const {
+    std::string_view word = line.substr(start, end - start);
+
+    // 关键字表只有一种大小写时先转换；过长的单词不是关键字
+    std::string_view key = word;
+    char folded[MAX_FOLDED_WORD];
+    const bool upper = (spec_.flags & LanguageSpec::UPPER_CASE_WORDS) != 0;
+    const bool lower = (spec_.flags & LanguageSpec::LOWER_CASE_WORDS) != 0;
+    if (upper || lower) {
+        if (word.size() > MAX_FOLDED_WORD) {
+            key = std::string_view();
+        } else {
+            for (size_t k = 0; k < word.size(); ++k) {
+                char ch = word[k];
+                if (upper && ch >= 'a' && ch <= 'z') {
+                    ch = static_cast<char>(ch - 'a' + 'A');
+                } else if (lower && ch >= 'A' && ch <= 'Z') {
+                    ch = static_cast<char>(ch - 'A' + 'a');
+                }
+                folded[k] = ch;
+            }
+            key = std::string_view(folded, word.size());
+        }
+    }
+
+    if (!key.empty() && contains(keywords_, key)) {
+        return TokenType::KEYWORD;
+    }
+    if (!key.empty() && contains(types_, key)) {
+        return TokenType::TYPE;
+    }
+    if ((spec_.flags & LanguageSpec::FUNCTION_CALLS) && end < line.size() && line[end] == '(') {
+        return TokenType::FUNCTION;
+    }
+    if ((spec_.flags & LanguageSpec::CAPITALIZED_TYPES) && word[0] >= 'A' && word[0] <= 'Z') {
+        return TokenType::TYPE;
+    }
+    return TokenType::NORMAL;
+}
+
+} // namespace features
+} // namespace pnana
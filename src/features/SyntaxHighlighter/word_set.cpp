@@ -0,0 +1,129 @@
+#include "features/SyntaxHighlighter/word_set.h"
+#include <algorithm>
+
+namespace pnana {
+namespace features {
+
+namespace {
+
+// 每个桶尝试的种子数上限，超过后加倍槽位数重试（词表只有几百个词，实际很快就能找到）
+constexpr uint32_t MAX_DISPLACEMENT = 1u << 16;
+
+uint32_t roundUpToPowerOfTwo(size_t n) {
+    uint32_t value = 1;
+    while (value < n) {
+        value <<= 1;
+    }
+    return value;
+}
+
+} // namespace
+
+WordSet::WordSet(std::initializer_list<std::string_view> words) {
+    build(std::vector<std::string>(words.begin(), words.end()));
+}
+
+WordSet::WordSet(const std::vector<std::string>& words) {
+    build(words);
+}
+
+uint32_t WordSet::hash(std::string_view word, uint32_t seed) {
+    // FNV-1a，种子混入初始值，最后再混合一次高低位
+    uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+    for (char ch : word) {
+        h ^= static_cast<unsigned char>(ch);
+        h *= 16777619u;
+    }
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    return h;
+}
+
+void WordSet::build(std::vector<std::string> words) {
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+    words_ = std::move(words);
+    if (words_.empty()) {
+        return;
+    }
+
+    min_length_ = words_.front().size();
+    max_length_ = 0;
+    for (const auto& word : words_) {
+        min_length_ = std::min(min_length_, word.size());
+        max_length_ = std::max(max_length_, word.size());
+    }
+
+    // 槽位数取词数的两倍（负载不超过 1/2），每个桶平均两个词
+    size_t slot_count = roundUpToPowerOfTwo(words_.size() * 2);
+    while (!place(slot_count)) {
+        slot_count *= 2;
+    }
+}
+
+bool WordSet::place(size_t slot_count) {
+    const uint32_t bucket_count = roundUpToPowerOfTwo(std::max<size_t>(1, words_.size() / 2));
+    bucket_mask_ = bucket_count - 1;
+    slot_mask_ = static_cast<uint32_t>(slot_count - 1);
+
+    std::vector<std::vector<uint32_t>> buckets(bucket_count);
+    for (uint32_t index = 0; index < words_.size(); ++index) {
+        buckets[hash(words_[index], 0) & bucket_mask_].push_back(index);
+    }
+
+    // 词多的桶先放，空槽位多时更容易找到种子
+    std::vector<uint32_t> order(bucket_count);
+    for (uint32_t bucket = 0; bucket < bucket_count; ++bucket) {
+        order[bucket] = bucket;
+    }
+    std::stable_sort(order.begin(), order.end(), [&buckets](uint32_t a, uint32_t b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    displacements_.assign(bucket_count, 0);
+    slots_.assign(slot_count, EMPTY_SLOT);
+    std::vector<uint32_t> candidate;
+    for (uint32_t bucket : order) {
+        const auto& members = buckets[bucket];
+        if (members.empty()) {
+            break;
+        }
+        bool placed = false;
+        for (uint32_t seed = 1; seed < MAX_DISPLACEMENT && !placed; ++seed) {
+            candidate.clear();
+            placed = true;
+            for (uint32_t index : members) {
+                uint32_t slot = hash(words_[index], seed) & slot_mask_;
+                if (slots_[slot] != EMPTY_SLOT ||
+                    std::find(candidate.begin(), candidate.end(), slot) != candidate.end()) {
+                    placed = false;
+                    break;
+                }
+                candidate.push_back(slot);
+            }
+            if (placed) {
+                displacements_[bucket] = seed;
+                for (size_t k = 0; k < members.size(); ++k) {
+                    slots_[candidate[k]] = members[k];
+                }
+            }
+        }
+        if (!placed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool WordSet::contains(std::string_view word) const {
+    if (word.size() < min_length_ || word.size() > max_length_) {
+        return false;
+    }
+    uint32_t seed = displacements_[hash(word, 0) & bucket_mask_];
+    uint32_t index = slots_[hash(word, seed) & slot_mask_];
+    return index != EMPTY_SLOT && words_[index] == word;
+}
+
+} // namespace features
+} // namespace pnana
@@ -1,4 +1,5 @@
 #include "features/encoding_converter.h"
+#include "utils/text_scanner.h"
 #include <algorithm>
 #include <cstring>
 #include <fstream>
@@ -7,6 +8,10 @@
 namespace pnana {
 namespace features {
 
+namespace {
+constexpr size_t ENCODING_PROBE_BYTES = 4096; // 编码检测读取的字节数（检测只用到前1KB）
+} // namespace
+
 std::vector<std::string> EncodingConverter::getSupportedEncodings() {
     return {"UTF-8",  "UTF-16", "UTF-16LE",   "UTF-16BE",    "GBK",
             "GB2312", "ASCII",  "ISO-8859-1", "Windows-1252"};
@@ -27,7 +32,8 @@ bool EncodingConverter::isEncodingSupported(const std::string& encoding) {
     return false;
 }
 
-std::vector<uint8_t> EncodingConverter::readFileAsBytes(const std::string& filepath) {
+std::vector<uint8_t> EncodingConverter::readFileAsBytes(const std::string& filepath,
+                                                        size_t max_bytes) {
     std::vector<uint8_t> content;
     std::ifstream file(filepath, std::ios::binary);
     if (!file.is_open()) {
@@ -35,7 +41,7 @@ std::vector<uint8_t> EncodingConverter::readFileAsBytes(const std::string& filep
     }
 
     file.seekg(0, std::ios::end);
-    size_t size = file.tellg();
+    size_t size = std::min(static_cast<size_t>(file.tellg()), max_bytes);
     file.seekg(0, std::ios::beg);
 
     content.resize(size);
@@ -46,11 +52,19 @@ std::vector<uint8_t> EncodingConverter::readFileAsBytes(const std::string& filep
 }
 
 std::string EncodingConverter::detectFileEncoding(const std::string& filepath) {
-    auto bytes = readFileAsBytes(filepath);
+    // 检测只需要文件开头，不再读入整个文件
+    auto bytes = readFileAsBytes(filepath, ENCODING_PROBE_BYTES);
     if (bytes.empty()) {
         return "UTF-8"; // 默认编码
     }
 
+    // 纯 ASCII（也不可能有 BOM）直接按 UTF-8 处理
+    utils::TextScanResult scan = utils::TextScanner::scan(
+        reinterpret_cast<const char*>(bytes.data()), bytes.size(), false);
+    if (!scan.has_non_ascii) {
+        return "UTF-8";
+    }
+
     // 检测UTF-8 BOM
     if (bytes.size() >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF) {
         return "UTF-8";
@@ -1,4 +1,5 @@
 #include "features/lsp/lsp_client.h"
+#include "utils/json_escaper.h"
 #include "utils/logger.h"
 #include <algorithm>
 #include <cctype>
@@ -129,50 +130,81 @@ void LspClient::shutdown() {
 
 void LspClient::didOpen(const std::string& uri, const std::string& language_id,
                         const std::string& content, int version) {
-    if (!isConnected()) {
-        return;
-    }
+    sendDidOpen(uri, language_id, version, content.size(), [&content](std::string& out) {
+        utils::JsonEscaper::append(out, content);
+    });
+}
 
-    try {
-        document_versions_[uri] = version;
+void LspClient::didOpen(const std::string& uri, const std::string& language_id,
+                        const core::DocumentSnapshot& snapshot, int version) {
+    sendDidOpen(uri, language_id, version, snapshot.contentSize(), [&snapshot](std::string& out) {
+        snapshot.forEachChunk([&out](std::string_view chunk) {
+            utils::JsonEscaper::append(out, chunk);
+        });
+    });
+}
 
-        jsonrpccxx::json params;
-        params["textDocument"]["uri"] = uri;
-        params["textDocument"]["languageId"] = language_id;
-        params["textDocument"]["version"] = version;
-        params["textDocument"]["text"] = content;
+void LspClient::didChange(const std::string& uri, const std::string& content, int version) {
+    sendDidChange(uri, version, content.size(), [&content](std::string& out) {
+        utils::JsonEscaper::append(out, content);
+    });
+}
 
-        jsonrpccxx::named_parameter named_params;
-        for (auto& [key, value] : params.items()) {
-            named_params[key] = value;
-        }
-        rpc_client_->CallNotificationNamed("textDocument/didOpen", named_params);
-    } catch (const std::exception& e) {
-        // 静默处理错误
-    }
+void LspClient::didChange(const std::string& uri, const core::DocumentSnapshot& snapshot,
+                          int version) {
+    sendDidChange(uri, version, snapshot.contentSize(), [&snapshot](std::string& out) {
+        snapshot.forEachChunk([&out](std::string_view chunk) {
+            utils::JsonEscaper::append(out, chunk);
+        });
+    });
 }
 
-void LspClient::didChange(const std::string& uri, const std::string& content, int version) {
+void LspClient::sendDidOpen(const std::string& uri, const std::string& language_id, int version,
+                            size_t text_size, const TextWriter& write_text) {
     if (!isConnected()) {
         return;
     }
+    document_versions_[uri] = version;
 
-    try {
-        document_versions_[uri] = version;
+    std::string prefix = "{\"textDocument\":{\"uri\":";
+    utils::JsonEscaper::appendQuoted(prefix, uri);
+    prefix += ",\"languageId\":";
+    utils::JsonEscaper::appendQuoted(prefix, language_id);
+    prefix += ",\"version\":" + std::to_string(version) + ",\"text\":";
+    sendTextNotification("textDocument/didOpen", prefix, text_size, write_text, "}}");
+}
 
-        jsonrpccxx::json params;
-        params["textDocument"]["uri"] = uri;
-        params["textDocument"]["version"] = version;
+void LspClient::sendDidChange(const std::string& uri, int version, size_t text_size,
+                              const TextWriter& write_text) {
+    if (!isConnected()) {
+        return;
+    }
+    document_versions_[uri] = version;
 
-        jsonrpccxx::json change;
-        change["text"] = content;
-        params["contentChanges"] = jsonrpccxx::json::array({change});
+    std::string prefix = "{\"textDocument\":{\"uri\":";
+    utils::JsonEscaper::appendQuoted(prefix, uri);
+    prefix += ",\"version\":" + std::to_string(version) + "},\"contentChanges\":[{\"text\":";
+    sendTextNotification("textDocument/didChange", prefix, text_size, write_text, "}]}");
+}
 
-        jsonrpccxx::named_parameter named_params;
-        for (auto& [key, value] : params.items()) {
-            named_params[key] = value;
-        }
-        rpc_client_->CallNotificationNamed("textDocument/didChange", named_params);
+void LspClient::sendTextNotification(const std::string& method, const std::string& params_prefix,
+                                     size_t text_size, const TextWriter& write_text,
+                                     const char* params_suffix) {
+    try {
+        // 文档内容一次转义进最终的消息缓冲区，由连接器直接写出：
+        // 不经过 json 对象、named_parameter 拷贝、序列化和 Send() 中的重新解析
+        std::string message;
+        message.reserve(text_size + text_size / 16 + params_prefix.size() + method.size() + 64);
+        message += "{\"jsonrpc\":\"2.0\",\"method\":";
+        utils::JsonEscaper::appendQuoted(message, method);
+        message += ",\"params\":";
+        message += params_prefix;
+        message += '"';
+        write_text(message);
+        message += '"';
+        message += params_suffix;
+        message += '}';
+        connector_->sendNotification(message);
     } catch (const std::exception& e) {
         // 静默处理错误
     }
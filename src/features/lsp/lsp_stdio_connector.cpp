@@ -501,6 +501,15 @@ std::string LspStdioConnector::Send(const std::string& request) {
     }
 }
 
+void LspStdioConnector::sendNotification(const std::string& notification) {
+    if (!isRunning()) {
+        throw jsonrpccxx::JsonRpcException(jsonrpccxx::error_type::internal_error,
+                                           "LSP server is not running");
+    }
+    std::lock_guard<std::mutex> lock(request_mutex_);
+    writeLspMessage(notification);
+}
+
 void LspStdioConnector::writeLspMessage(const std::string& message) {
     // LSP 协议要求：Content-Length: <length>\r\n\r\n<message>
     std::ostringstream header;
@@ -510,12 +519,14 @@ void LspStdioConnector::writeLspMessage(const std::string& message) {
     *stdin_stream_ << header.str() << message;
     stdin_stream_->flush();
 #else
-    std::string full_message = header.str() + message;
     // 记录写入的头部和消息（限长以避免日志过大）
     std::string preview =
         message.size() > 512 ? message.substr(0, 512) + "...(truncated)" : message;
     LOG("LSP -> Writing message (header + preview):\n" + header.str() + preview);
-    fwrite(full_message.c_str(), 1, full_message.size(), stdin_file_);
+    // 头部和消息体分别写入同一个缓冲流，避免为拼接再复制一遍整个消息
+    std::string header_str = header.str();
+    fwrite(header_str.data(), 1, header_str.size(), stdin_file_);
+    fwrite(message.data(), 1, message.size(), stdin_file_);
     fflush(stdin_file_);
 #endif
 }
@@ -1,106 +1,533 @@
 #include "features/search.h"
+#include "core/document.h"
+#include "features/search_job.h"
+#include "utils/literal_finder.h"
+#include "utils/regex_matcher.h"
+#include "utils/unicode_width.h"
 #include <algorithm>
 #include <cctype>
+#include <mutex>
 
 namespace pnana {
 namespace features {
 
+namespace {
+
+// 最近编译过的正则表达式：逐键输入、查找下一个和并行分块都会反复用到同一个模式
+constexpr size_t REGEX_CACHE_SIZE = 8;
+
+std::shared_ptr<const utils::RegexMatcher> compiledRegex(const std::string& pattern,
+                                                         bool case_sensitive) {
+    struct Entry {
+        std::string pattern;
+        bool case_sensitive;
+        std::shared_ptr<const utils::RegexMatcher> matcher;
+    };
+    static std::mutex mutex;
+    static std::vector<Entry> cache; // 最近使用的在末尾
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = cache.begin(); it != cache.end(); ++it) {
+        if (it->case_sensitive == case_sensitive && it->pattern == pattern) {
+            Entry entry = std::move(*it);
+            cache.erase(it);
+            cache.push_back(std::move(entry));
+            return cache.back().matcher;
+        }
+    }
+    if (cache.size() >= REGEX_CACHE_SIZE) {
+        cache.erase(cache.begin());
+    }
+    cache.push_back(
+        {pattern, case_sensitive,
+         std::make_shared<const utils::RegexMatcher>(pattern, case_sensitive)});
+    return cache.back().matcher;
+}
+
+// 增量细化时候选数不到行数的 1/16 就逐个定位，否则顺序遍历
+constexpr size_t SPARSE_CANDIDATE_RATIO = 16;
+
+// 不区分大小写时与 LiteralFinder 一样只折叠 ASCII 字母
+inline unsigned char foldAscii(unsigned char ch) {
+    return (ch >= 'A' && ch <= 'Z') ? static_cast<unsigned char>(ch | 0x20) : ch;
+}
+
+bool matchesAt(std::string_view line, size_t column, const std::string& pattern,
+               bool case_sensitive) {
+    if (column > line.size() || line.size() - column < pattern.size()) {
+        return false;
+    }
+    if (case_sensitive) {
+        return line.compare(column, pattern.size(), pattern) == 0;
+    }
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        if (foldAscii(static_cast<unsigned char>(line[column + i])) !=
+            foldAscii(static_cast<unsigned char>(pattern[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 模式是否有非空的真边界（既是真前缀又是真后缀），即两次出现能否重叠（KMP 前缀函数）
+bool hasBorder(const std::string& pattern, bool case_sensitive) {
+    auto at = [&](size_t i) {
+        unsigned char ch = static_cast<unsigned char>(pattern[i]);
+        return case_sensitive ? ch : foldAscii(ch);
+    };
+    std::vector<size_t> border(pattern.size(), 0);
+    for (size_t i = 1; i < pattern.size(); ++i) {
+        size_t k = border[i - 1];
+        while (k > 0 && at(i) != at(k)) {
+            k = border[k - 1];
+        }
+        if (at(i) == at(k)) {
+            ++k;
+        }
+        border[i] = k;
+    }
+    return !pattern.empty() && border.back() > 0;
+}
+
+} // namespace
+
 SearchEngine::SearchEngine() : current_match_index_(0) {}
 
-void SearchEngine::search(const std::string& pattern, const std::vector<std::string>& lines,
-                          const SearchOptions& options) {
+SearchEngine::~SearchEngine() = default;
+
+void SearchEngine::resetSearch(const std::string& pattern, const SearchOptions& options) {
+    job_.reset(); // 取消进行中的后台搜索
+    head_matches_.clear();
+    head_end_line_ = 0; // 否则之后的 searchAsync 会把开头的匹配误当作绕回后的结果攒起来
+    visible_lines_ = 0;
+    source_ = nullptr;
     pattern_ = pattern;
     options_ = options;
     matches_.clear();
     current_match_index_ = 0;
+}
+
+void SearchEngine::search(const std::string& pattern, const core::LineBuffer& lines,
+                          const SearchOptions& options) {
+    resetSearch(pattern, options);
+    if (pattern.empty()) {
+        return;
+    }
+
+    if (lines.size() >= PARALLEL_MIN_LINES) {
+        SearchJob job(pattern, lines, options);
+        job.wait();
+        job.takeReady(matches_);
+    } else {
+        searchLines(pattern, lines, options, 0, lines.size(), matches_);
+    }
+}
+
+void SearchEngine::searchAsync(const std::string& pattern, const core::LineBuffer& lines,
+                               const SearchOptions& options, std::function<void()> notify) {
+    resetSearch(pattern, options);
+    if (pattern.empty()) {
+        return;
+    }
+    notify_ = notify;
+    job_ = std::make_unique<SearchJob>(pattern, lines, options, std::move(notify));
+}
+
+void SearchEngine::dropPendingEdits(core::Document& doc) {
+    size_t first = 0;
+    size_t end = 0;
+    size_t replaced = 0;
+    doc.takeLineChanges(core::LineBuffer::SEARCH_MATCHES, first, end, replaced);
+}
+
+void SearchEngine::search(const std::string& pattern, core::Document& doc,
+                          const SearchOptions& options) {
+    dropPendingEdits(doc);
+    search(pattern, doc.getLines(), options);
+    source_ = &doc;
+    source_version_ = doc.getVersion();
+}
+
+void SearchEngine::searchAsync(const std::string& pattern, core::Document& doc,
+                               const SearchOptions& options, std::function<void()> notify) {
+    dropPendingEdits(doc);
+    searchAsync(pattern, doc.getLines(), options, std::move(notify));
+    source_ = &doc;
+    source_version_ = doc.getVersion();
+}
+
+void SearchEngine::searchIncremental(const std::string& pattern, core::Document& doc,
+                                     const SearchOptions& options, const SearchScope& scope,
+                                     std::function<void()> notify) {
+    // 能细化时上一次的结果与当前版本相同，没有待取出的修改；否则重新搜索，修改已反映在结果中
+    dropPendingEdits(doc);
+    SearchScope bound = scope;
+    bound.source = &doc;
+    bound.version = doc.getVersion();
+    searchIncremental(pattern, doc.getLines(), options, bound, std::move(notify));
+}
 
+void SearchEngine::searchIncremental(const std::string& pattern, const core::LineBuffer& lines,
+                                     const SearchOptions& options, const SearchScope& scope,
+                                     std::function<void()> notify) {
+    SearchJob::Candidates candidates;
+    if (canRefine(pattern, options, scope)) {
+        // 先并入已完成的部分，候选覆盖的行越多，需要重新完整搜索的行越少
+        pollResults();
+        auto refined = std::make_shared<SearchCandidates>();
+        if (job_) {
+            // 覆盖可见行及其后已取到的部分；可见区域之前（绕回后）的匹配排在最前
+            refined->first_line = head_end_line_;
+            refined->line_count = visible_lines_ + job_->readyLines();
+            refined->matches = std::move(head_matches_);
+            refined->matches.insert(refined->matches.end(), matches_.begin(), matches_.end());
+        } else {
+            refined->line_count = lines.size();
+            refined->matches = std::move(matches_);
+        }
+        candidates = std::move(refined);
+    }
+    resetSearch(pattern, options);
     if (pattern.empty()) {
         return;
     }
+    source_ = scope.source;
+    source_version_ = scope.version;
+
+    auto collect = [&](size_t first_line, size_t last_line) {
+        if (candidates) {
+            refineLines(pattern, lines, options, *candidates, first_line, last_line, matches_);
+        } else {
+            searchLines(pattern, lines, options, first_line, last_line, matches_);
+        }
+    };
+
+    const size_t total = lines.size();
+    if (total < PARALLEL_MIN_LINES) {
+        collect(0, total);
+        return;
+    }
+
+    // 可见行的结果立即可用；后台从可见区域之后搜到末尾，再回到开头搜到可见区域之前
+    const size_t first_visible = std::min(scope.first_visible, total);
+    const size_t last_visible = std::min(std::max(scope.last_visible, first_visible), total);
+    collect(first_visible, last_visible);
+    head_end_line_ = first_visible;
+    visible_lines_ = last_visible - first_visible;
+    notify_ = notify;
+    job_ = std::make_unique<SearchJob>(pattern, lines, options, last_visible,
+                                       total - (last_visible - first_visible),
+                                       std::move(candidates), std::move(notify));
+}
+
+bool SearchEngine::canRefine(const std::string& pattern, const SearchOptions& options,
+                             const SearchScope& scope) const {
+    // 只有字面搜索满足“新模式的匹配位置一定是旧模式的匹配位置”；正则和全词匹配都不满足
+    if (pattern_.empty() || options.regex || options.whole_word || options_.regex ||
+        options_.whole_word || options.case_sensitive != options_.case_sensitive) {
+        return false;
+    }
+    if (source_ == nullptr || scope.source != source_ || scope.version != source_version_) {
+        return false;
+    }
+    if (pattern.size() <= pattern_.size() || pattern.compare(0, pattern_.size(), pattern_) != 0) {
+        return false;
+    }
+    // 旧模式自身可以重叠（有相同的真前缀和真后缀，如 "aa"、"abab"）时，
+    // 不重叠扫描得到的位置不是它的全部出现位置，不能作为候选
+    return !hasBorder(pattern_, options.case_sensitive);
+}
+
+bool SearchEngine::pollResults() {
+    if (!job_) {
+        return false;
+    }
+    // 绕回开头之后的结果属于可见区域之前，先攒着，搜索完成时一次插到前面（当前匹配随之后移）
+    // 先判断是否完成再取结果：取结果之后才完成的块不能随任务一起丢掉
+    const bool finished = job_->isFinished();
+    const size_t before = matches_.size();
+    size_t added = job_->takeReady(matches_);
+    auto head = std::find_if(matches_.begin() + before, matches_.end(),
+                             [this](const SearchMatch& match) {
+                                 return match.line < head_end_line_;
+                             });
+    head_matches_.insert(head_matches_.end(), head, matches_.end());
+    matches_.erase(head, matches_.end());
+    if (finished) {
+        job_.reset();
+        if (!head_matches_.empty()) {
+            matches_.insert(matches_.begin(), head_matches_.begin(), head_matches_.end());
+            current_match_index_ += head_matches_.size();
+            std::vector<SearchMatch>().swap(head_matches_);
+        }
+    }
+    return added > 0;
+}
+
+bool SearchEngine::isSearching() const {
+    return job_ != nullptr;
+}
+
+void SearchEngine::finish() {
+    if (job_) {
+        job_->wait();
+        pollResults();
+    }
+}
 
+void SearchEngine::searchLines(const std::string& pattern, const core::LineBuffer& lines,
+                               const SearchOptions& options, size_t first_line, size_t last_line,
+                               std::vector<SearchMatch>& out) {
+    if (pattern.empty()) {
+        return;
+    }
     if (options.regex) {
-        searchRegex(pattern, lines);
+        searchRegex(pattern, lines, options, first_line, last_line, out);
     } else if (options.whole_word) {
-        searchWholeWord(pattern, lines);
+        searchWholeWord(pattern, lines, options, first_line, last_line, out);
     } else {
-        searchLiteral(pattern, lines);
+        searchLiteral(pattern, lines, options, first_line, last_line, out);
     }
 }
 
-void SearchEngine::searchLiteral(const std::string& pattern,
-                                 const std::vector<std::string>& lines) {
-    std::string search_pattern = pattern;
-
-    for (size_t line_num = 0; line_num < lines.size(); ++line_num) {
-        std::string line = lines[line_num];
+void SearchEngine::refineLines(const std::string& pattern, const core::LineBuffer& lines,
+                               const SearchOptions& options, const SearchCandidates& candidates,
+                               size_t first_line, size_t last_line,
+                               std::vector<SearchMatch>& out) {
+    // 覆盖范围在 [0, total) 中至多是两段：绕回开头的 [0, wrapped) 和 [begin, end)
+    const size_t total = lines.size();
+    const size_t count = std::min(candidates.line_count, total);
+    const size_t begin = std::min(candidates.first_line, total);
+    const size_t end = std::min(begin + count, total);
+    const size_t wrapped = begin + count - end;
+    const std::pair<size_t, size_t> covered[] = {{0, wrapped}, {begin, end}};
+
+    // 按行序交替处理未覆盖的部分（完整搜索）和覆盖的部分（确认候选），结果保持有序
+    size_t pos = first_line;
+    for (const auto& range : covered) {
+        const size_t lo = std::max(range.first, pos);
+        const size_t hi = std::min(range.second, last_line);
+        if (lo >= hi) {
+            continue;
+        }
+        if (pos < lo) {
+            searchLines(pattern, lines, options, pos, lo, out);
+        }
+        confirmCandidates(pattern, lines, options, candidates.matches, lo, hi, out);
+        pos = hi;
+    }
+    if (pos < last_line) {
+        searchLines(pattern, lines, options, pos, last_line, out);
+    }
+}
 
-        // 转换为小写（如果不区分大小写）
-        if (!options_.case_sensitive) {
-            std::transform(search_pattern.begin(), search_pattern.end(), search_pattern.begin(),
-                           ::tolower);
-            std::transform(line.begin(), line.end(), line.begin(), ::tolower);
+void SearchEngine::confirmCandidates(const std::string& pattern, const core::LineBuffer& lines,
+                                     const SearchOptions& options,
+                                     const std::vector<SearchMatch>& candidates,
+                                     size_t first_line, size_t last_line,
+                                     std::vector<SearchMatch>& out) {
+    auto by_line = [](const SearchMatch& match, size_t line) {
+        return match.line < line;
+    };
+    auto it = std::lower_bound(candidates.begin(), candidates.end(), first_line, by_line);
+    auto end = std::lower_bound(it, candidates.end(), last_line, by_line);
+
+    // 与 searchLiteral 一样不重叠：跳过与上一个匹配重叠的候选
+    auto confirm = [&](size_t line_num, std::string_view line) {
+        size_t next_free = 0;
+        for (; it != end && it->line == line_num; ++it) {
+            if (it->column >= next_free &&
+                matchesAt(line, it->column, pattern, options.case_sensitive)) {
+                out.emplace_back(line_num, it->column, pattern.length());
+                next_free = it->column + pattern.length();
+            }
+        }
+    };
+
+    // 候选稠密时顺序遍历各行，稀疏时逐个定位候选所在的行
+    const size_t line_count = last_line - std::min(first_line, last_line);
+    if (static_cast<size_t>(end - it) * SPARSE_CANDIDATE_RATIO >= line_count) {
+        size_t line_num = first_line;
+        lines.forEachLine(first_line, last_line, [&](std::string_view line) {
+            if (it != end && it->line == line_num) {
+                confirm(line_num, line);
+            }
+            ++line_num;
+        });
+    } else {
+        while (it != end) {
+            size_t line_num = it->line;
+            confirm(line_num, lines.view(line_num));
         }
+    }
+}
 
-        size_t pos = 0;
-        while ((pos = line.find(search_pattern, pos)) != std::string::npos) {
-            matches_.emplace_back(line_num, pos, pattern.length());
-            pos += pattern.length();
+void SearchEngine::searchLiteral(const std::string& pattern, const core::LineBuffer& lines,
+                                 const SearchOptions& options, size_t first_line,
+                                 size_t last_line, std::vector<SearchMatch>& out) {
+    // 模式只预处理一次，各行直接在文档的 string_view 上查找，不复制、不转换大小写
+    const utils::LiteralFinder finder(pattern, options.case_sensitive);
+
+    size_t line_num = first_line;
+    lines.forEachLine(first_line, last_line, [&](std::string_view line) {
+        for (size_t pos = finder.find(line); pos != std::string_view::npos;
+             pos = finder.find(line, pos + pattern.length())) {
+            out.emplace_back(line_num, pos, pattern.length());
         }
+        ++line_num;
+    });
+}
+
+void SearchEngine::searchRegex(const std::string& pattern, const core::LineBuffer& lines,
+                               const SearchOptions& options, size_t first_line, size_t last_line,
+                               std::vector<SearchMatch>& out) {
+    std::shared_ptr<const utils::RegexMatcher> matcher =
+        compiledRegex(pattern, options.case_sensitive);
+    if (matcher->status() == utils::RegexMatcher::Status::INVALID) {
+        // 正则表达式错误，回退到字面搜索
+        searchLiteral(pattern, lines, options, first_line, last_line, out);
+        return;
+    }
+    if (matcher->status() == utils::RegexMatcher::Status::UNSUPPORTED) {
+        searchStdRegex(pattern, lines, options, first_line, last_line, out);
+        return;
     }
+
+    size_t line_num = first_line;
+    lines.forEachLine(first_line, last_line, [&](std::string_view line) {
+        // 不含必需字面量的行不可能匹配，绝大多数行在这里就跳过了
+        if (matcher->mayMatch(line)) {
+            size_t pos = 0;
+            size_t start = 0;
+            size_t end = 0;
+            while (pos <= line.size() && matcher->find(line, pos, start, end)) {
+                out.emplace_back(line_num, start, end - start);
+                if (end > start) {
+                    pos = end;
+                } else if (start < line.size()) {
+                    // 空匹配：从下一个码点继续
+                    pos = start;
+                    utils::UnicodeWidth::decode(line, pos);
+                } else {
+                    break;
+                }
+            }
+        }
+        ++line_num;
+    });
 }
 
-void SearchEngine::searchRegex(const std::string& pattern, const std::vector<std::string>& lines) {
+void SearchEngine::searchStdRegex(const std::string& pattern, const core::LineBuffer& lines,
+                                  const SearchOptions& options, size_t first_line,
+                                  size_t last_line, std::vector<SearchMatch>& out) {
     try {
         std::regex::flag_type flags = std::regex::ECMAScript;
-        if (!options_.case_sensitive) {
+        if (!options.case_sensitive) {
             flags |= std::regex::icase;
         }
 
         std::regex regex(pattern, flags);
 
-        for (size_t line_num = 0; line_num < lines.size(); ++line_num) {
-            const std::string& line = lines[line_num];
+        size_t line_num = first_line;
+        lines.forEachLine(first_line, last_line, [&](std::string_view line) {
+            auto words_begin = std::cregex_iterator(line.data(), line.data() + line.size(), regex);
+            auto words_end = std::cregex_iterator();
 
-            auto words_begin = std::sregex_iterator(line.begin(), line.end(), regex);
-            auto words_end = std::sregex_iterator();
-
-            for (std::sregex_iterator i = words_begin; i != words_end; ++i) {
-                std::smatch match = *i;
-                matches_.emplace_back(line_num, match.position(), match.length());
+            for (std::cregex_iterator i = words_begin; i != words_end; ++i) {
+                const std::cmatch& match = *i;
+                out.emplace_back(line_num, match.position(), match.length());
             }
-        }
+            ++line_num;
+        });
     } catch (const std::regex_error&) {
         // 正则表达式错误，回退到字面搜索
-        searchLiteral(pattern, lines);
+        searchLiteral(pattern, lines, options, first_line, last_line, out);
     }
 }
 
-void SearchEngine::searchWholeWord(const std::string& pattern,
-                                   const std::vector<std::string>& lines) {
-    for (size_t line_num = 0; line_num < lines.size(); ++line_num) {
-        std::string line = lines[line_num];
-        std::string search_pattern = pattern;
-
-        if (!options_.case_sensitive) {
-            std::transform(search_pattern.begin(), search_pattern.end(), search_pattern.begin(),
-                           ::tolower);
-            std::transform(line.begin(), line.end(), line.begin(), ::tolower);
-        }
-
-        size_t pos = 0;
-        while ((pos = line.find(search_pattern, pos)) != std::string::npos) {
+void SearchEngine::searchWholeWord(const std::string& pattern, const core::LineBuffer& lines,
+                                   const SearchOptions& options, size_t first_line,
+                                   size_t last_line, std::vector<SearchMatch>& out) {
+    const utils::LiteralFinder finder(pattern, options.case_sensitive);
+    auto is_word_char = [](char ch) {
+        return std::isalnum(static_cast<unsigned char>(ch)) != 0;
+    };
+
+    size_t line_num = first_line;
+    lines.forEachLine(first_line, last_line, [&](std::string_view line) {
+        for (size_t pos = finder.find(line); pos != std::string_view::npos;
+             pos = finder.find(line, pos + pattern.length())) {
             // 检查是否是完整单词
-            bool is_word_start = (pos == 0) || !std::isalnum(line[pos - 1]);
-            bool is_word_end = (pos + search_pattern.length() >= line.length()) ||
-                               !std::isalnum(line[pos + search_pattern.length()]);
+            size_t end = pos + pattern.length();
+            bool is_word_start = pos == 0 || !is_word_char(line[pos - 1]);
+            bool is_word_end = end >= line.length() || !is_word_char(line[end]);
 
             if (is_word_start && is_word_end) {
-                matches_.emplace_back(line_num, pos, pattern.length());
+                out.emplace_back(line_num, pos, pattern.length());
             }
+        }
+        ++line_num;
+    });
+}
+
+bool SearchEngine::applyEdits(core::Document& doc) {
+    size_t first = 0;
+    size_t end = 0;
+    size_t replaced = 0;
+    if (!doc.takeLineChanges(core::LineBuffer::SEARCH_MATCHES, first, end, replaced)) {
+        return false;
+    }
+    if (pattern_.empty() || source_ != &doc) {
+        return false;
+    }
+    const core::LineBuffer& lines = doc.getLines();
 
-            pos += pattern.length();
+    if (job_) {
+        // 后台搜索的是修改前的快照，已取到的和将要取到的结果都对不上了，重新开始
+        searchAsync(std::string(pattern_), doc, options_, notify_);
+    } else {
+        // 原来的 [first, first + replaced) 行变成了现在的 [first, end)
+        auto by_line = [](const SearchMatch& match, size_t line) {
+            return match.line < line;
+        };
+        const size_t lo = std::lower_bound(matches_.begin(), matches_.end(), first, by_line) -
+                          matches_.begin();
+        const size_t hi =
+            std::lower_bound(matches_.begin() + lo, matches_.end(), first + replaced, by_line) -
+            matches_.begin();
+
+        std::vector<SearchMatch> fresh;
+        searchLines(pattern_, lines, options_, first, end, fresh);
+
+        // 当前匹配：在改动范围之前不变，之后随之平移，落在范围内时取原位置及之后的第一个
+        size_t current = current_match_index_;
+        if (current >= hi) {
+            current = current - hi + lo + fresh.size();
+        } else if (current >= lo) {
+            const SearchMatch& old = matches_[current];
+            current = lo + (std::lower_bound(fresh.begin(), fresh.end(), old,
+                                             [](const SearchMatch& a, const SearchMatch& b) {
+                                                 return a.line < b.line ||
+                                                        (a.line == b.line && a.column < b.column);
+                                             }) -
+                            fresh.begin());
+        }
+
+        for (size_t i = hi; i < matches_.size(); ++i) {
+            matches_[i].line = matches_[i].line - replaced + (end - first);
+        }
+        if (fresh.size() == hi - lo) {
+            std::copy(fresh.begin(), fresh.end(), matches_.begin() + lo);
+        } else {
+            matches_.erase(matches_.begin() + lo, matches_.begin() + hi);
+            matches_.insert(matches_.begin() + lo, fresh.begin(), fresh.end());
         }
+        current_match_index_ = current < matches_.size() ? current : 0;
     }
+
+    // 结果已与修改后的内容一致，增量搜索可以继续在其上细化
+    source_version_ = doc.getVersion();
+    return true;
 }
 
 bool SearchEngine::findNext() {
@@ -134,8 +561,20 @@ bool SearchEngine::jumpToMatch(size_t index) {
     return true;
 }
 
-bool SearchEngine::replaceCurrentMatch(const std::string& replacement,
-                                       std::vector<std::string>& lines) {
+bool SearchEngine::jumpToMatchAt(size_t line, size_t column) {
+    if (matches_.empty()) {
+        return false;
+    }
+    auto it = std::lower_bound(matches_.begin(), matches_.end(), std::make_pair(line, column),
+                               [](const SearchMatch& match, const std::pair<size_t, size_t>& pos) {
+                                   return match.line < pos.first ||
+                                          (match.line == pos.first && match.column < pos.second);
+                               });
+    current_match_index_ = it == matches_.end() ? 0 : static_cast<size_t>(it - matches_.begin());
+    return true;
+}
+
+bool SearchEngine::replaceCurrentMatch(const std::string& replacement, core::LineBuffer& lines) {
     if (matches_.empty() || current_match_index_ >= matches_.size()) {
         return false;
     }
@@ -152,6 +591,7 @@ bool SearchEngine::replaceCurrentMatch(const std::string& replacement,
     }
 
     line.replace(match.column, match.length, replacement);
+    source_ = nullptr; // 文本已变，剩下的匹配不能再作为增量搜索的候选
 
     // 移除当前匹配
     matches_.erase(matches_.begin() + current_match_index_);
@@ -164,7 +604,7 @@ bool SearchEngine::replaceCurrentMatch(const std::string& replacement,
     return true;
 }
 
-size_t SearchEngine::replaceAll(const std::string& replacement, std::vector<std::string>& lines) {
+size_t SearchEngine::replaceAll(const std::string& replacement, core::LineBuffer& lines) {
     size_t count = 0;
 
     // 从后向前替换，避免位置偏移问题
@@ -184,8 +624,7 @@ size_t SearchEngine::replaceAll(const std::string& replacement, std::vector<std:
         count++;
     }
 
-    matches_.clear();
-    current_match_index_ = 0;
+    resetSearch(pattern_, options_);
 
     return count;
 }
@@ -198,9 +637,7 @@ const SearchMatch* SearchEngine::getCurrentMatch() const {
 }
 
 void SearchEngine::clearSearch() {
-    pattern_.clear();
-    matches_.clear();
-    current_match_index_ = 0;
+    resetSearch(std::string(), options_);
 }
 
 bool SearchEngine::isHighlightPosition(size_t line, size_t col) const {
@@ -0,0 +1,134 @@
+#include "features/search_job.h"
+#include <algorithm>
+
+namespace pnana {
+namespace features {
+
+SearchJob::SearchJob(std::string pattern, core::LineBuffer lines, SearchOptions options,
+                     NotifyCallback notify, size_t threads)
+    : SearchJob(std::move(pattern), std::move(lines), options, 0, std::string::npos, nullptr,
+                std::move(notify), threads) {}
+
+SearchJob::SearchJob(std::string pattern, core::LineBuffer lines, SearchOptions options,
+                     size_t first_line, size_t line_count, Candidates candidates,
+                     NotifyCallback notify, size_t threads)
+    : pattern_(std::move(pattern)), lines_(std::move(lines)), options_(options),
+      first_line_(std::min(first_line, lines_.size())),
+      line_count_(std::min(line_count, lines_.size())), candidates_(std::move(candidates)),
+      notify_(std::move(notify)), chunk_count_((line_count_ + CHUNK_LINES - 1) / CHUNK_LINES) {
+    chunk_matches_.resize(chunk_count_);
+    chunk_done_.assign(chunk_count_, 0);
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, chunk_count_);
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back(&SearchJob::run, this);
+    }
+}
+
+SearchJob::~SearchJob() {
+    cancel();
+    wait();
+}
+
+void SearchJob::cancel() {
+    cancelled_ = true;
+}
+
+void SearchJob::wait() {
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+size_t SearchJob::takeReady(std::vector<SearchMatch>& out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t added = 0;
+    for (; next_ready_ < chunk_count_ && chunk_done_[next_ready_]; ++next_ready_) {
+        auto& found = chunk_matches_[next_ready_];
+        out.insert(out.end(), found.begin(), found.end());
+        added += found.size();
+        std::vector<SearchMatch>().swap(found);
+    }
+    return added;
+}
+
+size_t SearchJob::readyLines() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::min(next_ready_ * CHUNK_LINES, line_count_);
+}
+
+int SearchJob::progress() const {
+    if (chunk_count_ == 0) {
+        return 100;
+    }
+    return static_cast<int>(done_chunks_.load() * 100 / chunk_count_);
+}
+
+void SearchJob::run() {
+    while (!cancelled_) {
+        size_t chunk = next_chunk_.fetch_add(1);
+        if (chunk >= chunk_count_) {
+            return;
+        }
+        std::vector<SearchMatch> found;
+        searchChunk(chunk, found);
+        match_count_ += found.size();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            chunk_matches_[chunk] = std::move(found);
+            chunk_done_[chunk] = 1;
+        }
+        notify(++done_chunks_);
+    }
+}
+
+void SearchJob::searchChunk(size_t chunk, std::vector<SearchMatch>& found) const {
+    // 块在 [first_line_, first_line_ + line_count_) 中的位置，超出文档末尾的部分绕回开头
+    const size_t total = lines_.size();
+    size_t begin = first_line_ + chunk * CHUNK_LINES;
+    size_t end = first_line_ + std::min((chunk + 1) * CHUNK_LINES, line_count_);
+    if (begin >= total) {
+        searchRange(begin - total, end - total, found);
+    } else if (end > total) {
+        searchRange(begin, total, found);
+        searchRange(0, end - total, found);
+    } else {
+        searchRange(begin, end, found);
+    }
+}
+
+void SearchJob::searchRange(size_t first_line, size_t last_line,
+                            std::vector<SearchMatch>& found) const {
+    if (candidates_) {
+        SearchEngine::refineLines(pattern_, lines_, options_, *candidates_, first_line, last_line,
+                                  found);
+    } else {
+        SearchEngine::searchLines(pattern_, lines_, options_, first_line, last_line, found);
+    }
+}
+
+void SearchJob::notify(size_t done_chunks) {
+    if (!notify_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = std::chrono::steady_clock::now();
+        // 第一块到达（第一屏结果）和全部完成时立即通知，其余按间隔合并
+        bool first_ready = !first_notified_ && chunk_done_[0];
+        if (!first_ready && done_chunks != chunk_count_ && now - last_notify_ < NOTIFY_INTERVAL) {
+            return;
+        }
+        first_notified_ = first_notified_ || first_ready;
+        last_notify_ = now;
+    }
+    notify_();
+}
+
+} // namespace features
+} // namespace pnana
@@ -106,7 +106,8 @@ int FileAPI::lua_api_save_file(lua_State* L) {
         return 1;
     }
 
-    bool result = editor->saveFile();
+    // 脚本需要确切的结果：大文件也等到写完
+    bool result = editor->saveFile(true);
     lua_pushboolean(L, result ? 1 : 0);
     return 1;
 }
@@ -0,0 +1,176 @@
+#include "ui/line_decorations.h"
+#include "utils/unicode_width.h"
+#include <algorithm>
+
+using namespace ftxui;
+
+namespace pnana {
+namespace ui {
+
+LineDecorations clipDecorations(const LineDecorations& decorations, size_t begin, size_t end) {
+    // 把 [start, stop) 裁剪到 [begin, end) 并平移，裁剪后为空时返回 false
+    auto clip = [begin, end](size_t& start, size_t& stop) {
+        start = std::min(std::max(start, begin), end) - begin;
+        stop = std::min(std::max(stop, begin), end) - begin;
+        return start < stop;
+    };
+
+    LineDecorations clipped;
+    const auto& spans = decorations.spans;
+    auto first = std::upper_bound(
+        spans.begin(), spans.end(), begin,
+        [](size_t pos, const features::StyleSpan& span) { return pos < span.end; });
+    for (auto it = first; it != spans.end() && it->start < end; ++it) {
+        features::StyleSpan span = *it;
+        if (clip(span.start, span.end)) {
+            clipped.spans.push_back(span);
+        }
+    }
+    for (auto diagnostic : decorations.diagnostics) {
+        if (clip(diagnostic.start, diagnostic.end)) {
+            clipped.diagnostics.push_back(diagnostic);
+        }
+    }
+    for (auto match : decorations.matches) {
+        if (clip(match.start, match.end)) {
+            clipped.matches.push_back(match);
+        }
+    }
+    if (decorations.has_selection) {
+        clipped.selection = decorations.selection;
+        clipped.has_selection = clip(clipped.selection.start, clipped.selection.end);
+    }
+    if (decorations.has_cursor && decorations.cursor >= begin && decorations.cursor <= end) {
+        clipped.has_cursor = true;
+        clipped.cursor = decorations.cursor - begin;
+    }
+    return clipped;
+}
+
+Element renderDecoratedLine(const std::string& line, const LineDecorations& decorations,
+                            const LineDecorationColors& colors,
+                            const CursorRenderer& render_cursor) {
+    const size_t length = line.length();
+    const auto& spans = decorations.spans;
+    const auto& matches = decorations.matches;
+
+    // 光标覆盖的字节范围（完整的一个字形簇，组合字符和 emoji 序列不会被拆开）
+    const bool draw_cursor = decorations.has_cursor && decorations.cursor <= length;
+    const size_t cursor = decorations.cursor;
+    size_t cursor_end = cursor;
+    if (draw_cursor && cursor < length) {
+        cursor_end = utils::UnicodeWidth::nextGrapheme(line, cursor);
+    }
+
+    Elements parts;
+    size_t span_index = 0;
+    size_t match_index = 0;
+    size_t pos = 0;
+
+    while (pos < length) {
+        // 每一层给出 pos 处的样式，以及样式保持不变的最远位置
+        size_t next = length;
+
+        while (span_index < spans.size() && spans[span_index].end <= pos) {
+            ++span_index;
+        }
+        Color foreground = colors.foreground;
+        if (span_index < spans.size()) {
+            const auto& span = spans[span_index];
+            if (span.start > pos) {
+                next = std::min(next, span.start);
+            } else {
+                foreground = span.color;
+                next = std::min(next, span.end);
+            }
+        }
+
+        int severity = 0;
+        for (const auto& diagnostic : decorations.diagnostics) {
+            if (diagnostic.start > pos) {
+                next = std::min(next, diagnostic.start);
+            } else if (pos < diagnostic.end) {
+                severity = severity == 0 ? diagnostic.severity
+                                         : std::min(severity, diagnostic.severity);
+                next = std::min(next, diagnostic.end);
+            }
+        }
+
+        while (match_index < matches.size() && matches[match_index].end <= pos) {
+            ++match_index;
+        }
+        bool in_match = false;
+        if (match_index < matches.size()) {
+            const auto& match = matches[match_index];
+            if (match.start > pos) {
+                next = std::min(next, match.start);
+            } else {
+                in_match = true;
+                next = std::min(next, match.end);
+            }
+        }
+
+        bool in_selection = false;
+        if (decorations.has_selection) {
+            const auto& selection = decorations.selection;
+            if (pos < selection.start) {
+                next = std::min(next, selection.start);
+            } else if (pos < selection.end) {
+                in_selection = true;
+                next = std::min(next, selection.end);
+            }
+        }
+
+        bool at_cursor = false;
+        if (draw_cursor && cursor < length) {
+            if (cursor > pos) {
+                next = std::min(next, cursor);
+            } else if (pos < cursor_end) {
+                at_cursor = true;
+                next = cursor_end; // 光标字符不再切分
+            }
+        }
+
+        if (next <= pos) {
+            next = pos + 1;
+        }
+
+        Element elem;
+        if (at_cursor) {
+            elem = render_cursor(line.substr(pos, next - pos));
+        } else {
+            if (severity == 1) {
+                foreground = colors.error;
+            } else if (severity == 2) {
+                foreground = colors.warning;
+            }
+            elem = text(line.substr(pos, next - pos)) | color(foreground);
+            if (severity != 0) {
+                elem = elem | underlined;
+            }
+        }
+
+        // 选中高亮优先于搜索高亮
+        if (in_selection) {
+            elem = elem | bgcolor(colors.selection);
+        } else if (in_match) {
+            elem = elem | bgcolor(colors.search_match);
+        }
+        parts.push_back(elem);
+
+        pos = next;
+    }
+
+    // 光标在行尾
+    if (draw_cursor && cursor == length) {
+        parts.push_back(render_cursor(" "));
+    }
+
+    if (parts.empty()) {
+        return text("");
+    }
+    return hbox(parts);
+}
+
+} // namespace ui
+} // namespace pnana
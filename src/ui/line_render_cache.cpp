@@ -0,0 +1,93 @@
+#include "ui/line_render_cache.h"
+#include <utility>
+#include <vector>
+
+namespace pnana {
+namespace ui {
+
+void LineRenderCache::setContext(const std::string& context) {
+    if (context != context_) {
+        context_ = context;
+        clear();
+    }
+}
+
+const LineRenderCache::Entry* LineRenderCache::find(const std::string& line,
+                                                    const features::StyleSpans& spans) {
+    auto it = current_.find(line);
+    if (it == current_.end()) {
+        auto old = previous_.find(line);
+        if (old == previous_.end()) {
+            return nullptr;
+        }
+        // 上一代命中：先取出条目再提升回当前代（当前代已满时降代会替换掉上一代）
+        Entry entry = std::move(old->second);
+        previous_.erase(old);
+        if (current_.size() >= MAX_ENTRIES) {
+            previous_ = std::move(current_);
+            current_.clear();
+        }
+        it = current_.emplace(line, std::move(entry)).first;
+    }
+
+    if (it->second.frame == frame_ || it->second.spans != spans) {
+        return nullptr;
+    }
+    it->second.frame = frame_;
+    return &it->second;
+}
+
+void LineRenderCache::insert(const std::string& line, ftxui::Element element,
+                             features::StyleSpans spans) {
+    if (current_.size() >= MAX_ENTRIES) {
+        previous_ = std::move(current_);
+        current_.clear();
+    }
+    Entry& entry = current_[line];
+    entry.element = std::move(element);
+    entry.frame = frame_;
+    entry.spans = std::move(spans);
+}
+
+void LineRenderCache::clear() {
+    current_.clear();
+    previous_.clear();
+    ++generation_;
+}
+
+const features::StyleSpans* RowSpanCache::find(size_t row, const Key& key) const {
+    auto it = rows_.find(row);
+    if (it == rows_.end() || !(it->second.key == key)) {
+        return nullptr;
+    }
+    return &it->second.spans;
+}
+
+void RowSpanCache::insert(size_t row, const Key& key, features::StyleSpans spans) {
+    if (rows_.size() >= MAX_ROWS && rows_.find(row) == rows_.end()) {
+        rows_.clear();
+    }
+    Row& entry = rows_[row];
+    entry.key = key;
+    entry.spans = std::move(spans);
+}
+
+void RowSpanCache::applyChange(size_t first, size_t end, size_t replaced) {
+    // 被替换的旧行丢弃，之后的行平移到新行号
+    const size_t old_end = first + replaced;
+    rows_.erase(rows_.lower_bound(first), rows_.lower_bound(old_end));
+    if (end == old_end) {
+        return;
+    }
+    std::vector<decltype(rows_)::node_type> moved;
+    for (auto it = rows_.lower_bound(old_end); it != rows_.end();) {
+        moved.push_back(rows_.extract(it++));
+    }
+    for (auto& node : moved) {
+        node.key() = node.key() - old_end + end;
+        rows_.insert(std::move(node));
+    }
+}
+
+} // namespace ui
+} // namespace pnana
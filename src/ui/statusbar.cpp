@@ -32,7 +32,8 @@ Element Statusbar::render(const std::string& filename, bool is_modified, bool is
                           const std::string& region_name, bool syntax_highlighting,
                           bool has_selection, size_t selection_length,
                           const std::string& git_branch, int git_uncommitted_count,
-                          const std::string& ssh_host, const std::string& ssh_user) {
+                          const std::string& ssh_host, const std::string& ssh_user,
+                          size_t undo_memory) {
     auto& colors = theme_.getColors();
 
     // Neovim 风格状态栏：左侧、中间、右侧三部分
@@ -189,6 +190,13 @@ Element Statusbar::render(const std::string& filename, bool is_modified, bool is
     total_oss << total_lines << "L";
     right_elements.push_back(text(total_oss.str()) | color(colors.comment) | dim);
 
+    // 撤销历史占用的内存
+    if (undo_memory > 0) {
+        right_elements.push_back(text(" │ ") | color(colors.comment) | dim);
+        right_elements.push_back(text(std::string(icons::UNDO) + " " + formatBytes(undo_memory)) |
+                                 color(colors.comment) | dim);
+    }
+
     // 应用美化配置 - 增强视觉效果
     if (beautify_config_.enabled && beautify_config_.bg_color.size() >= 3 &&
         beautify_config_.fg_color.size() >= 3) {
@@ -236,6 +244,18 @@ std::string Statusbar::formatProgress(size_t current, size_t total) {
     return oss.str();
 }
 
+std::string Statusbar::formatBytes(size_t bytes) {
+    std::ostringstream oss;
+    if (bytes < 1024) {
+        oss << bytes << "B";
+    } else if (bytes < 1024 * 1024) {
+        oss << (bytes / 1024) << "K";
+    } else {
+        oss << std::fixed << std::setprecision(1) << (bytes / (1024.0 * 1024.0)) << "M";
+    }
+    return oss.str();
+}
+
 std::string Statusbar::getRegionIcon(const std::string& region_name) {
     namespace icons = pnana::ui::icons;
     if (region_name.find("Code") != std::string::npos ||
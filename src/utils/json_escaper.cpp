@@ -0,0 +1,52 @@
+#include "utils/json_escaper.h"
+#include "utils/text_scanner.h"
+
+namespace pnana {
+namespace utils {
+
+void JsonEscaper::append(std::string& out, std::string_view text) {
+    static const char HEX[] = "0123456789abcdef";
+    const char* data = text.data();
+    size_t size = text.size();
+    size_t pos = 0;
+    while (pos < size) {
+        size_t next = pos + TextScanner::findJsonEscape(data + pos, size - pos);
+        out.append(data + pos, next - pos);
+        if (next == size) {
+            break;
+        }
+        unsigned char ch = static_cast<unsigned char>(data[next]);
+        switch (ch) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            case '\b':
+                out += "\\b";
+                break;
+            case '\f':
+                out += "\\f";
+                break;
+            default: {
+                char escaped[] = {'\\', 'u', '0', '0', HEX[ch >> 4], HEX[ch & 0xF]};
+                out.append(escaped, sizeof(escaped));
+                break;
+            }
+        }
+        pos = next + 1;
+    }
+}
+
+} // namespace utils
+} // namespace pnana
@@ -0,0 +1,160 @@
+#include "utils/literal_finder.h"
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define PNANA_LITERAL_FINDER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace pnana {
+namespace utils {
+
+namespace {
+
+inline unsigned char foldAscii(unsigned char ch) {
+    return (ch >= 'A' && ch <= 'Z') ? static_cast<unsigned char>(ch | 0x20) : ch;
+}
+
+inline bool isAsciiLetter(unsigned char ch) {
+    return foldAscii(ch) >= 'a' && foldAscii(ch) <= 'z';
+}
+
+} // namespace
+
+LiteralFinder::LiteralFinder(std::string_view pattern, bool case_sensitive)
+    : pattern_(pattern), case_sensitive_(case_sensitive) {
+    if (pattern_.empty()) {
+        return;
+    }
+    if (!case_sensitive_) {
+        for (char& ch : pattern_) {
+            ch = static_cast<char>(foldAscii(static_cast<unsigned char>(ch)));
+        }
+    }
+    first_value_ = static_cast<unsigned char>(pattern_.front());
+    last_value_ = static_cast<unsigned char>(pattern_.back());
+    // 小写字母与对应的大写字母只差 0x20 这一位，其他字节 | 0x20 都不会等于小写字母
+    if (!case_sensitive_) {
+        first_mask_ = isAsciiLetter(first_value_) ? 0x20 : 0;
+        last_mask_ = isAsciiLetter(last_value_) ? 0x20 : 0;
+    }
+}
+
+bool LiteralFinder::matchesAt(const char* candidate) const {
+    const size_t length = pattern_.size();
+    if (length <= 2) {
+        return true;
+    }
+    if (case_sensitive_) {
+        return std::memcmp(candidate + 1, pattern_.data() + 1, length - 2) == 0;
+    }
+    for (size_t i = 1; i + 1 < length; ++i) {
+        if (foldAscii(static_cast<unsigned char>(candidate[i])) !=
+            static_cast<unsigned char>(pattern_[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t LiteralFinder::findScalar(std::string_view text, size_t from) const {
+    if (case_sensitive_) {
+        return text.find(pattern_, from); // 标准库实现内部用 memchr 找首字节
+    }
+    const size_t last = pattern_.size() - 1;
+    for (size_t pos = from; pos + last < text.size(); ++pos) {
+        if ((static_cast<unsigned char>(text[pos]) | first_mask_) == first_value_ &&
+            (static_cast<unsigned char>(text[pos + last]) | last_mask_) == last_value_ &&
+            matchesAt(text.data() + pos)) {
+            return pos;
+        }
+    }
+    return std::string_view::npos;
+}
+
+#ifdef PNANA_LITERAL_FINDER_X86
+
+// SSE2 是 x86_64 的基线指令集，无需运行时检测
+size_t LiteralFinder::findSse2(std::string_view text, size_t from) const {
+    const char* data = text.data();
+    const size_t last = pattern_.size() - 1;
+    const __m128i first_value = _mm_set1_epi8(static_cast<char>(first_value_));
+    const __m128i first_mask = _mm_set1_epi8(static_cast<char>(first_mask_));
+    const __m128i last_value = _mm_set1_epi8(static_cast<char>(last_value_));
+    const __m128i last_mask = _mm_set1_epi8(static_cast<char>(last_mask_));
+    size_t pos = from;
+    // 每次检查 16 个起点：首字节取自 pos，末字节取自 pos + last，两次加载都不越界
+    for (; pos + last + 16 <= text.size(); pos += 16) {
+        __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + last));
+        __m128i hit =
+            _mm_and_si128(_mm_cmpeq_epi8(_mm_or_si128(head, first_mask), first_value),
+                          _mm_cmpeq_epi8(_mm_or_si128(tail, last_mask), last_value));
+        for (unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit)); mask;
+             mask &= mask - 1) {
+            size_t candidate = pos + __builtin_ctz(mask);
+            if (matchesAt(data + candidate)) {
+                return candidate;
+            }
+        }
+    }
+    return findScalar(text, pos);
+}
+
+__attribute__((target("avx2"))) size_t LiteralFinder::findAvx2(std::string_view text,
+                                                              size_t from) const {
+    const char* data = text.data();
+    const size_t last = pattern_.size() - 1;
+    const __m256i first_value = _mm256_set1_epi8(static_cast<char>(first_value_));
+    const __m256i first_mask = _mm256_set1_epi8(static_cast<char>(first_mask_));
+    const __m256i last_value = _mm256_set1_epi8(static_cast<char>(last_value_));
+    const __m256i last_mask = _mm256_set1_epi8(static_cast<char>(last_mask_));
+    size_t pos = from;
+    for (; pos + last + 32 <= text.size(); pos += 32) {
+        __m256i head = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        __m256i tail = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + last));
+        __m256i hit = _mm256_and_si256(
+            _mm256_cmpeq_epi8(_mm256_or_si256(head, first_mask), first_value),
+            _mm256_cmpeq_epi8(_mm256_or_si256(tail, last_mask), last_value));
+        for (uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hit)); mask;
+             mask &= mask - 1) {
+            size_t candidate = pos + __builtin_ctz(mask);
+            if (matchesAt(data + candidate)) {
+                return candidate;
+            }
+        }
+    }
+    // 剩余不足 32 个起点时交给 SSE2 和标量实现
+    return findSse2(text, pos);
+}
+
+#endif // PNANA_LITERAL_FINDER_X86
+
+const LiteralFinder::Implementation& LiteralFinder::selectImplementation() {
+    static const Implementation impl = []() {
+#ifdef PNANA_LITERAL_FINDER_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return Implementation{"avx2", &LiteralFinder::findAvx2};
+        }
+        return Implementation{"sse2", &LiteralFinder::findSse2};
+#else
+        return Implementation{"scalar", &LiteralFinder::findScalar};
+#endif
+    }();
+    return impl;
+}
+
+size_t LiteralFinder::find(std::string_view text, size_t from) const {
+    if (pattern_.empty() || from > text.size() || text.size() - from < pattern_.size()) {
+        return std::string_view::npos;
+    }
+    return (this->*selectImplementation().find)(text, from);
+}
+
+const char* LiteralFinder::implementation() {
+    return selectImplementation().name;
+}
+
+} // namespace utils
+} // namespace pnana
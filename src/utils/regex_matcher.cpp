@@ -0,0 +1,1012 @@
+#include "utils/regex_matcher.h"
+#include "utils/unicode_width.h"
+#include <algorithm>
+#include <memory>
+
+namespace pnana {
+namespace utils {
+
+namespace {
+
+constexpr char32_t MAX_CODE_POINT = 0x10FFFF;
+constexpr int MAX_NESTING_DEPTH = 200;
+constexpr int MAX_REPEAT_COUNT = 1000;
+constexpr size_t MAX_EXACT_LITERAL = 256;
+
+using Ranges = std::vector<std::pair<char32_t, char32_t>>;
+
+const Ranges DIGIT_RANGES = {{'0', '9'}};
+const Ranges WORD_RANGES = {{'0', '9'}, {'A', 'Z'}, {'_', '_'}, {'a', 'z'}};
+const Ranges SPACE_RANGES = {{0x09, 0x0D},     {0x20, 0x20},     {0xA0, 0xA0},
+                             {0x1680, 0x1680}, {0x2000, 0x200A}, {0x2028, 0x2029},
+                             {0x202F, 0x202F}, {0x205F, 0x205F}, {0x3000, 0x3000},
+                             {0xFEFF, 0xFEFF}};
+
+inline char32_t foldAscii(char32_t ch) {
+    return (ch >= 'A' && ch <= 'Z') ? ch + ('a' - 'A') : ch;
+}
+
+inline bool isWordByte(char ch) {
+    return (ch >= '0' && ch <= '9') || (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z') ||
+           ch == '_';
+}
+
+inline bool isLineTerminator(char32_t ch) {
+    return ch == '\n' || ch == '\r' || ch == 0x2028 || ch == 0x2029;
+}
+
+int hexValue(char ch) {
+    if (ch >= '0' && ch <= '9') {
+        return ch - '0';
+    }
+    if (ch >= 'a' && ch <= 'f') {
+        return ch - 'a' + 10;
+    }
+    if (ch >= 'A' && ch <= 'F') {
+        return ch - 'A' + 10;
+    }
+    return -1;
+}
+
+void appendUtf8(std::string& out, char32_t ch) {
+    if (ch < 0x80) {
+        out += static_cast<char>(ch);
+    } else if (ch < 0x800) {
+        out += static_cast<char>(0xC0 | (ch >> 6));
+        out += static_cast<char>(0x80 | (ch & 0x3F));
+    } else if (ch < 0x10000) {
+        out += static_cast<char>(0xE0 | (ch >> 12));
+        out += static_cast<char>(0x80 | ((ch >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (ch & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (ch >> 18));
+        out += static_cast<char>(0x80 | ((ch >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((ch >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (ch & 0x3F));
+    }
+}
+
+Ranges complement(const Ranges& ranges) {
+    Ranges result;
+    char32_t next = 0;
+    for (const auto& range : ranges) {
+        if (range.first > next) {
+            result.emplace_back(next, range.first - 1);
+        }
+        next = range.second + 1;
+    }
+    if (next <= MAX_CODE_POINT) {
+        result.emplace_back(next, MAX_CODE_POINT);
+    }
+    return result;
+}
+
+// 排序并合并相交或相邻的区间
+void normalize(Ranges& ranges) {
+    std::sort(ranges.begin(), ranges.end());
+    Ranges merged;
+    for (const auto& range : ranges) {
+        if (!merged.empty() && range.first <= merged.back().second + 1) {
+            merged.back().second = std::max(merged.back().second, range.second);
+        } else {
+            merged.push_back(range);
+        }
+    }
+    ranges.swap(merged);
+}
+
+// 为与 ASCII 字母相交的区间补上另一种大小写
+void addCaseVariants(Ranges& ranges) {
+    const size_t count = ranges.size();
+    for (size_t i = 0; i < count; ++i) {
+        const auto range = ranges[i];
+        char32_t lo = std::max<char32_t>(range.first, 'a');
+        char32_t hi = std::min<char32_t>(range.second, 'z');
+        if (lo <= hi) {
+            ranges.emplace_back(lo - ('a' - 'A'), hi - ('a' - 'A'));
+        }
+        lo = std::max<char32_t>(range.first, 'A');
+        hi = std::min<char32_t>(range.second, 'Z');
+        if (lo <= hi) {
+            ranges.emplace_back(lo + ('a' - 'A'), hi + ('a' - 'A'));
+        }
+    }
+}
+
+// Pike VM 的线程表：稀疏集合，按加入顺序（即优先级）遍历，O(1) 判重和清空
+struct ThreadList {
+    std::vector<uint32_t> sparse;
+    std::vector<uint32_t> dense;
+    std::vector<size_t> starts; // 与 dense 对应：线程的匹配起点
+    size_t count = 0;
+
+    void reset(size_t program_size) {
+        if (sparse.size() < program_size) {
+            sparse.resize(program_size);
+            dense.resize(program_size);
+            starts.resize(program_size);
+        }
+        count = 0;
+    }
+
+    bool contains(uint32_t pc) const {
+        uint32_t index = sparse[pc];
+        return index < count && dense[index] == pc;
+    }
+
+    void insert(uint32_t pc, size_t start) {
+        sparse[pc] = static_cast<uint32_t>(count);
+        dense[count] = pc;
+        starts[count] = start;
+        ++count;
+    }
+};
+
+struct Scratch {
+    ThreadList current;
+    ThreadList next;
+    std::vector<uint32_t> stack;
+};
+
+} // namespace
+
+struct RegexMatcher::Node {
+    enum class Kind { EMPTY, CHAR, ANY, CLASS, CONCAT, ALTERNATE, REPEAT, ASSERT };
+
+    Kind kind = Kind::EMPTY;
+    char32_t ch = 0;
+    uint32_t class_index = 0;
+    Assertion assertion = Assertion::LINE_BEGIN;
+    int min = 0;
+    int max = 0; // 小于 0 表示无上限
+    bool greedy = true;
+    std::vector<std::unique_ptr<Node>> children;
+
+    explicit Node(Kind node_kind) : kind(node_kind) {}
+};
+
+// 节点的字面量信息：exact 时节点只能匹配 text；
+// required 为每个匹配都包含的字面量，prefix 为每个匹配共同的前缀
+struct RegexMatcher::LiteralInfo {
+    bool exact = false;
+    std::string text;
+    std::string required;
+    std::string prefix;
+};
+
+// 递归下降解析器，嵌套深度有上限
+struct RegexMatcher::Parser {
+    std::string_view pattern;
+    bool case_sensitive;
+    std::vector<CharClass>& classes;
+    size_t pos = 0;
+    int depth = 0;
+    Status status = Status::OK;
+    std::string error;
+
+    Parser(std::string_view source, bool sensitive, std::vector<CharClass>& class_table)
+        : pattern(source), case_sensitive(sensitive), classes(class_table) {}
+
+    std::unique_ptr<Node> parse() {
+        std::unique_ptr<Node> root = parseAlternation();
+        if (root && pos < pattern.size()) {
+            return fail(Status::INVALID, "多余的 )");
+        }
+        return root;
+    }
+
+    std::unique_ptr<Node> fail(Status failure, const char* message) {
+        if (status == Status::OK) {
+            status = failure;
+            error = message;
+        }
+        return nullptr;
+    }
+
+    bool atEnd() const {
+        return pos >= pattern.size();
+    }
+
+    char peek() const {
+        return pattern[pos];
+    }
+
+    std::unique_ptr<Node> parseAlternation() {
+        if (++depth > MAX_NESTING_DEPTH) {
+            return fail(Status::INVALID, "嵌套过深");
+        }
+        auto alternatives = std::make_unique<Node>(Node::Kind::ALTERNATE);
+        while (true) {
+            std::unique_ptr<Node> branch = parseConcat();
+            if (!branch) {
+                return nullptr;
+            }
+            alternatives->children.push_back(std::move(branch));
+            if (atEnd() || peek() != '|') {
+                break;
+            }
+            ++pos;
+        }
+        --depth;
+        if (alternatives->children.size() == 1) {
+            return std::move(alternatives->children.front());
+        }
+        return alternatives;
+    }
+
+    std::unique_ptr<Node> parseConcat() {
+        auto sequence = std::make_unique<Node>(Node::Kind::CONCAT);
+        while (!atEnd() && peek() != '|' && peek() != ')') {
+            const bool grouped = peek() == '(';
+            std::unique_ptr<Node> atom = parseAtom();
+            if (!atom) {
+                return nullptr;
+            }
+            if (!atEnd() && isQuantifierStart(peek())) {
+                // ^* 是语法错误，(^)* 则允许
+                if (atom->kind == Node::Kind::ASSERT && !grouped) {
+                    return fail(Status::INVALID, "断言不能重复");
+                }
+                atom = parseQuantifier(std::move(atom));
+                if (!atom) {
+                    return nullptr;
+                }
+            }
+            sequence->children.push_back(std::move(atom));
+        }
+        if (sequence->children.empty()) {
+            return std::make_unique<Node>(Node::Kind::EMPTY);
+        }
+        if (sequence->children.size() == 1) {
+            return std::move(sequence->children.front());
+        }
+        return sequence;
+    }
+
+    static bool isQuantifierStart(char ch) {
+        return ch == '*' || ch == '+' || ch == '?' || ch == '{';
+    }
+
+    bool parseCount(int& value) {
+        if (atEnd() || peek() < '0' || peek() > '9') {
+            return false;
+        }
+        long long number = 0;
+        while (!atEnd() && peek() >= '0' && peek() <= '9') {
+            number = std::min<long long>(number * 10 + (peek() - '0'), MAX_REPEAT_COUNT + 1);
+            ++pos;
+        }
+        value = static_cast<int>(number);
+        return true;
+    }
+
+    std::unique_ptr<Node> parseQuantifier(std::unique_ptr<Node> atom) {
+        auto repeat = std::make_unique<Node>(Node::Kind::REPEAT);
+        char ch = pattern[pos++];
+        if (ch == '*') {
+            repeat->min = 0;
+            repeat->max = -1;
+        } else if (ch == '+') {
+            repeat->min = 1;
+            repeat->max = -1;
+        } else if (ch == '?') {
+            repeat->min = 0;
+            repeat->max = 1;
+        } else {
+            if (!parseCount(repeat->min)) {
+                return fail(Status::INVALID, "无效的 {n,m} 量词");
+            }
+            repeat->max = repeat->min;
+            if (!atEnd() && peek() == ',') {
+                ++pos;
+                repeat->max = -1;
+                if (!atEnd() && peek() != '}' && !parseCount(repeat->max)) {
+                    return fail(Status::INVALID, "无效的 {n,m} 量词");
+                }
+            }
+            if (atEnd() || peek() != '}') {
+                return fail(Status::INVALID, "无效的 {n,m} 量词");
+            }
+            ++pos;
+            if (repeat->max >= 0 && repeat->max < repeat->min) {
+                return fail(Status::INVALID, "量词范围顺序错误");
+            }
+            if (repeat->min > MAX_REPEAT_COUNT || repeat->max > MAX_REPEAT_COUNT) {
+                return fail(Status::UNSUPPORTED, "重复次数过大");
+            }
+        }
+        if (!atEnd() && peek() == '?') {
+            repeat->greedy = false;
+            ++pos;
+        }
+        repeat->children.push_back(std::move(atom));
+        return repeat;
+    }
+
+    std::unique_ptr<Node> makeChar(char32_t ch) {
+        auto node = std::make_unique<Node>(Node::Kind::CHAR);
+        node->ch = case_sensitive ? ch : foldAscii(ch);
+        return node;
+    }
+
+    std::unique_ptr<Node> makeAssert(Assertion assertion) {
+        auto node = std::make_unique<Node>(Node::Kind::ASSERT);
+        node->assertion = assertion;
+        return node;
+    }
+
+    std::unique_ptr<Node> makeClass(Ranges ranges, bool negated) {
+        if (!case_sensitive) {
+            addCaseVariants(ranges);
+        }
+        normalize(ranges);
+        if (negated) {
+            ranges = complement(ranges);
+        }
+        auto node = std::make_unique<Node>(Node::Kind::CLASS);
+        node->class_index = static_cast<uint32_t>(classes.size());
+        classes.push_back(CharClass{std::move(ranges)});
+        return node;
+    }
+
+    std::unique_ptr<Node> parseAtom() {
+        char ch = peek();
+        switch (ch) {
+            case '^':
+                ++pos;
+                return makeAssert(Assertion::LINE_BEGIN);
+            case '$':
+                ++pos;
+                return makeAssert(Assertion::LINE_END);
+            case '.':
+                ++pos;
+                return std::make_unique<Node>(Node::Kind::ANY);
+            case '(':
+                return parseGroup();
+            case '[':
+                return parseClass();
+            case '\\':
+                return parseEscape();
+            case '*':
+            case '+':
+            case '?':
+            case '{':
+                return fail(Status::INVALID, "量词前没有可重复的内容");
+            default:
+                return makeChar(UnicodeWidth::decode(pattern, pos));
+        }
+    }
+
+    std::unique_ptr<Node> parseGroup() {
+        ++pos; // (
+        if (!atEnd() && peek() == '?') {
+            if (pos + 1 < pattern.size() && pattern[pos + 1] == ':') {
+                pos += 2;
+            } else {
+                return fail(Status::UNSUPPORTED, "不支持环视和命名分组");
+            }
+        }
+        std::unique_ptr<Node> inner = parseAlternation();
+        if (!inner) {
+            return nullptr;
+        }
+        if (atEnd() || peek() != ')') {
+            return fail(Status::INVALID, "缺少 )");
+        }
+        ++pos;
+        return inner;
+    }
+
+    // 解析 \ 之后的普通字符转义（字符类内外共用），pos 指向 \ 后的字符
+    bool parseCharEscape(char32_t& value) {
+        char ch = peek();
+        switch (ch) {
+            case '0':
+                ++pos;
+                value = 0;
+                return true;
+            case 'f':
+                ++pos;
+                value = '\f';
+                return true;
+            case 'n':
+                ++pos;
+                value = '\n';
+                return true;
+            case 'r':
+                ++pos;
+                value = '\r';
+                return true;
+            case 't':
+                ++pos;
+                value = '\t';
+                return true;
+            case 'v':
+                ++pos;
+                value = '\v';
+                return true;
+            case 'c': {
+                if (pos + 1 >= pattern.size() || foldAscii(pattern[pos + 1]) < 'a' ||
+                    foldAscii(pattern[pos + 1]) > 'z') {
+                    fail(Status::INVALID, "无效的 \\c 转义");
+                    return false;
+                }
+                value = static_cast<char32_t>(pattern[pos + 1] % 32);
+                pos += 2;
+                return true;
+            }
+            case 'x':
+            case 'u': {
+                const size_t digits = ch == 'x' ? 2 : 4;
+                if (pos + digits >= pattern.size()) {
+                    fail(Status::INVALID, "无效的十六进制转义");
+                    return false;
+                }
+                value = 0;
+                for (size_t i = 1; i <= digits; ++i) {
+                    int digit = hexValue(pattern[pos + i]);
+                    if (digit < 0) {
+                        fail(Status::INVALID, "无效的十六进制转义");
+                        return false;
+                    }
+                    value = value * 16 + static_cast<char32_t>(digit);
+                }
+                pos += digits + 1;
+                return true;
+            }
+            default:
+                value = UnicodeWidth::decode(pattern, pos);
+                return true;
+        }
+    }
+
+    // \d \w \s 及其补集，ch 不是这几个字母时返回 false
+    static bool classEscape(char ch, Ranges& ranges) {
+        switch (ch) {
+            case 'd':
+                ranges = DIGIT_RANGES;
+                return true;
+            case 'D':
+                ranges = complement(DIGIT_RANGES);
+                return true;
+            case 'w':
+                ranges = WORD_RANGES;
+                return true;
+            case 'W':
+                ranges = complement(WORD_RANGES);
+                return true;
+            case 's':
+                ranges = SPACE_RANGES;
+                return true;
+            case 'S':
+                ranges = complement(SPACE_RANGES);
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    std::unique_ptr<Node> parseEscape() {
+        ++pos; // '\'
+        if (atEnd()) {
+            return fail(Status::INVALID, "模式以 \\ 结尾");
+        }
+        char ch = peek();
+        if (ch == 'b' || ch == 'B') {
+            ++pos;
+            return makeAssert(ch == 'b' ? Assertion::WORD_BOUNDARY
+                                        : Assertion::NOT_WORD_BOUNDARY);
+        }
+        if (ch >= '1' && ch <= '9') {
+            return fail(Status::UNSUPPORTED, "不支持反向引用");
+        }
+        Ranges ranges;
+        if (classEscape(ch, ranges)) {
+            ++pos;
+            return makeClass(std::move(ranges), false);
+        }
+        char32_t value = 0;
+        if (!parseCharEscape(value)) {
+            return nullptr;
+        }
+        return makeChar(value);
+    }
+
+    // 字符类中的一个原子：单个字符（is_set 为 false）或 \d 这样的集合
+    bool parseClassAtom(char32_t& value, bool& is_set, Ranges& set) {
+        is_set = false;
+        if (peek() != '\\') {
+            value = UnicodeWidth::decode(pattern, pos);
+            return true;
+        }
+        ++pos;
+        if (atEnd()) {
+            fail(Status::INVALID, "缺少 ]");
+            return false;
+        }
+        if (classEscape(peek(), set)) {
+            ++pos;
+            is_set = true;
+            return true;
+        }
+        if (peek() == 'b') {
+            ++pos;
+            value = '\b';
+            return true;
+        }
+        return parseCharEscape(value);
+    }
+
+    std::unique_ptr<Node> parseClass() {
+        ++pos; // [
+        bool negated = false;
+        if (!atEnd() && peek() == '^') {
+            negated = true;
+            ++pos;
+        }
+        Ranges ranges;
+        while (true) {
+            if (atEnd()) {
+                return fail(Status::INVALID, "缺少 ]");
+            }
+            if (peek() == ']') {
+                ++pos;
+                break;
+            }
+            char32_t low = 0;
+            bool is_set = false;
+            Ranges set;
+            if (!parseClassAtom(low, is_set, set)) {
+                return nullptr;
+            }
+            if (is_set) {
+                ranges.insert(ranges.end(), set.begin(), set.end());
+                continue;
+            }
+            // a-z；末尾的 - 按字面处理
+            if (pos + 1 < pattern.size() && peek() == '-' && pattern[pos + 1] != ']') {
+                ++pos;
+                char32_t high = 0;
+                if (!parseClassAtom(high, is_set, set)) {
+                    return nullptr;
+                }
+                if (is_set) {
+                    return fail(Status::INVALID, "字符类范围的端点不能是集合");
+                }
+                if (high < low) {
+                    return fail(Status::INVALID, "字符类范围顺序错误");
+                }
+                ranges.emplace_back(low, high);
+            } else {
+                ranges.emplace_back(low, low);
+            }
+        }
+        return makeClass(std::move(ranges), negated);
+    }
+};
+
+bool RegexMatcher::CharClass::contains(char32_t ch) const {
+    auto it = std::upper_bound(ranges.begin(), ranges.end(), ch,
+                               [](char32_t value, const std::pair<char32_t, char32_t>& range) {
+                                   return value < range.first;
+                               });
+    return it != ranges.begin() && ch <= std::prev(it)->second;
+}
+
+RegexMatcher::RegexMatcher(std::string_view pattern, bool case_sensitive)
+    : case_sensitive_(case_sensitive) {
+    Parser parser(pattern, case_sensitive, classes_);
+    std::unique_ptr<Node> root = parser.parse();
+    if (!root) {
+        status_ = parser.status;
+        error_ = parser.error;
+        return;
+    }
+    if (!compile(*root)) {
+        status_ = Status::UNSUPPORTED;
+        error_ = "模式过大";
+        program_.clear();
+        return;
+    }
+    emit(Op::MATCH);
+    computeFirstBytes();
+
+    LiteralInfo info = literals(*root);
+    required_ = std::move(info.required);
+    prefix_ = std::move(info.prefix);
+    if (!required_.empty()) {
+        required_finder_ = LiteralFinder(required_, case_sensitive_);
+    }
+    if (!prefix_.empty()) {
+        prefix_finder_ = LiteralFinder(prefix_, case_sensitive_);
+    }
+}
+
+uint32_t RegexMatcher::emit(Op op) {
+    program_.push_back(Inst{op, Assertion::LINE_BEGIN, 0, 0, 0});
+    return static_cast<uint32_t>(program_.size() - 1);
+}
+
+bool RegexMatcher::compile(const Node& node) {
+    if (program_.size() > MAX_PROGRAM_SIZE) {
+        return false;
+    }
+    switch (node.kind) {
+        case Node::Kind::EMPTY:
+            return true;
+        case Node::Kind::CHAR:
+            program_[emit(Op::CHAR)].ch = node.ch;
+            return true;
+        case Node::Kind::ANY:
+            emit(Op::ANY);
+            return true;
+        case Node::Kind::CLASS:
+            program_[emit(Op::CLASS)].x = node.class_index;
+            return true;
+        case Node::Kind::ASSERT:
+            program_[emit(Op::ASSERT)].assertion = node.assertion;
+            return true;
+        case Node::Kind::CONCAT:
+            for (const auto& child : node.children) {
+                if (!compile(*child)) {
+                    return false;
+                }
+            }
+            return true;
+        case Node::Kind::ALTERNATE: {
+            // SPLIT L1, next; L1: e1; JMP out; next: SPLIT L2, ... 越靠前的分支优先级越高
+            std::vector<uint32_t> exits;
+            for (size_t i = 0; i < node.children.size(); ++i) {
+                const bool last = i + 1 == node.children.size();
+                uint32_t split = 0;
+                if (!last) {
+                    split = emit(Op::SPLIT);
+                    program_[split].x = split + 1;
+                }
+                if (!compile(*node.children[i])) {
+                    return false;
+                }
+                if (!last) {
+                    exits.push_back(emit(Op::JMP));
+                    program_[split].y = static_cast<uint32_t>(program_.size());
+                }
+            }
+            for (uint32_t exit : exits) {
+                program_[exit].x = static_cast<uint32_t>(program_.size());
+            }
+            return true;
+        }
+        case Node::Kind::REPEAT: {
+            const Node& child = *node.children.front();
+            for (int i = 0; i < node.min; ++i) {
+                if (!compile(child)) {
+                    return false;
+                }
+            }
+            // 贪婪时 SPLIT 优先进入循环体，惰性时优先跳出
+            auto link = [this, &node](uint32_t split, uint32_t body, uint32_t out) {
+                program_[split].x = node.greedy ? body : out;
+                program_[split].y = node.greedy ? out : body;
+            };
+            if (node.max < 0) {
+                uint32_t loop = emit(Op::SPLIT);
+                if (!compile(child)) {
+                    return false;
+                }
+                program_[emit(Op::JMP)].x = loop;
+                link(loop, loop + 1, static_cast<uint32_t>(program_.size()));
+                return true;
+            }
+            // x{n,m} 的可选部分嵌套展开为 (x(x(x)?)?)?，任一层不匹配都直接跳到末尾
+            std::vector<uint32_t> splits;
+            for (int i = node.min; i < node.max; ++i) {
+                splits.push_back(emit(Op::SPLIT));
+                if (!compile(child)) {
+                    return false;
+                }
+            }
+            for (uint32_t split : splits) {
+                link(split, split + 1, static_cast<uint32_t>(program_.size()));
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void RegexMatcher::computeFirstBytes() {
+    // 从入口沿 ε 边（断言按可通过处理）找出所有可能消耗第一个字符的指令
+    std::vector<bool> visited(program_.size(), false);
+    std::vector<uint32_t> stack = {0};
+    auto mark_code_point = [this](char32_t ch) {
+        if (ch < 0x80) {
+            first_bytes_[ch] = true;
+            if (!case_sensitive_ && ch >= 'a' && ch <= 'z') {
+                first_bytes_[ch - ('a' - 'A')] = true;
+            }
+        } else {
+            std::string bytes;
+            appendUtf8(bytes, ch);
+            first_bytes_[static_cast<unsigned char>(bytes.front())] = true;
+        }
+    };
+    auto mark_non_ascii = [this]() {
+        // 无效字节按 U+FFFD 解码，保守起见全部标记
+        for (size_t byte = 0x80; byte < 256; ++byte) {
+            first_bytes_[byte] = true;
+        }
+    };
+
+    while (!stack.empty()) {
+        uint32_t pc = stack.back();
+        stack.pop_back();
+        if (visited[pc]) {
+            continue;
+        }
+        visited[pc] = true;
+        const Inst& inst = program_[pc];
+        switch (inst.op) {
+            case Op::MATCH:
+                return; // 能匹配空串，任何位置都可能是起点
+            case Op::JMP:
+                stack.push_back(inst.x);
+                break;
+            case Op::SPLIT:
+                stack.push_back(inst.x);
+                stack.push_back(inst.y);
+                break;
+            case Op::ASSERT:
+                stack.push_back(pc + 1);
+                break;
+            case Op::CHAR:
+                mark_code_point(inst.ch);
+                break;
+            case Op::ANY:
+                first_bytes_.fill(true);
+                break;
+            case Op::CLASS:
+                for (const auto& range : classes_[inst.x].ranges) {
+                    for (char32_t ch = range.first; ch <= range.second && ch < 0x80; ++ch) {
+                        first_bytes_[ch] = true;
+                    }
+                    if (range.second >= 0x80) {
+                        mark_non_ascii();
+                    }
+                }
+                break;
+        }
+    }
+    skip_by_first_byte_ = true;
+}
+
+RegexMatcher::LiteralInfo RegexMatcher::literals(const Node& node) {
+    LiteralInfo info;
+    auto longer = [](std::string& best, const std::string& candidate) {
+        if (candidate.size() > best.size()) {
+            best = candidate;
+        }
+    };
+
+    switch (node.kind) {
+        case Node::Kind::EMPTY:
+        case Node::Kind::ASSERT:
+            // 零宽，相当于匹配空串
+            info.exact = true;
+            break;
+        case Node::Kind::CHAR:
+            info.exact = true;
+            appendUtf8(info.text, node.ch);
+            break;
+        case Node::Kind::ANY:
+        case Node::Kind::CLASS:
+            return info;
+        case Node::Kind::CONCAT: {
+            // 相邻的精确子节点连成一段字面量，取最长的一段（或子节点的必需字面量）
+            std::string run;
+            bool all_exact = true;
+            for (const auto& child : node.children) {
+                LiteralInfo part = literals(*child);
+                if (part.exact && run.size() + part.text.size() <= MAX_EXACT_LITERAL) {
+                    run += part.text;
+                    continue;
+                }
+                if (all_exact) {
+                    info.prefix = run + part.prefix;
+                    all_exact = false;
+                }
+                longer(info.required, run);
+                longer(info.required, part.required);
+                run = part.exact ? part.text : std::string();
+            }
+            if (all_exact) {
+                info.exact = true;
+                info.text = std::move(run);
+                break;
+            }
+            longer(info.required, run);
+            return info;
+        }
+        case Node::Kind::ALTERNATE: {
+            // 各分支相同时才有必需字面量；前缀取各分支前缀的公共部分
+            std::vector<LiteralInfo> parts;
+            for (const auto& child : node.children) {
+                parts.push_back(literals(*child));
+            }
+            bool same_text = true;
+            info.required = parts.front().required;
+            info.prefix = parts.front().prefix;
+            for (const auto& part : parts) {
+                same_text = same_text && part.exact && parts.front().exact &&
+                            part.text == parts.front().text;
+                if (part.required != info.required) {
+                    info.required.clear();
+                }
+                size_t common = 0;
+                while (common < info.prefix.size() && common < part.prefix.size() &&
+                       info.prefix[common] == part.prefix[common]) {
+                    ++common;
+                }
+                info.prefix.resize(common);
+            }
+            if (same_text) {
+                return parts.front();
+            }
+            return info;
+        }
+        case Node::Kind::REPEAT: {
+            if (node.max == 0) {
+                info.exact = true;
+                return info;
+            }
+            if (node.min == 0) {
+                return info;
+            }
+            LiteralInfo part = literals(*node.children.front());
+            if (part.exact && node.min == node.max &&
+                part.text.size() * static_cast<size_t>(node.min) <= MAX_EXACT_LITERAL) {
+                info.exact = true;
+                for (int i = 0; i < node.min; ++i) {
+                    info.text += part.text;
+                }
+                break;
+            }
+            info.required = std::move(part.required);
+            info.prefix = std::move(part.prefix);
+            return info;
+        }
+    }
+    // 精确节点的前缀和必需字面量就是它本身
+    info.required = info.text;
+    info.prefix = info.text;
+    return info;
+}
+
+bool RegexMatcher::checkAssertion(Assertion assertion, std::string_view text, size_t pos) const {
+    switch (assertion) {
+        case Assertion::LINE_BEGIN:
+            return pos == 0;
+        case Assertion::LINE_END:
+            return pos == text.size();
+        case Assertion::WORD_BOUNDARY:
+        case Assertion::NOT_WORD_BOUNDARY: {
+            bool before = pos > 0 && isWordByte(text[pos - 1]);
+            bool after = pos < text.size() && isWordByte(text[pos]);
+            return (before != after) == (assertion == Assertion::WORD_BOUNDARY);
+        }
+    }
+    return false;
+}
+
+bool RegexMatcher::find(std::string_view text, size_t from, size_t& start, size_t& end) const {
+    if (status_ != Status::OK || from > text.size()) {
+        return false;
+    }
+
+    thread_local Scratch scratch;
+    ThreadList* current = &scratch.current;
+    ThreadList* next = &scratch.next;
+    current->reset(program_.size());
+    next->reset(program_.size());
+    std::vector<uint32_t>& stack = scratch.stack;
+
+    // 沿 JMP/SPLIT/ASSERT 求 ε 闭包，按优先级顺序把线程加入 list；SPLIT 的 x 后入栈先处理
+    auto add_thread = [&](ThreadList& list, uint32_t first_pc, size_t thread_start, size_t pos) {
+        stack.clear();
+        stack.push_back(first_pc);
+        while (!stack.empty()) {
+            uint32_t pc = stack.back();
+            stack.pop_back();
+            if (list.contains(pc)) {
+                continue;
+            }
+            list.insert(pc, thread_start);
+            const Inst& inst = program_[pc];
+            switch (inst.op) {
+                case Op::JMP:
+                    stack.push_back(inst.x);
+                    break;
+                case Op::SPLIT:
+                    stack.push_back(inst.y);
+                    stack.push_back(inst.x);
+                    break;
+                case Op::ASSERT:
+                    if (checkAssertion(inst.assertion, text, pos)) {
+                        stack.push_back(pc + 1);
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    };
+
+    bool matched = false;
+    size_t pos = from;
+    while (true) {
+        if (!matched) {
+            // 没有活动线程时直接跳到下一个可能的起点
+            if (current->count == 0 && !prefix_.empty()) {
+                size_t candidate = prefix_finder_.find(text, pos);
+                if (candidate == std::string_view::npos) {
+                    break;
+                }
+                pos = candidate;
+            } else if (current->count == 0 && skip_by_first_byte_) {
+                while (pos < text.size() && !first_bytes_[static_cast<unsigned char>(text[pos])]) {
+                    ++pos;
+                }
+                if (pos >= text.size()) {
+                    break;
+                }
+            }
+            // 新起点的优先级低于已有线程，保证最左匹配
+            add_thread(*current, 0, pos, pos);
+        }
+        if (current->count == 0) {
+            break;
+        }
+
+        const bool at_end = pos >= text.size();
+        size_t next_pos = pos;
+        char32_t ch = at_end ? 0 : UnicodeWidth::decode(text, next_pos);
+        const char32_t folded = case_sensitive_ ? ch : foldAscii(ch);
+        for (size_t i = 0; i < current->count; ++i) {
+            const Inst& inst = program_[current->dense[i]];
+            bool advance = false;
+            switch (inst.op) {
+                case Op::MATCH:
+                    // 更低优先级的线程全部丢弃
+                    matched = true;
+                    start = current->starts[i];
+                    end = pos;
+                    i = current->count;
+                    break;
+                case Op::CHAR:
+                    advance = !at_end && folded == inst.ch;
+                    break;
+                case Op::ANY:
+                    advance = !at_end && !isLineTerminator(ch);
+                    break;
+                case Op::CLASS:
+                    advance = !at_end && classes_[inst.x].contains(ch);
+                    break;
+                default:
+                    break;
+            }
+            if (advance) {
+                add_thread(*next, current->dense[i] + 1, current->starts[i], next_pos);
+            }
+        }
+
+        std::swap(current, next);
+        next->count = 0;
+        if (at_end) {
+            break;
+        }
+        pos = next_pos;
+    }
+    return matched;
+}
+
+} // namespace utils
+} // namespace pnana
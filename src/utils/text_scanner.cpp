@@ -0,0 +1,338 @@
+#include "utils/text_scanner.h"
+#include <algorithm>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define PNANA_TEXT_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace pnana {
+namespace utils {
+
+namespace {
+
+// 64 字节块的比较结果，第 i 位对应块内第 i 个字节
+struct BlockMasks {
+    uint64_t lf = 0;
+    uint64_t cr = 0;
+    uint64_t high = 0;
+    uint64_t nul = 0;  // 仅在二进制检测窗口内计算
+    uint64_t ctrl = 0; // 同上，<= 0x1F 的字节
+};
+
+struct ScanState {
+    TextScanResult& result;
+    bool collect_lines;
+    size_t cr_total = 0;
+    bool prev_cr = false; // 上一块最后一个字节是否为 \r
+};
+
+inline unsigned popcount64(uint64_t value) {
+    return static_cast<unsigned>(__builtin_popcountll(value));
+}
+
+// 累计一个块（width <= 64 字节）的统计
+inline void consumeBlock(const BlockMasks& masks, size_t base, unsigned width, ScanState& state) {
+    TextScanResult& result = state.result;
+    result.lf_count += popcount64(masks.lf);
+    state.cr_total += popcount64(masks.cr);
+    // \r 的下一位是 \n 即为 CRLF；跨块的情况由 prev_cr 补上
+    result.crlf_count += popcount64(masks.cr & (masks.lf >> 1));
+    if (state.prev_cr && (masks.lf & 1)) {
+        result.crlf_count++;
+    }
+    state.prev_cr = (masks.cr >> (width - 1)) & 1;
+    if (masks.high) {
+        result.has_non_ascii = true;
+    }
+    if (base < result.probe_size) {
+        uint64_t allowed = masks.lf | masks.cr;
+        result.null_count += popcount64(masks.nul);
+        result.control_count += popcount64(masks.ctrl & ~allowed);
+    }
+    if (state.collect_lines) {
+        for (uint64_t lf = masks.lf; lf; lf &= lf - 1) {
+            result.line_starts.push_back(base + __builtin_ctzll(lf) + 1);
+        }
+    }
+}
+
+// 标量实现：处理任意长度（<= 64）的块，也用于 SIMD 路径的尾部
+inline BlockMasks scalarMasks(const char* data, unsigned width, bool probe) {
+    BlockMasks masks;
+    for (unsigned i = 0; i < width; ++i) {
+        unsigned char ch = static_cast<unsigned char>(data[i]);
+        uint64_t bit = uint64_t(1) << i;
+        if (ch == '\n') {
+            masks.lf |= bit;
+        } else if (ch == '\r') {
+            masks.cr |= bit;
+        } else if (ch >= 0x80) {
+            masks.high |= bit;
+        }
+        if (probe && ch < 0x20) {
+            if (ch == 0) {
+                masks.nul |= bit;
+            }
+            if (ch != '\t') {
+                masks.ctrl |= bit;
+            }
+        }
+    }
+    return masks;
+}
+
+void scanScalar(const char* data, size_t size, size_t& pos, ScanState& state) {
+    for (; pos + 64 <= size; pos += 64) {
+        consumeBlock(scalarMasks(data + pos, 64, pos < state.result.probe_size), pos, 64, state);
+    }
+}
+
+// 从 pos 开始逐字节查找换行，追加到 positions[count...]，返回新的个数
+inline size_t appendNewlinesScalar(const char* data, size_t size, size_t pos, size_t* positions,
+                                   size_t count, size_t max_count) {
+    for (; pos < size && count < max_count; ++pos) {
+        if (data[pos] == '\n') {
+            positions[count++] = pos;
+        }
+    }
+    return count;
+}
+
+size_t findNewlinesScalar(const char* data, size_t size, size_t* positions, size_t max_count) {
+    return appendNewlinesScalar(data, size, 0, positions, 0, max_count);
+}
+
+inline bool needsJsonEscape(unsigned char ch) {
+    return ch < 0x20 || ch == '"' || ch == '\\';
+}
+
+size_t findJsonEscapeScalar(const char* data, size_t size, size_t pos) {
+    while (pos < size && !needsJsonEscape(static_cast<unsigned char>(data[pos]))) {
+        ++pos;
+    }
+    return pos;
+}
+
+#ifdef PNANA_TEXT_SCANNER_X86
+
+// SSE2 是 x86_64 的基线指令集，无需运行时检测
+inline uint64_t sse2Mask(__m128i a, __m128i b, __m128i c, __m128i d) {
+    return static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(a))) |
+           static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(b))) << 16 |
+           static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(c))) << 32 |
+           static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(d))) << 48;
+}
+
+void scanSse2(const char* data, size_t size, size_t& pos, ScanState& state) {
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i max_ctrl = _mm_set1_epi8(0x1F);
+    for (; pos + 64 <= size; pos += 64) {
+        const __m128i* p = reinterpret_cast<const __m128i*>(data + pos);
+        __m128i v0 = _mm_loadu_si128(p);
+        __m128i v1 = _mm_loadu_si128(p + 1);
+        __m128i v2 = _mm_loadu_si128(p + 2);
+        __m128i v3 = _mm_loadu_si128(p + 3);
+
+        BlockMasks masks;
+        masks.lf = sse2Mask(_mm_cmpeq_epi8(v0, lf), _mm_cmpeq_epi8(v1, lf),
+                            _mm_cmpeq_epi8(v2, lf), _mm_cmpeq_epi8(v3, lf));
+        masks.cr = sse2Mask(_mm_cmpeq_epi8(v0, cr), _mm_cmpeq_epi8(v1, cr),
+                            _mm_cmpeq_epi8(v2, cr), _mm_cmpeq_epi8(v3, cr));
+        masks.high = sse2Mask(v0, v1, v2, v3);
+        if (pos < state.result.probe_size) {
+            masks.nul = sse2Mask(_mm_cmpeq_epi8(v0, zero), _mm_cmpeq_epi8(v1, zero),
+                                 _mm_cmpeq_epi8(v2, zero), _mm_cmpeq_epi8(v3, zero));
+            // v <= 0x1F 且不是 \t（\n \r 在 consumeBlock 中排除）
+            auto ctrl = [&](__m128i v) {
+                __m128i low = _mm_cmpeq_epi8(_mm_min_epu8(v, max_ctrl), v);
+                return _mm_andnot_si128(_mm_cmpeq_epi8(v, tab), low);
+            };
+            masks.ctrl = sse2Mask(ctrl(v0), ctrl(v1), ctrl(v2), ctrl(v3));
+        }
+        consumeBlock(masks, pos, 64, state);
+    }
+}
+
+size_t findNewlinesSse2(const char* data, size_t size, size_t* positions, size_t max_count) {
+    const __m128i lf = _mm_set1_epi8('\n');
+    size_t count = 0;
+    size_t pos = 0;
+    for (; pos + 64 <= size; pos += 64) {
+        const __m128i* p = reinterpret_cast<const __m128i*>(data + pos);
+        uint64_t mask = sse2Mask(
+            _mm_cmpeq_epi8(_mm_loadu_si128(p), lf), _mm_cmpeq_epi8(_mm_loadu_si128(p + 1), lf),
+            _mm_cmpeq_epi8(_mm_loadu_si128(p + 2), lf), _mm_cmpeq_epi8(_mm_loadu_si128(p + 3), lf));
+        for (; mask; mask &= mask - 1) {
+            positions[count++] = pos + __builtin_ctzll(mask);
+            if (count == max_count) {
+                return count;
+            }
+        }
+    }
+    return appendNewlinesScalar(data, size, pos, positions, count, max_count);
+}
+
+// JSON 转义只在发送 LSP 消息时使用，SSE2 已足够（转义字符通常很稀疏，瓶颈在内存复制）
+size_t findJsonEscapeSse2(const char* data, size_t size) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i max_ctrl = _mm_set1_epi8(0x1F);
+    size_t pos = 0;
+    for (; pos + 16 <= size; pos += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash));
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi8(_mm_min_epu8(v, max_ctrl), v));
+        int mask = _mm_movemask_epi8(hit);
+        if (mask) {
+            return pos + __builtin_ctz(mask);
+        }
+    }
+    return findJsonEscapeScalar(data, size, pos);
+}
+
+__attribute__((target("avx2"))) inline uint64_t avx2Mask(__m256i a, __m256i b) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(a))) |
+           static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(b))) << 32;
+}
+
+__attribute__((target("avx2"))) void scanAvx2(const char* data, size_t size, size_t& pos,
+                                              ScanState& state) {
+    const __m256i lf = _mm256_set1_epi8('\n');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i max_ctrl = _mm256_set1_epi8(0x1F);
+    for (; pos + 64 <= size; pos += 64) {
+        const __m256i* p = reinterpret_cast<const __m256i*>(data + pos);
+        __m256i v0 = _mm256_loadu_si256(p);
+        __m256i v1 = _mm256_loadu_si256(p + 1);
+
+        BlockMasks masks;
+        masks.lf = avx2Mask(_mm256_cmpeq_epi8(v0, lf), _mm256_cmpeq_epi8(v1, lf));
+        masks.cr = avx2Mask(_mm256_cmpeq_epi8(v0, cr), _mm256_cmpeq_epi8(v1, cr));
+        masks.high = avx2Mask(v0, v1);
+        if (pos < state.result.probe_size) {
+            masks.nul = avx2Mask(_mm256_cmpeq_epi8(v0, zero), _mm256_cmpeq_epi8(v1, zero));
+            __m256i low0 = _mm256_cmpeq_epi8(_mm256_min_epu8(v0, max_ctrl), v0);
+            __m256i low1 = _mm256_cmpeq_epi8(_mm256_min_epu8(v1, max_ctrl), v1);
+            masks.ctrl = avx2Mask(_mm256_andnot_si256(_mm256_cmpeq_epi8(v0, tab), low0),
+                                  _mm256_andnot_si256(_mm256_cmpeq_epi8(v1, tab), low1));
+        }
+        consumeBlock(masks, pos, 64, state);
+    }
+}
+
+__attribute__((target("avx2"))) size_t findNewlinesAvx2(const char* data, size_t size,
+                                                        size_t* positions, size_t max_count) {
+    const __m256i lf = _mm256_set1_epi8('\n');
+    size_t count = 0;
+    size_t pos = 0;
+    for (; pos + 64 <= size; pos += 64) {
+        const __m256i* p = reinterpret_cast<const __m256i*>(data + pos);
+        uint64_t mask = avx2Mask(_mm256_cmpeq_epi8(_mm256_loadu_si256(p), lf),
+                                 _mm256_cmpeq_epi8(_mm256_loadu_si256(p + 1), lf));
+        for (; mask; mask &= mask - 1) {
+            positions[count++] = pos + __builtin_ctzll(mask);
+            if (count == max_count) {
+                return count;
+            }
+        }
+    }
+    return appendNewlinesScalar(data, size, pos, positions, count, max_count);
+}
+
+#endif // PNANA_TEXT_SCANNER_X86
+
+using ScanFn = void (*)(const char*, size_t, size_t&, ScanState&);
+using FindFn = size_t (*)(const char*, size_t, size_t*, size_t);
+
+struct Implementation {
+    const char* name;
+    ScanFn scan;
+    FindFn find_newlines;
+};
+
+const Implementation& selectImplementation() {
+    static const Implementation impl = []() {
+#ifdef PNANA_TEXT_SCANNER_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return Implementation{"avx2", scanAvx2, findNewlinesAvx2};
+        }
+        return Implementation{"sse2", scanSse2, findNewlinesSse2};
+#else
+        return Implementation{"scalar", scanScalar, findNewlinesScalar};
+#endif
+    }();
+    return impl;
+}
+
+} // namespace
+
+TextScanResult TextScanner::scan(const char* data, size_t size, bool collect_lines) {
+    TextScanResult result;
+    result.probe_size = std::min(size, BINARY_PROBE_BYTES);
+    if (collect_lines) {
+        result.line_starts.push_back(0);
+    }
+
+    ScanState state{result, collect_lines};
+    size_t pos = 0;
+    selectImplementation().scan(data, size, pos, state);
+    // 不足 64 字节的尾部用标量处理
+    if (pos < size) {
+        unsigned width = static_cast<unsigned>(size - pos);
+        consumeBlock(scalarMasks(data + pos, width, pos < result.probe_size), pos, width, state);
+    }
+
+    result.cr_count = state.cr_total - result.crlf_count;
+    return result;
+}
+
+size_t TextScanner::findNewlines(const char* data, size_t size, size_t* positions,
+                                 size_t max_count) {
+    if (max_count == 0) {
+        return 0;
+    }
+    return selectImplementation().find_newlines(data, size, positions, max_count);
+}
+
+std::vector<std::string> TextScanner::splitLines(const std::string& content) {
+    return splitLines(content, scan(content.data(), content.size()));
+}
+
+std::vector<std::string> TextScanner::splitLines(const std::string& content,
+                                                 const TextScanResult& scan_result) {
+    const std::vector<size_t>& starts = scan_result.line_starts;
+
+    std::vector<std::string> lines;
+    lines.reserve(starts.size());
+    for (size_t i = 0; i < starts.size(); ++i) {
+        size_t begin = starts[i];
+        size_t end = i + 1 < starts.size() ? starts[i + 1] - 1 : content.size();
+        if (end > begin && content[end - 1] == '\r') {
+            end--;
+        }
+        lines.emplace_back(content, begin, end - begin);
+    }
+    return lines;
+}
+
+size_t TextScanner::findJsonEscape(const char* data, size_t size) {
+#ifdef PNANA_TEXT_SCANNER_X86
+    return findJsonEscapeSse2(data, size);
+#else
+    return findJsonEscapeScalar(data, size, 0);
+#endif
+}
+
+const char* TextScanner::implementation() {
+    return selectImplementation().name;
+}
+
+} // namespace utils
+} // namespace pnana
@@ -0,0 +1,445 @@
+#include "utils/unicode_width.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+namespace pnana {
+namespace utils {
+
+namespace {
+
+struct CodePointRange {
+    char32_t first;
+    char32_t last;
+};
+
+// 以下两张表由 Unicode 14.0 字符数据库生成（未分配的码点并入相邻区间）：
+// 0 宽为 Mn/Me/Cf 类字符与谚文中声、终声（U+1160-U+11FF、U+D7B0-U+D7FF），不含软连字符 U+00AD；
+// 2 宽为 East Asian Width 为 W 或 F 的字符，以及 U+20000-U+3FFFD
+// clang-format off
+constexpr CodePointRange ZERO_WIDTH_RANGES[] = {
+    {0x0300, 0x036F}, {0x0483, 0x0489}, {0x0591, 0x05BD}, {0x05BF, 0x05BF},
+    {0x05C1, 0x05C2}, {0x05C4, 0x05C5}, {0x05C7, 0x05C7}, {0x0600, 0x0605},
+    {0x0610, 0x061A}, {0x061C, 0x061C}, {0x064B, 0x065F}, {0x0670, 0x0670},
+    {0x06D6, 0x06DD}, {0x06DF, 0x06E4}, {0x06E7, 0x06E8}, {0x06EA, 0x06ED},
+    {0x070F, 0x070F}, {0x0711, 0x0711}, {0x0730, 0x074A}, {0x07A6, 0x07B0},
+    {0x07EB, 0x07F3}, {0x07FD, 0x07FD}, {0x0816, 0x0819}, {0x081B, 0x0823},
+    {0x0825, 0x0827}, {0x0829, 0x082D}, {0x0859, 0x085B}, {0x0890, 0x089F},
+    {0x08CA, 0x0902}, {0x093A, 0x093A}, {0x093C, 0x093C}, {0x0941, 0x0948},
+    {0x094D, 0x094D}, {0x0951, 0x0957}, {0x0962, 0x0963}, {0x0981, 0x0981},
+    {0x09BC, 0x09BC}, {0x09C1, 0x09C4}, {0x09CD, 0x09CD}, {0x09E2, 0x09E3},
+    {0x09FE, 0x0A02}, {0x0A3C, 0x0A3C}, {0x0A41, 0x0A51}, {0x0A70, 0x0A71},
+    {0x0A75, 0x0A75}, {0x0A81, 0x0A82}, {0x0ABC, 0x0ABC}, {0x0AC1, 0x0AC8},
+    {0x0ACD, 0x0ACD}, {0x0AE2, 0x0AE3}, {0x0AFA, 0x0B01}, {0x0B3C, 0x0B3C},
+    {0x0B3F, 0x0B3F}, {0x0B41, 0x0B44}, {0x0B4D, 0x0B56}, {0x0B62, 0x0B63},
+    {0x0B82, 0x0B82}, {0x0BC0, 0x0BC0}, {0x0BCD, 0x0BCD}, {0x0C00, 0x0C00},
+    {0x0C04, 0x0C04}, {0x0C3C, 0x0C3C}, {0x0C3E, 0x0C40}, {0x0C46, 0x0C56},
+    {0x0C62, 0x0C63}, {0x0C81, 0x0C81}, {0x0CBC, 0x0CBC}, {0x0CBF, 0x0CBF},
+    {0x0CC6, 0x0CC6}, {0x0CCC, 0x0CCD}, {0x0CE2, 0x0CE3}, {0x0D00, 0x0D01},
+    {0x0D3B, 0x0D3C}, {0x0D41, 0x0D44}, {0x0D4D, 0x0D4D}, {0x0D62, 0x0D63},
+    {0x0D81, 0x0D81}, {0x0DCA, 0x0DCA}, {0x0DD2, 0x0DD6}, {0x0E31, 0x0E31},
+    {0x0E34, 0x0E3A}, {0x0E47, 0x0E4E}, {0x0EB1, 0x0EB1}, {0x0EB4, 0x0EBC},
+    {0x0EC8, 0x0ECD}, {0x0F18, 0x0F19}, {0x0F35, 0x0F35}, {0x0F37, 0x0F37},
+    {0x0F39, 0x0F39}, {0x0F71, 0x0F7E}, {0x0F80, 0x0F84}, {0x0F86, 0x0F87},
+    {0x0F8D, 0x0FBC}, {0x0FC6, 0x0FC6}, {0x102D, 0x1030}, {0x1032, 0x1037},
+    {0x1039, 0x103A}, {0x103D, 0x103E}, {0x1058, 0x1059}, {0x105E, 0x1060},
+    {0x1071, 0x1074}, {0x1082, 0x1082}, {0x1085, 0x1086}, {0x108D, 0x108D},
+    {0x109D, 0x109D}, {0x1160, 0x11FF}, {0x135D, 0x135F}, {0x1712, 0x1714},
+    {0x1732, 0x1733}, {0x1752, 0x1753}, {0x1772, 0x1773}, {0x17B4, 0x17B5},
+    {0x17B7, 0x17BD}, {0x17C6, 0x17C6}, {0x17C9, 0x17D3}, {0x17DD, 0x17DD},
+    {0x180B, 0x180F}, {0x1885, 0x1886}, {0x18A9, 0x18A9}, {0x1920, 0x1922},
+    {0x1927, 0x1928}, {0x1932, 0x1932}, {0x1939, 0x193B}, {0x1A17, 0x1A18},
+    {0x1A1B, 0x1A1B}, {0x1A56, 0x1A56}, {0x1A58, 0x1A60}, {0x1A62, 0x1A62},
+    {0x1A65, 0x1A6C}, {0x1A73, 0x1A7F}, {0x1AB0, 0x1B03}, {0x1B34, 0x1B34},
+    {0x1B36, 0x1B3A}, {0x1B3C, 0x1B3C}, {0x1B42, 0x1B42}, {0x1B6B, 0x1B73},
+    {0x1B80, 0x1B81}, {0x1BA2, 0x1BA5}, {0x1BA8, 0x1BA9}, {0x1BAB, 0x1BAD},
+    {0x1BE6, 0x1BE6}, {0x1BE8, 0x1BE9}, {0x1BED, 0x1BED}, {0x1BEF, 0x1BF1},
+    {0x1C2C, 0x1C33}, {0x1C36, 0x1C37}, {0x1CD0, 0x1CD2}, {0x1CD4, 0x1CE0},
+    {0x1CE2, 0x1CE8}, {0x1CED, 0x1CED}, {0x1CF4, 0x1CF4}, {0x1CF8, 0x1CF9},
+    {0x1DC0, 0x1DFF}, {0x200B, 0x200F}, {0x202A, 0x202E}, {0x2060, 0x206F},
+    {0x20D0, 0x20F0}, {0x2CEF, 0x2CF1}, {0x2D7F, 0x2D7F}, {0x2DE0, 0x2DFF},
+    {0x302A, 0x302D}, {0x3099, 0x309A}, {0xA66F, 0xA672}, {0xA674, 0xA67D},
+    {0xA69E, 0xA69F}, {0xA6F0, 0xA6F1}, {0xA802, 0xA802}, {0xA806, 0xA806},
+    {0xA80B, 0xA80B}, {0xA825, 0xA826}, {0xA82C, 0xA82C}, {0xA8C4, 0xA8C5},
+    {0xA8E0, 0xA8F1}, {0xA8FF, 0xA8FF}, {0xA926, 0xA92D}, {0xA947, 0xA951},
+    {0xA980, 0xA982}, {0xA9B3, 0xA9B3}, {0xA9B6, 0xA9B9}, {0xA9BC, 0xA9BD},
+    {0xA9E5, 0xA9E5}, {0xAA29, 0xAA2E}, {0xAA31, 0xAA32}, {0xAA35, 0xAA36},
+    {0xAA43, 0xAA43}, {0xAA4C, 0xAA4C}, {0xAA7C, 0xAA7C}, {0xAAB0, 0xAAB0},
+    {0xAAB2, 0xAAB4}, {0xAAB7, 0xAAB8}, {0xAABE, 0xAABF}, {0xAAC1, 0xAAC1},
+    {0xAAEC, 0xAAED}, {0xAAF6, 0xAAF6}, {0xABE5, 0xABE5}, {0xABE8, 0xABE8},
+    {0xABED, 0xABED}, {0xD7B0, 0xD7FB}, {0xFB1E, 0xFB1E}, {0xFE00, 0xFE0F},
+    {0xFE20, 0xFE2F}, {0xFEFF, 0xFEFF}, {0xFFF9, 0xFFFB}, {0x101FD, 0x101FD},
+    {0x102E0, 0x102E0}, {0x10376, 0x1037A}, {0x10A01, 0x10A0F}, {0x10A38, 0x10A3F},
+    {0x10AE5, 0x10AE6}, {0x10D24, 0x10D27}, {0x10EAB, 0x10EAC}, {0x10F46, 0x10F50},
+    {0x10F82, 0x10F85}, {0x11001, 0x11001}, {0x11038, 0x11046}, {0x11070, 0x11070},
+    {0x11073, 0x11074}, {0x1107F, 0x11081}, {0x110B3, 0x110B6}, {0x110B9, 0x110BA},
+    {0x110BD, 0x110BD}, {0x110C2, 0x110CD}, {0x11100, 0x11102}, {0x11127, 0x1112B},
+    {0x1112D, 0x11134}, {0x11173, 0x11173}, {0x11180, 0x11181}, {0x111B6, 0x111BE},
+    {0x111C9, 0x111CC}, {0x111CF, 0x111CF}, {0x1122F, 0x11231}, {0x11234, 0x11234},
+    {0x11236, 0x11237}, {0x1123E, 0x1123E}, {0x112DF, 0x112DF}, {0x112E3, 0x112EA},
+    {0x11300, 0x11301}, {0x1133B, 0x1133C}, {0x11340, 0x11340}, {0x11366, 0x11374},
+    {0x11438, 0x1143F}, {0x11442, 0x11444}, {0x11446, 0x11446}, {0x1145E, 0x1145E},
+    {0x114B3, 0x114B8}, {0x114BA, 0x114BA}, {0x114BF, 0x114C0}, {0x114C2, 0x114C3},
+    {0x115B2, 0x115B5}, {0x115BC, 0x115BD}, {0x115BF, 0x115C0}, {0x115DC, 0x115DD},
+    {0x11633, 0x1163A}, {0x1163D, 0x1163D}, {0x1163F, 0x11640}, {0x116AB, 0x116AB},
+    {0x116AD, 0x116AD}, {0x116B0, 0x116B5}, {0x116B7, 0x116B7}, {0x1171D, 0x1171F},
+    {0x11722, 0x11725}, {0x11727, 0x1172B}, {0x1182F, 0x11837}, {0x11839, 0x1183A},
+    {0x1193B, 0x1193C}, {0x1193E, 0x1193E}, {0x11943, 0x11943}, {0x119D4, 0x119DB},
+    {0x119E0, 0x119E0}, {0x11A01, 0x11A0A}, {0x11A33, 0x11A38}, {0x11A3B, 0x11A3E},
+    {0x11A47, 0x11A47}, {0x11A51, 0x11A56}, {0x11A59, 0x11A5B}, {0x11A8A, 0x11A96},
+    {0x11A98, 0x11A99}, {0x11C30, 0x11C3D}, {0x11C3F, 0x11C3F}, {0x11C92, 0x11CA7},
+    {0x11CAA, 0x11CB0}, {0x11CB2, 0x11CB3}, {0x11CB5, 0x11CB6}, {0x11D31, 0x11D45},
+    {0x11D47, 0x11D47}, {0x11D90, 0x11D91}, {0x11D95, 0x11D95}, {0x11D97, 0x11D97},
+    {0x11EF3, 0x11EF4}, {0x13430, 0x13438}, {0x16AF0, 0x16AF4}, {0x16B30, 0x16B36},
+    {0x16F4F, 0x16F4F}, {0x16F8F, 0x16F92}, {0x16FE4, 0x16FE4}, {0x1BC9D, 0x1BC9E},
+    {0x1BCA0, 0x1CF46}, {0x1D167, 0x1D169}, {0x1D173, 0x1D182}, {0x1D185, 0x1D18B},
+    {0x1D1AA, 0x1D1AD}, {0x1D242, 0x1D244}, {0x1DA00, 0x1DA36}, {0x1DA3B, 0x1DA6C},
+    {0x1DA75, 0x1DA75}, {0x1DA84, 0x1DA84}, {0x1DA9B, 0x1DAAF}, {0x1E000, 0x1E02A},
+    {0x1E130, 0x1E136}, {0x1E2AE, 0x1E2AE}, {0x1E2EC, 0x1E2EF}, {0x1E8D0, 0x1E8D6},
+    {0x1E944, 0x1E94A}, {0xE0001, 0xE01EF},
+};
+
+constexpr CodePointRange WIDE_RANGES[] = {
+    {0x1100, 0x115F}, {0x231A, 0x231B}, {0x2329, 0x232A}, {0x23E9, 0x23EC},
+    {0x23F0, 0x23F0}, {0x23F3, 0x23F3}, {0x25FD, 0x25FE}, {0x2614, 0x2615},
+    {0x2648, 0x2653}, {0x267F, 0x267F}, {0x2693, 0x2693}, {0x26A1, 0x26A1},
+    {0x26AA, 0x26AB}, {0x26BD, 0x26BE}, {0x26C4, 0x26C5}, {0x26CE, 0x26CE},
+    {0x26D4, 0x26D4}, {0x26EA, 0x26EA}, {0x26F2, 0x26F3}, {0x26F5, 0x26F5},
+    {0x26FA, 0x26FA}, {0x26FD, 0x26FD}, {0x2705, 0x2705}, {0x270A, 0x270B},
+    {0x2728, 0x2728}, {0x274C, 0x274C}, {0x274E, 0x274E}, {0x2753, 0x2755},
+    {0x2757, 0x2757}, {0x2795, 0x2797}, {0x27B0, 0x27B0}, {0x27BF, 0x27BF},
+    {0x2B1B, 0x2B1C}, {0x2B50, 0x2B50}, {0x2B55, 0x2B55}, {0x2E80, 0x3029},
+    {0x302E, 0x303E}, {0x3041, 0x3096}, {0x309B, 0x3247}, {0x3250, 0x4DBF},
+    {0x4E00, 0xA4C6}, {0xA960, 0xA97C}, {0xAC00, 0xD7A3}, {0xF900, 0xFAD9},
+    {0xFE10, 0xFE19}, {0xFE30, 0xFE6B}, {0xFF01, 0xFF60}, {0xFFE0, 0xFFE6},
+    {0x16FE0, 0x16FE3}, {0x16FF0, 0x1B2FB}, {0x1F004, 0x1F004}, {0x1F0CF, 0x1F0CF},
+    {0x1F18E, 0x1F18E}, {0x1F191, 0x1F19A}, {0x1F200, 0x1F320}, {0x1F32D, 0x1F335},
+    {0x1F337, 0x1F37C}, {0x1F37E, 0x1F393}, {0x1F3A0, 0x1F3CA}, {0x1F3CF, 0x1F3D3},
+    {0x1F3E0, 0x1F3F0}, {0x1F3F4, 0x1F3F4}, {0x1F3F8, 0x1F43E}, {0x1F440, 0x1F440},
+    {0x1F442, 0x1F4FC}, {0x1F4FF, 0x1F53D}, {0x1F54B, 0x1F54E}, {0x1F550, 0x1F567},
+    {0x1F57A, 0x1F57A}, {0x1F595, 0x1F596}, {0x1F5A4, 0x1F5A4}, {0x1F5FB, 0x1F64F},
+    {0x1F680, 0x1F6C5}, {0x1F6CC, 0x1F6CC}, {0x1F6D0, 0x1F6D2}, {0x1F6D5, 0x1F6DF},
+    {0x1F6EB, 0x1F6EC}, {0x1F6F4, 0x1F6FC}, {0x1F7E0, 0x1F7F0}, {0x1F90C, 0x1F93A},
+    {0x1F93C, 0x1F945}, {0x1F947, 0x1F9FF}, {0x1FA70, 0x1FAF6}, {0x20000, 0x3FFFD},
+};
+// clang-format on
+
+constexpr char32_t REPLACEMENT_CHARACTER = 0xFFFD;
+constexpr char32_t ZERO_WIDTH_JOINER = 0x200D;
+// 向前寻找确定的簇起点时最多回退的码点数
+constexpr int MAX_LOOKBEHIND = 32;
+
+template <size_t N>
+bool inRanges(const CodePointRange (&ranges)[N], char32_t code_point) {
+    auto it = std::upper_bound(
+        ranges, ranges + N, code_point,
+        [](char32_t value, const CodePointRange& range) { return value < range.first; });
+    return it != ranges && code_point <= (it - 1)->last;
+}
+
+bool isRegionalIndicator(char32_t code_point) {
+    return code_point >= 0x1F1E6 && code_point <= 0x1F1FF;
+}
+
+bool isEmojiModifier(char32_t code_point) {
+    return code_point >= 0x1F3FB && code_point <= 0x1F3FF;
+}
+
+// 附着在前一个字符上的码点（组合符号、变体选择符、ZWJ 等 0 宽字符）
+bool isExtend(char32_t code_point) {
+    return code_point >= 0x300 && UnicodeWidth::codePointWidth(code_point) == 0;
+}
+
+// pos 之前一个码点的起始位置
+size_t prevCodePoint(std::string_view text, size_t pos) {
+    size_t start = pos - 1;
+    while (start > 0 && pos - start < 4 &&
+           (static_cast<unsigned char>(text[start]) & 0xC0) == 0x80) {
+        start--;
+    }
+    return start;
+}
+
+// start 处一定是字形簇的起点：自身不会附着到前一个字符，且前一个码点不是 ZWJ（\r\n 中的 \n 也不是）
+bool isClusterStart(std::string_view text, size_t start) {
+    size_t pos = start;
+    const char32_t code_point = UnicodeWidth::decode(text, pos);
+    if (isExtend(code_point) || isEmojiModifier(code_point) || isRegionalIndicator(code_point)) {
+        return false;
+    }
+    if (start == 0) {
+        return true;
+    }
+    size_t prev = prevCodePoint(text, start);
+    const char32_t previous = UnicodeWidth::decode(text, prev);
+    return previous != ZERO_WIDTH_JOINER && !(previous == '\r' && code_point == '\n');
+}
+
+} // namespace
+
+int UnicodeWidth::codePointWidth(char32_t code_point) {
+    if (code_point < 0x300) {
+        return 1;
+    }
+    if (inRanges(ZERO_WIDTH_RANGES, code_point)) {
+        return 0;
+    }
+    if (inRanges(WIDE_RANGES, code_point)) {
+        return 2;
+    }
+    return 1;
+}
+
+char32_t UnicodeWidth::decode(std::string_view text, size_t& pos) {
+    const unsigned char first = static_cast<unsigned char>(text[pos]);
+    if (first < 0x80) {
+        pos++;
+        return first;
+    }
+    size_t length;
+    char32_t code_point;
+    if ((first & 0xE0) == 0xC0) {
+        length = 2;
+        code_point = first & 0x1F;
+    } else if ((first & 0xF0) == 0xE0) {
+        length = 3;
+        code_point = first & 0x0F;
+    } else if ((first & 0xF8) == 0xF0) {
+        length = 4;
+        code_point = first & 0x07;
+    } else {
+        pos++;
+        return REPLACEMENT_CHARACTER;
+    }
+    if (pos + length > text.size()) {
+        pos++;
+        return REPLACEMENT_CHARACTER;
+    }
+    for (size_t k = 1; k < length; ++k) {
+        const unsigned char byte = static_cast<unsigned char>(text[pos + k]);
+        if ((byte & 0xC0) != 0x80) {
+            pos++;
+            return REPLACEMENT_CHARACTER;
+        }
+        code_point = (code_point << 6) | (byte & 0x3F);
+    }
+    pos += length;
+    return code_point;
+}
+
+size_t UnicodeWidth::nextGrapheme(std::string_view text, size_t pos) {
+    if (pos >= text.size()) {
+        return text.size();
+    }
+    size_t next = pos;
+    const char32_t base = decode(text, next);
+    if (base == '\r' && next < text.size() && text[next] == '\n') {
+        return next + 1;
+    }
+    bool pending_regional = isRegionalIndicator(base);
+    bool after_joiner = false;
+    while (next < text.size()) {
+        size_t after = next;
+        const char32_t code_point = decode(text, after);
+        if (isExtend(code_point) || isEmojiModifier(code_point)) {
+            after_joiner = code_point == ZERO_WIDTH_JOINER;
+        } else if (after_joiner) {
+            after_joiner = false; // ZWJ 连接的字符（如 👨‍👩‍👧 中的各个人物）
+        } else if (pending_regional && isRegionalIndicator(code_point)) {
+            pending_regional = false; // 两个区域指示符组成一面旗帜
+        } else {
+            break;
+        }
+        next = after;
+    }
+    return next;
+}
+
+size_t UnicodeWidth::prevGrapheme(std::string_view text, size_t pos) {
+    pos = std::min(pos, text.size());
+    if (pos == 0) {
+        return 0;
+    }
+    // 先退到一个确定的簇起点，再向后逐簇找到 pos 之前的最后一个边界
+    size_t start = pos;
+    for (int steps = 0; steps < MAX_LOOKBEHIND && start > 0; ++steps) {
+        start = prevCodePoint(text, start);
+        if (isClusterStart(text, start)) {
+            break;
+        }
+    }
+    size_t boundary = start;
+    while (true) {
+        size_t next = nextGrapheme(text, boundary);
+        if (next >= pos) {
+            return boundary;
+        }
+        boundary = next;
+    }
+}
+
+int UnicodeWidth::graphemeWidth(std::string_view text, size_t pos) {
+    if (pos >= text.size()) {
+        return 0;
+    }
+    return codePointWidth(decode(text, pos));
+}
+
+size_t UnicodeWidth::displayWidth(std::string_view text) {
+    size_t width = 0;
+    for (size_t pos = 0; pos < text.size(); pos = nextGrapheme(text, pos)) {
+        width += static_cast<size_t>(graphemeWidth(text, pos));
+    }
+    return width;
+}
+
+namespace {
+
+// text 前 limit 字节中纯 ASCII 前缀的长度。前缀中每个字节各是一个 1 列的字形簇，
+// 但第一个非 ASCII 字节可能是前一个 ASCII 字符的组合符号，逐簇扫描要从前缀的最后一个字节开始
+size_t asciiPrefix(std::string_view text, size_t limit) {
+    const size_t end = std::min(limit, text.size());
+    size_t pos = 0;
+    // 渲染时每行都要换算水平滚动的起点，长行一次检查 8 个字节
+    while (pos + sizeof(uint64_t) <= end) {
+        uint64_t word;
+        std::memcpy(&word, text.data() + pos, sizeof(word));
+        if (word & 0x8080808080808080ULL) {
+            break;
+        }
+        pos += sizeof(word);
+    }
+    while (pos < end && static_cast<unsigned char>(text[pos]) < 0x80) {
+        ++pos;
+    }
+    return pos;
+}
+
+} // namespace
+
+size_t UnicodeWidth::columnAt(std::string_view text, size_t byte) {
+    // [0, byte] 都是 ASCII 时字节即列
+    const size_t ascii = asciiPrefix(text, byte + 1);
+    if (ascii > byte || ascii == text.size()) {
+        return std::min(byte, text.size());
+    }
+    size_t pos = ascii > 0 ? ascii - 1 : 0;
+    size_t column = pos;
+    while (pos < text.size()) {
+        const size_t next = nextGrapheme(text, pos);
+        if (next > byte) {
+            return column;
+        }
+        column += static_cast<size_t>(graphemeWidth(text, pos));
+        pos = next;
+    }
+    return column;
+}
+
+size_t UnicodeWidth::byteAt(std::string_view text, size_t column) {
+    // [0, column] 都是 ASCII 时第 column 列就是第 column 个字节
+    const size_t ascii = asciiPrefix(text, column + 1);
+    if (ascii > column || ascii == text.size()) {
+        return std::min(column, text.size());
+    }
+    size_t pos = ascii > 0 ? ascii - 1 : 0;
+    size_t current = pos;
+    while (pos < text.size()) {
+        const size_t width = static_cast<size_t>(graphemeWidth(text, pos));
+        if (current + width > column) {
+            return pos;
+        }
+        current += width;
+        pos = nextGrapheme(text, pos);
+    }
+    return text.size();
+}
+
+size_t UnicodeWidth::utf16ToByte(std::string_view text, size_t units) {
+    // [0, units) 都是 ASCII 时码元即字节
+    const size_t ascii = asciiPrefix(text, units);
+    if (ascii == units || ascii == text.size()) {
+        return ascii;
+    }
+    size_t pos = ascii;
+    size_t count = ascii;
+    while (pos < text.size() && count < units) {
+        count += decode(text, pos) >= 0x10000 ? 2 : 1;
+    }
+    return pos;
+}
+
+void ColumnIndex::clear() {
+    checkpoints_.clear();
+    length_ = 0;
+    complete_ = false;
+}
+
+void ColumnIndex::prepare(std::string_view text) {
+    if (checkpoints_.empty() || length_ != text.size()) {
+        clear();
+        checkpoints_.push_back({0, 0});
+        length_ = text.size();
+    }
+}
+
+bool ColumnIndex::extend(std::string_view text) {
+    const Checkpoint last = checkpoints_.back();
+    const size_t target = last.byte + CHECKPOINT_BYTES;
+    if (target >= text.size()) {
+        complete_ = true;
+        return false;
+    }
+
+    // [last.byte, target] 都是 ASCII 时 target 就是簇边界
+    size_t pos = last.byte;
+    size_t column = last.column;
+    const size_t ascii = asciiPrefix(text.substr(pos), target - pos + 1);
+    if (ascii > target - pos) {
+        checkpoints_.push_back({target, column + (target - pos)});
+        return true;
+    }
+    if (ascii > 0) {
+        pos += ascii - 1;
+        column += ascii - 1;
+    }
+    // 逐簇走到 target 之后的第一个边界
+    while (pos < target) {
+        column += static_cast<size_t>(UnicodeWidth::graphemeWidth(text, pos));
+        pos = UnicodeWidth::nextGrapheme(text, pos);
+    }
+    if (pos >= text.size()) {
+        complete_ = true;
+        return false;
+    }
+    checkpoints_.push_back({pos, column});
+    return true;
+}
+
+size_t ColumnIndex::columnAt(std::string_view text, size_t byte) {
+    prepare(text);
+    while (!complete_ && checkpoints_.back().byte + CHECKPOINT_BYTES <= byte && extend(text)) {
+    }
+    // 最后一个不超过 byte 的检查点：簇不跨越检查点，从这里扫描即可
+    auto it = std::upper_bound(
+        checkpoints_.begin(), checkpoints_.end(), byte,
+        [](size_t value, const Checkpoint& checkpoint) { return value < checkpoint.byte; });
+    const Checkpoint& from = *std::prev(it);
+    return from.column + UnicodeWidth::columnAt(text.substr(from.byte), byte - from.byte);
+}
+
+size_t ColumnIndex::byteAt(std::string_view text, size_t column) {
+    prepare(text);
+    while (!complete_ && checkpoints_.back().column <= column && extend(text)) {
+    }
+    // 最后一个不超过 column 的检查点：覆盖 column 的簇不会在它之前开始
+    auto it = std::upper_bound(
+        checkpoints_.begin(), checkpoints_.end(), column,
+        [](size_t value, const Checkpoint& checkpoint) { return value < checkpoint.column; });
+    const Checkpoint& from = *std::prev(it);
+    return from.byte + UnicodeWidth::byteAt(text.substr(from.byte), column - from.column);
+}
+
+} // namespace utils
+} // namespace pnana